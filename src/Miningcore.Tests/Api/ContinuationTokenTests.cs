@@ -0,0 +1,52 @@
+using System;
+using Miningcore.Api;
+using Miningcore.Persistence.Model;
+using Xunit;
+
+namespace Miningcore.Tests.Api;
+
+public class ContinuationTokenTests
+{
+    [Fact]
+    public void PageCursor_Roundtrip()
+    {
+        var cursor = new PageCursor(new DateTime(2024, 5, 17, 13, 45, 12, 345, DateTimeKind.Utc).AddTicks(6780), 123456789012);
+
+        var token = ContinuationToken.Encode(cursor);
+        var decoded = ContinuationToken.DecodePageCursor(token);
+
+        Assert.DoesNotContain('+', token);
+        Assert.DoesNotContain('/', token);
+        Assert.Equal(cursor, decoded);
+        Assert.Equal(DateTimeKind.Utc, decoded.Created.Kind);
+    }
+
+    [Fact]
+    public void MinerHashrate_Roundtrip()
+    {
+        var last = new MinerWorkerPerformanceStats { Miner = "ltc1qexampleaddress", Hashrate = 1234567.891 };
+
+        var decoded = ContinuationToken.DecodeMinerHashrateCursor(ContinuationToken.Encode(last));
+
+        Assert.Equal(last.Miner, decoded.Miner);
+        Assert.Equal(last.Hashrate, decoded.Hashrate);
+    }
+
+    [Fact]
+    public void Missing_Token_Means_First_Page()
+    {
+        Assert.Null(ContinuationToken.DecodePageCursor(null));
+        Assert.Null(ContinuationToken.DecodePageCursor(string.Empty));
+        Assert.Null(ContinuationToken.DecodeMinerHashrateCursor(null));
+    }
+
+    [Fact]
+    public void Invalid_Token_Throws()
+    {
+        var minerToken = ContinuationToken.Encode(new MinerWorkerPerformanceStats { Miner = "x", Hashrate = 1 });
+
+        Assert.ThrowsAny<Exception>(() => ContinuationToken.DecodePageCursor("not a token!"));
+        Assert.ThrowsAny<Exception>(() => ContinuationToken.DecodePageCursor("AQID"));
+        Assert.ThrowsAny<Exception>(() => ContinuationToken.DecodePageCursor(minerToken));
+    }
+}
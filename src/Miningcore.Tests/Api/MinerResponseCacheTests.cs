@@ -0,0 +1,176 @@
+using System;
+using System.Text;
+using Miningcore.Api;
+using Miningcore.Messaging;
+using Miningcore.Notifications.Messages;
+using Miningcore.Persistence.Model;
+using Miningcore.Tests.Util;
+using Xunit;
+
+namespace Miningcore.Tests.Api;
+
+public class MinerResponseCacheTests
+{
+    private const string PoolId = "pool1";
+
+    private static readonly byte[] json = Encoding.UTF8.GetBytes("{\"pendingShares\":1}");
+
+    private static (MinerResponseCache, IMessageBus, MockMasterClock) Create(int capacity = 100)
+    {
+        var messageBus = new MessageBus();
+        var clock = new MockMasterClock { CurrentTime = new DateTime(2024, 1, 1, 0, 0, 0, DateTimeKind.Utc) };
+
+        return (new MinerResponseCache(messageBus, clock, capacity, TimeSpan.FromSeconds(60)), messageBus, clock);
+    }
+
+    private static void Fill(MinerResponseCache cache, string miner, SampleRange perfMode = SampleRange.Day)
+    {
+        Assert.False(cache.TryGet(PoolId, miner, perfMode, out _, out var ticket));
+        cache.Set(ticket, json);
+    }
+
+    [Fact]
+    public void Hit_After_Fill()
+    {
+        var (cache, _, _) = Create();
+
+        Fill(cache, "miner1");
+
+        Assert.True(cache.TryGet(PoolId, "miner1", SampleRange.Day, out var entry, out _));
+        Assert.Equal(json, entry.Json);
+        Assert.StartsWith("\"", entry.ETag);
+
+        // different range is a different response
+        Assert.False(cache.TryGet(PoolId, "miner1", SampleRange.Hour, out _, out _));
+    }
+
+    [Fact]
+    public void ETag_Depends_On_Content_Only()
+    {
+        var (cache, _, _) = Create();
+
+        Assert.False(cache.TryGet(PoolId, "miner1", SampleRange.Day, out _, out var t1));
+        Assert.False(cache.TryGet(PoolId, "miner2", SampleRange.Day, out _, out var t2));
+
+        var e1 = cache.Set(t1, json);
+        var e2 = cache.Set(t2, json);
+        Assert.Equal(e1.ETag, e2.ETag);
+
+        Assert.False(cache.TryGet(PoolId, "miner3", SampleRange.Day, out _, out var t3));
+        Assert.NotEqual(e1.ETag, cache.Set(t3, Encoding.UTF8.GetBytes("{}")).ETag);
+    }
+
+    [Fact]
+    public void Hashrate_Update_Invalidates_Miner()
+    {
+        var (cache, messageBus, _) = Create();
+
+        Fill(cache, "miner1");
+        Fill(cache, "miner1", SampleRange.Hour);
+        Fill(cache, "miner2");
+
+        messageBus.SendMessage(new HashrateNotification { PoolId = PoolId, Miner = "miner1", Hashrate = 1 });
+
+        Assert.False(cache.TryGet(PoolId, "miner1", SampleRange.Day, out _, out _));
+        Assert.False(cache.TryGet(PoolId, "miner1", SampleRange.Hour, out _, out _));
+        Assert.True(cache.TryGet(PoolId, "miner2", SampleRange.Day, out _, out _));
+
+        // pool hashrate updates don't affect miners
+        messageBus.SendMessage(new HashrateNotification { PoolId = PoolId, Hashrate = 1 });
+        Assert.True(cache.TryGet(PoolId, "miner2", SampleRange.Day, out _, out _));
+    }
+
+    [Fact]
+    public void Pool_Events_Invalidate_All_Miners_Of_Pool()
+    {
+        var (cache, messageBus, _) = Create();
+
+        Fill(cache, "miner1");
+        Fill(cache, "miner2");
+
+        messageBus.SendMessage(new BlockFoundNotification { PoolId = PoolId, Miner = "miner2" });
+
+        Assert.False(cache.TryGet(PoolId, "miner1", SampleRange.Day, out _, out var t1));
+        Assert.False(cache.TryGet(PoolId, "miner2", SampleRange.Day, out _, out _));
+
+        cache.Set(t1, json);
+        Assert.True(cache.TryGet(PoolId, "miner1", SampleRange.Day, out _, out _));
+
+        messageBus.SendMessage(new PaymentNotification(PoolId, null, 1, "BTC"));
+        Assert.False(cache.TryGet(PoolId, "miner1", SampleRange.Day, out _, out _));
+
+        Fill(cache, "miner1");
+        messageBus.SendMessage(new BlockUnlockedNotification { PoolId = PoolId, Status = BlockStatus.Confirmed });
+        Assert.False(cache.TryGet(PoolId, "miner1", SampleRange.Day, out _, out _));
+
+        Fill(cache, "miner1");
+        messageBus.SendMessage(new BlockFoundNotification { PoolId = "pool2" });
+        Assert.True(cache.TryGet(PoolId, "miner1", SampleRange.Day, out _, out _));
+    }
+
+    [Fact]
+    public void Invalidation_During_Fill_Discards_Result()
+    {
+        var (cache, messageBus, _) = Create();
+
+        Assert.False(cache.TryGet(PoolId, "miner1", SampleRange.Day, out _, out var ticket));
+
+        // event arrives while the response is being built from the database
+        messageBus.SendMessage(new HashrateNotification { PoolId = PoolId, Miner = "miner1", Hashrate = 1 });
+
+        var entry = cache.Set(ticket, json);
+        Assert.Equal(json, entry.Json);
+
+        Assert.False(cache.TryGet(PoolId, "miner1", SampleRange.Day, out _, out ticket));
+
+        messageBus.SendMessage(new PaymentNotification(PoolId, null, 1, "BTC"));
+        cache.Set(ticket, json);
+
+        Assert.False(cache.TryGet(PoolId, "miner1", SampleRange.Day, out _, out _));
+    }
+
+    [Fact]
+    public void Entries_Expire_After_Max_Age()
+    {
+        var (cache, _, clock) = Create();
+
+        Fill(cache, "miner1");
+
+        clock.CurrentTime += TimeSpan.FromSeconds(59);
+        Assert.True(cache.TryGet(PoolId, "miner1", SampleRange.Day, out _, out _));
+
+        clock.CurrentTime += TimeSpan.FromSeconds(1);
+        Assert.False(cache.TryGet(PoolId, "miner1", SampleRange.Day, out _, out _));
+    }
+
+    [Fact]
+    public void Least_Recently_Used_Is_Evicted()
+    {
+        var (cache, _, _) = Create(2);
+
+        Fill(cache, "miner1");
+        Fill(cache, "miner2");
+
+        // touch miner1 so miner2 becomes the eviction candidate
+        Assert.True(cache.TryGet(PoolId, "miner1", SampleRange.Day, out _, out _));
+
+        Fill(cache, "miner3");
+
+        Assert.Equal(2, cache.Count);
+        Assert.True(cache.TryGet(PoolId, "miner1", SampleRange.Day, out _, out _));
+        Assert.True(cache.TryGet(PoolId, "miner3", SampleRange.Day, out _, out _));
+        Assert.False(cache.TryGet(PoolId, "miner2", SampleRange.Day, out _, out _));
+    }
+
+    [Fact]
+    public void Unknown_Miner_Is_Cached_As_Empty()
+    {
+        var (cache, _, _) = Create();
+
+        Assert.False(cache.TryGet(PoolId, "nobody", SampleRange.Day, out _, out var ticket));
+        cache.Set(ticket, null);
+
+        Assert.True(cache.TryGet(PoolId, "nobody", SampleRange.Day, out var entry, out _));
+        Assert.Null(entry.Json);
+    }
+}
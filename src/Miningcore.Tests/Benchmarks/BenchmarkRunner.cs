@@ -1,7 +1,11 @@
 using System;
+using BenchmarkDotNet.Columns;
 using BenchmarkDotNet.Configs;
 using BenchmarkDotNet.Loggers;
 using BenchmarkDotNet.Running;
+using Miningcore.Tests.Benchmarks.Bitcoin;
+using Miningcore.Tests.Benchmarks.Crypto;
+using Miningcore.Tests.Benchmarks.Persistence;
 using Miningcore.Tests.Benchmarks.Stratum;
 using Xunit;
 using Xunit.Abstractions;
@@ -24,9 +28,32 @@ public class Benchmarks
 
         var config = ManualConfig.Create(DefaultConfig.Instance)
             .AddLogger(logger)
+            .AddColumn(StatisticColumn.OperationsPerSecond)
             .WithOptions(ConfigOptions.DisableOptimizationsValidator);
 
         BenchmarkRunner.Run<StratumConnectionBenchmarks>(config);
+        BenchmarkRunner.Run<ShareBookkeepingBenchmarks>(config);
+        BenchmarkRunner.Run<PipelinedSubmitBenchmarks>(config);
+        BenchmarkRunner.Run<JobBroadcastBenchmarks>(config);
+        BenchmarkRunner.Run<JobLookupBenchmarks>(config);
+        BenchmarkRunner.Run<ConnectionTimerBenchmarks>(config);
+        BenchmarkRunner.Run<ScryptBenchmarks>(config);
+        BenchmarkRunner.Run<NeoScryptBenchmarks>(config);
+        BenchmarkRunner.Run<PwxformBenchmarks>(config);
+        BenchmarkRunner.Run<Sha512256DBenchmarks>(config);
+        BenchmarkRunner.Run<HashBatchDispatcherBenchmarks>(config);
+        BenchmarkRunner.Run<CuckooCycleBenchmarks>(config);
+        BenchmarkRunner.Run<EquihashBenchmarks>(config);
+        BenchmarkRunner.Run<BitcoinShareBenchmarks>(config);
+
+        if(VerthashBenchmarks.IsConfigured)
+            BenchmarkRunner.Run<VerthashBenchmarks>(config);
+
+        if(PagingBenchmarks.IsConfigured)
+            BenchmarkRunner.Run<PagingBenchmarks>(config);
+
+        if(ShareIngestBenchmarks.IsConfigured)
+            BenchmarkRunner.Run<ShareIngestBenchmarks>(config);
 
         // write benchmark summary
         output.WriteLine(logger.GetLog());
@@ -0,0 +1,135 @@
+using System;
+using System.Linq;
+using Autofac;
+using BenchmarkDotNet.Attributes;
+using Microsoft.IO;
+using Miningcore.Blockchain.Bitcoin;
+using Miningcore.Blockchain.Bitcoin.DaemonResponses;
+using Miningcore.Configuration;
+using Miningcore.Crypto;
+using Miningcore.Crypto.Hashing.Algorithms;
+using Miningcore.Extensions;
+using Miningcore.Stratum;
+using Miningcore.Tests.Util;
+using NBitcoin;
+using NLog;
+using BlockTemplate = Miningcore.Blockchain.Bitcoin.DaemonResponses.BlockTemplate;
+
+namespace Miningcore.Tests.Benchmarks.Bitcoin;
+
+public enum ShareHashPath
+{
+    Generic,
+    Midstate,
+}
+
+/// <summary>
+/// Bitcoin share validation throughput under an ASIC-like submission pattern: every
+/// extraNonce2 is used for many nonces, spread over a few rolled versions. Each iteration
+/// runs against a fresh job, so the cache starts cold like it does after a new block.
+/// Op/s is shares per second.
+/// </summary>
+[MemoryDiagnoser]
+[InvocationCount(1)]
+public class BitcoinShareBenchmarks
+{
+    private const int Workers = 16;
+    private const int ExtraNonce2PerWorker = 4;
+    private const int VersionsPerExtraNonce2 = 4;
+    private const int NoncesPerVersion = 16;
+    private const int ShareCount = Workers * ExtraNonce2PerWorker * VersionsPerExtraNonce2 * NoncesPerVersion;
+    private const uint CurTime = 1700000000;
+
+    /// <summary>
+    /// Sha256D under a different type, which keeps the job on the generic hashing path
+    /// </summary>
+    private class GenericSha256D : IHashAlgorithm
+    {
+        private readonly Sha256D hasher = new();
+
+        public void Digest(ReadOnlySpan<byte> data, Span<byte> result, params object[] extra)
+        {
+            hasher.Digest(data, result, extra);
+        }
+    }
+
+    private record Submission(StratumConnection Worker, string ExtraNonce2, string NTime, string Nonce, string VersionBits);
+
+    private BitcoinTemplate coin;
+    private BlockTemplate blockTemplate;
+    private MockMasterClock clock;
+    private IDestination poolAddressDestination;
+    private Submission[] submissions;
+    private BitcoinJob job;
+
+    [Params(ShareHashPath.Generic, ShareHashPath.Midstate)]
+    public ShareHashPath HashPath { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        ModuleInitializer.Initialize();
+
+        var rmsm = ModuleInitializer.Container.Resolve<RecyclableMemoryStreamManager>();
+        var rnd = new Random(42);
+
+        coin = (BitcoinTemplate) ModuleInitializer.CoinTemplates["bitcoin"];
+        clock = new MockMasterClock { CurrentTime = DateTimeOffset.FromUnixTimeSeconds(CurTime).UtcDateTime };
+        poolAddressDestination = BitcoinUtils.AddressToDestination("1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa", Network.Main);
+
+        // a full block worth of transactions gives a merkle branch of realistic depth
+        blockTemplate = new BlockTemplate
+        {
+            Version = 0x20000000,
+            PreviousBlockhash = "00000000000000000002a7c4c1e48d76c5a37902165a270156b7a8d72728a054",
+            CoinbaseValue = 625000000,
+            Target = "0000000000000000000538bf0000000000000000000000000000000000000000",
+            CurTime = CurTime,
+            Bits = "17053894",
+            Height = 800000,
+            Transactions = Enumerable.Range(0, 3000).Select(_ =>
+            {
+                var hash = new byte[32];
+                rnd.NextBytes(hash);
+
+                return new BitcoinBlockTransaction { TxId = hash.ToHexString(), Data = string.Empty };
+            }).ToArray(),
+        };
+
+        var versions = new[] { "00000000", "00002000", "0000e000", "1fffe000" };
+
+        submissions = Enumerable.Range(0, Workers).SelectMany(w =>
+        {
+            var connection = new StratumConnection(new NullLogger(LogManager.LogFactory), rmsm, clock, w.ToString(), false);
+
+            connection.SetContext(new BitcoinWorkerContext
+            {
+                ExtraNonce1 = (0x10000000 + w).ToString("x8"),
+                Difficulty = 1e-12,
+                VersionRollingMask = 0x1fffe000,
+            });
+
+            return Enumerable.Range(0, ExtraNonce2PerWorker).SelectMany(e =>
+                Enumerable.Range(0, NoncesPerVersion * VersionsPerExtraNonce2).Select(n =>
+                    new Submission(connection, e.ToString("x8"), (CurTime + (uint) n / 32).ToString("x8"),
+                        ((uint) n * 0x9e3779b9u).ToString("x8"), versions[n % VersionsPerExtraNonce2])));
+        }).ToArray();
+    }
+
+    [IterationSetup]
+    public void CreateJob()
+    {
+        job = new BitcoinJob();
+
+        job.Init(blockTemplate, "1", new PoolConfig { Template = coin }, null, new ClusterConfig(), clock,
+            poolAddressDestination, Network.Main, false, coin.ShareMultiplier, coin.CoinbaseHasherValue,
+            HashPath == ShareHashPath.Midstate ? coin.HeaderHasherValue : new GenericSha256D(), coin.BlockHasherValue);
+    }
+
+    [Benchmark(OperationsPerInvoke = ShareCount)]
+    public void ProcessShares()
+    {
+        foreach(var s in submissions)
+            job.ProcessShare(s.Worker, s.ExtraNonce2, s.NTime, s.Nonce, s.VersionBits);
+    }
+}
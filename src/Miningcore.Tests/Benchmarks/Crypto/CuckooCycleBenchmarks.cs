@@ -0,0 +1,62 @@
+using System;
+using System.Linq;
+using BenchmarkDotNet.Attributes;
+using Miningcore.Extensions;
+using Miningcore.Native;
+using Miningcore.Tests.Crypto;
+
+namespace Miningcore.Tests.Benchmarks.Crypto;
+
+/// <summary>
+/// Cuckoo-cycle verification throughput of the vector kernels against the scalar path. Each invocation
+/// verifies <see cref="BatchSize"/> solutions, so Op/s is verifies per second.
+/// </summary>
+[MemoryDiagnoser]
+public class CuckooCycleBenchmarks
+{
+    private const int BatchSize = 64;
+
+    private byte[] header;
+    private int proofSize;
+    private byte[] headers;
+    private uint[] solutions;
+    private readonly CuckooVerifyResult[] results = new CuckooVerifyResult[BatchSize];
+
+    [Params(CuckooVariant.Cortex, CuckooVariant.C29s, CuckooVariant.C29v)]
+    public CuckooVariant Variant { get; set; }
+
+    [Params(CuckooKernel.Scalar, CuckooKernel.Avx2, CuckooKernel.Avx512)]
+    public CuckooKernel Kernel { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        // xor-balanced known answers hash every edge and walk the cycle check before failing
+        var kat = CuckooCycleTests.KnownAnswers.First(x => (CuckooVariant) x[0] == Variant);
+        var solution = (uint[]) kat[2];
+
+        header = ((string) kat[1]).HexToByteArray();
+        proofSize = solution.Length;
+        headers = new byte[BatchSize * header.Length];
+        solutions = new uint[BatchSize * proofSize];
+
+        for(var i = 0; i < BatchSize; i++)
+        {
+            header.CopyTo(headers, i * header.Length);
+            solution.CopyTo(solutions, i * proofSize);
+        }
+    }
+
+    [Benchmark(Baseline = true, OperationsPerInvoke = BatchSize)]
+    public void Single()
+    {
+        for(var i = 0; i < BatchSize; i++)
+            results[i] = CuckooCycle.Verify(Variant, header, solutions.AsSpan(i * proofSize, proofSize), Kernel);
+    }
+
+    [Benchmark(OperationsPerInvoke = BatchSize)]
+    public void Batch()
+    {
+        CuckooCycle.VerifyBatch(Variant, headers, header.Length, solutions, results, BatchSize, Kernel);
+    }
+}
@@ -0,0 +1,92 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Threading;
+using System.Threading.Tasks;
+using BenchmarkDotNet.Attributes;
+using Miningcore.Crypto;
+using Miningcore.Crypto.Hashing.Algorithms;
+
+namespace Miningcore.Tests.Benchmarks.Crypto;
+
+/// <summary>
+/// Scrypt(1024, 1, 1) share validation with and without the batch dispatcher at increasing arrival rates.
+/// Shares arrive on a fixed schedule and are validated on the thread pool, as stratum requests would be.
+/// Each invocation validates <see cref="BatchSize"/> shares, so Op/s is validated shares per second.
+/// Median and 99th percentile latency, measured from scheduled arrival, are printed at the end of each run.
+/// </summary>
+public class HashBatchDispatcherBenchmarks
+{
+    private const int BatchSize = 2048;
+    private const int HeaderSize = 80;
+    private static readonly TimeSpan window = TimeSpan.FromMilliseconds(1);
+
+    private readonly Scrypt scrypt = new(1024, 1);
+    private readonly byte[] inputs = new byte[BatchSize * HeaderSize];
+    private readonly byte[] hashes = new byte[BatchSize * 32];
+    private readonly double[] latencies = new double[BatchSize];
+    private readonly List<double> allLatencies = new();
+    private BatchingHashAlgorithm batcher;
+
+    [Params(1000, 10000, 50000)]
+    public int ArrivalRate { get; set; }
+
+    [Params(false, true)]
+    public bool Batching { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        new Random(42).NextBytes(inputs);
+
+        if(Batching)
+            batcher = new BatchingHashAlgorithm(scrypt, new HashBatchDispatcher(scrypt, window));
+    }
+
+    [GlobalCleanup]
+    public void Cleanup()
+    {
+        allLatencies.Sort();
+
+        if(allLatencies.Count > 0)
+        {
+            Console.WriteLine($"// {(Batching ? "batched" : "single")} @ {ArrivalRate}/s: " +
+                $"p50 {allLatencies[allLatencies.Count / 2]:0} us, p99 {allLatencies[allLatencies.Count * 99 / 100]:0} us");
+        }
+    }
+
+    [Benchmark(OperationsPerInvoke = BatchSize)]
+    public async Task Validate()
+    {
+        var interval = Stopwatch.Frequency / (double) ArrivalRate;
+        var start = Stopwatch.GetTimestamp();
+        var tasks = new Task[BatchSize];
+
+        for(var i = 0; i < BatchSize; i++)
+        {
+            var due = start + (long) (i * interval);
+
+            while(Stopwatch.GetTimestamp() < due)
+                Thread.SpinWait(10);
+
+            var index = i;
+
+            tasks[i] = Task.Run(async () =>
+            {
+                var input = inputs.AsMemory(index * HeaderSize, HeaderSize);
+                var hash = hashes.AsMemory(index * 32, 32);
+
+                if(batcher != null)
+                    await batcher.DigestAsync(input, hash);
+                else
+                    scrypt.Digest(input.Span, hash.Span);
+
+                latencies[index] = (Stopwatch.GetTimestamp() - due) * 1e6 / Stopwatch.Frequency;
+            });
+        }
+
+        await Task.WhenAll(tasks);
+
+        allLatencies.AddRange(latencies);
+    }
+}
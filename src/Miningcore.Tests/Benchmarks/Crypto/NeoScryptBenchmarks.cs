@@ -0,0 +1,34 @@
+using System;
+using BenchmarkDotNet.Attributes;
+using Miningcore.Crypto.Hashing.Algorithms;
+
+namespace Miningcore.Tests.Benchmarks.Crypto;
+
+/// <summary>
+/// NeoScrypt throughput per kernel. Each invocation hashes <see cref="BatchSize"/>
+/// headers, so Op/s is hashes per second.
+/// </summary>
+[MemoryDiagnoser]
+public class NeoScryptBenchmarks
+{
+    private const int BatchSize = 32;
+
+    private readonly NeoScrypt hasher = new(0);
+    private readonly byte[] inputs = new byte[BatchSize * 80];
+    private readonly byte[] hashes = new byte[BatchSize * 32];
+
+    [Params(NeoScryptKernel.Scalar, NeoScryptKernel.Sse2, NeoScryptKernel.Avx2)]
+    public NeoScryptKernel Kernel { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        new Random(42).NextBytes(inputs);
+    }
+
+    [Benchmark(OperationsPerInvoke = BatchSize)]
+    public void Batch()
+    {
+        hasher.DigestBatch(inputs, 80, hashes, BatchSize, Kernel);
+    }
+}
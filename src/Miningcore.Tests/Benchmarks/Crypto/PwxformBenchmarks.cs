@@ -0,0 +1,57 @@
+using System;
+using BenchmarkDotNet.Attributes;
+using Miningcore.Crypto;
+using Miningcore.Crypto.Hashing.Algorithms;
+
+namespace Miningcore.Tests.Benchmarks.Crypto;
+
+public enum PwxformVariant
+{
+    Yespower,
+    YespowerR16,
+    YespowerTIDE,
+    YescryptR8,
+    YescryptR16,
+    YescryptR32,
+}
+
+/// <summary>
+/// Yespower and yescrypt throughput per variant and kernel. Op/s is hashes per second.
+/// </summary>
+[MemoryDiagnoser]
+public class PwxformBenchmarks
+{
+    private readonly byte[] input = new byte[80];
+    private readonly byte[] hash = new byte[32];
+    private IHashAlgorithm hasher;
+
+    [Params(PwxformVariant.Yespower, PwxformVariant.YespowerR16, PwxformVariant.YespowerTIDE,
+        PwxformVariant.YescryptR8, PwxformVariant.YescryptR16, PwxformVariant.YescryptR32)]
+    public PwxformVariant Variant { get; set; }
+
+    [Params(PwxformKernel.Scalar, PwxformKernel.Sse2, PwxformKernel.Avx, PwxformKernel.Xop)]
+    public PwxformKernel Kernel { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        new Random(42).NextBytes(input);
+
+        hasher = Variant switch
+        {
+            PwxformVariant.Yespower => new Yespower(),
+            PwxformVariant.YespowerR16 => new YespowerR16(),
+            PwxformVariant.YespowerTIDE => new YespowerTIDE(),
+            PwxformVariant.YescryptR8 => new YescryptR8(),
+            PwxformVariant.YescryptR16 => new YescryptR16(),
+            PwxformVariant.YescryptR32 => new YescryptR32(),
+            _ => throw new ArgumentOutOfRangeException()
+        };
+    }
+
+    [Benchmark]
+    public void Digest()
+    {
+        Pwxform.Digest(hasher, input, hash, Kernel);
+    }
+}
@@ -0,0 +1,55 @@
+using System;
+using BenchmarkDotNet.Attributes;
+using Miningcore.Crypto.Hashing.Algorithms;
+
+namespace Miningcore.Tests.Benchmarks.Crypto;
+
+/// <summary>
+/// Scrypt(1024, 1, 1) throughput per kernel lane width. Each invocation hashes
+/// <see cref="BatchSize"/> headers, so Op/s is hashes per second.
+/// </summary>
+[MemoryDiagnoser]
+public class ScryptBenchmarks
+{
+    private const int BatchSize = 64;
+    private const int HeaderSize = 80;
+
+    private readonly Scrypt hasher = new(1024, 1);
+    private readonly byte[] inputs = new byte[BatchSize * HeaderSize];
+    private readonly byte[] hashes = new byte[BatchSize * 32];
+    private readonly uint[] midstate = new uint[Scrypt.MidstateSize];
+
+    [Params(1, 4, 8, 16)]
+    public int Lanes { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        new Random(42).NextBytes(inputs);
+
+        // all headers share the first 64 bytes, as they would within a job
+        for(var i = 1; i < BatchSize; i++)
+            Array.Copy(inputs, 0, inputs, i * HeaderSize, 64);
+
+        Scrypt.ComputeMidstate(inputs, midstate);
+    }
+
+    [Benchmark(Baseline = true, OperationsPerInvoke = BatchSize)]
+    public void Single()
+    {
+        for(var i = 0; i < BatchSize; i++)
+            hasher.Digest(inputs.AsSpan(i * HeaderSize, HeaderSize), hashes.AsSpan(i * 32, 32));
+    }
+
+    [Benchmark(OperationsPerInvoke = BatchSize)]
+    public void Batch()
+    {
+        hasher.DigestBatch(inputs, HeaderSize, hashes, BatchSize, ReadOnlySpan<uint>.Empty, Lanes);
+    }
+
+    [Benchmark(OperationsPerInvoke = BatchSize)]
+    public void Batch_Midstate()
+    {
+        hasher.DigestBatch(inputs, HeaderSize, hashes, BatchSize, midstate, Lanes);
+    }
+}
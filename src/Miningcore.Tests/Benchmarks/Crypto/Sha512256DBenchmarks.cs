@@ -0,0 +1,42 @@
+using System;
+using BenchmarkDotNet.Attributes;
+using Miningcore.Crypto.Hashing.Algorithms;
+
+namespace Miningcore.Tests.Benchmarks.Crypto;
+
+/// <summary>
+/// SHA-512/256d throughput of the multi-buffer kernels against the scalar path. Each invocation
+/// hashes <see cref="BatchSize"/> headers, so Op/s is hashes per second.
+/// </summary>
+[MemoryDiagnoser]
+public class Sha512256DBenchmarks
+{
+    private const int BatchSize = 64;
+    private const int HeaderSize = 80;
+
+    private readonly Sha512256D hasher = new();
+    private readonly byte[] inputs = new byte[BatchSize * HeaderSize];
+    private readonly byte[] hashes = new byte[BatchSize * 32];
+
+    [Params(Sha512256DKernel.Scalar, Sha512256DKernel.Avx2, Sha512256DKernel.Avx512)]
+    public Sha512256DKernel Kernel { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        new Random(42).NextBytes(inputs);
+    }
+
+    [Benchmark(Baseline = true, OperationsPerInvoke = BatchSize)]
+    public void Single()
+    {
+        for(var i = 0; i < BatchSize; i++)
+            hasher.Digest(inputs.AsSpan(i * HeaderSize, HeaderSize), hashes.AsSpan(i * 32, 32));
+    }
+
+    [Benchmark(OperationsPerInvoke = BatchSize)]
+    public void Batch()
+    {
+        hasher.DigestBatch(inputs, HeaderSize, hashes, BatchSize, Kernel);
+    }
+}
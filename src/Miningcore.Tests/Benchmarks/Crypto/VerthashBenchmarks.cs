@@ -0,0 +1,52 @@
+using System;
+using System.Collections.Generic;
+using BenchmarkDotNet.Attributes;
+using Miningcore.Configuration;
+using Miningcore.Crypto.Hashing.Algorithms;
+
+namespace Miningcore.Tests.Benchmarks.Crypto;
+
+/// <summary>
+/// Verthash throughput at different lane counts. Each invocation hashes <see cref="BatchSize"/>
+/// headers in batches of <see cref="Lanes"/>, so Op/s is hashes per second.
+/// Requires a verthash data file, its path supplied through the MININGCORE_BENCHMARK_VERTHASH
+/// environment variable.
+/// </summary>
+public class VerthashBenchmarks
+{
+    private const string DataFileVariable = "MININGCORE_BENCHMARK_VERTHASH";
+    private const int BatchSize = 16;
+
+    private readonly Verthash hasher = new();
+    private readonly byte[] inputs = new byte[BatchSize * 80];
+    private readonly byte[] hashes = new byte[BatchSize * 32];
+
+    public static bool IsConfigured => !string.IsNullOrEmpty(Environment.GetEnvironmentVariable(DataFileVariable));
+
+    [Params(1, 4, 8, 16)]
+    public int Lanes { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        var poolConfig = new PoolConfig
+        {
+            Extra = new Dictionary<string, object>
+            {
+                { "vertHashDataFile", Environment.GetEnvironmentVariable(DataFileVariable) }
+            }
+        };
+
+        if(!hasher.DigestInit(poolConfig))
+            throw new InvalidOperationException("Unable to load verthash data file");
+
+        new Random(42).NextBytes(inputs);
+    }
+
+    [Benchmark(OperationsPerInvoke = BatchSize)]
+    public void Batch()
+    {
+        for(var i = 0; i < BatchSize; i += Lanes)
+            hasher.DigestBatch(inputs.AsSpan(i * 80), 80, hashes.AsSpan(i * 32), Lanes);
+    }
+}
@@ -0,0 +1,86 @@
+using System;
+using System.Threading;
+using System.Threading.Tasks;
+using Autofac;
+using AutoMapper;
+using BenchmarkDotNet.Attributes;
+using Dapper;
+using Miningcore.Persistence.Model;
+using Miningcore.Persistence.Postgres.Repositories;
+using Npgsql;
+
+namespace Miningcore.Tests.Benchmarks.Persistence;
+
+/// <summary>
+/// OFFSET vs keyset pagination of the blocks table at shallow and deep pages.
+/// Requires a database created with createdb.sql, its connection string supplied
+/// through the MININGCORE_BENCHMARK_PG environment variable.
+/// </summary>
+public class PagingBenchmarks
+{
+    private const string ConnectionStringVariable = "MININGCORE_BENCHMARK_PG";
+    private const string PoolId = "benchmark-paging";
+    private const int PageSize = 15;
+    private const int MaxDepth = 10_000;
+
+    private static readonly BlockStatus[] states = { BlockStatus.Confirmed, BlockStatus.Pending, BlockStatus.Orphaned };
+
+    private NpgsqlConnection con;
+    private BlockRepository repo;
+    private PageCursor cursor;
+
+    public static bool IsConfigured => !string.IsNullOrEmpty(Environment.GetEnvironmentVariable(ConnectionStringVariable));
+
+    [Params(1, MaxDepth)]
+    public int Depth { get; set; }
+
+    [GlobalSetup]
+    public async Task Setup()
+    {
+        ModuleInitializer.Initialize();
+
+        repo = new BlockRepository(ModuleInitializer.Container.Resolve<IMapper>());
+        con = new NpgsqlConnection(Environment.GetEnvironmentVariable(ConnectionStringVariable));
+        await con.OpenAsync();
+
+        const int rows = (MaxDepth + 1) * PageSize;
+
+        var existing = await con.ExecuteScalarAsync<int>("SELECT COUNT(*) FROM blocks WHERE poolid = @poolId", new { poolId = PoolId });
+
+        if(existing < rows)
+        {
+            await con.ExecuteAsync("DELETE FROM blocks WHERE poolid = @poolId", new { poolId = PoolId });
+
+            await con.ExecuteAsync(@"INSERT INTO blocks(poolid, blockheight, networkdifficulty, status, transactionconfirmationdata, miner, reward, created)
+                SELECT @poolId, g, 1, 'confirmed', '', 'miner', 1, now() - g * interval '1 minute' FROM generate_series(1, @rows) g",
+                new { poolId = PoolId, rows });
+
+            await con.ExecuteAsync("ANALYZE blocks");
+        }
+
+        // position the cursor at the end of the page preceding the requested one
+        if(Depth > 1)
+        {
+            var last = await repo.PageBlocksAsync(con, PoolId, states, Depth - 2, PageSize, CancellationToken.None);
+            cursor = new PageCursor(last[^1].Created, last[^1].Id);
+        }
+    }
+
+    [GlobalCleanup]
+    public void Cleanup()
+    {
+        con?.Dispose();
+    }
+
+    [Benchmark(Baseline = true)]
+    public Task<Block[]> Offset()
+    {
+        return repo.PageBlocksAsync(con, PoolId, states, Depth - 1, PageSize, CancellationToken.None);
+    }
+
+    [Benchmark]
+    public Task<Block[]> Keyset()
+    {
+        return repo.PageBlocksAsync(con, PoolId, states, cursor, PageSize, CancellationToken.None);
+    }
+}
@@ -0,0 +1,117 @@
+using System;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using Autofac;
+using AutoMapper;
+using BenchmarkDotNet.Attributes;
+using Dapper;
+using Miningcore.Persistence.Model;
+using Miningcore.Persistence.Postgres.Repositories;
+using Npgsql;
+
+namespace Miningcore.Tests.Benchmarks.Persistence;
+
+/// <summary>
+/// Share ingestion straight into the indexed shares table vs. the staging table with periodic merges.
+/// Each invocation records a batch of <see cref="BatchSize"/> shares, so Op/s is rows per second.
+/// The staged case includes the cost of merging. WAL bytes per share are printed at the end of each run.
+/// Requires a database created with createdb.sql (or add_share_staging.sql applied), its connection string
+/// supplied through the MININGCORE_BENCHMARK_PG environment variable.
+/// </summary>
+public class ShareIngestBenchmarks
+{
+    private const string ConnectionStringVariable = "MININGCORE_BENCHMARK_PG";
+    private const string PoolId = "benchmark-ingest";
+    private const int BatchSize = 250;
+    private const int MinerCount = 5000;
+
+    // merge every 10k staged shares, about 5 seconds worth at 2k shares per second
+    private const int MergeEvery = 40;
+
+    private NpgsqlConnection con;
+    private ShareRepository repo;
+    private Share[][] batches;
+    private int invocations;
+    private string startLsn;
+
+    public static bool IsConfigured => !string.IsNullOrEmpty(Environment.GetEnvironmentVariable(ConnectionStringVariable));
+
+    [Params(false, true)]
+    public bool Staged { get; set; }
+
+    [GlobalSetup]
+    public async Task Setup()
+    {
+        ModuleInitializer.Initialize();
+
+        repo = new ShareRepository(ModuleInitializer.Container.Resolve<IMapper>(), Staged);
+        con = new NpgsqlConnection(Environment.GetEnvironmentVariable(ConnectionStringVariable));
+        await con.OpenAsync();
+
+        await DeleteSharesAsync();
+
+        // shares arrive interleaved across miners, like they do on a busy pool
+        var random = new Random(42);
+        var now = DateTime.UtcNow;
+
+        batches = Enumerable.Range(0, 64).Select(b => Enumerable.Range(0, BatchSize).Select(i => new Share
+        {
+            PoolId = PoolId,
+            BlockHeight = 800000,
+            Miner = $"miner{random.Next(MinerCount)}",
+            Worker = "rig",
+            UserAgent = "cgminer/4.11.1",
+            Difficulty = random.Next(1, 1 << 20),
+            NetworkDifficulty = 1e12,
+            IpAddress = "127.0.0.1",
+            Source = "benchmark",
+            Created = now.AddMilliseconds(b * BatchSize + i)
+        }).ToArray()).ToArray();
+
+        startLsn = await con.ExecuteScalarAsync<string>("SELECT pg_current_wal_lsn()::text");
+    }
+
+    [GlobalCleanup]
+    public async Task Cleanup()
+    {
+        if(Staged)
+            await MergeAsync();
+
+        var walBytes = await con.ExecuteScalarAsync<double>("SELECT pg_wal_lsn_diff(pg_current_wal_lsn(), @startLsn::pg_lsn)", new { startLsn });
+        var shares = (double) invocations * BatchSize;
+
+        Console.WriteLine($"// {(Staged ? "staged" : "direct")}: {shares} shares, {walBytes / shares:0.0} WAL bytes per share");
+
+        await DeleteSharesAsync();
+        await con.DisposeAsync();
+    }
+
+    [Benchmark(OperationsPerInvoke = BatchSize)]
+    public async Task Ingest()
+    {
+        var batch = batches[invocations++ % batches.Length];
+
+        await using(var tx = await con.BeginTransactionAsync())
+        {
+            await repo.BatchInsertAsync(con, tx, batch, CancellationToken.None);
+            await tx.CommitAsync();
+        }
+
+        if(Staged && invocations % MergeEvery == 0)
+            await MergeAsync();
+    }
+
+    private async Task MergeAsync()
+    {
+        while(await repo.MergeStagedSharesAsync(con, 100000, CancellationToken.None) > 0)
+        {
+        }
+    }
+
+    private async Task DeleteSharesAsync()
+    {
+        await con.ExecuteAsync("DELETE FROM shares_staging WHERE poolid = @poolId", new { poolId = PoolId });
+        await con.ExecuteAsync("DELETE FROM shares WHERE poolid = @poolId", new { poolId = PoolId });
+    }
+}
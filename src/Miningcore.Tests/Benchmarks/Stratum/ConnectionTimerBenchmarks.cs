@@ -0,0 +1,118 @@
+using System;
+using System.Threading;
+using BenchmarkDotNet.Attributes;
+using Miningcore.Time;
+
+namespace Miningcore.Tests.Benchmarks.Stratum;
+
+/// <summary>
+/// Per-connection deadlines at scale. Send deadline cost per message on the timer wheel versus a linked
+/// CancellationTokenSource with CancelAfter, and the cost of running idle checks over one 30 second interval
+/// on the wheel versus sweeping all connections at once.
+/// </summary>
+[MemoryDiagnoser]
+public class ConnectionTimerBenchmarks
+{
+    private const int OpsPerInvoke = 1000;
+    private static readonly TimeSpan tick = TimeSpan.FromMilliseconds(100);
+    private static readonly TimeSpan sendTimeout = TimeSpan.FromSeconds(5);
+    private static readonly TimeSpan idleInterval = TimeSpan.FromSeconds(30);
+
+    private class Connection
+    {
+        public long LastActivity;
+        public TimerWheel.Timer IdleTimer;
+    }
+
+    private TimerWheel wheel;
+    private Connection[] connections;
+    private TimerWheel.Timer sendTimer;
+    private CancellationTokenSource connectionCts;
+    private long now;
+    private long idle;
+
+    [Params(10000, 100000)]
+    public int Connections { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        wheel = new TimerWheel(tick);
+        connections = new Connection[Connections];
+        connectionCts = new CancellationTokenSource();
+
+        var random = new Random(42);
+        var intervalTicks = (int) (idleInterval / tick);
+
+        // connections came in at random times, their idle timers are spread over the interval
+        for(var i = 0; i < connections.Length; i++)
+        {
+            var connection = connections[i] = new Connection();
+
+            connection.IdleTimer = wheel.CreateTimer(OnIdle, connection);
+            connection.IdleTimer.Arm(tick * random.Next(1, intervalTicks + 1));
+        }
+
+        sendTimer = wheel.CreateTimer(_ => { });
+    }
+
+    [GlobalCleanup]
+    public void Cleanup()
+    {
+        connectionCts.Dispose();
+    }
+
+    private void OnIdle(object state)
+    {
+        var connection = (Connection) state;
+
+        if(now - connection.LastActivity > 300)
+            idle++;
+
+        connection.IdleTimer.Arm(idleInterval);
+    }
+
+    [Benchmark(OperationsPerInvoke = OpsPerInvoke)]
+    public void Send_Deadline_CancelAfter()
+    {
+        for(var i = 0; i < OpsPerInvoke; i++)
+        {
+            using var cts = CancellationTokenSource.CreateLinkedTokenSource(connectionCts.Token);
+            cts.CancelAfter(sendTimeout);
+        }
+    }
+
+    [Benchmark(OperationsPerInvoke = OpsPerInvoke)]
+    public void Send_Deadline_Wheel()
+    {
+        for(var i = 0; i < OpsPerInvoke; i++)
+        {
+            sendTimer.Arm(sendTimeout);
+            sendTimer.Cancel();
+        }
+    }
+
+    [Benchmark]
+    public void Idle_Interval_Sweep()
+    {
+        now += (long) (idleInterval / tick);
+
+        foreach(var connection in connections)
+        {
+            if(now - connection.LastActivity > 300)
+                idle++;
+        }
+    }
+
+    /// <summary>
+    /// Every idle timer fires and re-arms once, spread over 300 ticks
+    /// </summary>
+    [Benchmark]
+    public void Idle_Interval_Wheel()
+    {
+        var end = now + (long) (idleInterval / tick);
+
+        while(now < end)
+            wheel.AdvanceTo(++now);
+    }
+}
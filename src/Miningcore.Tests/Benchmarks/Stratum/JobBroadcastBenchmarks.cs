@@ -0,0 +1,180 @@
+using System;
+using System.Data;
+using System.Net;
+using System.Net.Http;
+using System.Threading;
+using System.Threading.Tasks;
+using Autofac;
+using AutoMapper;
+using BenchmarkDotNet.Attributes;
+using Microsoft.Extensions.Caching.Memory;
+using Microsoft.IO;
+using Miningcore.Blockchain;
+using Miningcore.Configuration;
+using Miningcore.JsonRpc;
+using Miningcore.Messaging;
+using Miningcore.Mining;
+using Miningcore.Nicehash;
+using Miningcore.Persistence;
+using Miningcore.Persistence.Postgres.Repositories;
+using Miningcore.Persistence.Repositories;
+using Miningcore.Stratum;
+using Miningcore.Time;
+using Newtonsoft.Json;
+using NLog;
+
+namespace Miningcore.Tests.Benchmarks.Stratum;
+
+/// <summary>
+/// New job broadcast to <see cref="ConnectionCount"/> authorized connections with miner effort banning on and off,
+/// while accepted shares keep arriving on another thread. Broadcasting must not touch the database, any attempt throws.
+/// Each invocation is one broadcast, so Mean is broadcast latency.
+/// </summary>
+public class JobBroadcastBenchmarks
+{
+    private const int ConnectionCount = 10000;
+    private const string PoolId = "benchmark";
+
+    private class NoDatabaseConnectionFactory : IConnectionFactory
+    {
+        public Task<IDbConnection> OpenConnectionAsync(ConnectionIntent intent = ConnectionIntent.Write)
+        {
+            throw new InvalidOperationException("Job broadcast must not query the database");
+        }
+    }
+
+    private class HttpClientFactory : IHttpClientFactory
+    {
+        public HttpClient CreateClient(string name) => new();
+    }
+
+    private class BenchmarkPool : PoolBase
+    {
+        public BenchmarkPool(IComponentContext ctx, IMapper mapper, PoolConfig pc, ClusterConfig cc) :
+            base(ctx, new JsonSerializerSettings(), new NoDatabaseConnectionFactory(),
+                new StatsRepository(mapper, ctx.Resolve<IMasterClock>(), cc), mapper,
+                ctx.Resolve<IMasterClock>(), ctx.Resolve<IMessageBus>(), ctx.Resolve<RecyclableMemoryStreamManager>(),
+                new NicehashService(new HttpClientFactory(), new MemoryCache(new MemoryCacheOptions())))
+        {
+            logger = new NullLogger(LogManager.LogFactory);
+            poolConfig = pc;
+            clusterConfig = cc;
+
+            if(pc.Banning?.Enabled == true)
+            {
+                minerEffortTracker = new MinerEffortTracker();
+                disposables.Add(messageBus.Listen<Share>().Subscribe(minerEffortTracker.Record));
+            }
+        }
+
+        public void AddMiner(int i)
+        {
+            var connection = new StratumConnection(logger, ctx.Resolve<RecyclableMemoryStreamManager>(), clock, i.ToString(), false);
+            var context = CreateWorkerContext();
+
+            context.Init(1000, null, clock);
+            context.Miner = $"miner{i}";
+            context.IsAuthorized = true;
+            connection.SetContext(context);
+
+            connections[connection.ConnectionId] = connection;
+        }
+
+        public Task BroadcastAsync()
+        {
+            // stand-in for serializing the notify, which is the same with or without effort banning
+            return ForEachMinerAsync((connection, _) =>
+            {
+                connection.Context.LastActivity = clock.Now;
+                return Task.CompletedTask;
+            });
+        }
+
+        public void CheckEffort()
+        {
+            if(minerEffortTracker != null)
+                CheckMinerEffort();
+        }
+
+        protected override Task SetupJobManager(CancellationToken ct) => Task.CompletedTask;
+        protected override WorkerContextBase CreateWorkerContext() => new();
+        protected override void OnConnect(StratumConnection connection, IPEndPoint ipEndPoint) { }
+        protected override Task OnRequestAsync(StratumConnection connection, Timestamped<JsonRpcRequest> tsRequest, CancellationToken ct) => Task.CompletedTask;
+        public override double HashrateFromShares(double shares, double interval) => shares / interval;
+    }
+
+    private ILifetimeScope scope;
+    private BenchmarkPool pool;
+    private CancellationTokenSource cts;
+    private Task shareTask;
+
+    [Params(false, true)]
+    public bool EffortBanning { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        ModuleInitializer.Initialize();
+
+        var mapper = ModuleInitializer.Container.Resolve<IMapper>();
+
+        scope = ModuleInitializer.Container.BeginLifetimeScope(builder =>
+        {
+            builder.RegisterInstance<IBlockRepository>(new BlockRepository(mapper));
+            builder.RegisterInstance<IShareRepository>(new ShareRepository(mapper, false));
+        });
+
+        var poolConfig = new PoolConfig
+        {
+            Id = PoolId,
+            Banning = EffortBanning ? new PoolShareBasedBanningConfig
+            {
+                Enabled = true,
+                MinerEffortPercent = 1e9,
+                MinerEffortTime = 600
+            } : null
+        };
+
+        pool = new BenchmarkPool(scope, mapper, poolConfig, new ClusterConfig { Logging = new ClusterLoggingConfig() });
+
+        for(var i = 0; i < ConnectionCount; i++)
+            pool.AddMiner(i);
+
+        cts = new CancellationTokenSource();
+        var messageBus = scope.Resolve<IMessageBus>();
+
+        // accepted shares from all over the pool, plus a sweep of the effort check every now and then
+        shareTask = Task.Factory.StartNew(() =>
+        {
+            var random = new Random(42);
+
+            for(var n = 1; !cts.IsCancellationRequested; n++)
+            {
+                messageBus.SendMessage(new Share
+                {
+                    PoolId = PoolId,
+                    Miner = $"miner{random.Next(ConnectionCount)}",
+                    Difficulty = 1000,
+                    NetworkDifficulty = 1e12
+                });
+
+                if(n % 100000 == 0)
+                    pool.CheckEffort();
+            }
+        }, TaskCreationOptions.LongRunning);
+    }
+
+    [GlobalCleanup]
+    public void Cleanup()
+    {
+        cts.Cancel();
+        shareTask.Wait();
+        scope.Dispose();
+    }
+
+    [Benchmark]
+    public Task Broadcast()
+    {
+        return pool.BroadcastAsync();
+    }
+}
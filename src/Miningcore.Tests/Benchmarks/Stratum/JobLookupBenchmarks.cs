@@ -0,0 +1,137 @@
+using System.Collections.Generic;
+using System.Linq;
+using BenchmarkDotNet.Attributes;
+using Miningcore.Blockchain;
+
+namespace Miningcore.Tests.Benchmarks.Stratum;
+
+/// <summary>
+/// Share-time job lookup: the per-worker job queue searched with ToArray().FirstOrDefault against the pool-wide
+/// <see cref="JobRing{TJob}"/> plus the worker's <see cref="JobWindow"/>, by job id and by Ethereum-style header.
+/// Each invocation performs <see cref="LookupCount"/> lookups, so Op/s is lookups per second.
+/// </summary>
+[MemoryDiagnoser]
+public class JobLookupBenchmarks
+{
+    private const int LookupCount = 1024;
+
+    private class Job
+    {
+        public Job(long id)
+        {
+            JobId = id.ToString("x8");
+            Header = "0x" + id.ToString("x64");
+        }
+
+        public string JobId { get; }
+        public string Header { get; }
+    }
+
+    private readonly Queue<Job> queue = new();
+    private JobRing<Job> ring;
+    private JobWindow window;
+    private string[] jobIds;
+    private string[] headers;
+
+    [Params(4, 16)]
+    public int MaxActiveJobs { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        ring = new JobRing<Job>(MaxActiveJobs, x => x.Header);
+
+        for(var i = 1; i <= MaxActiveJobs * 2; i++)
+        {
+            var job = new Job(i);
+
+            ring.Add(job.JobId, job);
+            window.Add(i, MaxActiveJobs);
+
+            queue.Enqueue(job);
+
+            while(queue.Count > MaxActiveJobs)
+                queue.Dequeue();
+        }
+
+        // mostly recent jobs, some stale, looked up by fresh strings like those parsed from a submission
+        var ids = Enumerable.Range(0, LookupCount)
+            .Select(i => (long) MaxActiveJobs * 2 - i % (MaxActiveJobs + 2))
+            .ToArray();
+
+        jobIds = ids.Select(x => x.ToString("x8")).ToArray();
+        headers = ids.Select(x => "0x" + x.ToString("x64")).ToArray();
+    }
+
+    [Benchmark(Baseline = true, OperationsPerInvoke = LookupCount)]
+    public int Queue_By_Id()
+    {
+        var found = 0;
+
+        foreach(var jobId in jobIds)
+        {
+            lock(queue)
+            {
+                if(queue.ToArray().FirstOrDefault(x => x.JobId == jobId) != null)
+                    found++;
+            }
+        }
+
+        return found;
+    }
+
+    [Benchmark(OperationsPerInvoke = LookupCount)]
+    public int Ring_By_Id()
+    {
+        var found = 0;
+
+        foreach(var jobId in jobIds)
+        {
+            var job = ring.Get(jobId, out var id);
+
+            lock(queue)
+            {
+                if(job != null && window.Contains(id))
+                    found++;
+            }
+        }
+
+        return found;
+    }
+
+    [Benchmark(OperationsPerInvoke = LookupCount)]
+    public int Queue_By_Header()
+    {
+        var found = 0;
+
+        foreach(var header in headers)
+        {
+            lock(queue)
+            {
+                if(queue.ToArray().FirstOrDefault(x => x.Header.Equals(header)) != null)
+                    found++;
+            }
+        }
+
+        return found;
+    }
+
+    [Benchmark(OperationsPerInvoke = LookupCount)]
+    public int Ring_By_Header()
+    {
+        var found = 0;
+
+        foreach(var header in headers)
+        {
+            var job = ring.GetByKey(header, out var id);
+
+            lock(queue)
+            {
+                if(job != null && window.Contains(id))
+                    found++;
+            }
+        }
+
+        return found;
+    }
+}
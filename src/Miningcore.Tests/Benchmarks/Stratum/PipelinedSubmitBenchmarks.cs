@@ -0,0 +1,127 @@
+using System;
+using System.Diagnostics;
+using System.IO;
+using System.Net;
+using System.Net.Sockets;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using Autofac;
+using BenchmarkDotNet.Attributes;
+using Microsoft.IO;
+using Miningcore.Configuration;
+using Miningcore.JsonRpc;
+using Miningcore.Messaging;
+using Miningcore.Mining;
+using Miningcore.Stratum;
+using Miningcore.Time;
+using NLog;
+
+namespace Miningcore.Tests.Benchmarks.Stratum;
+
+/// <summary>
+/// Share submissions through a single multiplexed loopback connection, as sent by a proxy.
+/// Each submission burns <see cref="ValidationTime"/> of CPU. Each invocation sends
+/// <see cref="BatchSize"/> submissions, so Op/s is shares per second.
+/// </summary>
+public class PipelinedSubmitBenchmarks
+{
+    private const int BatchSize = 256;
+    private static readonly TimeSpan ValidationTime = TimeSpan.FromMilliseconds(0.2);
+
+    private class BenchmarkServer : StratumServer
+    {
+        public BenchmarkServer(IComponentContext ctx) :
+            base(ctx, ctx.Resolve<IMessageBus>(), ctx.Resolve<RecyclableMemoryStreamManager>(), ctx.Resolve<IMasterClock>())
+        {
+            logger = new NullLogger(LogManager.LogFactory);
+            clusterConfig = new ClusterConfig { Logging = new ClusterLoggingConfig() };
+            poolConfig = new PoolConfig { Id = "benchmark" };
+        }
+
+        public Task RunAsync(StratumEndpoint endpoint, CancellationToken ct)
+        {
+            return RunAsync(ct, endpoint);
+        }
+
+        protected override void OnConnect(StratumConnection connection, IPEndPoint ipEndPoint)
+        {
+            var context = new WorkerContextBase();
+            context.Init(1000, null, clock);
+
+            connection.SetContext(context);
+        }
+
+        protected override Task OnRequestAsync(StratumConnection connection, Timestamped<JsonRpcRequest> tsRequest, CancellationToken ct)
+        {
+            var sw = Stopwatch.StartNew();
+
+            while(sw.Elapsed < ValidationTime)
+                Thread.SpinWait(100);
+
+            return connection.RespondAsync(true, tsRequest.Value.Id);
+        }
+    }
+
+    private CancellationTokenSource cts;
+    private Task serverTask;
+    private TcpClient tcp;
+    private NetworkStream stream;
+    private StreamReader reader;
+    private byte[] requests;
+
+    [Params(1, 4, 8)]
+    public int PipelineDepth { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        ModuleInitializer.Initialize();
+
+        var listener = new TcpListener(IPAddress.Loopback, 0);
+        listener.Start();
+        var port = ((IPEndPoint) listener.LocalEndpoint).Port;
+        listener.Stop();
+
+        var endpoint = new StratumEndpoint(new IPEndPoint(IPAddress.Loopback, port), new PoolEndpoint
+        {
+            Difficulty = 1000,
+            PipelineDepth = PipelineDepth
+        });
+
+        cts = new CancellationTokenSource();
+        serverTask = new BenchmarkServer(ModuleInitializer.Container).RunAsync(endpoint, cts.Token);
+
+        tcp = new TcpClient();
+        tcp.Connect(IPAddress.Loopback, port);
+        stream = tcp.GetStream();
+        reader = new StreamReader(stream, Encoding.UTF8);
+
+        var sb = new StringBuilder();
+
+        for(var i = 0; i < BatchSize; i++)
+            sb.Append($"{{\"id\":{i},\"method\":\"mining.submit\",\"params\":[\"worker\",\"1\",\"00000000\",\"5f5e1000\",\"00000000\"]}}\n");
+
+        requests = Encoding.UTF8.GetBytes(sb.ToString());
+    }
+
+    [GlobalCleanup]
+    public void Cleanup()
+    {
+        tcp.Dispose();
+        cts.Cancel();
+        serverTask.Wait(TimeSpan.FromSeconds(5));
+    }
+
+    [Benchmark(OperationsPerInvoke = BatchSize)]
+    public async Task Submit()
+    {
+        // keep writing while responses come in, like a proxy would
+        var send = stream.WriteAsync(requests).AsTask();
+
+        for(var i = 0; i < BatchSize; i++)
+            await reader.ReadLineAsync();
+
+        await send;
+    }
+}
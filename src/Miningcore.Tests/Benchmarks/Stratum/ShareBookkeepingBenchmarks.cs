@@ -0,0 +1,58 @@
+using System;
+using System.Reactive.Concurrency;
+using System.Reactive.Linq;
+using BenchmarkDotNet.Attributes;
+using Miningcore.Extensions;
+using Miningcore.Messaging;
+using Miningcore.Mining;
+using Miningcore.Notifications.Messages;
+
+namespace Miningcore.Tests.Benchmarks.Stratum;
+
+/// <summary>
+/// Per-share bookkeeping after a share has been validated: a telemetry event routed
+/// through the message bus to a subscriber like the metrics publisher, versus
+/// interlocked per-connection counters that are sampled on scrape.
+/// </summary>
+[MemoryDiagnoser]
+public class ShareBookkeepingBenchmarks
+{
+    private const string PoolId = "pool1";
+
+    private static readonly DateTime now = new(2024, 1, 1, 0, 0, 0, DateTimeKind.Utc);
+
+    private IMessageBus messageBus;
+    private IDisposable subscription;
+    private ShareStats stats;
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        messageBus = new MessageBus();
+        stats = new ShareStats();
+
+        subscription = messageBus.Listen<TelemetryEvent>()
+            .ObserveOn(TaskPoolScheduler.Default)
+            .Subscribe(_ => { });
+    }
+
+    [GlobalCleanup]
+    public void Cleanup()
+    {
+        subscription.Dispose();
+    }
+
+    [Benchmark(Baseline = true)]
+    public void Telemetry_Event()
+    {
+        messageBus.SendTelemetry(PoolId, TelemetryCategory.Share, TimeSpan.FromMilliseconds(1), true);
+
+        stats.ValidShares++;
+    }
+
+    [Benchmark]
+    public void Interlocked_Counters()
+    {
+        stats.RecordAccepted(1024, now);
+    }
+}
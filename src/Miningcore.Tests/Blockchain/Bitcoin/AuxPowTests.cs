@@ -0,0 +1,236 @@
+using System;
+using System.Buffers.Binary;
+using System.Linq;
+using System.Security.Cryptography;
+using Autofac;
+using Microsoft.IO;
+using Miningcore.Blockchain.Bitcoin;
+using Miningcore.Blockchain.Bitcoin.DaemonResponses;
+using Miningcore.Configuration;
+using Miningcore.Extensions;
+using Miningcore.Stratum;
+using Miningcore.Tests.Util;
+using Miningcore.Util;
+using NBitcoin;
+using NLog;
+using Xunit;
+using BlockTemplate = Miningcore.Blockchain.Bitcoin.DaemonResponses.BlockTemplate;
+
+namespace Miningcore.Tests.Blockchain.Bitcoin;
+
+public class AuxPowTests : TestBase
+{
+    private const uint CurTime = 1700000000;
+
+    private static readonly uint256 MaxTarget = new(Enumerable.Repeat((byte) 0xff, 32).ToArray());
+
+    [Theory]
+    [InlineData(0u, 1, 0, 0u)]
+    [InlineData(0u, 1, 1, 1u)]
+    [InlineData(0u, 98, 2, 0u)]
+    [InlineData(7u, 98, 3, 7u)]
+    [InlineData(0u, 4096, 4, 14u)]
+    [InlineData(123456u, 16, 8, 142u)]
+    public void Expected_Index(uint nonce, int chainId, int merkleHeight, uint expected)
+    {
+        Assert.Equal(expected, AuxPowWork.GetExpectedIndex(nonce, chainId, merkleHeight));
+    }
+
+    [Fact]
+    public void Single_Chain_Commits_To_Block_Hash()
+    {
+        var hash = "00000000000000000001a2b3c4d5e6f708192a3b4c5d6e7f8091a2b3c4d5e6f7";
+        var work = AuxPowWork.Create(new[] { new AuxPowBlock("NMC", hash, 1, MaxTarget, 1) });
+
+        Assert.Equal(1u, work.MerkleSize);
+        Assert.Equal(0u, work.MerkleNonce);
+        Assert.Empty(work.GetBranch(0));
+        Assert.Equal("fabe6d6d" + hash + "01000000" + "00000000", work.Commitment.ToHexString());
+    }
+
+    [Fact]
+    public void Multiple_Chains_Get_Distinct_Slots()
+    {
+        var blocks = new[]
+        {
+            new AuxPowBlock("A", string.Concat(Enumerable.Repeat("11", 32)), 1, MaxTarget, 1),
+            new AuxPowBlock("B", string.Concat(Enumerable.Repeat("22", 32)), 98, MaxTarget, 1),
+            new AuxPowBlock("C", string.Concat(Enumerable.Repeat("33", 32)), 4096, MaxTarget, 1),
+        };
+
+        var work = AuxPowWork.Create(blocks);
+
+        Assert.Equal(4u, work.MerkleSize);
+        Assert.Equal(0u, work.MerkleNonce);
+        Assert.Equal(new[] { 3, 0, 2 }, Enumerable.Range(0, blocks.Length).Select(work.GetIndex));
+        Assert.Equal("fabe6d6ddd1f5b6348ff5dc48bb7853366c296998541ed583d6124838d4924378e299c3d0400000000000000", work.Commitment.ToHexString());
+
+        // every branch leads to the committed root
+        for(var i = 0; i < blocks.Length; i++)
+            Assert.Equal(work.MerkleRoot, FoldBranch(blocks[i].Hash.HexToReverseByteArray(), work.GetBranch(i), work.GetIndex(i)));
+    }
+
+    [Fact]
+    public void Duplicate_Chain_Ids_Are_Rejected()
+    {
+        var blocks = new[]
+        {
+            new AuxPowBlock("A", string.Concat(Enumerable.Repeat("11", 32)), 1, MaxTarget, 1),
+            new AuxPowBlock("B", string.Concat(Enumerable.Repeat("22", 32)), 1, MaxTarget, 1),
+        };
+
+        Assert.Throws<ArgumentException>(() => AuxPowWork.Create(blocks));
+    }
+
+    [Fact]
+    public void Serialize_Known_Vector()
+    {
+        var coinbase = "01000000010000000000000000000000000000000000000000000000000000000000000000ffffffff0100ffffffff0100000000000000000000000000".HexToByteArray();
+        var parentHash = Enumerable.Range(0, 32).Select(x => (byte) x).ToArray();
+        var coinbaseBranch = new[] { Enumerable.Repeat((byte) 0xaa, 32).ToArray(), Enumerable.Repeat((byte) 0xbb, 32).ToArray() };
+        var chainBranch = new[] { Enumerable.Repeat((byte) 0xcc, 32).ToArray() };
+        var header = Enumerable.Repeat((byte) 0x01, 80).ToArray();
+
+        var result = AuxPowWork.Serialize(coinbase, parentHash, coinbaseBranch, chainBranch, 1, header);
+
+        Assert.Equal("01000000010000000000000000000000000000000000000000000000000000000000000000ffffffff0100ffffffff0100000000000000000000000000" +
+            "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f" +
+            "02aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaabbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb00000000" +
+            "01cccccccccccccccccccccccccccccccccccccccccccccccccccccccccccccccc01000000" +
+            string.Concat(Enumerable.Repeat("01", 80)), result.ToHexString());
+    }
+
+    [Fact]
+    public void Share_Is_Checked_Against_All_Aux_Targets()
+    {
+        var solvable = new AuxPowBlock("A", string.Concat(Enumerable.Repeat("11", 32)), 1, MaxTarget, 100);
+        var unsolvable = new AuxPowBlock("B", string.Concat(Enumerable.Repeat("22", 32)), 98, uint256.Zero, 200);
+        var work = AuxPowWork.Create(new[] { solvable, unsolvable });
+
+        var (job, worker) = CreateJob(work);
+
+        // far below the stratum difficulty, but the share still solves aux block A
+        var (share, blockHex, auxProofs) = job.ProcessShare(worker, "00000001", CurTime.ToString("x8"), "12345678");
+
+        Assert.NotNull(share);
+        Assert.False(share.IsBlockCandidate);
+        Assert.Null(blockHex);
+        Assert.Single(auxProofs);
+        Assert.Same(solvable, auxProofs[0].Block);
+
+        var proof = auxProofs[0].AuxPow.HexToByteArray();
+
+        // coinbase, parent hash, coinbase branch (two steps for three transactions), chain branch, header
+        var coinbaseLength = proof.Length - 32 - (1 + 2 * 32 + 4) - (1 + work.MerkleHeight * 32 + 4) - 80;
+        var coinbase = proof[..coinbaseLength];
+        var parentHash = proof[coinbaseLength..(coinbaseLength + 32)];
+        var coinbaseBranch = proof[(coinbaseLength + 32)..(coinbaseLength + 32 + 1 + 2 * 32 + 4)];
+        var chainBranch = proof[(coinbaseLength + 32 + 1 + 2 * 32 + 4)..^80];
+        var header = proof[^80..];
+
+        // credited for the work the hash represents, not for the stratum difficulty it missed
+        var hashDifficulty = (double) new BigRational(BitcoinConstants.Diff1, DoubleDigest(header).AsSpan().ToBigInteger());
+
+        Assert.True(share.Difficulty < 1e6);
+        Assert.Equal(hashDifficulty, share.Difficulty);
+
+        // coinbase carries the commitment and leads to the header merkle root
+        Assert.Contains(work.Commitment.ToHexString(), coinbase.ToHexString());
+        Assert.Equal(2, coinbaseBranch[0]);
+        Assert.Equal(0u, BinaryPrimitives.ReadUInt32LittleEndian(coinbaseBranch[^4..]));
+
+        var merkleRoot = FoldBranch(DoubleDigest(coinbase), new[] { coinbaseBranch[1..33], coinbaseBranch[33..65] }, 0);
+        Assert.Equal(header[36..68], merkleRoot);
+
+        // parent hash is the hash of the header
+        Assert.Equal(DoubleDigest(header), parentHash);
+
+        // chain branch leads from the aux block to the committed root
+        Assert.Equal(work.MerkleHeight, chainBranch[0]);
+        Assert.Equal((uint) work.GetIndex(0), BinaryPrimitives.ReadUInt32LittleEndian(chainBranch[^4..]));
+
+        var steps = Enumerable.Range(0, work.MerkleHeight).Select(i => chainBranch[(1 + i * 32)..(1 + (i + 1) * 32)]).ToArray();
+        Assert.Equal(work.MerkleRoot, FoldBranch(solvable.Hash.HexToReverseByteArray(), steps, work.GetIndex(0)));
+    }
+
+    [Fact]
+    public void Aux_Block_Is_Submitted_Once_Per_Job()
+    {
+        var block = new AuxPowBlock("A", string.Concat(Enumerable.Repeat("11", 32)), 1, MaxTarget, 100);
+        var other = new AuxPowBlock("B", block.Hash, 98, MaxTarget, 100);
+        var (job, _) = CreateJob(AuxPowWork.Create(new[] { block, other }));
+
+        Assert.True(job.RegisterAuxSubmit(block));
+        Assert.False(job.RegisterAuxSubmit(block));
+        Assert.True(job.RegisterAuxSubmit(other));
+
+        // a new job carries new work
+        var (next, _) = CreateJob(AuxPowWork.Create(new[] { block }));
+        Assert.True(next.RegisterAuxSubmit(block));
+    }
+
+    [Fact]
+    public void Share_Without_Aux_Match_Is_Rejected_Below_Difficulty()
+    {
+        var work = AuxPowWork.Create(new[] { new AuxPowBlock("A", string.Concat(Enumerable.Repeat("11", 32)), 1, uint256.Zero, 100) });
+        var (job, worker) = CreateJob(work);
+
+        Assert.ThrowsAny<StratumException>(() => job.ProcessShare(worker, "00000001", CurTime.ToString("x8"), "12345678"));
+    }
+
+    private static byte[] DoubleDigest(byte[] data)
+    {
+        return SHA256.HashData(SHA256.HashData(data));
+    }
+
+    private static byte[] FoldBranch(byte[] hash, byte[][] branch, int index)
+    {
+        foreach(var step in branch)
+        {
+            hash = (index & 1) != 0 ?
+                DoubleDigest(step.Concat(hash).ToArray()) :
+                DoubleDigest(hash.Concat(step).ToArray());
+
+            index >>= 1;
+        }
+
+        return hash;
+    }
+
+    private (BitcoinJob, StratumConnection) CreateJob(AuxPowWork auxWork)
+    {
+        var coin = (BitcoinTemplate) ModuleInitializer.CoinTemplates["bitcoin"];
+        var clock = new MockMasterClock { CurrentTime = DateTimeOffset.FromUnixTimeSeconds(CurTime).UtcDateTime };
+        var poolAddressDestination = BitcoinUtils.AddressToDestination("1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa", Network.Main);
+
+        var blockTemplate = new BlockTemplate
+        {
+            Version = 0x20000000,
+            PreviousBlockhash = "00000000000000000002a7c4c1e48d76c5a37902165a270156b7a8d72728a054",
+            CoinbaseValue = 625000000,
+            Target = "0000000000000000000538bf0000000000000000000000000000000000000000",
+            CurTime = CurTime,
+            Bits = "17053894",
+            Height = 800000,
+            Transactions = new[] { "aa", "bb", "cc" }
+                .Select(x => new BitcoinBlockTransaction { TxId = string.Concat(Enumerable.Repeat(x, 32)), Data = string.Empty })
+                .ToArray(),
+        };
+
+        var worker = new StratumConnection(new NullLogger(LogManager.LogFactory), container.Resolve<RecyclableMemoryStreamManager>(), clock, "1", false);
+
+        worker.SetContext(new BitcoinWorkerContext
+        {
+            ExtraNonce1 = "10000000",
+            Difficulty = 1e6,
+        });
+
+        var job = new BitcoinJob { AuxWork = auxWork };
+
+        job.Init(blockTemplate, "1", new PoolConfig { Template = coin }, null, new ClusterConfig(), clock,
+            poolAddressDestination, Network.Main, false, coin.ShareMultiplier, coin.CoinbaseHasherValue,
+            coin.HeaderHasherValue, coin.BlockHasherValue);
+
+        return (job, worker);
+    }
+}
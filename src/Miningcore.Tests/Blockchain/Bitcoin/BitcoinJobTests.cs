@@ -1,7 +1,10 @@
+using System;
 using Autofac;
 using Microsoft.IO;
 using Miningcore.Blockchain.Bitcoin;
 using Miningcore.Configuration;
+using Miningcore.Crypto;
+using Miningcore.Crypto.Hashing.Algorithms;
 using Miningcore.Stratum;
 using Miningcore.Tests.Util;
 using NBitcoin;
@@ -27,7 +30,7 @@ public class BitcoinJobTests : TestBase
         var nonce = submitParams[4] as string;
 
         // validate & process
-        var (share, blockHex) = job.ProcessShare(worker, extraNonce2, nTime, nonce);
+        var (share, blockHex, _) = job.ProcessShare(worker, extraNonce2, nTime, nonce);
 
         Assert.NotNull(share);
         Assert.Equal("00000056300e9fd18624edd7eaa8bcd6c8466d7eb8cf91b4e60f9d35fa97f504", share.BlockHash);
@@ -49,7 +52,7 @@ public class BitcoinJobTests : TestBase
         var nonce = submitParams[4] as string;
 
         // validate & process
-        var (share, _) = job.ProcessShare(worker, extraNonce2, nTime, nonce);
+        var (share, _, _) = job.ProcessShare(worker, extraNonce2, nTime, nonce);
 
         Assert.NotNull(share);
         Assert.True(share.IsBlockCandidate);
@@ -89,7 +92,76 @@ public class BitcoinJobTests : TestBase
         Assert.ThrowsAny<StratumException>(()=> job.ProcessShare(worker, extraNonce2, nTime, nonce));
     }
 
-    private (BitcoinJob, StratumConnection) CreateJob()
+    /// <summary>
+    /// Sha256D under a different type, which keeps the job on the generic hashing path
+    /// </summary>
+    private class GenericSha256D : IHashAlgorithm
+    {
+        private readonly Sha256D hasher = new();
+
+        public void Digest(ReadOnlySpan<byte> data, Span<byte> result, params object[] extra)
+        {
+            hasher.Digest(data, result, extra);
+        }
+    }
+
+    private static string Submit(BitcoinJob job, StratumConnection worker, string extraNonce2, string nonce, string versionBits)
+    {
+        try
+        {
+            var (share, _, _) = job.ProcessShare(worker, extraNonce2, "63445774", nonce, versionBits);
+            return share.BlockHash ?? share.Difficulty.ToString();
+        }
+
+        catch(StratumException ex)
+        {
+            // the message carries the computed share difficulty
+            return ex.Message;
+        }
+    }
+
+    [Fact]
+    public void Midstate_Path_Matches_Generic_Path()
+    {
+        var stats = new BitcoinShareCacheStats();
+        var (job, worker) = CreateJob(new Sha256D());
+        var (reference, referenceWorker) = CreateJob(new GenericSha256D());
+
+        job.ShareCacheStats = stats;
+
+        foreach(var context in new[] { worker.ContextAs<BitcoinWorkerContext>(), referenceWorker.ContextAs<BitcoinWorkerContext>() })
+        {
+            context.VersionRollingMask = 0x1fffe000;
+            context.Difficulty = 1e12;
+        }
+
+        var count = 0;
+
+        // ASIC pattern: a handful of rolled versions, many nonces per extraNonce2
+        foreach(var extraNonce2 in new[] { "01000000", "02000000" })
+        {
+            foreach(var versionBits in new[] { "00000000", "00002000", "1fffe000" })
+            {
+                for(var i = 0; i < 8; i++)
+                {
+                    // the dupe check ignores version-bits, so every share gets its own nonce
+                    var nonce = (0x51036775u + (uint) count * 0x01010101u).ToString("x8");
+
+                    Assert.Equal(Submit(reference, referenceWorker, extraNonce2, nonce, versionBits),
+                        Submit(job, worker, extraNonce2, nonce, versionBits));
+
+                    count++;
+                }
+            }
+        }
+
+        var result = stats.Take();
+
+        Assert.Equal((BitcoinShareCacheStats.Coinbase, count - 2L, 2L), result[0]);
+        Assert.Equal((BitcoinShareCacheStats.Midstate, count - 6L, 6L), result[1]);
+    }
+
+    private (BitcoinJob, StratumConnection) CreateJob(IHashAlgorithm headerHasher = null)
     {
         var job = new BitcoinJob();
         var coin = (BitcoinTemplate) ModuleInitializer.CoinTemplates["dash"];
@@ -112,7 +184,7 @@ public class BitcoinJobTests : TestBase
         worker.SetContext(context);
 
         job.Init(blockTemplate, "1", pc, null, new ClusterConfig(), clock, poolAddressDestination, network, false,
-            coin.ShareMultiplier, coin.CoinbaseHasherValue, coin.HeaderHasherValue, coin.BlockHasherValue);
+            coin.ShareMultiplier, coin.CoinbaseHasherValue, headerHasher ?? coin.HeaderHasherValue, coin.BlockHasherValue);
 
         return (job, worker);
     }
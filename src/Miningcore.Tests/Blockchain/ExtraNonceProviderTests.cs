@@ -0,0 +1,129 @@
+using System.Collections.Concurrent;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using Miningcore.Blockchain.Bitcoin;
+using Miningcore.Blockchain.Kaspa;
+using Xunit;
+
+namespace Miningcore.Tests.Blockchain;
+
+public class ExtraNonceProviderTests
+{
+    private const string PoolId = "pool1";
+
+    [Fact]
+    public void Next_Encodes_Instance_Id()
+    {
+        var provider = new BitcoinExtraNonceProvider(PoolId, 0xa);
+
+        Assert.Equal("a0000001", provider.Next());
+        Assert.Equal("a0000002", provider.Next());
+    }
+
+    [Fact]
+    public void Released_Values_Are_Reused()
+    {
+        var provider = new BitcoinExtraNonceProvider(PoolId, 0xa);
+
+        var first = provider.Next();
+        provider.Next();
+
+        provider.Release(first);
+
+        Assert.Equal(first, provider.Next());
+        Assert.Equal("a0000003", provider.Next());
+    }
+
+    [Fact]
+    public void Foreign_Or_Invalid_Values_Are_Ignored()
+    {
+        var provider = new BitcoinExtraNonceProvider(PoolId, 0xa);
+
+        provider.Release("b0000001");
+        provider.Release("junk");
+        provider.Release(null);
+
+        Assert.Equal("a0000001", provider.Next());
+
+        provider.Reserve("b0001000");
+        Assert.Equal("a0000002", provider.Next());
+    }
+
+    [Fact]
+    public void Reserve_Skips_Values_Issued_Elsewhere()
+    {
+        var provider = new BitcoinExtraNonceProvider(PoolId, 0xa);
+
+        provider.Reserve("a0000100");
+        provider.Reserve("a0000010");
+
+        Assert.Equal("a0000101", provider.Next());
+    }
+
+    [Fact]
+    public void Next_Skips_Values_In_Use_After_Wrap()
+    {
+        // a single byte leaves four bits next to the instance id, 16 values
+        var provider = new KaspaExtraNonceProvider(PoolId, 1, 0xa);
+
+        // sessions resumed after a handoff
+        provider.Reserve("a3");
+        provider.Reserve("a5");
+
+        var issued = Enumerable.Range(0, 14).Select(_ => provider.Next()).ToArray();
+
+        Assert.Equal(new[] { "a6", "a7", "a8", "a9", "aa", "ab", "ac", "ad", "ae", "af", "a0", "a1", "a2", "a4" }, issued);
+
+        // only values whose sessions are gone come back
+        provider.Release("a3");
+        provider.Release(issued[0]);
+
+        Assert.Equal("a3", provider.Next());
+        Assert.Equal("a6", provider.Next());
+    }
+
+    [Fact]
+    public void Released_Value_Is_Not_Issued_Twice_After_Wrap()
+    {
+        var provider = new KaspaExtraNonceProvider(PoolId, 1, 0xa);
+        var issued = Enumerable.Range(0, 16).Select(_ => provider.Next()).ToList();
+
+        Assert.Equal(16, issued.Distinct().Count());
+
+        // released twice, still only one session may get it
+        provider.Release("a7");
+        provider.Release("a7");
+        provider.Release("a9");
+
+        Assert.Equal("a7", provider.Next());
+        Assert.Equal("a9", provider.Next());
+    }
+
+    [Fact]
+    public void Concurrent_Next_And_Release_Never_Issue_Live_Value_Twice()
+    {
+        var provider = new BitcoinExtraNonceProvider(PoolId, 0xa);
+        var live = new ConcurrentDictionary<string, bool>();
+        var duplicates = 0;
+
+        Parallel.For(0, 8, _ =>
+        {
+            for(var i = 0; i < 20000; i++)
+            {
+                var value = provider.Next();
+
+                if(!live.TryAdd(value, true))
+                    Interlocked.Increment(ref duplicates);
+
+                // give back every other value once it is no longer in use
+                if(i % 2 == 0 && live.TryRemove(value, out _))
+                    provider.Release(value);
+            }
+        });
+
+        Assert.Equal(0, duplicates);
+        Assert.Equal(8 * 10000, live.Count);
+        Assert.True(live.Keys.All(x => x.StartsWith("a")));
+    }
+}
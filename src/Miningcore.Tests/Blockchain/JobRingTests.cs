@@ -0,0 +1,194 @@
+using System;
+using Miningcore.Blockchain;
+using Xunit;
+
+namespace Miningcore.Tests.Blockchain;
+
+public class JobRingTests
+{
+    private record Job(string JobId, string Header);
+
+    private static Job Add(JobRing<Job> ring, long id, string header = null)
+    {
+        var job = new Job(id.ToString("x8"), header);
+        ring.Add(job.JobId, job);
+
+        return job;
+    }
+
+    [Fact]
+    public void Get_By_Id()
+    {
+        var ring = new JobRing<Job>(4);
+        var first = Add(ring, 1);
+        var second = Add(ring, 2);
+
+        Assert.Same(first, ring.Get("00000001", out var id));
+        Assert.Equal(1, id);
+        Assert.Same(second, ring.Get("00000002", out id));
+        Assert.Equal(2, id);
+        Assert.Equal(2, ring.Newest);
+
+        Assert.Null(ring.Get("00000003", out _));
+    }
+
+    [Theory]
+    [InlineData(null)]
+    [InlineData("")]
+    [InlineData("xyz")]
+    [InlineData("-1")]
+    [InlineData("10000000000000001")]
+    public void Get_Invalid_Id(string jobId)
+    {
+        var ring = new JobRing<Job>(4);
+        Add(ring, 1);
+
+        Assert.Null(ring.Get(jobId, out _));
+    }
+
+    [Fact]
+    public void Add_Invalid_Id_Throws()
+    {
+        var ring = new JobRing<Job>(4);
+
+        Assert.Throws<ArgumentException>(() => ring.Add("xyz", new Job("xyz", null)));
+    }
+
+    [Fact]
+    public void Capacity_Rounds_Up_To_Power_Of_Two()
+    {
+        Assert.Equal(8, new JobRing<Job>(6).Capacity);
+        Assert.Equal(4, new JobRing<Job>(4).Capacity);
+    }
+
+    [Fact]
+    public void Oldest_Jobs_Are_Evicted()
+    {
+        var ring = new JobRing<Job>(4);
+
+        for(var i = 1; i <= 6; i++)
+            Add(ring, i);
+
+        Assert.Null(ring.Get("00000001", out _));
+        Assert.Null(ring.Get("00000002", out _));
+
+        for(var i = 3; i <= 6; i++)
+            Assert.NotNull(ring.Get(i.ToString("x8"), out _));
+    }
+
+    [Fact]
+    public void Get_By_Key()
+    {
+        var ring = new JobRing<Job>(2, x => x.Header);
+        var first = Add(ring, 1, "0xaa");
+        Add(ring, 2, "0xbb");
+
+        Assert.Same(first, ring.GetByKey("0xaa", out var id));
+        Assert.Equal(1, id);
+
+        Add(ring, 3, "0xcc");
+
+        Assert.Null(ring.GetByKey("0xaa", out _));
+        Assert.Null(ring.GetByKey(null, out _));
+        Assert.Null(new JobRing<Job>(2).GetByKey("0xbb", out _));
+    }
+
+    [Fact]
+    public void Eviction_Keeps_Key_Taken_Over_By_Later_Job()
+    {
+        var ring = new JobRing<Job>(2, x => x.Header);
+        Add(ring, 1, "0xaa");
+        Add(ring, 2, "0xbb");
+        var third = Add(ring, 3, "0xbb");
+
+        // evicts job 2 whose key now belongs to job 3
+        Add(ring, 4, "0xdd");
+
+        Assert.Same(third, ring.GetByKey("0xbb", out var id));
+        Assert.Equal(3, id);
+    }
+
+    [Fact]
+    public void Window_Starts_At_First_Job()
+    {
+        var window = new JobWindow();
+
+        Assert.False(window.Contains(0));
+        Assert.False(window.Contains(5));
+
+        window.Add(5, 4);
+
+        Assert.False(window.Contains(4));
+        Assert.True(window.Contains(5));
+        Assert.False(window.Contains(6));
+    }
+
+    [Fact]
+    public void Window_Keeps_Max_Active_Jobs()
+    {
+        var window = new JobWindow();
+
+        for(var i = 1; i <= 10; i++)
+            window.Add(i, 4);
+
+        // re-sending an older job doesn't widen the window
+        window.Add(8, 4);
+
+        for(var i = 1; i <= 6; i++)
+            Assert.False(window.Contains(i));
+
+        for(var i = 7; i <= 10; i++)
+            Assert.True(window.Contains(i));
+    }
+
+    [Fact]
+    public void Window_Restarts_When_Ids_Start_Over()
+    {
+        var window = new JobWindow();
+        window.Add(100, 4);
+        window.Add(101, 4);
+
+        window.Add(1, 4);
+
+        Assert.True(window.Contains(1));
+        Assert.False(window.Contains(101));
+    }
+
+    [Fact]
+    public void Window_Follows_Ids_Across_Wrap()
+    {
+        var window = new JobWindow();
+
+        window.Add(0xfffffffe, 4);
+        window.Add(0xffffffff, 4);
+        window.Add(0, 4);
+
+        // the job ids just wrapped, the newest job is 0
+        Assert.True(window.Contains(0));
+        Assert.True(window.Contains(0xffffffff));
+        Assert.True(window.Contains(0xfffffffe));
+        Assert.False(window.Contains(1));
+
+        window.Add(1, 4);
+        window.Add(2, 4);
+
+        Assert.False(window.Contains(0xfffffffe));
+
+        for(var i = 0xffffffffL; i <= 0x100000002L; i++)
+            Assert.True(window.Contains(i & 0xffffffff));
+
+        Assert.False(window.Contains(0x100000000));
+    }
+
+    [Fact]
+    public void Ring_Finds_Jobs_Across_Wrap()
+    {
+        var ring = new JobRing<Job>(4);
+        var last = Add(ring, 0xffffffff);
+        var first = Add(ring, 0);
+
+        Assert.Same(last, ring.Get("ffffffff", out _));
+        Assert.Same(first, ring.Get("00000000", out var id));
+        Assert.Equal(0, id);
+    }
+}
@@ -0,0 +1,217 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using Miningcore.Extensions;
+using Miningcore.Native;
+using Xunit;
+
+namespace Miningcore.Tests.Crypto;
+
+public class CuckooCycleTests : TestBase
+{
+    // Finding real cycles on 2^29 and 2^30 edge graphs takes a solver, so these use sets of edges whose
+    // endpoints xor to zero without forming a cycle. The verifier has to hash every edge bit-exactly to get
+    // past the xor check and end up at DeadEnd. Random edges of each variant must fail with NonMatching.
+    public static IEnumerable<object[]> KnownAnswers => new[]
+    {
+        new object[]
+        {
+            CuckooVariant.Cortex,
+            "c6cdd4dbe2e9f0f7fe050c131a21282f363d444b525960676e757c838a91989fa6adb4bbc2c9d0d7dee5ecf3fa01080f161d242b323940474e555c636a71787f868d949ba2a9b0b7bec5ccd3dae1e8ef",
+            new uint[]
+            {
+            4522707, 12260256, 19767455, 47936369, 60875732, 62364611, 65691502, 74143659,
+            93388246, 135520872, 201561926, 214748959, 219531151, 231780618, 259609208, 362053496,
+            365822119, 399230659, 407699194, 428458136, 476079230, 487344227, 491263128, 498594435,
+            500545052, 622301269, 651478926, 738360465, 758650493, 766200609, 788392424, 804668615,
+            815217483, 823967203, 837108038, 844508892, 915022765, 940356432, 942662923, 1007857332,
+            1047664193, 1051608830,
+            },
+            new uint[]
+            {
+            10347357, 39005980, 138386410, 193340800, 194297564, 196231121, 250202148, 272985343,
+            278034979, 310730679, 318386603, 321270733, 369526040, 442681459, 462706012, 492264182,
+            553880261, 558846223, 577405113, 584024520, 587712798, 616638979, 616922505, 721347072,
+            722716950, 761275986, 789771344, 800223337, 823380008, 834208973, 863083529, 886720007,
+            891623254, 903561936, 912943833, 930939933, 979570983, 997215484, 1033842389, 1038789632,
+            1043234911, 1055223082,
+            }
+        },
+        new object[]
+        {
+            CuckooVariant.C29s,
+            "a7aeb5bcc3cad1d8dfe6edf4fb020910171e252c333a41484f565d646b727980878e959ca3aab1b8bfc6cdd4dbe2e9f0f7fe050c131a21282f363d444b525960676e757c838a91989fa6adb4bbc2c9d0",
+            new uint[]
+            {
+            3216941, 28063368, 50503220, 51190775, 60600677, 93622511, 110444465, 159275466,
+            167195372, 201256788, 216036923, 230210579, 245414605, 264515592, 271896931, 276606140,
+            290084467, 294811561, 300423608, 328347080, 372269018, 414855655, 418455522, 428562466,
+            437783726, 452989373, 459224379, 480277113, 515087840, 515553867, 521811015, 527557771,
+            },
+            new uint[]
+            {
+            12822971, 23262276, 28157613, 107048295, 117008334, 129289524, 130440477, 134448393,
+            160933755, 187594926, 208056912, 224641982, 244603133, 263251731, 266667965, 286105711,
+            353313126, 360358666, 366129406, 396801145, 403856545, 411499358, 426538124, 428270473,
+            445191648, 463847022, 473095363, 495322929, 505911682, 515670927, 524284187, 528952217,
+            }
+        },
+        new object[]
+        {
+            CuckooVariant.C29v,
+            "aab1b8bfc6cdd4dbe2e9f0f7fe050c131a21282f363d444b525960676e757c838a91989fa6adb4bbc2c9d0d7dee5ecf3fa01080f161d242b323940474e555c636a71787f868d949ba2a9b0b7bec5ccd3",
+            new uint[]
+            {
+            43438884, 51912698, 81665924, 127875605, 153235257, 165666181, 166978686, 170622828,
+            172817095, 178990736, 179978305, 204267875, 215520839, 253041093, 266197462, 270877312,
+            273814542, 298578157, 300098263, 309778180, 335015742, 360900276, 367730228, 387109266,
+            412598600, 419610139, 424647777, 427524377, 446203128, 498679291, 502254987, 531925307,
+            },
+            new uint[]
+            {
+            1101488, 6257441, 35256301, 45860741, 49840292, 64016926, 79134168, 82299187,
+            109953027, 151997177, 176557090, 191632328, 211016140, 212670252, 216873293, 223518753,
+            241615903, 243035216, 340100921, 364148777, 375928849, 377940373, 417726421, 418793436,
+            425757534, 428877063, 431940492, 441490454, 459003877, 486703318, 501927474, 510129044,
+            }
+        },
+        new object[]
+        {
+            CuckooVariant.C29b,
+            "969da4abb2b9c0c7ced5dce3eaf1f8ff060d141b222930373e454c535a61686f767d848b9299a0a7aeb5bcc3cad1d8dfe6edf4fb020910171e252c333a41484f565d646b727980878e959ca3aab1b8bf",
+            new uint[]
+            {
+            739498, 13533878, 87345972, 91233204, 96893015, 103130576, 127326193, 131330540,
+            134374515, 164674844, 180642843, 188398331, 206255599, 206625574, 224302050, 230970055,
+            238499966, 249153095, 286879947, 309427431, 310619794, 314030917, 315301103, 328294258,
+            333486300, 364300309, 382183823, 419449033, 437344760, 445216489, 452840462, 454079836,
+            467488468, 467900342, 468455721, 481564679, 491995493, 496037774, 498221252, 519542357,
+            },
+            new uint[]
+            {
+            272558, 40527164, 59776864, 60608256, 78235813, 100162484, 109923042, 121066054,
+            126253255, 132899388, 138448670, 161349186, 162955291, 194626634, 197385286, 238900011,
+            249265537, 256790775, 282987289, 297943806, 310831482, 319864233, 324807478, 331785461,
+            355758238, 378309830, 389617406, 392752304, 393493882, 436126448, 440483319, 453019801,
+            466661690, 475226393, 480281889, 481056827, 488419174, 488486912, 524959585, 533603256,
+            }
+        },
+        new object[]
+        {
+            CuckooVariant.C29i,
+            "9da4abb2b9c0c7ced5dce3eaf1f8ff060d141b222930373e454c535a61686f767d848b9299a0a7aeb5bcc3cad1d8dfe6edf4fb020910171e252c333a41484f565d646b727980878e959ca3aab1b8bfc6",
+            new uint[]
+            {
+            12238937, 15516465, 28240918, 37565500, 38345330, 40837783, 55354914, 65352812,
+            70677958, 86880743, 96015738, 105020289, 115038771, 123776586, 140118066, 168043833,
+            170570269, 170919269, 188168066, 192786517, 198305421, 198592574, 221558999, 244148318,
+            247501672, 247934051, 260422594, 272954832, 276467298, 285451292, 298170198, 302883148,
+            316059057, 326313636, 327409564, 373662901, 374127048, 399440151, 404595521, 417047110,
+            435806252, 447944976, 450305834, 472777556, 485295313, 501240088, 513783595, 536355066,
+            },
+            new uint[]
+            {
+            10100177, 11408953, 34724871, 36839142, 50186369, 56481924, 60461958, 123766573,
+            133948020, 134616680, 138580538, 140364756, 141501346, 141684457, 141885592, 165397645,
+            170764572, 185119974, 186885822, 198077526, 200184667, 224297458, 226595876, 241842396,
+            248863651, 251333476, 255998941, 256970062, 264953120, 265657556, 269810864, 271518495,
+            302180792, 313658669, 327414684, 349409492, 359298508, 372300711, 423960938, 424779328,
+            434163840, 435789104, 448788347, 494476403, 499691717, 505361975, 516367408, 529482551,
+            }
+        },
+    };
+
+    private static readonly CuckooKernel[] kernels = { CuckooKernel.Scalar, CuckooKernel.Avx2, CuckooKernel.Avx512, CuckooKernel.Auto };
+
+    [Theory]
+    [MemberData(nameof(KnownAnswers))]
+    public void Verify_Known_Answers(CuckooVariant variant, string header, uint[] balanced, uint[] random)
+    {
+        var headerBytes = header.HexToByteArray();
+
+        foreach(var kernel in kernels)
+        {
+            Assert.Equal(CuckooVerifyResult.DeadEnd, CuckooCycle.Verify(variant, headerBytes, balanced, kernel));
+            Assert.Equal(CuckooVerifyResult.NonMatching, CuckooCycle.Verify(variant, headerBytes, random, kernel));
+        }
+    }
+
+    [Theory]
+    [MemberData(nameof(KnownAnswers))]
+    public void Verify_Malformed(CuckooVariant variant, string header, uint[] balanced, uint[] random)
+    {
+        var headerBytes = header.HexToByteArray();
+        var edgeBits = variant == CuckooVariant.Cortex ? 30 : 29;
+
+        var swapped = balanced.ToArray();
+        (swapped[3], swapped[4]) = (swapped[4], swapped[3]);
+
+        Assert.Equal(CuckooVerifyResult.TooSmall, CuckooCycle.Verify(variant, headerBytes, swapped));
+
+        // keep the direction bit so cuckarood doesn't bail out as unbalanced first
+        var tooBig = balanced.ToArray();
+        tooBig[^1] = (1u << edgeBits) | (tooBig[^1] & 1);
+
+        Assert.Equal(CuckooVerifyResult.TooBig, CuckooCycle.Verify(variant, headerBytes, tooBig));
+    }
+
+    [Fact]
+    public void Verify_C29v_Unbalanced()
+    {
+        // all edges in the same direction
+        var solution = Enumerable.Range(0, 32).Select(i => (uint) i * 2).ToArray();
+
+        Assert.Equal(CuckooVerifyResult.Unbalanced, CuckooCycle.Verify(CuckooVariant.C29v, new byte[80], solution));
+    }
+
+    [Fact]
+    public void Verify_Cortex_Matches_Legacy_Export()
+    {
+        var kat = KnownAnswers.First();
+        var header = ((string) kat[1]).HexToByteArray();
+
+        foreach(var solution in new[] { (uint[]) kat[2], (uint[]) kat[3] })
+        {
+            var expected = (int) CuckooCycle.Verify(CuckooVariant.Cortex, header, solution);
+
+            Assert.Equal(expected, new CortexCuckooCycle().Verify(header, solution));
+        }
+    }
+
+    [Theory]
+    [MemberData(nameof(KnownAnswers))]
+    public void Verify_Batch_Matches_Single(CuckooVariant variant, string header, uint[] balanced, uint[] random)
+    {
+        // more than one chunk of eight and a tail that doesn't fill a vector
+        const int count = 11;
+
+        var headerBytes = header.HexToByteArray();
+        var proofSize = CuckooCycle.ProofSize(variant);
+        var headers = new byte[count * headerBytes.Length];
+        var solutions = new uint[count * proofSize];
+        var expected = new CuckooVerifyResult[count];
+
+        for(var i = 0; i < count; i++)
+        {
+            var solution = (i & 1) == 0 ? balanced.ToArray() : random.ToArray();
+
+            if(i == 4)
+                (solution[0], solution[1]) = (solution[1], solution[0]);
+
+            headerBytes.CopyTo(headers, i * headerBytes.Length);
+            solution.CopyTo(solutions, i * proofSize);
+
+            expected[i] = CuckooCycle.Verify(variant, headerBytes, solution);
+        }
+
+        Assert.Equal(CuckooVerifyResult.TooSmall, expected[4]);
+
+        foreach(var kernel in kernels)
+        {
+            var results = new CuckooVerifyResult[count];
+            CuckooCycle.VerifyBatch(variant, headers, headerBytes.Length, solutions, results, count, kernel);
+
+            Assert.Equal(expected, results);
+        }
+    }
+}
@@ -0,0 +1,181 @@
+using System;
+using System.Collections.Concurrent;
+using System.Linq;
+using System.Security.Cryptography;
+using System.Threading;
+using System.Threading.Tasks;
+using Miningcore.Crypto;
+using Xunit;
+
+namespace Miningcore.Tests.Crypto;
+
+public class HashBatchDispatcherTests
+{
+    private const int Lanes = 4;
+
+    /// <summary>
+    /// SHA-256 with a fixed cost per native call, records the size of every call
+    /// </summary>
+    private class FakeBatchHasher : IHashAlgorithm, IHashAlgorithmBatch
+    {
+        public FakeBatchHasher(int lanes, TimeSpan callCost)
+        {
+            MaxLanes = lanes;
+            this.callCost = callCost;
+        }
+
+        private readonly TimeSpan callCost;
+
+        private int singles;
+
+        public int MaxLanes { get; }
+        public ConcurrentQueue<int> Calls { get; } = new();
+        public int Singles => singles;
+        public object[] LastExtra { get; private set; }
+        public bool Fail { get; set; }
+
+        public void Digest(ReadOnlySpan<byte> data, Span<byte> result, params object[] extra)
+        {
+            Interlocked.Increment(ref singles);
+            LastExtra = extra;
+
+            if(callCost > TimeSpan.Zero)
+                Thread.Sleep(callCost);
+
+            if(Fail)
+                throw new InvalidOperationException("kernel failure");
+
+            SHA256.HashData(data, result);
+        }
+
+        public void DigestBatch(ReadOnlySpan<byte> data, int inputLength, Span<byte> result, int count)
+        {
+            Calls.Enqueue(count);
+
+            if(callCost > TimeSpan.Zero)
+                Thread.Sleep(callCost);
+
+            if(Fail)
+                throw new InvalidOperationException("kernel failure");
+
+            for(var i = 0; i < count; i++)
+                SHA256.HashData(data.Slice(i * inputLength, inputLength), result.Slice(i * 32, 32));
+        }
+    }
+
+    private static byte[] CreateInput(int i)
+    {
+        var input = new byte[80];
+        BitConverter.GetBytes(i).CopyTo(input, 0);
+
+        return input;
+    }
+
+    [Fact]
+    public async Task Sequential_Requests_Are_Hashed_Inline()
+    {
+        var hasher = new FakeBatchHasher(Lanes, TimeSpan.Zero);
+        var dispatcher = new HashBatchDispatcher(hasher, TimeSpan.FromMilliseconds(100));
+
+        for(var i = 0; i < 10; i++)
+        {
+            var input = CreateInput(i);
+            var hash = new byte[32];
+
+            await dispatcher.DigestAsync(input, hash);
+
+            Assert.Equal(SHA256.HashData(input), hash);
+        }
+
+        Assert.Equal(10, dispatcher.Inline);
+        Assert.Equal(0, dispatcher.Batches);
+
+        // inline hashes take the scalar path
+        Assert.Equal(10, hasher.Singles);
+        Assert.Empty(hasher.Calls);
+    }
+
+    [Fact]
+    public async Task Concurrent_Requests_Are_Batched()
+    {
+        const int count = 64;
+
+        // slow calls make sure requests pile up behind the first one
+        var hasher = new FakeBatchHasher(Lanes, TimeSpan.FromMilliseconds(5));
+        var dispatcher = new HashBatchDispatcher(hasher, TimeSpan.FromMilliseconds(2));
+        var inputs = Enumerable.Range(0, count).Select(CreateInput).ToArray();
+        var hashes = inputs.Select(_ => new byte[32]).ToArray();
+
+        using var start = new Barrier(count);
+
+        await Task.WhenAll(Enumerable.Range(0, count).Select(i => Task.Factory.StartNew(() =>
+        {
+            start.SignalAndWait();
+            return dispatcher.DigestAsync(inputs[i], hashes[i]);
+        }, TaskCreationOptions.LongRunning).Unwrap()));
+
+        for(var i = 0; i < count; i++)
+            Assert.Equal(SHA256.HashData(inputs[i]), hashes[i]);
+
+        Assert.Equal(count, dispatcher.Inline + dispatcher.Batched);
+        Assert.True(dispatcher.Batches > 0);
+        Assert.True(hasher.Calls.Count + hasher.Singles < count);
+        Assert.Contains(hasher.Calls, x => x > 1);
+        Assert.All(hasher.Calls, x => Assert.True(x <= Lanes));
+    }
+
+    [Fact]
+    public async Task Batch_Failure_Faults_Every_Request()
+    {
+        var hasher = new FakeBatchHasher(Lanes, TimeSpan.FromMilliseconds(20));
+        var dispatcher = new HashBatchDispatcher(hasher, TimeSpan.FromMilliseconds(50));
+
+        // occupy the dispatcher so the next requests are queued
+        var first = Task.Run(() => dispatcher.DigestAsync(CreateInput(0), new byte[32]));
+        await Task.Delay(5);
+
+        hasher.Fail = true;
+
+        var queued = Enumerable.Range(1, Lanes)
+            .Select(i => Task.Run(() => dispatcher.DigestAsync(CreateInput(i), new byte[32])))
+            .ToArray();
+
+        foreach(var task in queued)
+            await Assert.ThrowsAsync<InvalidOperationException>(() => task);
+
+        await Assert.ThrowsAnyAsync<Exception>(() => first);
+        Assert.True(dispatcher.Batched > 0);
+    }
+
+    [Fact]
+    public void Synchronous_Digest_Does_Not_Wait_For_A_Batch()
+    {
+        var hasher = new FakeBatchHasher(Lanes, TimeSpan.Zero);
+        var wrapped = Assert.IsType<BatchingHashAlgorithm>(HashBatchDispatcher.Wrap(hasher, TimeSpan.FromSeconds(10)));
+        var input = CreateInput(1);
+        var hash = new byte[32];
+
+        wrapped.Digest(input, hash, 1UL, "extra");
+
+        // served by the wrapped algorithm, extra arguments included
+        Assert.Equal(SHA256.HashData(input), hash);
+        Assert.Equal(new object[] { 1UL, "extra" }, hasher.LastExtra);
+        Assert.Equal(1, hasher.Singles);
+        Assert.Equal(0, wrapped.Dispatcher.Inline + wrapped.Dispatcher.Batched);
+    }
+
+    [Fact]
+    public void Wrap_Leaves_Single_Lane_Algorithms_Alone()
+    {
+        var single = new FakeBatchHasher(1, TimeSpan.Zero);
+        var multi = new FakeBatchHasher(Lanes, TimeSpan.Zero);
+
+        Assert.Same(single, HashBatchDispatcher.Wrap(single, TimeSpan.FromMilliseconds(1)));
+
+        var wrapped = Assert.IsType<BatchingHashAlgorithm>(HashBatchDispatcher.Wrap(multi, TimeSpan.FromMilliseconds(1)));
+        var other = Assert.IsType<BatchingHashAlgorithm>(HashBatchDispatcher.Wrap(multi, TimeSpan.FromMilliseconds(1)));
+
+        // one dispatcher per algorithm instance, shared by all pools using it
+        Assert.Same(wrapped.Dispatcher, other.Dispatcher);
+    }
+}
@@ -1,6 +1,11 @@
 using System;
+using System.Collections.Generic;
+using System.IO;
 using System.Linq;
 using System.Text;
+using System.Threading.Tasks;
+using Miningcore.Configuration;
+using Miningcore.Crypto;
 using Miningcore.Crypto.Hashing.Algorithms;
 using Miningcore.Crypto.Hashing.Equihash;
 using Miningcore.Extensions;
@@ -104,6 +109,39 @@ public class HashingTests : TestBase
         Assert.Equal("b546d334422ff5fff98e8ba847a55bbc06271c64bb5e21107b1b225f6579d40a", result);
     }
 
+    [Fact]
+    public void Scrypt_Hash_Batch()
+    {
+        const int count = 21;
+
+        var hasher = new Scrypt(1024, 1);
+        var inputs = new byte[count * testValue2.Length];
+        var expected = new byte[count * 32];
+
+        for(var i = 0; i < count; i++)
+        {
+            // same 64-byte prefix, varying tail
+            testValue2.CopyTo(inputs, i * testValue2.Length);
+            inputs[i * testValue2.Length + 76] = (byte) i;
+
+            hasher.Digest(inputs.AsSpan(i * testValue2.Length, testValue2.Length), expected.AsSpan(i * 32, 32));
+        }
+
+        var hashes = new byte[count * 32];
+        hasher.DigestBatch(inputs, testValue2.Length, hashes, count);
+        Assert.Equal(expected.ToHexString(), hashes.ToHexString());
+
+        foreach(var lanes in new[] { 1, 4, 8, 16 })
+        {
+            var midstate = new uint[Scrypt.MidstateSize];
+            Scrypt.ComputeMidstate(inputs, midstate);
+
+            Array.Clear(hashes);
+            hasher.DigestBatch(inputs, testValue2.Length, hashes, count, midstate, lanes);
+            Assert.Equal(expected.ToHexString(), hashes.ToHexString());
+        }
+    }
+
     [Fact]
     public void NeoScrypt_Hash()
     {
@@ -115,6 +153,55 @@ public class HashingTests : TestBase
         Assert.Equal("7915d56de262bf23b1fb9104cf5d2a13fcbed2f6b4b9b657309c222b09f54bc0", result);
     }
 
+    [Fact]
+    public void NeoScrypt_Hash_Kernels()
+    {
+        const int count = 5;
+
+        var inputs = new byte[count * 80];
+
+        for(var i = 0; i < inputs.Length; i++)
+            inputs[i] = (byte) (i * 131 + 17);
+
+        foreach(var profile in new uint[] { 0, 1 })
+        {
+            var hasher = new NeoScrypt(profile);
+            var expected = new byte[count * 32];
+            hasher.DigestBatch(inputs, 80, expected, count, NeoScryptKernel.Scalar);
+
+            foreach(var kernel in new[] { NeoScryptKernel.Sse2, NeoScryptKernel.Avx2, NeoScryptKernel.Auto })
+            {
+                var hashes = new byte[count * 32];
+                hasher.DigestBatch(inputs, 80, hashes, count, kernel);
+
+                Assert.Equal(expected.ToHexString(), hashes.ToHexString());
+            }
+        }
+    }
+
+    [Theory]
+    [InlineData(typeof(Yespower), "e330d06eaa604800cc3ff1fdaf81b9f935546ec375f518aca8de69dd110b1d32")]
+    [InlineData(typeof(YespowerIC), "b17d97e654749632f103e0b6bcfa15ef84135d897eb158262a77ff768890f3d4")]
+    [InlineData(typeof(YespowerR16), "ea9c4f62e207e362e52f7b789044ca14f27fc8b7e8d89588f8d4272aea250b8d")]
+    [InlineData(typeof(YespowerTIDE), "d737dad5065fce7df8f61c1293d70d5f0e84a4bb0d309b260afaf6561c365c11")]
+    [InlineData(typeof(CpuPower), "fbf20fd443ce6f57b8f3edfefa43297c52a215034b758741c6f48e1959f00d12")]
+    [InlineData(typeof(Yescrypt), "78a826acfebd684e90bc6cbfdcd48ba99993d80b4e4a38ecc0a8eff52a465d06")]
+    [InlineData(typeof(YescryptR8), "78a826acfebd684e90bc6cbfdcd48ba99993d80b4e4a38ecc0a8eff52a465d06")]
+    [InlineData(typeof(YescryptR16), "a10d6793e512bf688ceca1da02ce7c22b98130d8e60ef54a606ca0ff27a61874")]
+    [InlineData(typeof(YescryptR32), "6e1e45e4057b76fb956031c6fb3372a07e08d794bde8cbeee7c690bbfda3dd57")]
+    public void Pwxform_Hash_Kernels(Type algorithm, string expected)
+    {
+        var hasher = (IHashAlgorithm) Activator.CreateInstance(algorithm);
+
+        foreach(var kernel in new[] { PwxformKernel.Scalar, PwxformKernel.Sse2, PwxformKernel.Avx, PwxformKernel.Xop, PwxformKernel.Auto })
+        {
+            var hash = new byte[32];
+            Pwxform.Digest(hasher, testValue2, hash, kernel);
+
+            Assert.Equal(expected, hash.ToHexString());
+        }
+    }
+
     [Fact]
     public void ScryptN_Hash()
     {
@@ -216,6 +303,84 @@ public class HashingTests : TestBase
         Assert.Equal("6b86ce4bf945d8e935d51db4e32589acf6dbcda58ca1cef7568d52f704c46d7f", result);
     }
 
+    [Fact]
+    public void Sha512256D_Hash_Kernels()
+    {
+        // tails that don't fill a vector and messages spanning two blocks
+        const int count = 11;
+
+        var hasher = new Sha512256D();
+
+        foreach(var inputLength in new[] { 32, 80, 120 })
+        {
+            var inputs = new byte[count * inputLength];
+
+            for(var i = 0; i < inputs.Length; i++)
+                inputs[i] = (byte) (i * 131 + 17);
+
+            var expected = new byte[count * 32];
+
+            for(var i = 0; i < count; i++)
+                hasher.Digest(inputs.AsSpan(i * inputLength, inputLength), expected.AsSpan(i * 32, 32));
+
+            foreach(var kernel in new[] { Sha512256DKernel.Scalar, Sha512256DKernel.Avx2, Sha512256DKernel.Avx512, Sha512256DKernel.Auto })
+            {
+                var hashes = new byte[count * 32];
+                hasher.DigestBatch(inputs, inputLength, hashes, count, kernel);
+
+                Assert.Equal(expected.ToHexString(), hashes.ToHexString());
+            }
+        }
+
+        var batch = new byte[32];
+        hasher.DigestBatch(testValue, testValue.Length, batch, 1);
+
+        Assert.Equal("6b86ce4bf945d8e935d51db4e32589acf6dbcda58ca1cef7568d52f704c46d7f", batch.ToHexString());
+    }
+
+    [Fact]
+    public void Verthash_Batch_Matches_Single()
+    {
+        // two full batches of 16 lanes and a partial one
+        const int count = 37;
+
+        // the data file is loaded once per process. Lookups work on a file of any size, so a small
+        // synthetic one is enough to compare both paths.
+        var dataFile = Path.GetTempFileName();
+        var data = new byte[1 << 20];
+        new Random(42).NextBytes(data);
+        File.WriteAllBytes(dataFile, data);
+
+        try
+        {
+            var hasher = new Verthash();
+
+            Assert.True(hasher.DigestInit(new PoolConfig { Extra = new Dictionary<string, object> { { "vertHashDataFile", dataFile } } }));
+
+            var inputs = new byte[count * 80];
+
+            for(var i = 0; i < inputs.Length; i++)
+                inputs[i] = (byte) (i * 131 + 17);
+
+            var expected = new byte[count * 32];
+
+            for(var i = 0; i < count; i++)
+                hasher.Digest(inputs.AsSpan(i * 80, 80), expected.AsSpan(i * 32, 32));
+
+            Assert.NotEqual(new byte[32], expected[..32]);
+
+            var hashes = new byte[count * 32];
+            hasher.DigestBatch(inputs, 80, hashes, count);
+
+            Assert.Equal(expected.ToHexString(), hashes.ToHexString());
+        }
+
+        finally
+        {
+            File.Delete(dataFile);
+        }
+    }
+
     [Fact]
     public void X11_Hash()
     {
@@ -493,6 +658,26 @@ public class HashingTests : TestBase
         Assert.False(result);
     }
 
+    [Fact]
+    public void EquihashVerifier_Should_Verify_Concurrently()
+    {
+        var hasher = new EquihashSolver_200_9("ZcashPoW");
+        var header = "0400000008e9694cc2120ec1b5733cc12687b609058eec4f7046a521ad1d1e3049b400003e7420ed6f40659de0305ef9b7ec037f4380ed9848bc1c015691c90aa16ff3930000000000000000000000000000000000000000000000000000000000000000c9310d5874e0001f000000000000000000000000000000010b000000000000000000000000000040".HexToByteArray();
+        var solution = "00b43863a213bfe79f00337f5a729f09710abcc07035ef8ac34372abddecf2f82715f7223f075af96f0604fc124d6151fc8fb516d24a137faec123a89aa9a433f8a25a6bcfc554c28be556f6c878f96539186fab191505f278df48bf1ad2240e5bb39f372a143de1dd1b672312e00d52a3dd83f471b0239a7e8b30d4b9153027df87c8cd0b64de76749539fea376b4f39d08cf3d5e821495e52fdfa6f8085e59fc670656121c9d7c01388c8b4b4585aa7b9ac3f7ae796f9eb1fadba1730a1860eed797feabb18832b5e8f003c0adaf0788d1016e7a8969144018ecc86140aa4553962aa739a4850b509b505e158c5f9e2d5376374652e9e6d81b19fa0351be229af136efbce681463cc53d7880c1eeca3411154474ff8a7b2bac034a2026646776a517bf63921c31fbbd6be7c3ff42aab28230bfe81d33800b892b262f3579b7a41925a59f5cc1d4f523577c19ff9f92023146fa26486595bd89a1ba459eb0b5cec0578c3a071dbec73eca054c723ab30ce8e69de32e779cd2f1030e39878ac6ea3cdca743b43aedefe1a9b4f2da861038e2759defef0b8cad11d4179f2f08881b53ccc203e558c0571e049d998a257b3279016aad0d7999b609f6331a0d0f88e286a70432ca7f50a5bb8fafbbe9230b4ccb1fa57361c163d6b9f84579d61f41585a022d07dc8e55a8de4d8f87641dae777819458a2bf1bb02c438480ff11621ca8442ec2946875cce247c8877051359e9c822670d37bb00fa806e60e8e890ce62540fda2d5b1c790ca1e005030ac6d8e63db577bb98be111ee146828f9c48ee6257d7627b93ea3dd11aac3412e63dfc7ca132a73c4f51e7650f3f8ecf57bfc18716990b492d50e0a3e5fbf6136e771b91f7283ec3326209265b9531d157f8a07a4117fc8fb29ba1363afc6f9f0608251ea595256727a5bbe28f42a42edfbfa9017680e32980d4ad381612612b2bc7ad91e82eca693ea4fc27049a99636b50a576f1e55c72202d582b150ef194c1419f53177ecf315ea6b0e2f1aa8cd8f59b165aa0d89561c537fb6141f5813b7a4968fe16afc703326113f68508d88ff8d0aee1e88a84c0ae56c72f27511290ced48e93e8c95419d14aed1a5b2e9b2c9c1070c593e5eb50bb9a80e14e9f9fe501f56b1b3140159e8213b75d48d14af472a604484cd8e7e7abb6820245ed3ab29f9947463a033c586194be45eadec8392c8614d83a1e9ca0fe5655fa14f7a9c1d1f8f2185a06193ff4a3c3e9a96b02310033ceaa25894e7c56a6147e691597098054e285d39656d3d459ec5d13243c062b6eb44e19a13bdfc0b3c96bd3d1aeb75bb6b080322aea23555993cb529243958bb1a0e5d5027e6c78155437242d1d13c1d6e442a0e3783147a08bbfc0c2529fb705ad27713df40486fd58f001977f25dfd3c202451c07010a3880bca63959ca61f10ed3871f1152166fce2b52135718a8ceb239a0664a31c62defaad70be4b920dce70549c10d9138fbbad7f291c5b73fa21c3889929b143bc1576b72f70667ac11052b686891085290d871db528b5cfdc10a6d563925227609f10d1768a0e02dc7471ad424f94f737d4e7eb0fb167f1434fc4ae2d49e152f06f0845b6db0a44f0d6f5e7410420e6bd1f430b1af956005bf72b51405a04d9a5d9906ceca52c22c855785c3c3ac4c3e9bf532d31bab321e1db66f6a9f7dc9c017f2b7d8dfeb933cf5bbae71311ae318f6d187ebc5c843be342b08a9a0ff7c4b9c4b0f4fa74b13296afe84b6481440d58332e07b3d051ed55219d28e77af6612134da4431b797c63ef55bc53831e2f421db620fee51ba0967e4ed7009ef90af2204259bbfbb54537fd35c2132fa8e7f9c84bf9938d248862c6ca1cca9f48b0b33aa1589185c4eabc1c32".HexToByteArray();
+        var invalid = solution.ToArray();
+        invalid[0] ^= 0x90;
+
+        var results = new bool[64];
+
+        Parallel.For(0, results.Length, i =>
+        {
+            results[i] = hasher.Verify(header, i % 2 == 0 ? solution : invalid);
+        });
+
+        for(var i = 0; i < results.Length; i++)
+            Assert.Equal(i % 2 == 0, results[i]);
+    }
+
     [Fact]
     public void EquihashVerifier_Should_Not_Verify_Fake_Solution()
     {
@@ -0,0 +1,49 @@
+using System;
+using System.Security.Cryptography;
+using Miningcore.Crypto;
+using Xunit;
+
+namespace Miningcore.Tests.Crypto;
+
+public class Sha256MidstateTests
+{
+    [Fact]
+    public void DigestDouble80_Matches_Sha256d()
+    {
+        var rnd = new Random(42);
+        var header = new byte[80];
+        var state = new uint[Sha256Midstate.StateSize];
+        var result = new byte[32];
+
+        for(var i = 0; i < 100; i++)
+        {
+            rnd.NextBytes(header);
+
+            Sha256Midstate.Compute(header, state);
+            Sha256Midstate.DigestDouble80(state, header.AsSpan(64), result);
+
+            Assert.Equal(SHA256.HashData(SHA256.HashData(header)), result);
+        }
+    }
+
+    [Fact]
+    public void Midstate_Is_Reusable_Across_Tails()
+    {
+        var header = new byte[80];
+        new Random(7).NextBytes(header);
+
+        var state = new uint[Sha256Midstate.StateSize];
+        Sha256Midstate.Compute(header, state);
+
+        var result = new byte[32];
+
+        for(uint nonce = 0; nonce < 16; nonce++)
+        {
+            BitConverter.TryWriteBytes(header.AsSpan(76), nonce);
+
+            Sha256Midstate.DigestDouble80(state, header.AsSpan(64), result);
+
+            Assert.Equal(SHA256.HashData(SHA256.HashData(header)), result);
+        }
+    }
+}
@@ -0,0 +1,96 @@
+using System.Linq;
+using System.Threading.Tasks;
+using Miningcore.Blockchain;
+using Miningcore.Mining;
+using Xunit;
+
+namespace Miningcore.Tests.Mining;
+
+public class MinerEffortTrackerTests
+{
+    private static Share CreateShare(string miner, double difficulty, bool isBlockCandidate = false)
+    {
+        return new Share
+        {
+            PoolId = "pool1",
+            Miner = miner,
+            Difficulty = difficulty,
+            NetworkDifficulty = 1000,
+            IsBlockCandidate = isBlockCandidate
+        };
+    }
+
+    [Fact]
+    public void Effort_Accumulates_Per_Miner()
+    {
+        var tracker = new MinerEffortTracker();
+
+        tracker.Record(CreateShare("miner1", 100));
+        tracker.Record(CreateShare("miner1", 150));
+        tracker.Record(CreateShare("miner2", 500));
+
+        Assert.Equal(0.25, tracker.GetEffort("miner1"), 10);
+        Assert.Equal(0.5, tracker.GetEffort("miner2"), 10);
+        Assert.Equal(0, tracker.GetEffort("miner3"));
+        Assert.Equal(0, tracker.GetEffort(null));
+    }
+
+    [Fact]
+    public void Block_Candidate_Share_Does_Not_Reset_Effort()
+    {
+        var tracker = new MinerEffortTracker();
+
+        tracker.Record(CreateShare("miner1", 100));
+        tracker.Record(CreateShare("miner2", 100));
+
+        // the daemon may still reject the block, only an accepted one ends the round
+        tracker.Record(CreateShare("miner2", 1000, true));
+
+        Assert.Equal(0.1, tracker.GetEffort("miner1"), 10);
+        Assert.Equal(0.1, tracker.GetEffort("miner2"), 10);
+    }
+
+    [Fact]
+    public void Reset_Starts_Over()
+    {
+        var tracker = new MinerEffortTracker();
+
+        tracker.Record(CreateShare("miner1", 100));
+        tracker.Record(CreateShare("miner2", 100));
+        tracker.Reset();
+
+        Assert.Equal(0, tracker.GetEffort("miner1"));
+        Assert.Equal(0, tracker.GetEffort("miner2"));
+        Assert.Equal(0, tracker.Count);
+
+        tracker.Record(CreateShare("miner1", 100));
+
+        Assert.Equal(0.1, tracker.GetEffort("miner1"), 10);
+    }
+
+    [Fact]
+    public void Shares_Without_Network_Difficulty_Are_Ignored()
+    {
+        var tracker = new MinerEffortTracker();
+        var share = CreateShare("miner1", 100);
+        share.NetworkDifficulty = 0;
+
+        tracker.Record(share);
+
+        Assert.Equal(0, tracker.GetEffort("miner1"));
+    }
+
+    [Fact]
+    public async Task Concurrent_Shares_Are_Not_Lost()
+    {
+        var tracker = new MinerEffortTracker();
+
+        await Task.WhenAll(Enumerable.Range(0, 8).Select(_ => Task.Run(() =>
+        {
+            for(var i = 0; i < 10000; i++)
+                tracker.Record(CreateShare("miner1", 1));
+        })));
+
+        Assert.Equal(80, tracker.GetEffort("miner1"), 6);
+    }
+}
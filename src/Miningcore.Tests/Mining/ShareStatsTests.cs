@@ -0,0 +1,84 @@
+using System;
+using System.Threading.Tasks;
+using Miningcore.Mining;
+using Xunit;
+
+namespace Miningcore.Tests.Mining;
+
+public class ShareStatsTests
+{
+    private static readonly DateTime now = new(2024, 1, 1, 0, 0, 0, DateTimeKind.Utc);
+
+    [Fact]
+    public void Counters_Track_Accepted_Rejected_And_Stale()
+    {
+        var stats = new ShareStats();
+
+        stats.RecordAccepted(16, now);
+        stats.RecordAccepted(32, now.AddSeconds(10));
+        stats.RecordRejected(true);
+        stats.RecordRejected(false);
+
+        Assert.Equal(new ShareCounters(2, 2, 1, 48, now.AddSeconds(10)), stats.Sample());
+        Assert.Equal(2, stats.ValidShares);
+        Assert.Equal(2, stats.InvalidShares);
+    }
+
+    [Fact]
+    public void Ban_Window_Reset_Keeps_Totals()
+    {
+        var stats = new ShareStats();
+
+        stats.RecordAccepted(1, now);
+        stats.RecordRejected(false);
+
+        stats.ValidShares = 0;
+        stats.InvalidShares = 0;
+
+        var counters = stats.Sample();
+        Assert.Equal(1, counters.Accepted);
+        Assert.Equal(1, counters.Rejected);
+    }
+
+    [Fact]
+    public void Closed_Connections_Are_Folded()
+    {
+        var closed = new ShareStats();
+        var a = new ShareStats();
+        var b = new ShareStats();
+
+        a.RecordAccepted(8, now.AddSeconds(5));
+        b.RecordAccepted(4, now);
+        b.RecordRejected(true);
+
+        closed.Add(a.Sample());
+        closed.Add(b.Sample());
+
+        Assert.Equal(new ShareCounters(2, 1, 1, 12, now.AddSeconds(5)), closed.Sample());
+        Assert.Equal(closed.Sample(), a.Sample() + b.Sample());
+    }
+
+    [Fact]
+    public void Concurrent_Updates_Are_Not_Lost()
+    {
+        var stats = new ShareStats();
+
+        Parallel.For(0, 8, _ =>
+        {
+            for(var i = 0; i < 100000; i++)
+            {
+                if(i % 10 == 0)
+                    stats.RecordRejected(i % 20 == 0);
+                else
+                    stats.RecordAccepted(0.5, now);
+            }
+        });
+
+        var counters = stats.Sample();
+
+        Assert.Equal(8 * 90000, counters.Accepted);
+        Assert.Equal(8 * 10000, counters.Rejected);
+        Assert.Equal(8 * 5000, counters.Stale);
+        Assert.Equal(8 * 90000 * 0.5, counters.AcceptedDifficulty);
+    }
+}
@@ -0,0 +1,140 @@
+using System;
+using System.Collections.Generic;
+using Miningcore.Native;
+using Miningcore.Tests.Util;
+using Xunit;
+
+namespace Miningcore.Tests.Native;
+
+public class NativeMemoryBudgetTests
+{
+    private const long MB = 1024 * 1024;
+
+    private static readonly TimeSpan CacheCost = TimeSpan.FromSeconds(2);
+    private static readonly TimeSpan DatasetCost = TimeSpan.FromSeconds(30);
+
+    private readonly MockMasterClock clock = new() { CurrentTime = new DateTime(2024, 1, 1, 0, 0, 0, DateTimeKind.Utc) };
+
+    [Fact]
+    public void Overlapping_Transitions_Stay_Within_Budget()
+    {
+        var budget = new NativeMemoryBudget(1000 * MB, clock);
+        var evicted = new List<string>();
+
+        // ethash epoch 10 and RandomX seed A back current work
+        var epoch10 = budget.Register("Ethash", "epoch 10", 100 * MB, NativeMemoryPriority.Active, CacheCost, () => evicted.Add("epoch 10"));
+        var seedA = budget.Register("RandomX", "A", 600 * MB, NativeMemoryPriority.Active, DatasetCost, () => evicted.Add("A"));
+
+        // pre-building the next epoch fits
+        var epoch11 = budget.TryAdmit("Ethash", "epoch 11", 100 * MB, CacheCost, () => evicted.Add("epoch 11"));
+        Assert.NotNull(epoch11);
+
+        // pre-building the next seed doesn't, and must not displace anything
+        Assert.Null(budget.TryAdmit("RandomX", "B", 600 * MB, DatasetCost, () => evicted.Add("B")));
+        Assert.Empty(evicted);
+        Assert.Equal(800 * MB, budget.Used);
+
+        // epoch transition: 11 becomes current, 10 is retained for late shares, 12 gets pre-built
+        clock.CurrentTime += TimeSpan.FromSeconds(30);
+        epoch11.SetPriority(NativeMemoryPriority.Active);
+        epoch10.SetPriority(NativeMemoryPriority.Cache);
+
+        var epoch12 = budget.TryAdmit("Ethash", "epoch 12", 100 * MB, CacheCost, () => evicted.Add("epoch 12"));
+        Assert.NotNull(epoch12);
+        Assert.Equal(900 * MB, budget.Used);
+
+        // seed transition overlapping with the old seed: everything evictable goes, pre-builds first
+        clock.CurrentTime += TimeSpan.FromSeconds(60);
+        var seedB = budget.Register("RandomX", "B", 600 * MB, NativeMemoryPriority.Active, DatasetCost);
+
+        Assert.Equal(new[] { "epoch 12", "epoch 10" }, evicted);
+        Assert.True(epoch12.IsEvicted);
+        Assert.True(epoch10.IsEvicted);
+        Assert.False(epoch11.IsEvicted);
+        Assert.False(seedA.IsEvicted);
+
+        // current work is admitted even beyond the budget
+        Assert.Equal(1300 * MB, budget.Used);
+
+        var usage = budget.GetUsage();
+        Assert.Equal(100 * MB, usage["Ethash"]);
+        Assert.Equal(1200 * MB, usage["RandomX"]);
+
+        // the old seed is retired by its owner, which doesn't count as an eviction
+        seedA.Dispose();
+
+        Assert.Equal(700 * MB, budget.Used);
+        Assert.Equal(600 * MB, budget.GetUsage()["RandomX"]);
+        Assert.DoesNotContain("A", evicted);
+        Assert.False(seedB.IsEvicted);
+    }
+
+    [Fact]
+    public void Eviction_Is_Weighted_By_Rebuild_Cost()
+    {
+        var budget = new NativeMemoryBudget(300 * MB, clock);
+        var evicted = new List<string>();
+
+        var dataset = budget.Register("RandomX", "old", 100 * MB, NativeMemoryPriority.Cache, DatasetCost, () => evicted.Add("dataset"));
+
+        clock.CurrentTime += TimeSpan.FromSeconds(50);
+        budget.Register("Ethash", "epoch 1", 100 * MB, NativeMemoryPriority.Cache, CacheCost, () => evicted.Add("cache"));
+
+        // the dataset has been idle longer (60s vs 10s) but is 15 times as expensive to rebuild
+        clock.CurrentTime += TimeSpan.FromSeconds(10);
+        budget.Register("Ethash", "epoch 2", 150 * MB, NativeMemoryPriority.Active, CacheCost);
+
+        Assert.Equal(new[] { "cache" }, evicted);
+        Assert.False(dataset.IsEvicted);
+
+        // touching entries changes the order
+        clock.CurrentTime += TimeSpan.FromSeconds(1000);
+        dataset.Touch();
+        budget.Register("Ethash", "epoch 0", 50 * MB, NativeMemoryPriority.Cache, CacheCost, () => evicted.Add("epoch 0"));
+
+        clock.CurrentTime += TimeSpan.FromSeconds(10);
+        budget.Register("Ethash", "epoch 3", 100 * MB, NativeMemoryPriority.Active, CacheCost);
+
+        Assert.Equal(new[] { "cache", "epoch 0", "dataset" }, evicted);
+    }
+
+    [Fact]
+    public void Prefetch_Only_Displaces_Retained_Caches()
+    {
+        var budget = new NativeMemoryBudget(300 * MB, clock);
+        var evicted = new List<string>();
+
+        budget.Register("Ethash", "epoch 1", 100 * MB, NativeMemoryPriority.Active, CacheCost);
+        budget.Register("Ethash", "epoch 0", 100 * MB, NativeMemoryPriority.Cache, CacheCost, () => evicted.Add("epoch 0"));
+        budget.TryAdmit("Kawpow", "epoch 5", 100 * MB, CacheCost, () => evicted.Add("epoch 5"));
+
+        // another pre-build doesn't fit without evicting the first one
+        Assert.Null(budget.TryAdmit("Ethash", "epoch 2", 150 * MB, CacheCost));
+
+        // but may replace the retained cache
+        Assert.NotNull(budget.TryAdmit("Ethash", "epoch 2", 100 * MB, CacheCost));
+        Assert.Equal(new[] { "epoch 0" }, evicted);
+        Assert.Equal(300 * MB, budget.Used);
+    }
+
+    [Fact]
+    public void Unlimited_Budget_Never_Evicts()
+    {
+        var budget = new NativeMemoryBudget(0, clock);
+        var evicted = false;
+
+        budget.Register("RandomX", "A", 100_000 * MB, NativeMemoryPriority.Cache, DatasetCost, () => evicted = true);
+
+        Assert.NotNull(budget.TryAdmit("RandomX", "B", 100_000 * MB, DatasetCost));
+        Assert.False(evicted);
+        Assert.Equal(200_000 * MB, budget.Used);
+    }
+
+    [Fact]
+    public void Register_Rejects_Prefetch_Priority()
+    {
+        var budget = new NativeMemoryBudget(0, clock);
+
+        Assert.Throws<ArgumentException>(() => budget.Register("Ethash", "epoch 1", MB, NativeMemoryPriority.Prefetch, CacheCost));
+    }
+}
@@ -0,0 +1,162 @@
+using System;
+using System.Data;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using Miningcore.Extensions;
+using Miningcore.Persistence;
+using Miningcore.Tests.Util;
+using NSubstitute;
+using Xunit;
+
+namespace Miningcore.Tests.Persistence;
+
+public class ReplicaRoutingConnectionFactoryTests
+{
+    private static readonly TimeSpan maxLag = TimeSpan.FromSeconds(1);
+    private static readonly TimeSpan maxStaleness = TimeSpan.FromSeconds(30);
+    private static readonly TimeSpan probeInterval = TimeSpan.FromSeconds(5);
+
+    private class FakeConnectionFactory : IConnectionFactory
+    {
+        public FakeConnectionFactory(string name)
+        {
+            Name = name;
+        }
+
+        public string Name { get; }
+        public int Opened { get; private set; }
+        public bool Fail { get; set; }
+
+        // replication lag reported by connections handed out by this factory
+        public TimeSpan Lag { get; set; }
+
+        public Task<IDbConnection> OpenConnectionAsync(ConnectionIntent intent = ConnectionIntent.Write)
+        {
+            if(Fail)
+                throw new InvalidOperationException($"{Name} is down");
+
+            Opened++;
+
+            var con = Substitute.For<IDbConnection>();
+            con.Database.Returns(Name);
+
+            return Task.FromResult(con);
+        }
+    }
+
+    private static (ReplicaRoutingConnectionFactory, FakeConnectionFactory, FakeConnectionFactory[], MockMasterClock) Create(int replicaCount)
+    {
+        var primary = new FakeConnectionFactory("primary");
+        var replicas = new FakeConnectionFactory[replicaCount];
+
+        for(var i = 0; i < replicaCount; i++)
+            replicas[i] = new FakeConnectionFactory($"replica{i}");
+
+        var byName = replicas.ToDictionary(x => x.Name);
+
+        // the fake probe reports whatever lag the factory that opened the connection is configured with
+        Task<TimeSpan> ProbeLag(IDbConnection con, CancellationToken ct) => Task.FromResult(byName[con.Database].Lag);
+
+        var clock = new MockMasterClock { CurrentTime = new DateTime(2024, 1, 1, 0, 0, 0, DateTimeKind.Utc) };
+        var cf = new ReplicaRoutingConnectionFactory(primary, replicas, ProbeLag, clock, maxLag, maxStaleness, probeInterval);
+
+        return (cf, primary, replicas, clock);
+    }
+
+    private static Task<string> Target(IConnectionFactory cf, ConnectionIntent intent)
+    {
+        return cf.Run(intent, con => Task.FromResult(con.Database));
+    }
+
+    [Fact]
+    public async Task Writes_Always_Go_To_Primary()
+    {
+        var (cf, primary, replicas, _) = Create(2);
+
+        Assert.Equal("primary", await Target(cf, ConnectionIntent.Write));
+        Assert.Equal("primary", (await cf.OpenConnectionAsync()).Database);
+
+        await cf.RunTx((con, tx) => Task.CompletedTask);
+
+        Assert.Equal(3, primary.Opened);
+        Assert.All(replicas, x => Assert.Equal(0, x.Opened));
+    }
+
+    [Fact]
+    public async Task Reads_Go_To_Replica_Within_Bound()
+    {
+        var (cf, primary, _, _) = Create(1);
+
+        Assert.Equal("replica0", await Target(cf, ConnectionIntent.ReadStale));
+        Assert.Equal("replica0", await Target(cf, ConnectionIntent.Read));
+        Assert.Equal(0, primary.Opened);
+    }
+
+    [Fact]
+    public async Task Lagging_Replica_Serves_Stale_Reads_Only()
+    {
+        var (cf, _, replicas, _) = Create(1);
+        replicas[0].Lag = TimeSpan.FromSeconds(10);
+
+        Assert.Equal("primary", await Target(cf, ConnectionIntent.Read));
+        Assert.Equal("replica0", await Target(cf, ConnectionIntent.ReadStale));
+    }
+
+    [Fact]
+    public async Task Replica_Beyond_Staleness_Is_Skipped_Until_It_Catches_Up()
+    {
+        var (cf, _, replicas, clock) = Create(1);
+        replicas[0].Lag = TimeSpan.FromMinutes(5);
+
+        Assert.Equal("primary", await Target(cf, ConnectionIntent.ReadStale));
+
+        // replica is not even contacted again before the next probe is due
+        var opened = replicas[0].Opened;
+        replicas[0].Lag = TimeSpan.Zero;
+        Assert.Equal("primary", await Target(cf, ConnectionIntent.ReadStale));
+        Assert.Equal(opened, replicas[0].Opened);
+
+        clock.CurrentTime += probeInterval;
+        Assert.Equal("replica0", await Target(cf, ConnectionIntent.ReadStale));
+    }
+
+    [Fact]
+    public async Task Unreachable_Replica_Falls_Back_To_Primary()
+    {
+        var (cf, _, replicas, clock) = Create(1);
+        replicas[0].Fail = true;
+
+        Assert.Equal("primary", await Target(cf, ConnectionIntent.ReadStale));
+
+        replicas[0].Fail = false;
+        Assert.Equal("primary", await Target(cf, ConnectionIntent.ReadStale));
+
+        clock.CurrentTime += probeInterval;
+        Assert.Equal("replica0", await Target(cf, ConnectionIntent.ReadStale));
+    }
+
+    [Fact]
+    public async Task Reads_Are_Spread_Across_Healthy_Replicas()
+    {
+        var (cf, primary, replicas, _) = Create(3);
+        replicas[1].Lag = TimeSpan.FromMinutes(5);
+
+        for(var i = 0; i < 12; i++)
+            Assert.NotEqual("replica1", await Target(cf, ConnectionIntent.ReadStale));
+
+        Assert.Equal(0, primary.Opened);
+        Assert.True(replicas[0].Opened >= 4);
+        Assert.True(replicas[2].Opened >= 4);
+    }
+
+    [Fact]
+    public async Task No_Replicas_Routes_Everything_To_Primary()
+    {
+        var (cf, primary, _, _) = Create(0);
+
+        Assert.Equal("primary", await Target(cf, ConnectionIntent.Read));
+        Assert.Equal("primary", await Target(cf, ConnectionIntent.ReadStale));
+        Assert.Equal(2, primary.Opened);
+    }
+}
@@ -0,0 +1,275 @@
+using System;
+using System.Collections.Concurrent;
+using System.IO;
+using System.Linq;
+using System.Net;
+using System.Net.Sockets;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using Autofac;
+using Miningcore.Configuration;
+using Miningcore.Messaging;
+using Miningcore.Rpc;
+using Miningcore.Tests.Util;
+using Newtonsoft.Json.Linq;
+using NLog;
+using Xunit;
+
+namespace Miningcore.Tests.Rpc;
+
+public class RpcRequestCoalescerTests : TestBase
+{
+    private const int PoolCount = 8;
+
+    private static readonly ILogger logger = new NullLogger(LogManager.LogFactory);
+
+    /// <summary>
+    /// Minimal JSON-RPC daemon counting requests per method
+    /// </summary>
+    private class FakeDaemon : IDisposable
+    {
+        public FakeDaemon(TimeSpan latency)
+        {
+            this.latency = latency;
+
+            var listener = new TcpListener(IPAddress.Loopback, 0);
+            listener.Start();
+            Port = ((IPEndPoint) listener.LocalEndpoint).Port;
+            listener.Stop();
+
+            http.Prefixes.Add($"http://127.0.0.1:{Port}/");
+            http.Start();
+
+            Task.Run(ServeAsync);
+        }
+
+        private readonly HttpListener http = new();
+        private readonly TimeSpan latency;
+        private readonly ConcurrentDictionary<string, int> calls = new();
+        private int height;
+
+        public int Port { get; }
+
+        public int Calls(string method) => calls.TryGetValue(method, out var count) ? count : 0;
+
+        public void Dispose()
+        {
+            http.Close();
+        }
+
+        private async Task ServeAsync()
+        {
+            while(http.IsListening)
+            {
+                HttpListenerContext ctx;
+
+                try
+                {
+                    ctx = await http.GetContextAsync();
+                }
+
+                catch(Exception)
+                {
+                    break;
+                }
+
+                _ = Task.Run(() => RespondAsync(ctx));
+            }
+        }
+
+        private async Task RespondAsync(HttpListenerContext ctx)
+        {
+            using var reader = new StreamReader(ctx.Request.InputStream, Encoding.UTF8);
+            var request = JObject.Parse(await reader.ReadToEndAsync());
+            var method = request["method"]!.Value<string>();
+
+            calls.AddOrUpdate(method, 1, (_, count) => count + 1);
+
+            await Task.Delay(latency);
+
+            var response = new JObject
+            {
+                ["result"] = new JObject { ["height"] = Interlocked.Increment(ref height) },
+                ["error"] = null,
+                ["id"] = request["id"]
+            };
+
+            var data = Encoding.UTF8.GetBytes(response.ToString());
+            ctx.Response.ContentType = "application/json";
+            ctx.Response.ContentLength64 = data.Length;
+
+            await ctx.Response.OutputStream.WriteAsync(data);
+            ctx.Response.Close();
+        }
+    }
+
+    private RpcClient[] CreatePools(FakeDaemon daemon, RpcRequestCoalescer coalescer)
+    {
+        var endpoint = new DaemonEndpointConfig { Host = "127.0.0.1", Port = daemon.Port };
+        var messageBus = container.Resolve<IMessageBus>();
+
+        return Enumerable.Range(0, PoolCount)
+            .Select(i => new RpcClient(endpoint, jsonSerializerSettings, messageBus, $"pool{i}") { Coalescer = coalescer })
+            .ToArray();
+    }
+
+    private static async Task<int[]> GetHeightsAsync(RpcClient[] pools, string method, object payload = null)
+    {
+        var responses = await Task.WhenAll(pools.Select(x => x.ExecuteAsync<JToken>(logger, method, CancellationToken.None, payload)));
+
+        Assert.All(responses, x => Assert.Null(x.Error));
+
+        return responses.Select(x => x.Response["height"]!.Value<int>()).ToArray();
+    }
+
+    [Fact]
+    public async Task Concurrent_Template_Requests_Share_One_Daemon_Call()
+    {
+        using var daemon = new FakeDaemon(TimeSpan.FromMilliseconds(200));
+        var clock = MockMasterClock.FromTicks(new DateTime(2024, 1, 1, 0, 0, 0, DateTimeKind.Utc).Ticks);
+        var pools = CreatePools(daemon, new RpcRequestCoalescer(clock));
+
+        var heights = await GetHeightsAsync(pools, "getblocktemplate", new { rules = new[] { "segwit" } });
+
+        Assert.Equal(1, daemon.Calls("getblocktemplate"));
+        Assert.All(heights, x => Assert.Equal(heights[0], x));
+
+        // templates are reused for half a second at most
+        await GetHeightsAsync(pools, "getblocktemplate", new { rules = new[] { "segwit" } });
+
+        Assert.Equal(1, daemon.Calls("getblocktemplate"));
+
+        clock.CurrentTime += TimeSpan.FromSeconds(1);
+
+        await GetHeightsAsync(pools, "getblocktemplate", new { rules = new[] { "segwit" } });
+
+        Assert.Equal(2, daemon.Calls("getblocktemplate"));
+    }
+
+    [Fact]
+    public async Task Different_Template_Parameters_Are_Not_Shared()
+    {
+        using var daemon = new FakeDaemon(TimeSpan.FromMilliseconds(200));
+        var pools = CreatePools(daemon, new RpcRequestCoalescer());
+
+        await Task.WhenAll(pools.Select((x, i) => x.ExecuteAsync<JToken>(logger, "getblocktemplate", CancellationToken.None,
+            new { rules = new[] { "segwit" }, capabilities = new[] { i % 2 == 0 ? "coinbasetxn" : "proposal" } })));
+
+        Assert.Equal(2, daemon.Calls("getblocktemplate"));
+    }
+
+    [Fact]
+    public async Task Read_Requests_Are_Cached_Briefly()
+    {
+        using var daemon = new FakeDaemon(TimeSpan.FromMilliseconds(10));
+        var clock = MockMasterClock.FromTicks(new DateTime(2024, 1, 1, 0, 0, 0, DateTimeKind.Utc).Ticks);
+        var coalescer = new RpcRequestCoalescer(clock);
+        var pools = CreatePools(daemon, coalescer);
+
+        foreach(var pool in pools)
+        {
+            await pool.ExecuteAsync<JToken>(logger, "getblockchaininfo", CancellationToken.None);
+            await pool.ExecuteAsync<JToken>(logger, "getnetworkinfo", CancellationToken.None);
+        }
+
+        Assert.Equal(1, daemon.Calls("getblockchaininfo"));
+        Assert.Equal(1, daemon.Calls("getnetworkinfo"));
+        Assert.Equal(PoolCount * 2, coalescer.Requests);
+        Assert.Equal((PoolCount - 1) * 2, coalescer.Coalesced);
+
+        clock.CurrentTime += TimeSpan.FromSeconds(2);
+
+        await GetHeightsAsync(pools, "getblockchaininfo");
+
+        Assert.Equal(2, daemon.Calls("getblockchaininfo"));
+    }
+
+    [Fact]
+    public async Task Block_Notification_Forces_Fresh_Template()
+    {
+        using var daemon = new FakeDaemon(TimeSpan.FromMilliseconds(300));
+        var pools = CreatePools(daemon, new RpcRequestCoalescer());
+
+        // a poll is in flight when the block arrives
+        var stale = pools[0].ExecuteAsync<JToken>(logger, "getblocktemplate", CancellationToken.None);
+        await Task.Delay(50);
+
+        // every pool sees the notification, the first one invalidates
+        foreach(var pool in pools)
+            pool.InvalidateSharedRequests("00000000000000000001");
+
+        var heights = await GetHeightsAsync(pools, "getblocktemplate");
+        var staleHeight = (await stale).Response["height"]!.Value<int>();
+
+        Assert.Equal(2, daemon.Calls("getblocktemplate"));
+        Assert.All(heights, x => Assert.NotEqual(staleHeight, x));
+        Assert.All(heights, x => Assert.Equal(heights[0], x));
+    }
+
+    [Fact]
+    public async Task Block_Notification_Drops_Cached_Template()
+    {
+        using var daemon = new FakeDaemon(TimeSpan.FromMilliseconds(10));
+        var clock = MockMasterClock.FromTicks(new DateTime(2024, 1, 1, 0, 0, 0, DateTimeKind.Utc).Ticks);
+        var pools = CreatePools(daemon, new RpcRequestCoalescer(clock));
+
+        var before = await GetHeightsAsync(pools, "getblocktemplate");
+
+        clock.CurrentTime += TimeSpan.FromMilliseconds(100);
+        pools[0].InvalidateSharedRequests("00000000000000000001");
+        clock.CurrentTime += TimeSpan.FromMilliseconds(100);
+
+        var after = await GetHeightsAsync(pools, "getblocktemplate");
+
+        Assert.Equal(2, daemon.Calls("getblocktemplate"));
+        Assert.All(after, x => Assert.NotEqual(before[0], x));
+    }
+
+    [Fact]
+    public async Task Other_Methods_Are_Not_Shared()
+    {
+        using var daemon = new FakeDaemon(TimeSpan.FromMilliseconds(100));
+        var pools = CreatePools(daemon, new RpcRequestCoalescer());
+
+        await GetHeightsAsync(pools, "submitblock", new[] { "00" });
+
+        Assert.Equal(PoolCount, daemon.Calls("submitblock"));
+    }
+
+    [Fact]
+    public async Task Sharing_Can_Be_Disabled()
+    {
+        using var daemon = new FakeDaemon(TimeSpan.FromMilliseconds(100));
+        var pools = CreatePools(daemon, null);
+
+        await GetHeightsAsync(pools, "getblocktemplate");
+
+        Assert.Equal(PoolCount, daemon.Calls("getblocktemplate"));
+    }
+
+    [Fact]
+    public void Sharing_Is_Opt_In()
+    {
+        var endpoint = new DaemonEndpointConfig { Host = "127.0.0.1", Port = 8332 };
+        var rpc = new RpcClient(endpoint, jsonSerializerSettings, container.Resolve<IMessageBus>(), "pool1");
+
+        Assert.Null(rpc.Coalescer);
+    }
+
+    [Fact]
+    public async Task Cancelled_Caller_Does_Not_Cancel_Shared_Request()
+    {
+        using var daemon = new FakeDaemon(TimeSpan.FromMilliseconds(200));
+        var pools = CreatePools(daemon, new RpcRequestCoalescer());
+
+        using var cts = new CancellationTokenSource(TimeSpan.FromMilliseconds(50));
+
+        var cancelled = pools[0].ExecuteAsync<JToken>(logger, "getblocktemplate", cts.Token);
+        var other = pools[1].ExecuteAsync<JToken>(logger, "getblocktemplate", CancellationToken.None);
+
+        Assert.NotNull((await cancelled).Error);
+        Assert.Null((await other).Error);
+        Assert.Equal(1, daemon.Calls("getblocktemplate"));
+    }
+}
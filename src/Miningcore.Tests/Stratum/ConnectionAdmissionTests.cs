@@ -0,0 +1,338 @@
+using System;
+using System.IO;
+using System.Linq;
+using System.Net;
+using System.Net.Sockets;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using Autofac;
+using Microsoft.IO;
+using Miningcore.Banning;
+using Miningcore.Configuration;
+using Miningcore.JsonRpc;
+using Miningcore.Messaging;
+using Miningcore.Mining;
+using Miningcore.Stratum;
+using Miningcore.Time;
+using Newtonsoft.Json.Linq;
+using NLog;
+using Xunit;
+
+namespace Miningcore.Tests.Stratum;
+
+public class ConnectionAdmissionTests : TestBase
+{
+    private static readonly TimeSpan timeout = TimeSpan.FromSeconds(10);
+
+    [Fact]
+    public void Burst_Then_Rate_Limited()
+    {
+        var admission = new ConnectionAdmission(new StratumAdmissionConfig { ConnectRate = 0.001, ConnectBurst = 3 });
+        var address = IPAddress.Parse("10.0.0.1");
+
+        for(var i = 0; i < 3; i++)
+            Assert.Equal(AdmissionResult.Accepted, admission.TryAdmit(address));
+
+        Assert.Equal(AdmissionResult.AddressRate, admission.TryAdmit(address));
+
+        // other addresses have their own bucket
+        Assert.Equal(AdmissionResult.Accepted, admission.TryAdmit(IPAddress.Parse("10.0.0.2")));
+    }
+
+    [Fact]
+    public void Prefix_Rate_Limited()
+    {
+        var admission = new ConnectionAdmission(new StratumAdmissionConfig { PrefixConnectRate = 0.001, PrefixConnectBurst = 2 });
+
+        Assert.Equal(AdmissionResult.Accepted, admission.TryAdmit(IPAddress.Parse("10.0.0.1")));
+        Assert.Equal(AdmissionResult.Accepted, admission.TryAdmit(IPAddress.Parse("10.0.0.2")));
+        Assert.Equal(AdmissionResult.PrefixRate, admission.TryAdmit(IPAddress.Parse("10.0.0.3")));
+        Assert.Equal(AdmissionResult.Accepted, admission.TryAdmit(IPAddress.Parse("10.0.1.1")));
+    }
+
+    [Fact]
+    public void Address_Limit_Until_Released()
+    {
+        var admission = new ConnectionAdmission(new StratumAdmissionConfig { MaxConnectionsPerAddress = 2 });
+        var address = IPAddress.Parse("10.0.0.1");
+
+        Assert.Equal(AdmissionResult.Accepted, admission.TryAdmit(address));
+        Assert.Equal(AdmissionResult.Accepted, admission.TryAdmit(address));
+        Assert.Equal(AdmissionResult.AddressLimit, admission.TryAdmit(address));
+
+        admission.Release(address);
+
+        Assert.Equal(AdmissionResult.Accepted, admission.TryAdmit(address));
+    }
+
+    [Fact]
+    public void Limited_Connections_Do_Not_Spend_Tokens()
+    {
+        var admission = new ConnectionAdmission(new StratumAdmissionConfig { MaxConnectionsPerAddress = 1, ConnectRate = 0.001, ConnectBurst = 2 });
+        var address = IPAddress.Parse("10.0.0.1");
+
+        Assert.Equal(AdmissionResult.Accepted, admission.TryAdmit(address));
+
+        for(var i = 0; i < 10; i++)
+            Assert.Equal(AdmissionResult.AddressLimit, admission.TryAdmit(address));
+
+        admission.Release(address);
+
+        Assert.Equal(AdmissionResult.Accepted, admission.TryAdmit(address));
+    }
+
+    [Theory]
+    [InlineData("10.0.0.1", "10.0.0.254", "10.0.1.1")]
+    [InlineData("2001:db8::1", "2001:db8::ffff:1", "2001:db8:0:1::1")]
+    public void Prefix_Limit(string first, string samePrefix, string otherPrefix)
+    {
+        var admission = new ConnectionAdmission(new StratumAdmissionConfig { MaxConnectionsPerPrefix = 1 });
+
+        Assert.Equal(AdmissionResult.Accepted, admission.TryAdmit(IPAddress.Parse(first)));
+        Assert.Equal(AdmissionResult.PrefixLimit, admission.TryAdmit(IPAddress.Parse(samePrefix)));
+        Assert.Equal(AdmissionResult.Accepted, admission.TryAdmit(IPAddress.Parse(otherPrefix)));
+    }
+
+    [Fact]
+    public void IPv4_Mapped_Counts_As_IPv4()
+    {
+        var admission = new ConnectionAdmission(new StratumAdmissionConfig { MaxConnectionsPerAddress = 1 });
+
+        Assert.Equal(AdmissionResult.Accepted, admission.TryAdmit(IPAddress.Parse("10.0.0.1")));
+        Assert.Equal(AdmissionResult.AddressLimit, admission.TryAdmit(IPAddress.Parse("::ffff:10.0.0.1")));
+    }
+
+    [Fact]
+    public void Acquire_Counts_Against_Limit()
+    {
+        var admission = new ConnectionAdmission(new StratumAdmissionConfig { MaxConnectionsPerAddress = 1 });
+        var address = IPAddress.Parse("10.0.0.1");
+
+        admission.Acquire(address);
+        admission.Acquire(address);
+
+        Assert.Equal(AdmissionResult.AddressLimit, admission.TryAdmit(address));
+
+        admission.Release(address);
+        admission.Release(address);
+
+        Assert.Equal(AdmissionResult.Accepted, admission.TryAdmit(address));
+    }
+
+    [Fact]
+    public void Prune_Keeps_Open_Connections()
+    {
+        var admission = new ConnectionAdmission(new StratumAdmissionConfig { MaxConnectionsPerAddress = 1 });
+        var open = IPAddress.Parse("10.0.0.1");
+        var closed = IPAddress.Parse("10.0.1.1");
+
+        admission.TryAdmit(open);
+        admission.TryAdmit(closed);
+        admission.Release(closed);
+
+        Assert.Equal(4, admission.Count);
+        Assert.Equal(2, admission.Prune());
+        Assert.Equal(2, admission.Count);
+
+        Assert.Equal(AdmissionResult.AddressLimit, admission.TryAdmit(open));
+        Assert.Equal(AdmissionResult.Accepted, admission.TryAdmit(closed));
+    }
+
+    [Fact]
+    public void Counters()
+    {
+        var admission = new ConnectionAdmission(new StratumAdmissionConfig { MaxConnectionsPerAddress = 1, MaxConnectionsPerPrefix = 2 });
+
+        admission.TryAdmit(IPAddress.Parse("10.0.0.1"));
+        admission.TryAdmit(IPAddress.Parse("10.0.0.1"));
+        admission.TryAdmit(IPAddress.Parse("10.0.0.2"));
+        admission.TryAdmit(IPAddress.Parse("10.0.0.3"));
+
+        Assert.Equal(new AdmissionCounters(2, 0, 0, 1, 1), admission.GetCounters());
+    }
+
+    private class TestServer : StratumServer
+    {
+        public TestServer(IComponentContext ctx, StratumAdmissionConfig admission) :
+            base(ctx, ctx.Resolve<IMessageBus>(), ctx.Resolve<RecyclableMemoryStreamManager>(), ctx.Resolve<IMasterClock>())
+        {
+            logger = new NullLogger(LogManager.LogFactory);
+            clusterConfig = new ClusterConfig { Logging = new ClusterLoggingConfig() };
+            poolConfig = new PoolConfig { Id = "pool1", Admission = admission };
+        }
+
+        public IBanManager BanManager
+        {
+            set => banManager = value;
+        }
+
+        public Task RunAsync(StratumEndpoint endpoint, CancellationToken ct)
+        {
+            return RunAsync(ct, endpoint);
+        }
+
+        protected override void OnConnect(StratumConnection connection, IPEndPoint ipEndPoint)
+        {
+            var context = new WorkerContextBase();
+            context.Init(1000, null, clock);
+
+            connection.SetContext(context);
+        }
+
+        protected override Task OnRequestAsync(StratumConnection connection, Timestamped<JsonRpcRequest> tsRequest, CancellationToken ct)
+        {
+            return connection.RespondAsync(true, tsRequest.Value.Id);
+        }
+    }
+
+    /// <summary>
+    /// Fails the first lookup, as a broken ban list would
+    /// </summary>
+    private class FailingBanManager : IBanManager
+    {
+        private int lookups;
+
+        public int Lookups => lookups;
+
+        public bool IsBanned(IPAddress address)
+        {
+            if(Interlocked.Increment(ref lookups) == 1)
+                throw new InvalidOperationException("ban list unavailable");
+
+            return false;
+        }
+
+        public void Ban(IPAddress address, TimeSpan duration)
+        {
+        }
+    }
+
+    private static async Task<TcpClient> ConnectAsync(IPAddress from, int port)
+    {
+        var tcp = new TcpClient(new IPEndPoint(from, 0));
+        await tcp.ConnectAsync(IPAddress.Loopback, port);
+
+        return tcp;
+    }
+
+    [Fact]
+    public async Task Honest_Clients_Get_Through_Connect_Flood()
+    {
+        const int FloodCount = 200;
+
+        var listener = new TcpListener(IPAddress.Loopback, 0);
+        listener.Start();
+        var port = ((IPEndPoint) listener.LocalEndpoint).Port;
+        listener.Stop();
+
+        var endpoint = new StratumEndpoint(new IPEndPoint(IPAddress.Loopback, port), new PoolEndpoint { Difficulty = 1000 });
+
+        var server = new TestServer(container, new StratumAdmissionConfig
+        {
+            ConnectRate = 1,
+            ConnectBurst = 5,
+            PrefixConnectRate = 5,
+            PrefixConnectBurst = 20,
+            MaxConnectionsPerAddress = 10,
+        });
+
+        using var cts = new CancellationTokenSource();
+        var serverTask = server.RunAsync(endpoint, cts.Token);
+        var flood = new TcpClient[FloodCount];
+
+        try
+        {
+            // the kernel completes the handshake before the server sees the socket, refused ones are reset later
+            for(var i = 0; i < FloodCount; i++)
+                flood[i] = await ConnectAsync(IPAddress.Loopback, port);
+
+            // each from a /24 of its own on the loopback network
+            var honest = new[] { "127.0.1.1", "127.0.2.1", "127.0.3.1" }.Select(IPAddress.Parse).ToArray();
+
+            foreach(var address in honest)
+            {
+                using var tcp = await ConnectAsync(address, port);
+                var stream = tcp.GetStream();
+                using var reader = new StreamReader(stream, Encoding.UTF8);
+
+                await stream.WriteAsync(Encoding.UTF8.GetBytes("{\"id\":1,\"method\":\"mining.subscribe\",\"params\":[]}\n"));
+
+                var line = await reader.ReadLineAsync().WaitAsync(timeout);
+
+                Assert.NotNull(line);
+                Assert.True(JObject.Parse(line)["result"].Value<bool>());
+            }
+
+            var counters = server.GetAdmissionCounters();
+            var refused = counters.AddressRate + counters.PrefixRate + counters.AddressLimit + counters.PrefixLimit;
+
+            Assert.Equal(FloodCount + honest.Length, counters.Accepted + refused);
+
+            // burst plus at most a few refilled tokens while flooding
+            Assert.InRange(counters.Accepted - honest.Length, 5, 10);
+            Assert.True(counters.AddressRate > 0);
+        }
+
+        finally
+        {
+            foreach(var tcp in flood)
+                tcp?.Dispose();
+
+            cts.Cancel();
+            await serverTask.WaitAsync(timeout);
+        }
+    }
+
+    [Fact]
+    public async Task Failed_Accept_Releases_Admission()
+    {
+        var listener = new TcpListener(IPAddress.Loopback, 0);
+        listener.Start();
+        var port = ((IPEndPoint) listener.LocalEndpoint).Port;
+        listener.Stop();
+
+        var endpoint = new StratumEndpoint(new IPEndPoint(IPAddress.Loopback, port), new PoolEndpoint { Difficulty = 1000 });
+        var banManager = new FailingBanManager();
+
+        var server = new TestServer(container, new StratumAdmissionConfig { MaxConnectionsPerAddress = 1 })
+        {
+            BanManager = banManager
+        };
+
+        using var cts = new CancellationTokenSource();
+        var serverTask = server.RunAsync(endpoint, cts.Token);
+
+        try
+        {
+            // admitted, then lost before it became a connection
+            using(var failed = await ConnectAsync(IPAddress.Loopback, port))
+            {
+                var buf = new byte[1];
+
+                Assert.Equal(0, await failed.GetStream().ReadAsync(buf).AsTask().WaitAsync(timeout));
+            }
+
+            Assert.Equal(1, banManager.Lookups);
+
+            // the only slot of the address is free again
+            using var tcp = await ConnectAsync(IPAddress.Loopback, port);
+            var stream = tcp.GetStream();
+            using var reader = new StreamReader(stream, Encoding.UTF8);
+
+            await stream.WriteAsync(Encoding.UTF8.GetBytes("{\"id\":1,\"method\":\"mining.subscribe\",\"params\":[]}\n"));
+
+            var line = await reader.ReadLineAsync().WaitAsync(timeout);
+
+            Assert.NotNull(line);
+            Assert.True(JObject.Parse(line)["result"].Value<bool>());
+            Assert.Equal(new AdmissionCounters(2, 0, 0, 0, 0), server.GetAdmissionCounters());
+        }
+
+        finally
+        {
+            cts.Cancel();
+            await serverTask.WaitAsync(timeout);
+        }
+    }
+}
@@ -0,0 +1,312 @@
+using System;
+using System.IO;
+using System.Linq;
+using System.Net;
+using System.Net.Sockets;
+using System.Reactive;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using Autofac;
+using Microsoft.IO;
+using Miningcore.Configuration;
+using Miningcore.JsonRpc;
+using Miningcore.Messaging;
+using Miningcore.Mining;
+using Miningcore.Stratum;
+using Miningcore.Time;
+using Newtonsoft.Json.Linq;
+using NLog;
+using Xunit;
+
+namespace Miningcore.Tests.Stratum;
+
+public class SessionHandoffTests : TestBase
+{
+    private const string PoolId = "pool1";
+    private static readonly TimeSpan timeout = TimeSpan.FromSeconds(10);
+
+    /// <summary>
+    /// Answers every request with the name of the serving instance and the state of the session
+    /// </summary>
+    private class TestServer : StratumServer
+    {
+        public TestServer(IComponentContext ctx, string name, SessionHandoff handoff) :
+            base(ctx, ctx.Resolve<IMessageBus>(), ctx.Resolve<RecyclableMemoryStreamManager>(), ctx.Resolve<IMasterClock>())
+        {
+            this.name = name;
+            this.handoff = handoff;
+
+            logger = new NullLogger(LogManager.LogFactory);
+            clusterConfig = new ClusterConfig { Logging = new ClusterLoggingConfig() };
+            poolConfig = new PoolConfig { Id = PoolId };
+        }
+
+        private readonly string name;
+
+        public int ConnectionCount => connections.Count;
+
+        public bool FailResume { get; init; }
+
+        public Task RunAsync(StratumEndpoint endpoint, CancellationToken ct)
+        {
+            return RunAsync(ct, endpoint);
+        }
+
+        protected override void OnConnect(StratumConnection connection, IPEndPoint ipEndPoint)
+        {
+            var context = new WorkerContextBase();
+            context.Init(1000, null, clock);
+
+            connection.SetContext(context);
+        }
+
+        protected override bool CanHandoff(StratumConnection connection)
+        {
+            return true;
+        }
+
+        protected override Task OnResumeAsync(StratumConnection connection, IPEndPoint ipEndPoint, StratumSessionState state)
+        {
+            if(FailResume)
+                throw new InvalidOperationException("resume failed");
+
+            var context = new WorkerContextBase();
+            context.ImportState(state, null);
+
+            connection.SetContext(context);
+            return Task.CompletedTask;
+        }
+
+        protected override async Task OnRequestAsync(StratumConnection connection, Timestamped<JsonRpcRequest> tsRequest, CancellationToken ct)
+        {
+            var request = tsRequest.Value;
+            var context = connection.Context;
+
+            if(request.Method == "mining.authorize")
+            {
+                context.IsAuthorized = true;
+                context.Miner = request.ParamsAs<JArray>()[0].Value<string>();
+                context.SetDifficulty(context.Difficulty * 2);
+            }
+
+            await connection.RespondAsync(new object[] { name, context.Miner, context.Difficulty, connection.ConnectionId }, request.Id);
+        }
+    }
+
+    private class Client : IDisposable
+    {
+        public Client(int port)
+        {
+            tcp = new TcpClient();
+            tcp.Connect(IPAddress.Loopback, port);
+
+            stream = tcp.GetStream();
+            reader = new StreamReader(stream, Encoding.UTF8);
+        }
+
+        private readonly TcpClient tcp;
+        private readonly NetworkStream stream;
+        private readonly StreamReader reader;
+
+        public Task SendAsync(string data)
+        {
+            return stream.WriteAsync(Encoding.UTF8.GetBytes(data)).AsTask();
+        }
+
+        public async Task<JArray> ReceiveAsync()
+        {
+            var line = await reader.ReadLineAsync().WaitAsync(timeout);
+            Assert.NotNull(line);
+
+            return (JArray) JObject.Parse(line)["result"];
+        }
+
+        public void Dispose()
+        {
+            tcp.Dispose();
+        }
+    }
+
+    private static int GetFreePort()
+    {
+        var listener = new TcpListener(IPAddress.Loopback, 0);
+        listener.Start();
+
+        var port = ((IPEndPoint) listener.LocalEndpoint).Port;
+        listener.Stop();
+
+        return port;
+    }
+
+    private static async Task WaitForAsync(Func<bool> condition)
+    {
+        var deadline = DateTime.UtcNow + timeout;
+
+        while(!condition())
+        {
+            Assert.True(DateTime.UtcNow < deadline);
+            await Task.Delay(10);
+        }
+    }
+
+    [Fact]
+    public async Task Sessions_Survive_Handoff_Between_Hosts()
+    {
+        if(!SessionHandoff.IsSupported)
+            return;
+
+        var socketPath = Path.Combine(Path.GetTempPath(), $"mc-handoff-{Guid.NewGuid():N}.sock");
+        var port = GetFreePort();
+        var endpoint = new StratumEndpoint(new IPEndPoint(IPAddress.Loopback, port), new PoolEndpoint { Difficulty = 1000 });
+
+        using var oldCts = new CancellationTokenSource();
+        using var newCts = new CancellationTokenSource();
+        using var oldHandoff = new SessionHandoff(socketPath, timeout);
+        using var newHandoff = new SessionHandoff(socketPath, timeout);
+
+        try
+        {
+            // first host
+            var oldServer = new TestServer(container, "old", oldHandoff);
+            var released = new TaskCompletionSource<Unit>(TaskCreationOptions.RunContinuationsAsynchronously);
+
+            oldHandoff.Start(_ => oldServer, 1, () => released.TrySetResult(Unit.Default));
+            Assert.False(oldHandoff.IsSuccessor);
+
+            var oldTask = oldServer.RunAsync(endpoint, oldCts.Token);
+
+            using var client = new Client(port);
+
+            await client.SendAsync("{\"id\":1,\"method\":\"mining.authorize\",\"params\":[\"miner1\",\"x\"]}\n");
+            var result = await client.ReceiveAsync();
+
+            Assert.Equal("old", result[0].Value<string>());
+            Assert.Equal("miner1", result[1].Value<string>());
+            Assert.Equal(2000, result[2].Value<double>());
+
+            var connectionId = result[3].Value<string>();
+
+            // half a request in flight while the session moves
+            await client.SendAsync("{\"id\":2,\"method\":");
+            await Task.Delay(50);
+
+            // second host takes over
+            var newServer = new TestServer(container, "new", newHandoff);
+
+            newHandoff.Start(_ => newServer, 1, () => { });
+            Assert.True(newHandoff.IsSuccessor);
+
+            var newTask = newServer.RunAsync(endpoint, newCts.Token);
+
+            await released.Task.WaitAsync(timeout);
+
+            // a released instance shuts down, its connection timers go with it
+            oldCts.Cancel();
+            await oldTask.WaitAsync(timeout);
+
+            Assert.Equal(0, oldServer.ConnectionCount);
+            Assert.Equal(1, newServer.ConnectionCount);
+
+            // same connection, same session, now served by the second host
+            await client.SendAsync("\"mining.ping\",\"params\":[]}\n");
+            result = await client.ReceiveAsync();
+
+            Assert.Equal("new", result[0].Value<string>());
+            Assert.Equal("miner1", result[1].Value<string>());
+            Assert.Equal(2000, result[2].Value<double>());
+            Assert.Equal(connectionId, result[3].Value<string>());
+
+            // new connections are accepted on the inherited listening socket
+            using var client2 = new Client(port);
+
+            await client2.SendAsync("{\"id\":1,\"method\":\"mining.authorize\",\"params\":[\"miner2\",\"x\"]}\n");
+            result = await client2.ReceiveAsync();
+
+            Assert.Equal("new", result[0].Value<string>());
+            Assert.Equal("miner2", result[1].Value<string>());
+
+            await WaitForAsync(() => newServer.ConnectionCount == 2);
+
+            // the second host is now the one accepting handoff requests
+            Assert.True(File.Exists(socketPath));
+
+            newCts.Cancel();
+            await newTask.WaitAsync(timeout);
+        }
+
+        finally
+        {
+            oldCts.Cancel();
+            newCts.Cancel();
+
+            if(File.Exists(socketPath))
+                File.Delete(socketPath);
+        }
+    }
+
+    [Fact]
+    public async Task Failed_Session_Does_Not_Cost_Listeners()
+    {
+        if(!SessionHandoff.IsSupported)
+            return;
+
+        var socketPath = Path.Combine(Path.GetTempPath(), $"mc-handoff-{Guid.NewGuid():N}.sock");
+        var port = GetFreePort();
+        var endpoint = new StratumEndpoint(new IPEndPoint(IPAddress.Loopback, port), new PoolEndpoint { Difficulty = 1000 });
+
+        using var oldCts = new CancellationTokenSource();
+        using var newCts = new CancellationTokenSource();
+        using var oldHandoff = new SessionHandoff(socketPath, timeout);
+        using var newHandoff = new SessionHandoff(socketPath, timeout);
+
+        try
+        {
+            var oldServer = new TestServer(container, "old", oldHandoff);
+            var released = new TaskCompletionSource<Unit>(TaskCreationOptions.RunContinuationsAsynchronously);
+
+            oldHandoff.Start(_ => oldServer, 1, () => released.TrySetResult(Unit.Default));
+
+            var oldTask = oldServer.RunAsync(endpoint, oldCts.Token);
+
+            using var client = new Client(port);
+
+            await client.SendAsync("{\"id\":1,\"method\":\"mining.authorize\",\"params\":[\"miner1\",\"x\"]}\n");
+            await client.ReceiveAsync();
+
+            // the session is lost, the listening socket must still make it over
+            var newServer = new TestServer(container, "new", newHandoff) { FailResume = true };
+
+            newHandoff.Start(_ => newServer, 1, () => { });
+
+            var newTask = newServer.RunAsync(endpoint, newCts.Token);
+
+            await released.Task.WaitAsync(timeout);
+
+            Assert.Equal(0, newServer.ConnectionCount);
+            Assert.False(newTask.IsFaulted);
+
+            using var client2 = new Client(port);
+
+            await client2.SendAsync("{\"id\":1,\"method\":\"mining.authorize\",\"params\":[\"miner2\",\"x\"]}\n");
+            var result = await client2.ReceiveAsync();
+
+            Assert.Equal("new", result[0].Value<string>());
+
+            oldCts.Cancel();
+            await oldTask.WaitAsync(timeout);
+
+            newCts.Cancel();
+            await newTask.WaitAsync(timeout);
+        }
+
+        finally
+        {
+            oldCts.Cancel();
+            newCts.Cancel();
+
+            if(File.Exists(socketPath))
+                File.Delete(socketPath);
+        }
+    }
+}
@@ -0,0 +1,172 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Net;
+using System.Net.Sockets;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using Autofac;
+using Microsoft.IO;
+using Miningcore.Configuration;
+using Miningcore.JsonRpc;
+using Miningcore.Messaging;
+using Miningcore.Mining;
+using Miningcore.Stratum;
+using Miningcore.Time;
+using Newtonsoft.Json.Linq;
+using NLog;
+using Xunit;
+
+namespace Miningcore.Tests.Stratum;
+
+public class StratumPipelineTests : TestBase
+{
+    private const string PoolId = "pool1";
+    private const int SubmitCount = 8;
+    private static readonly TimeSpan timeout = TimeSpan.FromSeconds(10);
+
+    /// <summary>
+    /// Submissions take longer the earlier they were sent, other requests report how many submissions were in flight
+    /// </summary>
+    private class TestServer : StratumServer
+    {
+        public TestServer(IComponentContext ctx) :
+            base(ctx, ctx.Resolve<IMessageBus>(), ctx.Resolve<RecyclableMemoryStreamManager>(), ctx.Resolve<IMasterClock>())
+        {
+            logger = new NullLogger(LogManager.LogFactory);
+            clusterConfig = new ClusterConfig { Logging = new ClusterLoggingConfig() };
+            poolConfig = new PoolConfig { Id = PoolId };
+        }
+
+        private int active;
+        private int maxActive;
+
+        public int MaxActive => maxActive;
+
+        public Task RunAsync(StratumEndpoint endpoint, CancellationToken ct)
+        {
+            return RunAsync(ct, endpoint);
+        }
+
+        protected override void OnConnect(StratumConnection connection, IPEndPoint ipEndPoint)
+        {
+            var context = new WorkerContextBase();
+            context.Init(1000, null, clock);
+
+            connection.SetContext(context);
+        }
+
+        protected override async Task OnRequestAsync(StratumConnection connection, Timestamped<JsonRpcRequest> tsRequest, CancellationToken ct)
+        {
+            var request = tsRequest.Value;
+
+            if(request.Method != "mining.submit")
+            {
+                await connection.RespondAsync(Volatile.Read(ref active), request.Id);
+                return;
+            }
+
+            var current = Interlocked.Increment(ref active);
+
+            lock(this)
+            {
+                maxActive = Math.Max(maxActive, current);
+            }
+
+            await Task.Delay(TimeSpan.FromMilliseconds(20 * (SubmitCount - Convert.ToInt32(request.Id))), ct);
+
+            Interlocked.Decrement(ref active);
+
+            await connection.RespondAsync(true, request.Id);
+        }
+    }
+
+    private static int GetFreePort()
+    {
+        var listener = new TcpListener(IPAddress.Loopback, 0);
+        listener.Start();
+
+        var port = ((IPEndPoint) listener.LocalEndpoint).Port;
+        listener.Stop();
+
+        return port;
+    }
+
+    /// <summary>
+    /// Sends a burst of submissions followed by an authorize request and returns the responses in the order received
+    /// </summary>
+    private async Task<(List<JObject> Responses, int MaxActive)> RunAsync(int? pipelineDepth)
+    {
+        var port = GetFreePort();
+        var endpoint = new StratumEndpoint(new IPEndPoint(IPAddress.Loopback, port), new PoolEndpoint { Difficulty = 1000, PipelineDepth = pipelineDepth });
+
+        using var cts = new CancellationTokenSource();
+        var server = new TestServer(container);
+        var serverTask = server.RunAsync(endpoint, cts.Token);
+
+        try
+        {
+            using var tcp = new TcpClient();
+            await tcp.ConnectAsync(IPAddress.Loopback, port);
+
+            var stream = tcp.GetStream();
+            using var reader = new StreamReader(stream, Encoding.UTF8);
+
+            var requests = new StringBuilder();
+
+            for(var i = 0; i < SubmitCount; i++)
+                requests.Append($"{{\"id\":{i},\"method\":\"mining.submit\",\"params\":[\"miner1\",\"job\",\"00\",\"00\",\"00\"]}}\n");
+
+            requests.Append($"{{\"id\":{SubmitCount},\"method\":\"mining.authorize\",\"params\":[\"miner1\",\"x\"]}}\n");
+
+            await stream.WriteAsync(Encoding.UTF8.GetBytes(requests.ToString()));
+
+            var responses = new List<JObject>();
+
+            for(var i = 0; i <= SubmitCount; i++)
+            {
+                var line = await reader.ReadLineAsync().WaitAsync(timeout);
+                Assert.NotNull(line);
+
+                responses.Add(JObject.Parse(line));
+            }
+
+            return (responses, server.MaxActive);
+        }
+
+        finally
+        {
+            cts.Cancel();
+            await serverTask.WaitAsync(timeout);
+        }
+    }
+
+    [Fact]
+    public async Task Requests_Are_Processed_In_Order_By_Default()
+    {
+        var (responses, maxActive) = await RunAsync(null);
+
+        Assert.Equal(1, maxActive);
+        Assert.Equal(Enumerable.Range(0, SubmitCount + 1), responses.Select(x => x["id"].Value<int>()));
+    }
+
+    [Fact]
+    public async Task Pipelined_Submissions_Complete_Out_Of_Order()
+    {
+        var (responses, maxActive) = await RunAsync(4);
+
+        Assert.Equal(4, maxActive);
+
+        // later submissions finish first and are answered right away
+        var ids = responses.Take(SubmitCount).Select(x => x["id"].Value<int>()).ToArray();
+
+        Assert.NotEqual(Enumerable.Range(0, SubmitCount), ids);
+        Assert.Equal(Enumerable.Range(0, SubmitCount), ids.OrderBy(x => x));
+
+        // authorize waits for all submissions received before it
+        Assert.Equal(SubmitCount, responses[^1]["id"].Value<int>());
+        Assert.Equal(0, responses[^1]["result"].Value<int>());
+    }
+}
@@ -0,0 +1,231 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using Miningcore.Blockchain.Bitcoin;
+using Miningcore.Configuration;
+using Miningcore.Mining;
+using Miningcore.Stratum;
+using Miningcore.Tests.Util;
+using Miningcore.VarDiff;
+using Xunit;
+using Xunit.Abstractions;
+
+namespace Miningcore.Tests.Stratum;
+
+public class StratumSessionTableTests
+{
+    public StratumSessionTableTests(ITestOutputHelper output)
+    {
+        this.output = output;
+    }
+
+    private readonly ITestOutputHelper output;
+
+    private static readonly TimeSpan timeout = TimeSpan.FromSeconds(300);
+
+    private static MockMasterClock CreateClock()
+    {
+        return new MockMasterClock { CurrentTime = new DateTime(2024, 1, 1, 0, 0, 0, DateTimeKind.Utc) };
+    }
+
+    private static StratumSessionState CreateState(string id)
+    {
+        return new StratumSessionState
+        {
+            ConnectionId = id,
+            Difficulty = 1024,
+            Extra = new Dictionary<string, string> { ["ExtraNonce1"] = id }
+        };
+    }
+
+    [Fact]
+    public void Parked_Session_Resumes_Once()
+    {
+        var expired = new List<StratumSessionState>();
+        var table = new StratumSessionTable(CreateClock(), 10, timeout, expired.Add);
+
+        table.Park(CreateState("s1"));
+
+        Assert.True(table.TryResume("s1", out var state));
+        Assert.Equal(1024, state.Difficulty);
+
+        Assert.False(table.TryResume("s1", out _));
+        Assert.False(table.TryResume("s2", out _));
+        Assert.False(table.TryResume(null, out _));
+
+        Assert.Equal(0, table.Count);
+        Assert.Empty(expired);
+    }
+
+    [Fact]
+    public void Sessions_Expire_After_Timeout()
+    {
+        var clock = CreateClock();
+        var expired = new List<StratumSessionState>();
+        var table = new StratumSessionTable(clock, 10, timeout, expired.Add);
+
+        table.Park(CreateState("s1"));
+
+        clock.CurrentTime += TimeSpan.FromSeconds(100);
+        table.Park(CreateState("s2"));
+
+        clock.CurrentTime += TimeSpan.FromSeconds(200);
+        Assert.False(table.TryResume("s1", out _));
+        Assert.Equal("s1", Assert.Single(expired).ConnectionId);
+
+        Assert.True(table.TryResume("s2", out _));
+    }
+
+    [Fact]
+    public void Oldest_Session_Makes_Room()
+    {
+        var expired = new List<StratumSessionState>();
+        var table = new StratumSessionTable(CreateClock(), 2, timeout, expired.Add);
+
+        table.Park(CreateState("s1"));
+        table.Park(CreateState("s2"));
+        table.Park(CreateState("s3"));
+
+        Assert.Equal(2, table.Count);
+        Assert.Equal("s1", Assert.Single(expired).ConnectionId);
+        Assert.False(table.TryResume("s1", out _));
+        Assert.True(table.TryResume("s2", out _));
+        Assert.True(table.TryResume("s3", out _));
+    }
+
+    [Fact]
+    public void Expired_Extranonces_Are_Reissued()
+    {
+        var clock = CreateClock();
+        var provider = new BitcoinExtraNonceProvider("pool1", 0xa);
+
+        var table = new StratumSessionTable(clock, 10, timeout,
+            state => provider.Release(state.Extra["ExtraNonce1"]));
+
+        var extraNonce1 = provider.Next();
+        table.Park(CreateState(extraNonce1));
+
+        // still reserved for resumption
+        Assert.NotEqual(extraNonce1, provider.Next());
+
+        clock.CurrentTime += timeout;
+        table.Park(CreateState(provider.Next()));
+
+        Assert.Equal(extraNonce1, provider.Next());
+    }
+
+    #region Mass reconnect simulation
+
+    private const double PortDifficulty = 1;
+    private const int MinerCount = 200;
+
+    private static readonly VarDiffConfig varDiff = new()
+    {
+        MinDiff = 1,
+        TargetTime = 15,
+        RetargetTime = 90,
+        VariancePercent = 30
+    };
+
+    /// <summary>
+    /// Runs all miners for the given duration and returns the number of shares the pool had to validate
+    /// </summary>
+    private static int Mine(WorkerContextBase[] workers, double[] hashrates, MockMasterClock clock, TimeSpan duration)
+    {
+        var start = clock.CurrentTime;
+        var queue = new PriorityQueue<int, double>();
+        var shares = 0;
+
+        double ShareInterval(int i) => workers[i].Difficulty * Math.Pow(2, 32) / hashrates[i];
+
+        for(var i = 0; i < workers.Length; i++)
+            queue.Enqueue(i, ShareInterval(i));
+
+        while(queue.TryDequeue(out var i, out var t) && t < duration.TotalSeconds)
+        {
+            clock.CurrentTime = start.AddSeconds(t);
+            shares++;
+
+            var newDiff = VarDiffManager.Update(workers[i], varDiff, clock);
+
+            if(newDiff.HasValue)
+                workers[i].SetDifficulty(newDiff.Value);
+
+            queue.Enqueue(i, t + ShareInterval(i));
+        }
+
+        clock.CurrentTime = start + duration;
+        return shares;
+    }
+
+    private static WorkerContextBase[] Connect(MockMasterClock clock)
+    {
+        return Enumerable.Range(0, MinerCount).Select(_ =>
+        {
+            var context = new WorkerContextBase();
+            context.Init(PortDifficulty, varDiff, clock);
+
+            return context;
+        }).ToArray();
+    }
+
+    [Fact]
+    public void Resumption_Limits_Validation_Load_During_Mass_Reconnect()
+    {
+        var clock = CreateClock();
+
+        // a fleet of miners whose ideal difficulty ranges from 64 to 1024
+        var hashrates = Enumerable.Range(0, MinerCount)
+            .Select(i => Math.Pow(2, 6 + i % 5) * Math.Pow(2, 32) / varDiff.TargetTime)
+            .ToArray();
+
+        var workers = Connect(clock);
+        var warmup = Mine(workers, hashrates, clock, TimeSpan.FromMinutes(30));
+
+        // everybody drops off at once (pool restart, network blip)
+        var table = new StratumSessionTable(clock, MinerCount, timeout, null);
+
+        for(var i = 0; i < MinerCount; i++)
+        {
+            var state = new StratumSessionState { ConnectionId = $"s{i}" };
+            workers[i].ExportState(state);
+            table.Park(state);
+        }
+
+        var window = TimeSpan.FromMinutes(5);
+        clock.CurrentTime += TimeSpan.FromSeconds(30);
+
+        // reconnect without resumption, vardiff starts over at port difficulty
+        var freshClock = CreateClock();
+        freshClock.CurrentTime = clock.CurrentTime;
+
+        var fresh = Mine(Connect(freshClock), hashrates, freshClock, window);
+
+        // reconnect with resumption
+        var resumed = Connect(clock);
+
+        for(var i = 0; i < MinerCount; i++)
+        {
+            Assert.True(table.TryResume($"s{i}", out var state));
+            resumed[i].ResumeState(state, varDiff, clock);
+
+            Assert.Equal(workers[i].Difficulty, resumed[i].Difficulty);
+            Assert.False(resumed[i].IsAuthorized);
+        }
+
+        var resumedShares = Mine(resumed, hashrates, clock, window);
+
+        output.WriteLine($"Warmup shares: {warmup}, shares after reconnect without resumption: {fresh}, with resumption: {resumedShares}");
+
+        // at target time every miner submits one share per 15 seconds
+        var steady = MinerCount * window.TotalSeconds / varDiff.TargetTime;
+
+        Assert.InRange(resumedShares, steady * 0.9, steady * 1.1);
+        Assert.True(fresh > resumedShares * 10);
+
+        // nobody got retargeted after resuming
+        Assert.All(Enumerable.Range(0, MinerCount), i => Assert.Equal(workers[i].Difficulty, resumed[i].Difficulty));
+    }
+
+    #endregion // Mass reconnect simulation
+}
@@ -0,0 +1,116 @@
+using System;
+using System.Collections.Generic;
+using Miningcore.Time;
+using Xunit;
+
+namespace Miningcore.Tests.Util;
+
+public class TimerWheelTests
+{
+    private static readonly TimeSpan tick = TimeSpan.FromMilliseconds(100);
+
+    [Fact]
+    public void Timers_Fire_On_Their_Tick()
+    {
+        var wheel = new TimerWheel(tick);
+        var fired = new List<(int, long)>();
+        long now = 0;
+
+        // spans all levels of the wheel, including deadlines beyond the last one
+        var delays = new long[] { 1, 63, 64, 65, 4095, 4096, 5000, 262143, 300000, 17000000 };
+
+        for(var i = 0; i < delays.Length; i++)
+        {
+            var timer = wheel.CreateTimer(x => fired.Add(((int) x, now)), i);
+            timer.Arm(tick * delays[i]);
+        }
+
+        Assert.Equal(delays.Length, wheel.Count);
+
+        while(now < 17000000)
+            wheel.AdvanceTo(++now);
+
+        Assert.Equal(delays.Length, fired.Count);
+        Assert.Equal(0, wheel.Count);
+
+        foreach(var (i, firedAt) in fired)
+            Assert.Equal(delays[i], firedAt);
+    }
+
+    [Fact]
+    public void Cancelled_Timer_Does_Not_Fire()
+    {
+        var wheel = new TimerWheel(tick);
+        var fired = 0;
+        var timer = wheel.CreateTimer(_ => fired++);
+
+        timer.Arm(TimeSpan.FromSeconds(1));
+        Assert.True(timer.IsArmed);
+
+        Assert.True(timer.Cancel());
+        Assert.False(timer.Cancel());
+        Assert.False(timer.IsArmed);
+
+        wheel.AdvanceTo(100);
+
+        Assert.Equal(0, fired);
+        Assert.Equal(0, wheel.Count);
+    }
+
+    [Fact]
+    public void Rearming_Moves_The_Deadline()
+    {
+        var wheel = new TimerWheel(tick);
+        var fired = new List<long>();
+        long now = 0;
+        var timer = wheel.CreateTimer(_ => fired.Add(now));
+
+        timer.Arm(TimeSpan.FromSeconds(1));
+        timer.Arm(TimeSpan.FromSeconds(20));
+
+        Assert.Equal(1, wheel.Count);
+
+        while(now < 1000)
+            wheel.AdvanceTo(++now);
+
+        Assert.Equal(new long[] { 200 }, fired);
+    }
+
+    [Fact]
+    public void Callback_Can_Rearm_Its_Timer()
+    {
+        var wheel = new TimerWheel(tick);
+        var fired = new List<long>();
+        long now = 0;
+        TimerWheel.Timer timer = null;
+
+        timer = wheel.CreateTimer(_ =>
+        {
+            fired.Add(now);
+
+            if(fired.Count < 3)
+                timer.Arm(TimeSpan.FromSeconds(3));
+        });
+
+        timer.Arm(TimeSpan.FromSeconds(3));
+
+        while(now < 200)
+            wheel.AdvanceTo(++now);
+
+        Assert.Equal(new long[] { 30, 60, 90 }, fired);
+    }
+
+    [Fact]
+    public void Catching_Up_Fires_Everything_Due()
+    {
+        var wheel = new TimerWheel(tick);
+        var fired = 0;
+
+        for(var i = 1; i <= 1000; i++)
+            wheel.CreateTimer(_ => fired++).Arm(tick * i);
+
+        Assert.Equal(500, wheel.AdvanceTo(500));
+        Assert.Equal(500, fired);
+        Assert.Equal(500, wheel.Count);
+    }
+}
@@ -0,0 +1,215 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using Miningcore.Configuration;
+using Miningcore.Mining;
+using Miningcore.Tests.Util;
+using Miningcore.VarDiff;
+using Xunit;
+
+namespace Miningcore.Tests.VarDiff;
+
+public class ValidationCostFloorTests
+{
+    private const double CpuBudget = 0.1;
+
+    private static readonly TimeSpan validationCost = TimeSpan.FromMilliseconds(10);
+    private static readonly TimeSpan sweepInterval = TimeSpan.FromSeconds(30);
+    private static readonly TimeSpan duration = TimeSpan.FromHours(2);
+    private static readonly TimeSpan tail = TimeSpan.FromMinutes(30);
+
+    private static readonly VarDiffConfig varDiff = new()
+    {
+        MinDiff = 1,
+        TargetTime = 15,
+        RetargetTime = 90,
+        VariancePercent = 30
+    };
+
+    [Theory]
+    [InlineData(100)]
+    [InlineData(1000)]
+    [InlineData(5000)]
+    public void Validation_Cpu_Stays_Within_Budget_As_Workers_Grow(int workerCount)
+    {
+        var clock = CreateClock();
+        var floor = new ValidationCostFloor(CpuBudget, clock);
+
+        var cpu = Mine(workerCount, floor, clock);
+
+        Assert.True(cpu <= CpuBudget * 1.1, $"{cpu:0.###} cores used with a budget of {CpuBudget}");
+
+        // a small pool never touches the configured MinDiff
+        if(workerCount * validationCost.TotalSeconds * 2 / 30 < CpuBudget)
+            Assert.Equal(1, floor.Scale);
+        else
+            Assert.True(floor.Scale > 1);
+    }
+
+    [Fact]
+    public void Without_Floor_Validation_Cpu_Grows_With_Workers()
+    {
+        var cpu = Mine(5000, null, CreateClock());
+
+        Assert.True(cpu > CpuBudget * 10);
+    }
+
+    [Fact]
+    public void Floor_Relaxes_When_Load_Drops()
+    {
+        var clock = CreateClock();
+        var floor = new ValidationCostFloor(CpuBudget, clock, window: TimeSpan.FromSeconds(30));
+
+        // ten times the budget, raise is capped per window
+        floor.Record(TimeSpan.FromSeconds(30));
+        clock.CurrentTime += TimeSpan.FromSeconds(30);
+
+        Assert.Equal(2, floor.GetMinDiff(1));
+        Assert.Equal(1, floor.Utilization, 3);
+
+        // held while workers pick up the new floor
+        for(var i = 0; i < 4; i++)
+        {
+            floor.Record(TimeSpan.FromSeconds(30));
+            clock.CurrentTime += TimeSpan.FromSeconds(30);
+
+            Assert.Equal(2, floor.GetMinDiff(1));
+        }
+
+        // idle pool, the floor comes down step by step
+        var scales = new List<double>();
+
+        for(var i = 0; i < 10; i++)
+        {
+            clock.CurrentTime += TimeSpan.FromSeconds(30);
+            scales.Add(floor.GetMinDiff(1));
+        }
+
+        Assert.True(scales.Zip(scales.Skip(1)).All(x => x.Second <= x.First));
+        Assert.True(scales[0] < 2);
+        Assert.Equal(1, scales[^1]);
+    }
+
+    [Fact]
+    public void VarDiff_Raises_Worker_On_Target_Below_Floor()
+    {
+        var clock = CreateClock();
+        var context = new WorkerContextBase();
+        context.Init(1, varDiff, clock);
+
+        // shares right on target
+        VarDiffManager.Update(context, varDiff, clock);
+
+        for(var i = 0; i < 7; i++)
+        {
+            clock.CurrentTime += TimeSpan.FromSeconds(varDiff.TargetTime);
+
+            Assert.Null(VarDiffManager.Update(context, varDiff, clock));
+        }
+
+        clock.CurrentTime += TimeSpan.FromSeconds(varDiff.TargetTime);
+
+        Assert.Equal(4, VarDiffManager.Update(context, varDiff, clock, 4));
+    }
+
+    [Fact]
+    public void VarDiff_Leaves_Worker_On_Target_Alone_Without_Floor()
+    {
+        var clock = CreateClock();
+        var context = new WorkerContextBase();
+
+        // below the static MinDiff, e.g. a difficulty the miner asked for
+        context.Init(0.5, varDiff, clock);
+
+        VarDiffManager.Update(context, varDiff, clock);
+
+        for(var i = 0; i < 8; i++)
+        {
+            clock.CurrentTime += TimeSpan.FromSeconds(varDiff.TargetTime);
+
+            Assert.Null(VarDiffManager.Update(context, varDiff, clock));
+        }
+    }
+
+    /// <summary>
+    /// Runs a fleet of low hashrate miners and returns the CPU cores spent on validation towards the end
+    /// </summary>
+    private static double Mine(int workerCount, ValidationCostFloor floor, MockMasterClock clock)
+    {
+        var start = clock.CurrentTime;
+        var random = new Random(workerCount);
+
+        // at MinDiff these would submit every 15 to 60 seconds
+        var hashrates = Enumerable.Range(0, workerCount)
+            .Select(_ => Math.Pow(2, 32) / 30 * (0.5 + random.NextDouble() * 1.5))
+            .ToArray();
+
+        var workers = Enumerable.Range(0, workerCount).Select(_ =>
+        {
+            var context = new WorkerContextBase();
+            context.Init(varDiff.MinDiff, varDiff, clock);
+
+            return context;
+        }).ToArray();
+
+        // a new generation invalidates a scheduled share after an idle retarget
+        var generations = new int[workerCount];
+        var queue = new PriorityQueue<(int Worker, int Generation), double>();
+        var tailShares = 0;
+
+        double ShareInterval(int i) => workers[i].Difficulty * Math.Pow(2, 32) / hashrates[i];
+
+        for(var i = 0; i < workerCount; i++)
+            queue.Enqueue((i, 0), random.NextDouble() * 30);
+
+        for(var t = sweepInterval.TotalSeconds; t < duration.TotalSeconds; t += sweepInterval.TotalSeconds)
+            queue.Enqueue((-1, 0), t);
+
+        while(queue.TryDequeue(out var item, out var t) && t < duration.TotalSeconds)
+        {
+            clock.CurrentTime = start.AddSeconds(t);
+
+            var minDiff = floor?.GetMinDiff(varDiff.MinDiff);
+
+            if(item.Worker == -1)
+            {
+                for(var i = 0; i < workerCount; i++)
+                {
+                    var newDiff = VarDiffManager.IdleUpdate(workers[i], varDiff, clock, minDiff);
+
+                    if(newDiff.HasValue)
+                    {
+                        workers[i].SetDifficulty(newDiff.Value);
+                        queue.Enqueue((i, ++generations[i]), t + ShareInterval(i));
+                    }
+                }
+
+                continue;
+            }
+
+            if(item.Generation != generations[item.Worker])
+                continue;
+
+            floor?.Record(validationCost);
+
+            if(t >= (duration - tail).TotalSeconds)
+                tailShares++;
+
+            var diff = VarDiffManager.Update(workers[item.Worker], varDiff, clock, minDiff);
+
+            if(diff.HasValue)
+                workers[item.Worker].SetDifficulty(diff.Value);
+
+            queue.Enqueue(item, t + ShareInterval(item.Worker));
+        }
+
+        clock.CurrentTime = start + duration;
+
+        return tailShares * validationCost.TotalSeconds / tail.TotalSeconds;
+    }
+
+    private static MockMasterClock CreateClock()
+    {
+        return new MockMasterClock { CurrentTime = new DateTime(2024, 1, 1, 0, 0, 0, DateTimeKind.Utc) };
+    }
+}
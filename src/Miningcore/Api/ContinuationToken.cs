@@ -0,0 +1,91 @@
+using System.Buffers.Binary;
+using System.Net;
+using System.Text;
+using Microsoft.AspNetCore.WebUtilities;
+using Miningcore.Persistence.Model;
+
+namespace Miningcore.Api;
+
+/// <summary>
+/// Encodes keyset pagination cursors as opaque, url-safe tokens
+/// </summary>
+public static class ContinuationToken
+{
+    private const byte PageCursorTag = 1;
+    private const byte MinerHashrateTag = 2;
+
+    public static string Encode(PageCursor cursor)
+    {
+        var buf = new byte[17];
+        buf[0] = PageCursorTag;
+        BinaryPrimitives.WriteInt64LittleEndian(buf.AsSpan(1), cursor.Created.ToUniversalTime().Ticks);
+        BinaryPrimitives.WriteInt64LittleEndian(buf.AsSpan(9), cursor.Id);
+
+        return WebEncoders.Base64UrlEncode(buf);
+    }
+
+    public static string Encode(MinerWorkerPerformanceStats last)
+    {
+        var miner = Encoding.UTF8.GetBytes(last.Miner ?? string.Empty);
+        var buf = new byte[9 + miner.Length];
+        buf[0] = MinerHashrateTag;
+        BinaryPrimitives.WriteInt64LittleEndian(buf.AsSpan(1), BitConverter.DoubleToInt64Bits(last.Hashrate));
+        miner.CopyTo(buf, 9);
+
+        return WebEncoders.Base64UrlEncode(buf);
+    }
+
+    /// <summary>
+    /// Returns null for an absent token (first page)
+    /// </summary>
+    public static PageCursor DecodePageCursor(string token)
+    {
+        if(string.IsNullOrEmpty(token))
+            return null;
+
+        var buf = Decode(token);
+
+        if(buf.Length != 17 || buf[0] != PageCursorTag)
+            throw new ApiException("Invalid continuation token", HttpStatusCode.BadRequest);
+
+        var ticks = BinaryPrimitives.ReadInt64LittleEndian(buf.AsSpan(1));
+
+        if(ticks < DateTime.MinValue.Ticks || ticks > DateTime.MaxValue.Ticks)
+            throw new ApiException("Invalid continuation token", HttpStatusCode.BadRequest);
+
+        return new PageCursor(new DateTime(ticks, DateTimeKind.Utc), BinaryPrimitives.ReadInt64LittleEndian(buf.AsSpan(9)));
+    }
+
+    /// <summary>
+    /// Returns null for an absent token (first page)
+    /// </summary>
+    public static MinerWorkerPerformanceStats DecodeMinerHashrateCursor(string token)
+    {
+        if(string.IsNullOrEmpty(token))
+            return null;
+
+        var buf = Decode(token);
+
+        if(buf.Length < 9 || buf[0] != MinerHashrateTag)
+            throw new ApiException("Invalid continuation token", HttpStatusCode.BadRequest);
+
+        return new MinerWorkerPerformanceStats
+        {
+            Hashrate = BitConverter.Int64BitsToDouble(BinaryPrimitives.ReadInt64LittleEndian(buf.AsSpan(1))),
+            Miner = Encoding.UTF8.GetString(buf, 9, buf.Length - 9)
+        };
+    }
+
+    private static byte[] Decode(string token)
+    {
+        try
+        {
+            return WebEncoders.Base64UrlDecode(token);
+        }
+
+        catch(FormatException)
+        {
+            throw new ApiException("Invalid continuation token", HttpStatusCode.BadRequest);
+        }
+    }
+}
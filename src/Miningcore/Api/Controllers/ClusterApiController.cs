@@ -3,6 +3,7 @@ using Microsoft.AspNetCore.Mvc;
 using Miningcore.Blockchain;
 using Miningcore.Extensions;
 using Miningcore.Mining;
+using Miningcore.Persistence;
 using Miningcore.Persistence.Model;
 using Miningcore.Persistence.Repositories;
 using Miningcore.Time;
@@ -43,7 +44,7 @@ public class ClusterApiController : ApiControllerBase
             state :
             new[] { BlockStatus.Confirmed, BlockStatus.Pending, BlockStatus.Orphaned };
 
-        var blocks = (await cf.Run(con => blocksRepo.PageBlocksAsync(con, blockStates, page, pageSize, ct)))
+        var blocks = (await cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.PageBlocksAsync(con, blockStates, page, pageSize, ct)))
             .Select(mapper.Map<Responses.Block>)
             .Where(x => enabledPools.Contains(x.PoolId))
             .ToArray();
@@ -2,16 +2,21 @@ using System.Collections.Concurrent;
 using System.Data;
 using System.Globalization;
 using System.Net;
+using System.Text.Json;
 using Autofac;
+using Microsoft.AspNetCore.Http;
 using Microsoft.AspNetCore.Mvc;
 using Microsoft.AspNetCore.Mvc.ActionConstraints;
 using Microsoft.AspNetCore.Mvc.Infrastructure;
+using Microsoft.Extensions.Options;
+using Microsoft.Net.Http.Headers;
 using Miningcore.Api.Extensions;
 using Miningcore.Api.Responses;
 using Miningcore.Blockchain;
 using Miningcore.Configuration;
 using Miningcore.Extensions;
 using Miningcore.Mining;
+using Miningcore.Persistence;
 using Miningcore.Persistence.Model;
 using Miningcore.Persistence.Model.Projections;
 using Miningcore.Persistence.Repositories;
@@ -33,6 +38,9 @@ public class PoolApiController : ApiControllerBase
         paymentsRepo = ctx.Resolve<IPaymentRepository>();
         clock = ctx.Resolve<IMasterClock>();
         pools = ctx.Resolve<ConcurrentDictionary<string, IMiningPool>>();
+        itemCountCache = ctx.Resolve<ItemCountCache>();
+        minerResponseCache = ctx.Resolve<MinerResponseCache>();
+        jsonSerializerOptions = ctx.Resolve<IOptions<JsonOptions>>().Value.JsonSerializerOptions;
         adcp = _adcp;
     }
 
@@ -42,6 +50,9 @@ public class PoolApiController : ApiControllerBase
     private readonly IMinerRepository minerRepo;
     private readonly IShareRepository shareRepo;
     private readonly IMasterClock clock;
+    private readonly ItemCountCache itemCountCache;
+    private readonly MinerResponseCache minerResponseCache;
+    private readonly JsonSerializerOptions jsonSerializerOptions;
     private readonly IActionDescriptorCollectionProvider adcp;
     private readonly ConcurrentDictionary<string, IMiningPool> pools;
 
@@ -57,7 +68,7 @@ public class PoolApiController : ApiControllerBase
             Pools = await Task.WhenAll(clusterConfig.Pools.Where(x => x.Enabled).Select(async config =>
             {
                 // load stats
-                var stats = await cf.Run(con => statsRepo.GetLastPoolStatsAsync(con, config.Id, ct));
+                var stats = await cf.Run(ConnectionIntent.ReadStale, con => statsRepo.GetLastPoolStatsAsync(con, config.Id, ct));
 
                 // get pool
                 pools.TryGetValue(config.Id, out var pool);
@@ -66,26 +77,26 @@ public class PoolApiController : ApiControllerBase
                 var result = config.ToPoolInfo(mapper, stats, pool);
 
                 // enrich
-                result.TotalPaid = await cf.Run(con => statsRepo.GetTotalPoolPaymentsAsync(con, config.Id, ct));
-                result.TotalBlocks = await cf.Run(con => blocksRepo.GetPoolBlockCountAsync(con, config.Id, ct));
-                result.TotalConfirmedBlocks = await cf.Run(con => blocksRepo.GetTotalConfirmedBlocksAsync(con, config.Id, ct));
-                result.TotalPendingBlocks = await cf.Run(con => blocksRepo.GetTotalPendingBlocksAsync(con, config.Id, ct));
+                result.TotalPaid = await cf.Run(ConnectionIntent.ReadStale, con => statsRepo.GetTotalPoolPaymentsAsync(con, config.Id, ct));
+                result.TotalBlocks = await cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.GetPoolBlockCountAsync(con, config.Id, ct));
+                result.TotalConfirmedBlocks = await cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.GetTotalConfirmedBlocksAsync(con, config.Id, ct));
+                result.TotalPendingBlocks = await cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.GetTotalPendingBlocksAsync(con, config.Id, ct));
                 // get reward of the last confirmed block and set BlockReward
-                result.BlockReward = await cf.Run(con => blocksRepo.GetLastConfirmedBlockRewardAsync(con, config.Id, ct));
-                var lastBlockTime = await cf.Run(con => blocksRepo.GetLastPoolBlockTimeAsync(con, config.Id, ct));
+                result.BlockReward = await cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.GetLastConfirmedBlockRewardAsync(con, config.Id, ct));
+                var lastBlockTime = await cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.GetLastPoolBlockTimeAsync(con, config.Id, ct));
                 result.LastPoolBlockTime = lastBlockTime;
 
                 if(lastBlockTime.HasValue)
                 {
                     var startTime = lastBlockTime.Value;
-                    var poolEffort = await cf.Run(con => shareRepo.GetEffortBetweenCreatedAsync(con, config.Id, pool.ShareMultiplier, startTime, clock.Now, ct));
+                    var poolEffort = await cf.Run(ConnectionIntent.ReadStale, con => shareRepo.GetEffortBetweenCreatedAsync(con, config.Id, pool.ShareMultiplier, startTime, clock.Now, ct));
                     if(poolEffort.HasValue)
                         result.PoolEffort = poolEffort.Value;
                 }
 
                 var from = clock.Now.AddHours(-topMinersRange);
 
-                var minersByHashrate = await cf.Run(con => statsRepo.PagePoolMinersByHashrateAsync(con, config.Id, from, 0, 15, ct));
+                var minersByHashrate = await cf.Run(ConnectionIntent.ReadStale, con => statsRepo.PagePoolMinersByHashrateAsync(con, config.Id, from, 0, 15, ct));
 
                 result.TopMiners = minersByHashrate.Select(mapper.Map<MinerPerformanceStats>).ToArray();
 
@@ -128,7 +139,7 @@ public class PoolApiController : ApiControllerBase
         var pool = GetPool(poolId);
 
         // load stats
-        var stats = await cf.Run(con => statsRepo.GetLastPoolStatsAsync(con, pool.Id, ct));
+        var stats = await cf.Run(ConnectionIntent.ReadStale, con => statsRepo.GetLastPoolStatsAsync(con, pool.Id, ct));
 
         // get pool
         pools.TryGetValue(pool.Id, out var poolInstance);
@@ -139,26 +150,26 @@ public class PoolApiController : ApiControllerBase
         };
 
         // enrich
-        response.Pool.TotalPaid = await cf.Run(con => statsRepo.GetTotalPoolPaymentsAsync(con, pool.Id, ct));
-        response.Pool.TotalBlocks = await cf.Run(con => blocksRepo.GetPoolBlockCountAsync(con, pool.Id, ct));
-        response.Pool.TotalConfirmedBlocks = await cf.Run(con => blocksRepo.GetTotalConfirmedBlocksAsync(con, pool.Id, ct));
-        response.Pool.TotalPendingBlocks = await cf.Run(con => blocksRepo.GetTotalPendingBlocksAsync(con, pool.Id, ct));
+        response.Pool.TotalPaid = await cf.Run(ConnectionIntent.ReadStale, con => statsRepo.GetTotalPoolPaymentsAsync(con, pool.Id, ct));
+        response.Pool.TotalBlocks = await cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.GetPoolBlockCountAsync(con, pool.Id, ct));
+        response.Pool.TotalConfirmedBlocks = await cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.GetTotalConfirmedBlocksAsync(con, pool.Id, ct));
+        response.Pool.TotalPendingBlocks = await cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.GetTotalPendingBlocksAsync(con, pool.Id, ct));
         // get reward of the last confirmed block and set BlockReward
-        response.Pool.BlockReward = await cf.Run(con => blocksRepo.GetLastConfirmedBlockRewardAsync(con, pool.Id, ct));
-        var lastBlockTime = await cf.Run(con => blocksRepo.GetLastPoolBlockTimeAsync(con, pool.Id, ct));
+        response.Pool.BlockReward = await cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.GetLastConfirmedBlockRewardAsync(con, pool.Id, ct));
+        var lastBlockTime = await cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.GetLastPoolBlockTimeAsync(con, pool.Id, ct));
         response.Pool.LastPoolBlockTime = lastBlockTime;
 
         if(lastBlockTime.HasValue)
         {
             var startTime = lastBlockTime.Value;
-            var poolEffort = await cf.Run(con => shareRepo.GetEffortBetweenCreatedAsync(con, pool.Id, poolInstance.ShareMultiplier, startTime, clock.Now, ct));
+            var poolEffort = await cf.Run(ConnectionIntent.ReadStale, con => shareRepo.GetEffortBetweenCreatedAsync(con, pool.Id, poolInstance.ShareMultiplier, startTime, clock.Now, ct));
             if(poolEffort.HasValue)
                 response.Pool.PoolEffort = poolEffort.Value;
         }
 
         var from = clock.Now.AddHours(-topMinersRange);
 
-        response.Pool.TopMiners = (await cf.Run(con => statsRepo.PagePoolMinersByHashrateAsync(con, pool.Id, from, 0, 15, ct)))
+        response.Pool.TopMiners = (await cf.Run(ConnectionIntent.ReadStale, con => statsRepo.PagePoolMinersByHashrateAsync(con, pool.Id, from, 0, 15, ct)))
             .Select(mapper.Map<MinerPerformanceStats>)
             .ToArray();
 
@@ -191,7 +202,7 @@ public class PoolApiController : ApiControllerBase
                 throw new ApiException("invalid interval");
         }
 
-        var stats = await cf.Run(con => statsRepo.GetPoolPerformanceBetweenAsync(con, pool.Id, interval, start, end, ct));
+        var stats = await cf.Run(ConnectionIntent.ReadStale, con => statsRepo.GetPoolPerformanceBetweenAsync(con, pool.Id, interval, start, end, ct));
 
         var response = new GetPoolStatsResponse
         {
@@ -212,7 +223,7 @@ public class PoolApiController : ApiControllerBase
         var end = clock.Now;
         var start = end.AddHours(-topMinersRange);
 
-        var miners = (await cf.Run(con => statsRepo.PagePoolMinersByHashrateAsync(con, pool.Id, start, page, pageSize, ct)))
+        var miners = (await cf.Run(ConnectionIntent.ReadStale, con => statsRepo.PagePoolMinersByHashrateAsync(con, pool.Id, start, page, pageSize, ct)))
             .Select(mapper.Map<MinerPerformanceStats>)
             .ToArray();
 
@@ -230,7 +241,7 @@ public class PoolApiController : ApiControllerBase
             state :
             new[] { BlockStatus.Confirmed, BlockStatus.Pending, BlockStatus.Orphaned };
 
-        var blocks = (await cf.Run(con => blocksRepo.PageBlocksAsync(con, pool.Id, blockStates, page, pageSize, ct)))
+        var blocks = (await cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.PageBlocksAsync(con, pool.Id, blockStates, page, pageSize, ct)))
             .Select(mapper.Map<Responses.Block>)
             .ToArray();
 
@@ -268,10 +279,10 @@ public class PoolApiController : ApiControllerBase
             state :
             new[] { BlockStatus.Confirmed, BlockStatus.Pending, BlockStatus.Orphaned };
             
-        uint itemCount = await cf.Run(con => blocksRepo.GetPoolBlockCountAsync(con, poolId, ct));
+        uint itemCount = await cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.GetPoolBlockCountAsync(con, poolId, ct));
         uint pageCount = (uint) Math.Floor(itemCount / (double) pageSize);
 
-        var blocks = (await cf.Run(con => blocksRepo.PageBlocksAsync(con, pool.Id, blockStates, page, pageSize, ct)))
+        var blocks = (await cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.PageBlocksAsync(con, pool.Id, blockStates, page, pageSize, ct)))
             .Select(mapper.Map<Responses.Block>)
             .ToArray();
 
@@ -306,7 +317,7 @@ public class PoolApiController : ApiControllerBase
         var pool = GetPool(poolId);
         var ct = HttpContext.RequestAborted;
 
-        var payments = (await cf.Run(con => paymentsRepo.PagePaymentsAsync(
+        var payments = (await cf.Run(ConnectionIntent.ReadStale, con => paymentsRepo.PagePaymentsAsync(
                 con, pool.Id, null, page, pageSize, ct)))
             .Select(mapper.Map<Responses.Payment>)
             .ToArray();
@@ -336,10 +347,10 @@ public class PoolApiController : ApiControllerBase
         var pool = GetPool(poolId);
         var ct = HttpContext.RequestAborted;
 
-        uint itemCount = await cf.Run(con => paymentsRepo.GetPaymentsCountAsync(con, poolId, null, ct));
+        uint itemCount = await cf.Run(ConnectionIntent.ReadStale, con => paymentsRepo.GetPaymentsCountAsync(con, poolId, null, ct));
         uint pageCount = (uint) Math.Floor(itemCount / (double) pageSize);
 
-        var payments = (await cf.Run(con => paymentsRepo.PagePaymentsAsync(
+        var payments = (await cf.Run(ConnectionIntent.ReadStale, con => paymentsRepo.PagePaymentsAsync(
                 con, pool.Id, null, page, pageSize, ct)))
             .Select(mapper.Map<Responses.Payment>)
             .ToArray();
@@ -364,7 +375,8 @@ public class PoolApiController : ApiControllerBase
     }
 
     [HttpGet("{poolId}/miners/{address}")]
-    public async Task<Responses.MinerStats> GetMinerInfoAsync(
+    [ProducesResponseType(typeof(Responses.MinerStats), (int) HttpStatusCode.OK)]
+    public async Task<IActionResult> GetMinerInfoAsync(
         string poolId, string address, [FromQuery] SampleRange perfMode = SampleRange.Day)
     {
         var pool = GetPool(poolId);
@@ -376,50 +388,23 @@ public class PoolApiController : ApiControllerBase
         if(pool.Template.Family == CoinFamily.Ethereum)
             address = address.ToLower();
 
-        var statsResult = await cf.RunTx((con, tx) =>
-            statsRepo.GetMinerStatsAsync(con, tx, pool.Id, address, ct), true, IsolationLevel.Serializable);
-
-        Responses.MinerStats stats = null;
-
-        if(statsResult != null)
+        if(!minerResponseCache.TryGet(pool.Id, address, perfMode, out var entry, out var ticket))
         {
-            stats = mapper.Map<Responses.MinerStats>(statsResult);
+            var stats = await GetMinerStatsInternal(pool, address, perfMode, ct);
+            var json = stats != null ? JsonSerializer.SerializeToUtf8Bytes(stats, jsonSerializerOptions) : null;
 
-            // pre-multiply pending shares to cause less confusion with users
-            if(pool.Template.Family == CoinFamily.Bitcoin)
-                stats.PendingShares *= pool.Template.As<BitcoinTemplate>().ShareMultiplier;
+            entry = minerResponseCache.Set(ticket, json);
+        }
 
-            // optional fields
-            if(statsResult.LastPayment != null)
-            {
-                // Set timestamp of last payment
-                stats.LastPayment = statsResult.LastPayment.Created;
+        if(entry.Json == null)
+            return NoContent();
 
-                // Compute info link
-                var baseUrl = pool.Template.ExplorerTxLink;
-                if(!string.IsNullOrEmpty(baseUrl))
-                    stats.LastPaymentLink = string.Format(baseUrl, statsResult.LastPayment.TransactionConfirmationData);
-            }
+        Response.Headers[HeaderNames.ETag] = entry.ETag;
 
-            var lastBlockTime = await cf.Run(con => blocksRepo.GetLastPoolBlockTimeAsync(con, pool.Id, ct));
-            if(lastBlockTime.HasValue)
-            {
-                var startTime = lastBlockTime.Value;
-                var minerEffort = await cf.Run(con => shareRepo.GetMinerEffortBetweenCreatedAsync(con, pool.Id, address, startTime, clock.Now, ct));
-                if(minerEffort.HasValue)
-                    stats.MinerEffort = minerEffort.Value;
-            }
-
-            stats.PerformanceSamples = await GetMinerPerformanceInternal(perfMode, pool, address, ct);
+        if(Request.GetTypedHeaders().IfNoneMatch?.Any(x => x.Tag == entry.ETag || x.Equals(EntityTagHeaderValue.Any)) == true)
+            return StatusCode((int) HttpStatusCode.NotModified);
 
-            // add total confirmed and pending blocks
-            var totalConfirmedBlocks = await cf.Run(con => statsRepo.GetMinerTotalConfirmedBlocksAsync(con, pool.Id, address, ct));
-            var totalPendingBlocks = await cf.Run(con => statsRepo.GetMinerTotalPendingBlocksAsync(con, pool.Id, address, ct));
-            stats.TotalConfirmedBlocks = totalConfirmedBlocks;
-            stats.TotalPendingBlocks = totalPendingBlocks;
-        }
-
-        return stats;
+        return File(entry.Json, "application/json; charset=utf-8");
     }
 
     [HttpGet("{poolId}/miners/{address}/blocks")]
@@ -439,7 +424,7 @@ public class PoolApiController : ApiControllerBase
             state :
             new[] { BlockStatus.Confirmed, BlockStatus.Pending, BlockStatus.Orphaned };
 
-        var blocks = (await cf.Run(con => blocksRepo.PageMinerBlocksAsync(con, pool.Id, address, blockStates, page, pageSize, ct)))
+        var blocks = (await cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.PageMinerBlocksAsync(con, pool.Id, address, blockStates, page, pageSize, ct)))
             .Select(mapper.Map<Responses.Block>)
             .ToArray();
 
@@ -483,10 +468,10 @@ public class PoolApiController : ApiControllerBase
             state :
             new[] { BlockStatus.Confirmed, BlockStatus.Pending, BlockStatus.Orphaned };
         
-        uint itemCount = await cf.Run(con => blocksRepo.GetMinerBlockCountAsync(con, poolId, address, ct));
+        uint itemCount = await cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.GetMinerBlockCountAsync(con, poolId, address, ct));
         uint pageCount = (uint) Math.Floor(itemCount / (double) pageSize);
 
-        var blocks = (await cf.Run(con => blocksRepo.PageMinerBlocksAsync(con, pool.Id, address, blockStates, page, pageSize, ct)))
+        var blocks = (await cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.PageMinerBlocksAsync(con, pool.Id, address, blockStates, page, pageSize, ct)))
             .Select(mapper.Map<Responses.Block>)
             .ToArray();
 
@@ -527,7 +512,7 @@ public class PoolApiController : ApiControllerBase
         if(pool.Template.Family == CoinFamily.Ethereum)
             address = address.ToLower();
 
-        var payments = (await cf.Run(con => paymentsRepo.PagePaymentsAsync(
+        var payments = (await cf.Run(ConnectionIntent.ReadStale, con => paymentsRepo.PagePaymentsAsync(
                 con, pool.Id, address, page, pageSize, ct)))
             .Select(mapper.Map<Responses.Payment>)
             .ToArray();
@@ -563,10 +548,10 @@ public class PoolApiController : ApiControllerBase
         if(pool.Template.Family == CoinFamily.Ethereum)
             address = address.ToLower();
         
-        uint itemCount = await cf.Run(con => paymentsRepo.GetPaymentsCountAsync(con, poolId, address, ct));
+        uint itemCount = await cf.Run(ConnectionIntent.ReadStale, con => paymentsRepo.GetPaymentsCountAsync(con, poolId, address, ct));
         uint pageCount = (uint) Math.Floor(itemCount / (double) pageSize);
 
-        var payments = (await cf.Run(con => paymentsRepo.PagePaymentsAsync(
+        var payments = (await cf.Run(ConnectionIntent.ReadStale, con => paymentsRepo.PagePaymentsAsync(
                 con, pool.Id, address, page, pageSize, ct)))
             .Select(mapper.Map<Responses.Payment>)
             .ToArray();
@@ -603,7 +588,7 @@ public class PoolApiController : ApiControllerBase
         if(pool.Template.Family == CoinFamily.Ethereum)
             address = address.ToLower();
 
-        var balanceChanges = (await cf.Run(con => paymentsRepo.PageBalanceChangesAsync(
+        var balanceChanges = (await cf.Run(ConnectionIntent.ReadStale, con => paymentsRepo.PageBalanceChangesAsync(
                 con, pool.Id, address, page, pageSize, ct)))
             .Select(mapper.Map<Responses.BalanceChange>)
             .ToArray();
@@ -624,10 +609,10 @@ public class PoolApiController : ApiControllerBase
         if(pool.Template.Family == CoinFamily.Ethereum)
             address = address.ToLower();
         
-        uint itemCount = await cf.Run(con => paymentsRepo.GetBalanceChangesCountAsync(con, poolId, address));
+        uint itemCount = await cf.Run(ConnectionIntent.ReadStale, con => paymentsRepo.GetBalanceChangesCountAsync(con, poolId, address));
         uint pageCount = (uint) Math.Floor(itemCount / (double) pageSize);
 
-        var balanceChanges = (await cf.Run(con => paymentsRepo.PageBalanceChangesAsync(
+        var balanceChanges = (await cf.Run(ConnectionIntent.ReadStale, con => paymentsRepo.PageBalanceChangesAsync(
                 con, pool.Id, address, page, pageSize, ct)))
             .Select(mapper.Map<Responses.BalanceChange>)
             .ToArray();
@@ -649,7 +634,7 @@ public class PoolApiController : ApiControllerBase
         if(pool.Template.Family == CoinFamily.Ethereum)
             address = address.ToLower();
 
-        var earnings = (await cf.Run(con => paymentsRepo.PageMinerPaymentsByDayAsync(
+        var earnings = (await cf.Run(ConnectionIntent.ReadStale, con => paymentsRepo.PageMinerPaymentsByDayAsync(
                 con, pool.Id, address, page, pageSize, ct)))
             .ToArray();
 
@@ -669,10 +654,10 @@ public class PoolApiController : ApiControllerBase
         if(pool.Template.Family == CoinFamily.Ethereum)
             address = address.ToLower();
 
-        uint itemCount = await cf.Run(con => paymentsRepo.GetMinerPaymentsByDayCountAsync(con, poolId, address));
+        uint itemCount = await cf.Run(ConnectionIntent.ReadStale, con => paymentsRepo.GetMinerPaymentsByDayCountAsync(con, poolId, address));
         uint pageCount = (uint) Math.Floor(itemCount / (double) pageSize);
 
-        var earnings = (await cf.Run(con => paymentsRepo.PageMinerPaymentsByDayAsync(
+        var earnings = (await cf.Run(ConnectionIntent.ReadStale, con => paymentsRepo.PageMinerPaymentsByDayAsync(
                 con, pool.Id, address, page, pageSize, ct)))
             .ToArray();
 
@@ -709,7 +694,7 @@ public class PoolApiController : ApiControllerBase
         if(pool.Template.Family == CoinFamily.Ethereum)
             address = address.ToLower();
 
-        var result = await cf.Run(con => minerRepo.GetSettingsAsync(con, null, pool.Id, address));
+        var result = await cf.Run(ConnectionIntent.Read, con => minerRepo.GetSettingsAsync(con, null, pool.Id, address));
 
         if(result == null)
             throw new ApiException("No settings found", HttpStatusCode.NotFound);
@@ -736,7 +721,7 @@ public class PoolApiController : ApiControllerBase
             throw new ApiException("Invalid IP address", HttpStatusCode.BadRequest);
 
         // fetch recent IPs
-        var ips = await cf.Run(con => shareRepo.GetRecentyUsedIpAddressesAsync(con, null, poolId, address, ct));
+        var ips = await cf.Run(ConnectionIntent.ReadStale, con => shareRepo.GetRecentyUsedIpAddressesAsync(con, null, poolId, address, ct));
 
         // any known ips?
         if(ips == null || ips.Length == 0)
@@ -768,8 +753,190 @@ public class PoolApiController : ApiControllerBase
         });
     }
 
+    [HttpGet("/api/v3/pools/{poolId}/miners")]
+    public async Task<CursorResultResponse<MinerPerformanceStats[]>> PagePoolMinersV3Async(
+        string poolId, [FromQuery] string next = null, [FromQuery] int pageSize = 15, [FromQuery] uint topMinersRange = 24)
+    {
+        var pool = GetPool(poolId);
+        var ct = HttpContext.RequestAborted;
+        var after = ContinuationToken.DecodeMinerHashrateCursor(next);
+
+        // set range
+        var end = clock.Now;
+        var start = end.AddHours(-topMinersRange);
+
+        var miners = await cf.Run(ConnectionIntent.ReadStale, con => statsRepo.PagePoolMinersByHashrateAsync(con, pool.Id, start, after, pageSize, ct));
+
+        // connected miners is the closest thing to a count we have without aggregating the whole range twice
+        pools.TryGetValue(pool.Id, out var poolInstance);
+        var itemCount = poolInstance?.PoolStats?.ConnectedMiners ?? 0;
+        var result = miners.Select(mapper.Map<MinerPerformanceStats>).ToArray();
+
+        return new CursorResultResponse<MinerPerformanceStats[]>(result, (uint) itemCount,
+            miners.Length == pageSize ? ContinuationToken.Encode(miners[^1]) : null);
+    }
+
+    [HttpGet("/api/v3/pools/{poolId}/blocks")]
+    public async Task<CursorResultResponse<Responses.Block[]>> PagePoolBlocksV3Async(
+        string poolId, [FromQuery] string next = null, [FromQuery] int pageSize = 15, [FromQuery] BlockStatus[] state = null)
+    {
+        var pool = GetPool(poolId);
+        var ct = HttpContext.RequestAborted;
+        var after = ContinuationToken.DecodePageCursor(next);
+
+        var blockStates = state is { Length: > 0 } ?
+            state :
+            new[] { BlockStatus.Confirmed, BlockStatus.Pending, BlockStatus.Orphaned };
+
+        var itemCount = await itemCountCache.GetOrAddAsync($"{pool.Id}:blocks", () =>
+            cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.GetPoolBlockCountAsync(con, pool.Id, CancellationToken.None)));
+
+        var blocks = await cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.PageBlocksAsync(con, pool.Id, blockStates, after, pageSize, ct));
+
+        return new CursorResultResponse<Responses.Block[]>(MapBlocks(pool, blocks), itemCount,
+            blocks.Length == pageSize ? ContinuationToken.Encode(new PageCursor(blocks[^1].Created, blocks[^1].Id)) : null);
+    }
+
+    [HttpGet("/api/v3/pools/{poolId}/payments")]
+    public async Task<CursorResultResponse<Responses.Payment[]>> PagePoolPaymentsV3Async(
+        string poolId, [FromQuery] string next = null, [FromQuery] int pageSize = 15)
+    {
+        var pool = GetPool(poolId);
+        var ct = HttpContext.RequestAborted;
+        var after = ContinuationToken.DecodePageCursor(next);
+
+        var itemCount = await itemCountCache.GetOrAddAsync($"{pool.Id}:payments", () =>
+            cf.Run(ConnectionIntent.ReadStale, con => paymentsRepo.GetPaymentsCountAsync(con, pool.Id, null, CancellationToken.None)));
+
+        var payments = await cf.Run(ConnectionIntent.ReadStale, con => paymentsRepo.PagePaymentsAsync(con, pool.Id, null, after, pageSize, ct));
+
+        return new CursorResultResponse<Responses.Payment[]>(MapPayments(pool, payments), itemCount,
+            payments.Length == pageSize ? ContinuationToken.Encode(new PageCursor(payments[^1].Created, payments[^1].Id)) : null);
+    }
+
+    [HttpGet("/api/v3/pools/{poolId}/miners/{address}/blocks")]
+    public async Task<CursorResultResponse<Responses.Block[]>> PageMinerBlocksV3Async(
+        string poolId, string address, [FromQuery] string next = null, [FromQuery] int pageSize = 15, [FromQuery] BlockStatus[] state = null)
+    {
+        var pool = GetPool(poolId);
+        var ct = HttpContext.RequestAborted;
+        var after = ContinuationToken.DecodePageCursor(next);
+
+        if(string.IsNullOrEmpty(address))
+            throw new ApiException("Invalid or missing miner address", HttpStatusCode.NotFound);
+
+        if(pool.Template.Family == CoinFamily.Ethereum)
+            address = address.ToLower();
+
+        var blockStates = state is { Length: > 0 } ?
+            state :
+            new[] { BlockStatus.Confirmed, BlockStatus.Pending, BlockStatus.Orphaned };
+
+        var itemCount = await itemCountCache.GetOrAddAsync($"{pool.Id}:blocks:{address}", () =>
+            cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.GetMinerBlockCountAsync(con, pool.Id, address, CancellationToken.None)));
+
+        var blocks = await cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.PageMinerBlocksAsync(con, pool.Id, address, blockStates, after, pageSize, ct));
+
+        return new CursorResultResponse<Responses.Block[]>(MapBlocks(pool, blocks), itemCount,
+            blocks.Length == pageSize ? ContinuationToken.Encode(new PageCursor(blocks[^1].Created, blocks[^1].Id)) : null);
+    }
+
+    [HttpGet("/api/v3/pools/{poolId}/miners/{address}/payments")]
+    public async Task<CursorResultResponse<Responses.Payment[]>> PageMinerPaymentsV3Async(
+        string poolId, string address, [FromQuery] string next = null, [FromQuery] int pageSize = 15)
+    {
+        var pool = GetPool(poolId);
+        var ct = HttpContext.RequestAborted;
+        var after = ContinuationToken.DecodePageCursor(next);
+
+        if(string.IsNullOrEmpty(address))
+            throw new ApiException("Invalid or missing miner address", HttpStatusCode.NotFound);
+
+        if(pool.Template.Family == CoinFamily.Ethereum)
+            address = address.ToLower();
+
+        var itemCount = await itemCountCache.GetOrAddAsync($"{pool.Id}:payments:{address}", () =>
+            cf.Run(ConnectionIntent.ReadStale, con => paymentsRepo.GetPaymentsCountAsync(con, pool.Id, address, CancellationToken.None)));
+
+        var payments = await cf.Run(ConnectionIntent.ReadStale, con => paymentsRepo.PagePaymentsAsync(con, pool.Id, address, after, pageSize, ct));
+
+        return new CursorResultResponse<Responses.Payment[]>(MapPayments(pool, payments), itemCount,
+            payments.Length == pageSize ? ContinuationToken.Encode(new PageCursor(payments[^1].Created, payments[^1].Id)) : null);
+    }
+
+    [HttpGet("/api/v3/pools/{poolId}/miners/{address}/balancechanges")]
+    public async Task<CursorResultResponse<Responses.BalanceChange[]>> PageMinerBalanceChangesV3Async(
+        string poolId, string address, [FromQuery] string next = null, [FromQuery] int pageSize = 15)
+    {
+        var pool = GetPool(poolId);
+        var ct = HttpContext.RequestAborted;
+        var after = ContinuationToken.DecodePageCursor(next);
+
+        if(string.IsNullOrEmpty(address))
+            throw new ApiException("Invalid or missing miner address", HttpStatusCode.NotFound);
+
+        if(pool.Template.Family == CoinFamily.Ethereum)
+            address = address.ToLower();
+
+        var itemCount = await itemCountCache.GetOrAddAsync($"{pool.Id}:balancechanges:{address}", () =>
+            cf.Run(ConnectionIntent.ReadStale, con => paymentsRepo.GetBalanceChangesCountAsync(con, pool.Id, address)));
+
+        var balanceChanges = await cf.Run(ConnectionIntent.ReadStale, con => paymentsRepo.PageBalanceChangesAsync(con, pool.Id, address, after, pageSize, ct));
+
+        return new CursorResultResponse<Responses.BalanceChange[]>(balanceChanges.Select(mapper.Map<Responses.BalanceChange>).ToArray(), itemCount,
+            balanceChanges.Length == pageSize ? ContinuationToken.Encode(new PageCursor(balanceChanges[^1].Created, balanceChanges[^1].Id)) : null);
+    }
+
     #endregion // Actions
 
+    private async Task<Responses.MinerStats> GetMinerStatsInternal(PoolConfig pool, string address, SampleRange perfMode, CancellationToken ct)
+    {
+        var statsResult = await cf.RunTx((con, tx) =>
+            statsRepo.GetMinerStatsAsync(con, tx, pool.Id, address, ct), true, IsolationLevel.Serializable);
+
+        Responses.MinerStats stats = null;
+
+        if(statsResult != null)
+        {
+            stats = mapper.Map<Responses.MinerStats>(statsResult);
+
+            // pre-multiply pending shares to cause less confusion with users
+            if(pool.Template.Family == CoinFamily.Bitcoin)
+                stats.PendingShares *= pool.Template.As<BitcoinTemplate>().ShareMultiplier;
+
+            // optional fields
+            if(statsResult.LastPayment != null)
+            {
+                // Set timestamp of last payment
+                stats.LastPayment = statsResult.LastPayment.Created;
+
+                // Compute info link
+                var baseUrl = pool.Template.ExplorerTxLink;
+                if(!string.IsNullOrEmpty(baseUrl))
+                    stats.LastPaymentLink = string.Format(baseUrl, statsResult.LastPayment.TransactionConfirmationData);
+            }
+
+            var lastBlockTime = await cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.GetLastPoolBlockTimeAsync(con, pool.Id, ct));
+            if(lastBlockTime.HasValue)
+            {
+                var startTime = lastBlockTime.Value;
+                var minerEffort = await cf.Run(ConnectionIntent.ReadStale, con => shareRepo.GetMinerEffortBetweenCreatedAsync(con, pool.Id, address, startTime, clock.Now, ct));
+                if(minerEffort.HasValue)
+                    stats.MinerEffort = minerEffort.Value;
+            }
+
+            stats.PerformanceSamples = await GetMinerPerformanceInternal(perfMode, pool, address, ct);
+
+            // add total confirmed and pending blocks
+            var totalConfirmedBlocks = await cf.Run(ConnectionIntent.ReadStale, con => statsRepo.GetMinerTotalConfirmedBlocksAsync(con, pool.Id, address, ct));
+            var totalPendingBlocks = await cf.Run(ConnectionIntent.ReadStale, con => statsRepo.GetMinerTotalPendingBlocksAsync(con, pool.Id, address, ct));
+            stats.TotalConfirmedBlocks = totalConfirmedBlocks;
+            stats.TotalPendingBlocks = totalPendingBlocks;
+        }
+
+        return stats;
+    }
+
     private async Task<Responses.WorkerPerformanceStatsContainer[]> GetMinerPerformanceInternal(
         SampleRange mode, PoolConfig pool, string address, CancellationToken ct)
     {
@@ -784,7 +951,7 @@ public class PoolApiController : ApiControllerBase
 
                 start = end.AddHours(-1);
 
-                stats = await cf.Run(con => statsRepo.GetMinerPerformanceBetweenThreeMinutelyAsync(con, pool.Id, address, start, end, ct));
+                stats = await cf.Run(ConnectionIntent.ReadStale, con => statsRepo.GetMinerPerformanceBetweenThreeMinutelyAsync(con, pool.Id, address, start, end, ct));
                 break;
 
             case SampleRange.Day:
@@ -797,7 +964,7 @@ public class PoolApiController : ApiControllerBase
 
                 start = end.AddDays(-1);
 
-                stats = await cf.Run(con => statsRepo.GetMinerPerformanceBetweenHourlyAsync(con, pool.Id, address, start, end, ct));
+                stats = await cf.Run(ConnectionIntent.ReadStale, con => statsRepo.GetMinerPerformanceBetweenHourlyAsync(con, pool.Id, address, start, end, ct));
                 break;
 
             case SampleRange.Month:
@@ -809,7 +976,7 @@ public class PoolApiController : ApiControllerBase
                 // set range
                 start = end.AddMonths(-1);
 
-                stats = await cf.Run(con => statsRepo.GetMinerPerformanceBetweenDailyAsync(con, pool.Id, address, start, end, ct));
+                stats = await cf.Run(ConnectionIntent.ReadStale, con => statsRepo.GetMinerPerformanceBetweenDailyAsync(con, pool.Id, address, start, end, ct));
                 break;
         }
 
@@ -817,4 +984,57 @@ public class PoolApiController : ApiControllerBase
         var result = mapper.Map<Responses.WorkerPerformanceStatsContainer[]>(stats);
         return result;
     }
+
+    private Responses.Block[] MapBlocks(PoolConfig pool, Persistence.Model.Block[] blocks)
+    {
+        var result = blocks
+            .Select(mapper.Map<Responses.Block>)
+            .ToArray();
+
+        // enrich blocks
+        var blockInfobaseDict = pool.Template.ExplorerBlockLinks;
+
+        foreach(var block in result)
+        {
+            // compute infoLink
+            if(blockInfobaseDict != null)
+            {
+                blockInfobaseDict.TryGetValue(!string.IsNullOrEmpty(block.Type) ? block.Type : "block", out var blockInfobaseUrl);
+
+                if(!string.IsNullOrEmpty(blockInfobaseUrl))
+                {
+                    if(blockInfobaseUrl.Contains(CoinMetaData.BlockHeightPH))
+                        block.InfoLink = blockInfobaseUrl.Replace(CoinMetaData.BlockHeightPH, block.BlockHeight.ToString(CultureInfo.InvariantCulture));
+                    else if(blockInfobaseUrl.Contains(CoinMetaData.BlockHashPH) && !string.IsNullOrEmpty(block.Hash))
+                        block.InfoLink = blockInfobaseUrl.Replace(CoinMetaData.BlockHashPH, block.Hash);
+                }
+            }
+        }
+
+        return result;
+    }
+
+    private Responses.Payment[] MapPayments(PoolConfig pool, Persistence.Model.Payment[] payments)
+    {
+        var result = payments
+            .Select(mapper.Map<Responses.Payment>)
+            .ToArray();
+
+        // enrich payments
+        var txInfobaseUrl = pool.Template.ExplorerTxLink;
+        var addressInfobaseUrl = pool.Template.ExplorerAccountLink;
+
+        foreach(var payment in result)
+        {
+            // compute transaction infoLink
+            if(!string.IsNullOrEmpty(txInfobaseUrl))
+                payment.TransactionInfoLink = string.Format(txInfobaseUrl, payment.TransactionConfirmationData);
+
+            // pool wallet link
+            if(!string.IsNullOrEmpty(addressInfobaseUrl))
+                payment.AddressInfoLink = string.Format(addressInfobaseUrl, payment.Address);
+        }
+
+        return result;
+    }
 }
@@ -0,0 +1,46 @@
+using Microsoft.Extensions.Caching.Memory;
+
+namespace Miningcore.Api;
+
+/// <summary>
+/// Caches item counts for paged API results so that deep pagination doesn't pay for a COUNT(*) on every request.
+/// Concurrent requests for the same key share a single query.
+/// </summary>
+public class ItemCountCache
+{
+    public ItemCountCache(TimeSpan? ttl = null)
+    {
+        this.ttl = ttl ?? TimeSpan.FromMinutes(5);
+    }
+
+    private readonly TimeSpan ttl;
+
+    private readonly MemoryCache cache = new(new MemoryCacheOptions
+    {
+        ExpirationScanFrequency = TimeSpan.FromMinutes(1),
+        SizeLimit = 100_000
+    });
+
+    public async Task<uint> GetOrAddAsync(string key, Func<Task<uint>> factory)
+    {
+        var entry = cache.GetOrCreate(key, e =>
+        {
+            e.AbsoluteExpirationRelativeToNow = ttl;
+            e.Size = 1;
+
+            return new Lazy<Task<uint>>(factory);
+        });
+
+        try
+        {
+            return await entry.Value;
+        }
+
+        catch
+        {
+            // don't cache failures
+            cache.Remove(key);
+            throw;
+        }
+    }
+}
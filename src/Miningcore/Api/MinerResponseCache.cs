@@ -0,0 +1,196 @@
+using System.Reactive.Linq;
+using System.Security.Cryptography;
+using Miningcore.Messaging;
+using Miningcore.Notifications.Messages;
+using Miningcore.Persistence.Model;
+using Miningcore.Time;
+using Contract = Miningcore.Contracts.Contract;
+
+namespace Miningcore.Api;
+
+/// <summary>
+/// Bounded LRU of pre-serialized miner stats responses keyed by pool, miner and performance range.
+/// Entries are dropped when the message bus reports something that changes the result:
+/// hashrate updates invalidate a single miner, blocks found, unlocked blocks and payments
+/// invalidate every miner of the pool.
+/// </summary>
+public class MinerResponseCache : IDisposable
+{
+    public MinerResponseCache(IMessageBus messageBus, IMasterClock clock, int capacity, TimeSpan maxAge)
+    {
+        Contract.RequiresNonNull(messageBus);
+        Contract.RequiresNonNull(clock);
+
+        this.clock = clock;
+        this.capacity = capacity;
+        this.maxAge = maxAge;
+
+        subscriptions = new[]
+        {
+            messageBus.Listen<HashrateNotification>()
+                .Where(x => !string.IsNullOrEmpty(x.Miner))
+                .Subscribe(x => Invalidate(x.PoolId, x.Miner)),
+
+            messageBus.Listen<BlockFoundNotification>().Subscribe(x => InvalidatePool(x.PoolId)),
+            messageBus.Listen<BlockUnlockedNotification>().Subscribe(x => InvalidatePool(x.PoolId)),
+            messageBus.Listen<PaymentNotification>().Subscribe(x => InvalidatePool(x.PoolId)),
+        };
+    }
+
+    public record Entry(byte[] Json, string ETag);
+
+    internal record Key(string PoolId, string Miner, SampleRange PerfMode);
+
+    internal class Node
+    {
+        public Key Key;
+        public long PoolGeneration;
+        public DateTime Created;
+        public Entry Value;
+    }
+
+    /// <summary>
+    /// Handed out on a miss. Only the fill whose ticket is still current when the response
+    /// has been built gets stored, so an invalidation racing a fill never leaves stale data behind.
+    /// </summary>
+    public class Ticket
+    {
+        internal Node Node;
+    }
+
+    private static readonly SampleRange[] perfModes = Enum.GetValues<SampleRange>();
+
+    private readonly IMasterClock clock;
+    private readonly int capacity;
+    private readonly TimeSpan maxAge;
+    private readonly IDisposable[] subscriptions;
+    private readonly object sync = new();
+    private readonly Dictionary<Key, LinkedListNode<Node>> map = new();
+    private readonly LinkedList<Node> lru = new();
+    private readonly Dictionary<string, long> poolGenerations = new();
+
+    public int Count
+    {
+        get
+        {
+            lock(sync)
+            {
+                return map.Count;
+            }
+        }
+    }
+
+    public bool TryGet(string poolId, string miner, SampleRange perfMode, out Entry entry, out Ticket ticket)
+    {
+        var key = new Key(poolId, miner, perfMode);
+        var now = clock.Now;
+
+        lock(sync)
+        {
+            var generation = GetPoolGeneration(poolId);
+
+            if(map.TryGetValue(key, out var item))
+            {
+                var node = item.Value;
+
+                if(node.Value != null && node.PoolGeneration == generation && now - node.Created < maxAge)
+                {
+                    lru.Remove(item);
+                    lru.AddFirst(item);
+
+                    entry = node.Value;
+                    ticket = null;
+                    return true;
+                }
+
+                map.Remove(key);
+                lru.Remove(item);
+            }
+
+            // park an empty node for the fill
+            var fill = new Node { Key = key, PoolGeneration = generation, Created = now };
+            var fillItem = lru.AddFirst(fill);
+            map[key] = fillItem;
+
+            Evict();
+
+            entry = null;
+            ticket = new Ticket { Node = fill };
+            return false;
+        }
+    }
+
+    /// <summary>
+    /// Stores the serialized response for a previous miss. Returns the entry regardless
+    /// of whether it could be cached.
+    /// </summary>
+    public Entry Set(Ticket ticket, byte[] json)
+    {
+        var entry = new Entry(json, json != null ? ComputeETag(json) : null);
+        var node = ticket.Node;
+
+        lock(sync)
+        {
+            if(map.TryGetValue(node.Key, out var item) && item.Value == node &&
+               node.PoolGeneration == GetPoolGeneration(node.Key.PoolId))
+                node.Value = entry;
+        }
+
+        return entry;
+    }
+
+    public void Invalidate(string poolId, string miner)
+    {
+        lock(sync)
+        {
+            foreach(var perfMode in perfModes)
+            {
+                var key = new Key(poolId, miner, perfMode);
+
+                if(map.Remove(key, out var item))
+                    lru.Remove(item);
+            }
+        }
+    }
+
+    public void InvalidatePool(string poolId)
+    {
+        if(poolId == null)
+            return;
+
+        // entries of the previous generation are discarded lazily or by LRU eviction
+        lock(sync)
+        {
+            poolGenerations[poolId] = GetPoolGeneration(poolId) + 1;
+        }
+    }
+
+    private long GetPoolGeneration(string poolId)
+    {
+        return poolGenerations.TryGetValue(poolId, out var generation) ? generation : 0;
+    }
+
+    private void Evict()
+    {
+        while(map.Count > capacity && lru.Last != null)
+        {
+            var last = lru.Last;
+
+            map.Remove(last.Value.Key);
+            lru.RemoveLast();
+        }
+    }
+
+    private static string ComputeETag(byte[] json)
+    {
+        var hash = SHA256.HashData(json);
+
+        return $"\"{Convert.ToHexString(hash, 0, 16)}\"";
+    }
+
+    public void Dispose()
+    {
+        foreach(var subscription in subscriptions)
+            subscription.Dispose();
+    }
+}
@@ -0,0 +1,20 @@
+namespace Miningcore.Api.Responses;
+
+public class CursorResultResponse<T> : ResultResponse<T>
+{
+    public CursorResultResponse(T result, uint itemCount, string next) : base(result)
+    {
+        ItemCount = itemCount;
+        Next = next;
+    }
+
+    /// <summary>
+    /// Approximate total number of items, refreshed periodically
+    /// </summary>
+    public uint ItemCount { get; private set; }
+
+    /// <summary>
+    /// Opaque token to pass as 'next' to retrieve the following page, null on the last page
+    /// </summary>
+    public string Next { get; private set; }
+}
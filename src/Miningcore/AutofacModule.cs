@@ -76,6 +76,8 @@ public class AutofacModule : Module
             .AsImplementedInterfaces()
             .SingleInstance();
 
+        builder.RegisterInstance(new ItemCountCache());
+
         builder.RegisterType<IntegratedBanManager>()
             .Keyed<IBanManager>(BanManagerKind.Integrated)
             .SingleInstance();
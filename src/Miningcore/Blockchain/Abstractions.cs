@@ -18,4 +18,14 @@ public interface IExtraNonceProvider
 {
     int ByteSize { get; }
     string Next();
+
+    /// <summary>
+    /// Returns a value handed out by <see cref="Next"/> whose session is gone for good
+    /// </summary>
+    void Release(string extraNonce);
+
+    /// <summary>
+    /// Makes sure a value handed out elsewhere is not issued by <see cref="Next"/>
+    /// </summary>
+    void Reserve(string extraNonce);
 }
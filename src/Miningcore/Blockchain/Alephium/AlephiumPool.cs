@@ -268,7 +268,7 @@ public class AlephiumPool : PoolBase
             var requestParams = request.ParamsAs<AlephiumWorkerSubmitParams>();
 
             // submit
-            var share = await manager.SubmitShareAsync(connection, requestParams, ct);
+            var share = await ValidateShareAsync(() => manager.SubmitShareAsync(connection, requestParams, ct));
 
             // Nicehash's stupid validator insists on "error" property present
             // in successful responses which is a violation of the JSON-RPC spec
@@ -287,9 +287,6 @@ public class AlephiumPool : PoolBase
             // publish
             messageBus.SendMessage(share);
 
-            // telemetry
-            PublishTelemetry(TelemetryCategory.Share, clock.Now - tsRequest.Timestamp.UtcDateTime, true);
-
             logger.Info(() => $"[{connection.ConnectionId}] Share accepted: D={Math.Round(share.Difficulty * AlephiumConstants.ShareMultiplier, 3)}");
 
             // update pool stats
@@ -297,18 +294,15 @@ public class AlephiumPool : PoolBase
                 poolStats.LastPoolBlockTime = clock.Now;
 
             // update client stats
-            context.Stats.ValidShares++;
+            context.Stats.RecordAccepted(share.Difficulty, clock.Now);
 
             await UpdateVarDiffAsync(connection, false, ct);
         }
 
         catch(AlephiumStratumException ex)
         {
-            // telemetry
-            PublishTelemetry(TelemetryCategory.Share, clock.Now - tsRequest.Timestamp.UtcDateTime, false);
-
             // update client stats
-            context.Stats.InvalidShares++;
+            context.Stats.RecordRejected(ex.Code == AlephiumStratumError.JobNotFound);
             logger.Info(() => $"[{connection.ConnectionId}] Share rejected: {ex.Message} [{context.UserAgent}]");
 
             // banning
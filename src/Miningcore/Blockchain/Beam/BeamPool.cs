@@ -230,7 +230,7 @@ public class BeamPool : PoolBase
             else
             {
                 // submit
-                var (share, stratumError) = manager.SubmitShare(connection, request?.Id, request?.Nonce, request?.Output, ct);
+                var (share, stratumError) = ValidateShare(() => manager.SubmitShare(connection, request?.Id, request?.Nonce, request?.Output, ct));
                 
                 if (stratumError == BeamConstants.BeamRpcInvalidShare)
                 {
@@ -330,9 +330,6 @@ public class BeamPool : PoolBase
                     // publish
                     messageBus.SendMessage(share);
 
-                    // telemetry
-                    PublishTelemetry(TelemetryCategory.Share, clock.Now - tsRequest.Timestamp.UtcDateTime, true);
-
                     logger.Info(() => $"[{connection.ConnectionId}] Share accepted: D={Math.Round(share.Difficulty, 3)}");
 
                     // update pool stats
@@ -340,7 +337,7 @@ public class BeamPool : PoolBase
                         poolStats.LastPoolBlockTime = clock.Now;
 
                     // update client stats
-                    context.Stats.ValidShares++;
+                    context.Stats.RecordAccepted(share.Difficulty, clock.Now);
 
                     await UpdateVarDiffAsync(connection, false, ct);
                 }
@@ -349,11 +346,8 @@ public class BeamPool : PoolBase
 
         catch(StratumException ex)
         {
-            // telemetry
-            PublishTelemetry(TelemetryCategory.Share, clock.Now - tsRequest.Timestamp.UtcDateTime, false);
-
             // update client stats
-            context.Stats.InvalidShares++;
+            context.Stats.RecordRejected(ex.Code == StratumError.JobNotFound);
             logger.Info(() => $"[{connection.ConnectionId}] Share rejected: {ex.Message} [{context.UserAgent}]");
 
             // banning
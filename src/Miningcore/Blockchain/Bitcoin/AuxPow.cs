@@ -0,0 +1,251 @@
+using System.Buffers.Binary;
+using System.Security.Cryptography;
+using Miningcore.Blockchain.Bitcoin.DaemonResponses;
+using Miningcore.Extensions;
+using NBitcoin;
+using Contract = Miningcore.Contracts.Contract;
+
+namespace Miningcore.Blockchain.Bitcoin;
+
+/// <summary>
+/// Block of a merge-mined chain
+/// </summary>
+/// <param name="Hash">Block hash as returned by the aux daemon (big-endian hex)</param>
+/// <param name="Target">Target the parent header hash has to meet</param>
+public record AuxPowBlock(string Symbol, string Hash, int ChainId, uint256 Target, ulong Height)
+{
+    /// <summary>
+    /// Converts a createauxblock/getauxblock result, returns null if it is incomplete
+    /// </summary>
+    public static AuxPowBlock FromAuxBlock(string symbol, AuxBlock block)
+    {
+        var target = block.Target ?? block.LegacyTarget;
+
+        if(string.IsNullOrEmpty(block.Hash) || block.Hash.Length != 64 || target?.Length != 64)
+            return null;
+
+        // the target is serialized in little-endian order
+        return new AuxPowBlock(symbol, block.Hash, block.ChainId, new uint256(target.HexToByteArray()), block.Height);
+    }
+}
+
+/// <summary>
+/// Proof that a parent chain share solved an aux block
+/// </summary>
+/// <param name="AuxPow">Serialized AuxPoW as expected by submitauxblock/getauxblock</param>
+public record AuxPowProof(AuxPowBlock Block, string AuxPow);
+
+/// <summary>
+/// Merkle tree over the aux blocks mined along with a parent chain job
+/// </summary>
+/// <remarks>
+/// Every chain occupies the slot derived from its chain id and the merkle nonce, so that a proof
+/// for one chain can't be replayed at a different position. The parent coinbase commits to the root.
+/// </remarks>
+/// <specification>https://en.bitcoin.it/wiki/Merged_mining_specification</specification>
+public class AuxPowWork
+{
+    private AuxPowWork(AuxPowBlock[] blocks, int merkleHeight, uint merkleNonce, int[] indexes)
+    {
+        Blocks = blocks;
+        MerkleHeight = merkleHeight;
+        MerkleNonce = merkleNonce;
+        this.indexes = indexes;
+
+        // leaves are the aux block hashes in internal byte order, unused slots stay zero
+        var leaves = new byte[1 << merkleHeight][];
+
+        for(var i = 0; i < leaves.Length; i++)
+            leaves[i] = new byte[32];
+
+        for(var i = 0; i < blocks.Length; i++)
+            leaves[indexes[i]] = blocks[i].Hash.HexToReverseByteArray();
+
+        levels = new List<byte[][]> { leaves };
+
+        while(levels[^1].Length > 1)
+        {
+            var level = levels[^1];
+            var next = new byte[level.Length / 2][];
+
+            for(var i = 0; i < next.Length; i++)
+                next[i] = DoubleDigest(level[i * 2], level[i * 2 + 1]);
+
+            levels.Add(next);
+        }
+
+        MerkleRoot = levels[^1][0];
+
+        // magic, root (big-endian), tree size, nonce
+        Commitment = new byte[MergedMiningHeader.Length + 32 + 4 + 4];
+        MergedMiningHeader.CopyTo(Commitment, 0);
+        MerkleRoot.ToArray().ReverseInPlace().CopyTo(Commitment, MergedMiningHeader.Length);
+        BinaryPrimitives.WriteUInt32LittleEndian(Commitment.AsSpan(MergedMiningHeader.Length + 32), MerkleSize);
+        BinaryPrimitives.WriteUInt32LittleEndian(Commitment.AsSpan(MergedMiningHeader.Length + 36), MerkleNonce);
+    }
+
+    public static readonly byte[] MergedMiningHeader = { 0xfa, 0xbe, 0x6d, 0x6d };
+
+    // Namecoin rejects chain merkle branches longer than 30, but a handful of aux chains never need more than a few levels
+    private const int MaxMerkleHeight = 8;
+    private const uint MaxMerkleNonce = 1024;
+
+    private readonly int[] indexes;
+    private readonly List<byte[][]> levels;
+
+    public IReadOnlyList<AuxPowBlock> Blocks { get; }
+    public int MerkleHeight { get; }
+    public uint MerkleSize => 1u << MerkleHeight;
+    public uint MerkleNonce { get; }
+
+    /// <summary>
+    /// Merkle root in internal byte order
+    /// </summary>
+    public byte[] MerkleRoot { get; }
+
+    /// <summary>
+    /// Data the parent coinbase scriptSig has to carry
+    /// </summary>
+    public byte[] Commitment { get; }
+
+    /// <summary>
+    /// Slot of the aux chain in the merkle tree, which is bound to its chain id
+    /// </summary>
+    public static uint GetExpectedIndex(uint nonce, int chainId, int merkleHeight)
+    {
+        unchecked
+        {
+            // Same pseudo-random walk as CAuxPow::getExpectedIndex
+            var rand = nonce;
+            rand = rand * 1103515245 + 12345;
+            rand += (uint) chainId;
+            rand = rand * 1103515245 + 12345;
+
+            return rand % (1u << merkleHeight);
+        }
+    }
+
+    /// <summary>
+    /// Builds the smallest tree with a nonce that puts every chain into a distinct slot
+    /// </summary>
+    public static AuxPowWork Create(IEnumerable<AuxPowBlock> blocks)
+    {
+        Contract.RequiresNonNull(blocks);
+
+        var items = blocks.ToArray();
+
+        Contract.Requires<ArgumentException>(items.Length > 0);
+        Contract.Requires<ArgumentException>(items.Select(x => x.ChainId).Distinct().Count() == items.Length, "duplicate aux chain id");
+
+        var minHeight = 0;
+
+        while((1 << minHeight) < items.Length)
+            minHeight++;
+
+        var indexes = new int[items.Length];
+        var used = new bool[1 << MaxMerkleHeight];
+
+        for(var height = minHeight; height <= MaxMerkleHeight; height++)
+        {
+            for(var nonce = 0u; nonce < MaxMerkleNonce; nonce++)
+            {
+                Array.Clear(used);
+
+                var i = 0;
+
+                for(; i < items.Length; i++)
+                {
+                    var index = (int) GetExpectedIndex(nonce, items[i].ChainId, height);
+
+                    if(used[index])
+                        break;
+
+                    used[index] = true;
+                    indexes[i] = index;
+                }
+
+                if(i == items.Length)
+                    return new AuxPowWork(items, height, nonce, indexes);
+            }
+        }
+
+        throw new InvalidOperationException($"Unable to fit {items.Length} aux chains into a merkle tree");
+    }
+
+    public int GetIndex(int block)
+    {
+        return indexes[block];
+    }
+
+    /// <summary>
+    /// Merkle branch leading from the aux block to the root
+    /// </summary>
+    public byte[][] GetBranch(int block)
+    {
+        var index = indexes[block];
+        var branch = new byte[MerkleHeight][];
+
+        for(var i = 0; i < MerkleHeight; i++, index >>= 1)
+            branch[i] = levels[i][index ^ 1];
+
+        return branch;
+    }
+
+    /// <summary>
+    /// True if both trees contain the same aux blocks
+    /// </summary>
+    public static bool IsSameWork(AuxPowWork a, AuxPowWork b)
+    {
+        if(a == null || b == null)
+            return a == b;
+
+        return a.Blocks.Select(x => x.Hash).SequenceEqual(b.Blocks.Select(x => x.Hash), StringComparer.OrdinalIgnoreCase);
+    }
+
+    /// <summary>
+    /// Serializes an AuxPoW: parent coinbase, its merkle branch into the parent header,
+    /// the aux chain merkle branch and the parent header itself
+    /// </summary>
+    /// <param name="parentHash">Parent block hash in internal byte order</param>
+    public static byte[] Serialize(byte[] coinbase, byte[] parentHash, IList<byte[]> coinbaseBranch,
+        IList<byte[]> chainBranch, int chainIndex, byte[] parentHeader)
+    {
+        Contract.RequiresNonNull(coinbase);
+        Contract.RequiresNonNull(parentHash);
+        Contract.RequiresNonNull(coinbaseBranch);
+        Contract.RequiresNonNull(chainBranch);
+        Contract.Requires<ArgumentException>(parentHeader?.Length == 80, "parent header must be 80 bytes");
+
+        using(var stream = new MemoryStream())
+        {
+            var bs = new BitcoinStream(stream, true);
+
+            bs.ReadWrite(coinbase);
+            bs.ReadWrite(parentHash);
+
+            // the coinbase is always the first transaction
+            WriteBranch(bs, coinbaseBranch, 0);
+            WriteBranch(bs, chainBranch, (uint) chainIndex);
+
+            bs.ReadWrite(parentHeader);
+
+            return stream.ToArray();
+        }
+    }
+
+    private static void WriteBranch(BitcoinStream bs, IList<byte[]> branch, uint index)
+    {
+        var count = (uint) branch.Count;
+        bs.ReadWriteAsVarInt(ref count);
+
+        foreach(var hash in branch)
+            bs.ReadWrite(hash);
+
+        bs.ReadWrite(ref index);
+    }
+
+    private static byte[] DoubleDigest(byte[] left, byte[] right)
+    {
+        return SHA256.HashData(SHA256.HashData(left.Concat(right).ToArray()));
+    }
+}
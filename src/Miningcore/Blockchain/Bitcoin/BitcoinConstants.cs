@@ -156,6 +156,11 @@ public static class BitcoinCommands
     public const string WalletPassphrase = "walletpassphrase";
     public const string WalletLock = "walletlock";
 
+    // Merged mining
+    public const string CreateAuxBlock = "createauxblock";
+    public const string SubmitAuxBlock = "submitauxblock";
+    public const string GetAuxBlock = "getauxblock";
+
     // Legacy commands
     public const string GetInfo = "getinfo";
 
@@ -1,3 +1,4 @@
+using System.Buffers.Binary;
 using System.Collections.Concurrent;
 using System.Globalization;
 using System.Text;
@@ -5,6 +6,7 @@ using Miningcore.Blockchain.Bitcoin.Configuration;
 using Miningcore.Blockchain.Bitcoin.DaemonResponses;
 using Miningcore.Configuration;
 using Miningcore.Crypto;
+using Miningcore.Crypto.Hashing.Algorithms;
 using Miningcore.Extensions;
 using Miningcore.Stratum;
 using Miningcore.Time;
@@ -34,6 +36,7 @@ public class BitcoinJob
     protected BitcoinTemplate coin;
     private BitcoinTemplate.BitcoinNetworkParams networkParams;
     protected readonly ConcurrentDictionary<string, bool> submissions = new(StringComparer.OrdinalIgnoreCase);
+    protected readonly ConcurrentDictionary<string, bool> auxSubmissions = new(StringComparer.OrdinalIgnoreCase);
     protected uint256 blockTargetValue;
     protected byte[] coinbaseFinal;
     protected string coinbaseFinalHex;
@@ -42,6 +45,36 @@ public class BitcoinJob
     protected string[] merkleBranchesHex;
     protected MerkleTree mt;
 
+    ///////////////////////////////////////////
+    // Share validation cache
+
+    // upper bound of (extraNonce1, extraNonce2) combinations remembered per job
+    protected const int ShareCacheCapacity = 8192;
+
+    // number of rolled versions per combination for which a midstate is kept
+    private const int MidstateSlots = 4;
+
+    private record Midstate(uint Version, uint[] State);
+
+    private class ShareCacheEntry
+    {
+        public ShareCacheEntry(byte[] coinbase, byte[] merkleRoot)
+        {
+            Coinbase = coinbase;
+            MerkleRoot = merkleRoot;
+        }
+
+        public byte[] Coinbase { get; }
+        public byte[] MerkleRoot { get; }
+        public readonly Midstate[] Midstates = new Midstate[MidstateSlots];
+        public int NextSlot;
+    }
+
+    private readonly ConcurrentDictionary<(string, string), ShareCacheEntry> shareCache = new();
+    private int shareCacheCount;
+    private byte[] headerTemplate;
+    private bool useMidstate;
+
     ///////////////////////////////////////////
     // GetJobParams related properties
 
@@ -223,6 +256,10 @@ public class BitcoinJob
         if(!coin.CoinbaseIgnoreAuxFlags && !string.IsNullOrEmpty(BlockTemplate.CoinbaseAux?.Flags))
             ops.Add(Op.GetPushOp(BlockTemplate.CoinbaseAux.Flags.HexToByteArray()));
 
+        // merged mining commitment
+        if(AuxWork != null)
+            ops.Add(Op.GetPushOp(AuxWork.Commitment));
+
         // push timestamp
         ops.Add(Op.GetPushOp(now));
 
@@ -292,17 +329,22 @@ public class BitcoinJob
         return submissions.TryAdd(key, true);
     }
 
+    /// <summary>
+    /// Returns false if the aux block has already been submitted for this job. Every later share
+    /// of the job that meets the aux target solves the same block.
+    /// </summary>
+    public bool RegisterAuxSubmit(AuxPowBlock block)
+    {
+        return auxSubmissions.TryAdd($"{block.Symbol}:{block.Hash}", true);
+    }
+
     protected byte[] SerializeHeader(Span<byte> coinbaseHash, uint nTime, uint nonce, uint? versionMask, uint? versionBits)
     {
         // build merkle-root
         var merkleRoot = mt.WithFirst(coinbaseHash.ToArray());
 
         // Build version
-        var version = BlockTemplate.Version;
-
-        // Overt-ASIC boost
-        if(versionMask.HasValue && versionBits.HasValue)
-            version = (version & ~versionMask.Value) | (versionBits.Value & versionMask.Value);
+        var version = GetVersion(versionMask, versionBits);
 
 #pragma warning disable 618
         var blockHeader = new BlockHeader
@@ -319,21 +361,137 @@ public class BitcoinJob
             return blockHeader.ToBytes();
     }
 
-    protected virtual (Share Share, string BlockHex) ProcessShareInternal(
-        StratumConnection worker, string extraNonce2, uint nTime, uint nonce, uint? versionBits)
+    private uint GetVersion(uint? versionMask, uint? versionBits)
     {
-        var context = worker.ContextAs<BitcoinWorkerContext>();
-        var extraNonce1 = context.ExtraNonce1;
+        var version = BlockTemplate.Version;
+
+        // Overt-ASIC boost
+        if(versionMask.HasValue && versionBits.HasValue)
+            version = (version & ~versionMask.Value) | (versionBits.Value & versionMask.Value);
+
+        return version;
+    }
+
+    /// <summary>
+    /// Patches the fields that vary between shares into a copy of the serialized header template
+    /// </summary>
+    private void BuildHeader(Span<byte> header, byte[] merkleRoot, uint version, uint nTime, uint nonce)
+    {
+        headerTemplate.CopyTo(header);
+
+        BinaryPrimitives.WriteUInt32LittleEndian(header, version);
+        merkleRoot.CopyTo(header[36..]);
+        BinaryPrimitives.WriteUInt32LittleEndian(header[68..], nTime);
+        BinaryPrimitives.WriteUInt32LittleEndian(header[76..], nonce);
+    }
+
+    /// <summary>
+    /// Returns coinbase and merkle-root for the given extra-nonces, building them on first use.
+    /// ASICs submit many shares per extraNonce2 which differ only in version, time and nonce.
+    /// </summary>
+    private ShareCacheEntry GetShareCacheEntry(string extraNonce1, string extraNonce2)
+    {
+        var key = (extraNonce1, extraNonce2);
+
+        if(shareCache.TryGetValue(key, out var entry))
+        {
+            ShareCacheStats?.RecordCoinbase(true);
+            return entry;
+        }
+
+        ShareCacheStats?.RecordCoinbase(false);
 
-        // build coinbase
         var coinbase = SerializeCoinbase(extraNonce1, extraNonce2);
         Span<byte> coinbaseHash = stackalloc byte[32];
         coinbaseHasher.Digest(coinbase, coinbaseHash);
 
+        entry = new ShareCacheEntry(coinbase, mt.WithFirst(coinbaseHash.ToArray()));
+
+        // past capacity shares are still processed, just no longer cached
+        if(Interlocked.Increment(ref shareCacheCount) <= ShareCacheCapacity)
+            entry = shareCache.GetOrAdd(key, entry);
+
+        return entry;
+    }
+
+    /// <summary>
+    /// Returns the SHA-256 state after the first 64 header bytes, which vary only with version and merkle-root
+    /// </summary>
+    private uint[] GetMidstate(ShareCacheEntry entry, uint version, ReadOnlySpan<byte> header)
+    {
+        var slots = entry.Midstates;
+
+        for(var i = 0; i < slots.Length; i++)
+        {
+            var slot = Volatile.Read(ref slots[i]);
+
+            if(slot != null && slot.Version == version)
+            {
+                ShareCacheStats?.RecordMidstate(true);
+                return slot.State;
+            }
+        }
+
+        ShareCacheStats?.RecordMidstate(false);
+
+        var state = new uint[Sha256Midstate.StateSize];
+        Sha256Midstate.Compute(header, state);
+
+        var index = (int) ((uint) Interlocked.Increment(ref entry.NextSlot) % slots.Length);
+        Volatile.Write(ref slots[index], new Midstate(version, state));
+
+        return state;
+    }
+
+    protected virtual (Share Share, string BlockHex, AuxPowProof[] AuxProofs) ProcessShareInternal(
+        StratumConnection worker, string extraNonce2, uint nTime, uint nonce, uint? versionBits)
+    {
+        var context = worker.ContextAs<BitcoinWorkerContext>();
+        var extraNonce1 = context.ExtraNonce1;
+
+        // coinbase and merkle-root
+        var entry = GetShareCacheEntry(extraNonce1, extraNonce2);
+        var version = GetVersion(context.VersionRollingMask, versionBits);
+
+        // build block-header
+        Span<byte> headerBytes = stackalloc byte[headerTemplate.Length];
+        BuildHeader(headerBytes, entry.MerkleRoot, version, nTime, nonce);
+
         // hash block-header
-        var headerBytes = SerializeHeader(coinbaseHash, nTime, nonce, context.VersionRollingMask, versionBits);
         Span<byte> headerHash = stackalloc byte[32];
-        headerHasher.Digest(headerBytes, headerHash, (ulong) nTime, BlockTemplate, coin, networkParams);
+
+        if(useMidstate)
+            Sha256Midstate.DigestDouble80(GetMidstate(entry, version, headerBytes), headerBytes[Sha256Midstate.BlockSize..], headerHash);
+        else
+            headerHasher.Digest(headerBytes, headerHash, (ulong) nTime, BlockTemplate, coin, networkParams);
+
+        return ProcessHeaderHash(context, entry, headerBytes, headerHash, nTime);
+    }
+
+    private async Task<(Share Share, string BlockHex, AuxPowProof[] AuxProofs)> ProcessShareBatchedAsync(BatchingHashAlgorithm batchHasher,
+        StratumConnection worker, string extraNonce2, uint nTime, uint nonce, uint? versionBits)
+    {
+        var context = worker.ContextAs<BitcoinWorkerContext>();
+
+        // coinbase and merkle-root
+        var entry = GetShareCacheEntry(context.ExtraNonce1, extraNonce2);
+        var version = GetVersion(context.VersionRollingMask, versionBits);
+
+        // header and hash must outlive the wait for the batch, they can't live on the stack
+        var buf = new byte[headerTemplate.Length + 32];
+        var headerBytes = buf.AsMemory(0, headerTemplate.Length);
+        var headerHash = buf.AsMemory(headerTemplate.Length, 32);
+
+        BuildHeader(headerBytes.Span, entry.MerkleRoot, version, nTime, nonce);
+
+        await batchHasher.DigestAsync(headerBytes, headerHash);
+
+        return ProcessHeaderHash(context, entry, headerBytes.Span, headerHash.Span, nTime);
+    }
+
+    private (Share Share, string BlockHex, AuxPowProof[] AuxProofs) ProcessHeaderHash(BitcoinWorkerContext context,
+        ShareCacheEntry entry, Span<byte> headerBytes, Span<byte> headerHash, uint nTime)
+    {
         var headerValue = new uint256(headerHash);
 
         // calc share-diff
@@ -344,21 +502,36 @@ public class BitcoinJob
         // check if the share meets the much harder block difficulty (block candidate)
         var isBlockCandidate = headerValue <= blockTargetValue;
 
+        // check the same hash against the target of every merge-mined chain
+        var auxWork = AuxWork;
+        List<int> auxMatches = null;
+
+        if(auxWork != null)
+        {
+            for(var i = 0; i < auxWork.Blocks.Count; i++)
+            {
+                if(headerValue <= auxWork.Blocks[i].Target)
+                    (auxMatches ??= new List<int>()).Add(i);
+            }
+        }
+
+        var isAuxCandidate = auxMatches != null;
+
         // test if share meets at least workers current difficulty
         if(!isBlockCandidate && ratio < 0.99)
         {
             // check if share matched the previous difficulty from before a vardiff retarget
-            if(context.VarDiff?.LastUpdate != null && context.PreviousDifficulty.HasValue)
+            if(context.VarDiff?.LastUpdate != null && context.PreviousDifficulty.HasValue &&
+               shareDiff / context.PreviousDifficulty.Value >= 0.99)
             {
-                ratio = shareDiff / context.PreviousDifficulty.Value;
-
-                if(ratio < 0.99)
-                    throw new StratumException(StratumError.LowDifficultyShare, $"low difficulty share ({shareDiff})");
-
                 // use previous difficulty
                 stratumDifficulty = context.PreviousDifficulty.Value;
             }
 
+            // still solves a merge-mined block, credit only the work it actually represents
+            else if(isAuxCandidate)
+                stratumDifficulty = shareDiff;
+
             else
                 throw new StratumException(StratumError.LowDifficultyShare, $"low difficulty share ({shareDiff})");
         }
@@ -370,21 +543,36 @@ public class BitcoinJob
             Difficulty = stratumDifficulty / shareMultiplier,
         };
 
+        if(!isBlockCandidate && !isAuxCandidate)
+            return (result, null, null);
+
+        Span<byte> blockHash = stackalloc byte[32];
+        blockHasher.Digest(headerBytes, blockHash, nTime);
+
+        var header = headerBytes.ToArray();
+        string blockHex = null;
+        AuxPowProof[] auxProofs = null;
+
         if(isBlockCandidate)
         {
             result.IsBlockCandidate = true;
-
-            Span<byte> blockHash = stackalloc byte[32];
-            blockHasher.Digest(headerBytes, blockHash, nTime);
             result.BlockHash = blockHash.ToHexString();
 
-            var blockBytes = SerializeBlock(headerBytes, coinbase);
-            var blockHex = blockBytes.ToHexString();
+            var blockBytes = SerializeBlock(header, entry.Coinbase);
+            blockHex = blockBytes.ToHexString();
+        }
+
+        if(isAuxCandidate)
+        {
+            var parentHash = blockHash.ToArray().ReverseInPlace();
 
-            return (result, blockHex);
+            auxProofs = auxMatches
+                .Select(i => new AuxPowProof(auxWork.Blocks[i], AuxPowWork.Serialize(entry.Coinbase, parentHash,
+                    mt.Steps, auxWork.GetBranch(i), auxWork.GetIndex(i), header).ToHexString()))
+                .ToArray();
         }
 
-        return (result, null);
+        return (result, blockHex, auxProofs);
     }
 
     protected virtual byte[] SerializeCoinbase(string extraNonce1, string extraNonce2)
@@ -659,6 +847,49 @@ public class BitcoinJob
 
     #endregion // CoinbaseStakingReward
 
+    private (uint NTime, uint Nonce, uint VersionBits) ValidateSubmission(StratumConnection worker,
+        string extraNonce2, string nTime, string nonce, string versionBits)
+    {
+        Contract.RequiresNonNull(worker);
+        Contract.Requires<ArgumentException>(!string.IsNullOrEmpty(extraNonce2));
+        Contract.Requires<ArgumentException>(!string.IsNullOrEmpty(nTime));
+        Contract.Requires<ArgumentException>(!string.IsNullOrEmpty(nonce));
+
+        var context = worker.ContextAs<BitcoinWorkerContext>();
+
+        // validate nTime
+        if(nTime.Length != 8)
+            throw new StratumException(StratumError.Other, "incorrect size of ntime");
+
+        var nTimeInt = uint.Parse(nTime, NumberStyles.HexNumber);
+        if(nTimeInt < BlockTemplate.CurTime || nTimeInt > ((DateTimeOffset) clock.Now).ToUnixTimeSeconds() + 7200)
+            throw new StratumException(StratumError.Other, "ntime out of range");
+
+        // validate nonce
+        if(nonce.Length != 8)
+            throw new StratumException(StratumError.Other, "incorrect size of nonce");
+
+        var nonceInt = uint.Parse(nonce, NumberStyles.HexNumber);
+
+        // validate version-bits (overt ASIC boost)
+        uint versionBitsInt = 0;
+
+        if(context.VersionRollingMask.HasValue && versionBits != null)
+        {
+            versionBitsInt = uint.Parse(versionBits, NumberStyles.HexNumber);
+
+            // enforce that only bits covered by current mask are changed by miner
+            if((versionBitsInt & ~context.VersionRollingMask.Value) != 0)
+                throw new StratumException(StratumError.Other, "rolling-version mask violation");
+        }
+
+        // dupe check
+        if(!RegisterSubmit(context.ExtraNonce1, extraNonce2, nTime, nonce))
+            throw new StratumException(StratumError.DuplicateShare, "duplicate share");
+
+        return (nTimeInt, nonceInt, versionBitsInt);
+    }
+
     #region API-Surface
 
     public BlockTemplate BlockTemplate { get; protected set; }
@@ -666,6 +897,17 @@ public class BitcoinJob
 
     public string JobId { get; protected set; }
 
+    /// <summary>
+    /// Receives hit-rates of the share validation cache (optional)
+    /// </summary>
+    public BitcoinShareCacheStats ShareCacheStats { get; set; }
+
+    /// <summary>
+    /// Aux blocks merge-mined with this job (optional). Must be assigned before <see cref="Init"/>
+    /// as the coinbase commits to them.
+    /// </summary>
+    public AuxPowWork AuxWork { get; init; }
+
     public void Init(BlockTemplate blockTemplate, string jobId,
         PoolConfig pc, BitcoinPoolConfigExtra extraPoolConfig,
         ClusterConfig cc, IMasterClock clock,
@@ -764,6 +1006,15 @@ public class BitcoinJob
         BuildMerkleBranches();
         BuildCoinbase();
 
+        // fields that don't vary between shares are serialized once
+        headerTemplate = SerializeHeader(new byte[32], 0, 0, null, null);
+
+        if(AuxWork != null && headerTemplate.Length != 80)
+            throw new NotSupportedException("merged mining requires an 80-byte parent header");
+
+        // 80-byte headers hashed with plain sha256d can be finished from a midstate
+        useMidstate = headerHasher.GetType() == typeof(Sha256D) && headerTemplate.Length == 80;
+
         jobParams = new object[]
         {
             JobId,
@@ -784,47 +1035,27 @@ public class BitcoinJob
         return jobParams;
     }
 
-    public virtual (Share Share, string BlockHex) ProcessShare(StratumConnection worker,
+    public virtual (Share Share, string BlockHex, AuxPowProof[] AuxProofs) ProcessShare(StratumConnection worker,
         string extraNonce2, string nTime, string nonce, string versionBits = null)
     {
-        Contract.RequiresNonNull(worker);
-        Contract.Requires<ArgumentException>(!string.IsNullOrEmpty(extraNonce2));
-        Contract.Requires<ArgumentException>(!string.IsNullOrEmpty(nTime));
-        Contract.Requires<ArgumentException>(!string.IsNullOrEmpty(nonce));
+        var (nTimeInt, nonceInt, versionBitsInt) = ValidateSubmission(worker, extraNonce2, nTime, nonce, versionBits);
 
-        var context = worker.ContextAs<BitcoinWorkerContext>();
-
-        // validate nTime
-        if(nTime.Length != 8)
-            throw new StratumException(StratumError.Other, "incorrect size of ntime");
-
-        var nTimeInt = uint.Parse(nTime, NumberStyles.HexNumber);
-        if(nTimeInt < BlockTemplate.CurTime || nTimeInt > ((DateTimeOffset) clock.Now).ToUnixTimeSeconds() + 7200)
-            throw new StratumException(StratumError.Other, "ntime out of range");
-
-        // validate nonce
-        if(nonce.Length != 8)
-            throw new StratumException(StratumError.Other, "incorrect size of nonce");
-
-        var nonceInt = uint.Parse(nonce, NumberStyles.HexNumber);
-
-        // validate version-bits (overt ASIC boost)
-        uint versionBitsInt = 0;
-
-        if(context.VersionRollingMask.HasValue && versionBits != null)
-        {
-            versionBitsInt = uint.Parse(versionBits, NumberStyles.HexNumber);
+        return ProcessShareInternal(worker, extraNonce2, nTimeInt, nonceInt, versionBitsInt);
+    }
 
-            // enforce that only bits covered by current mask are changed by miner
-            if((versionBitsInt & ~context.VersionRollingMask.Value) != 0)
-                throw new StratumException(StratumError.Other, "rolling-version mask violation");
-        }
+    /// <summary>
+    /// Same as <see cref="ProcessShare"/>, but lets the header hash be batched with other connections' shares
+    /// if the header hasher is a <see cref="BatchingHashAlgorithm"/>
+    /// </summary>
+    public virtual Task<(Share Share, string BlockHex, AuxPowProof[] AuxProofs)> ProcessShareAsync(StratumConnection worker,
+        string extraNonce2, string nTime, string nonce, string versionBits = null)
+    {
+        if(headerHasher is not BatchingHashAlgorithm batchHasher)
+            return Task.FromResult(ProcessShare(worker, extraNonce2, nTime, nonce, versionBits));
 
-        // dupe check
-        if(!RegisterSubmit(context.ExtraNonce1, extraNonce2, nTime, nonce))
-            throw new StratumException(StratumError.DuplicateShare, "duplicate share");
+        var (nTimeInt, nonceInt, versionBitsInt) = ValidateSubmission(worker, extraNonce2, nTime, nonce, versionBits);
 
-        return ProcessShareInternal(worker, extraNonce2, nTimeInt, nonceInt, versionBitsInt);
+        return ProcessShareBatchedAsync(batchHasher, worker, extraNonce2, nTimeInt, nonceInt, versionBitsInt);
     }
 
     #endregion // API-Surface
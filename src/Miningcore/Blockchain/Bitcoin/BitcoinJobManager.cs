@@ -7,6 +7,8 @@ using Miningcore.Crypto;
 using Miningcore.Extensions;
 using Miningcore.JsonRpc;
 using Miningcore.Messaging;
+using Miningcore.Mining;
+using Miningcore.Notifications.Messages;
 using Miningcore.Rpc;
 using Miningcore.Stratum;
 using Miningcore.Time;
@@ -29,6 +31,11 @@ public class BitcoinJobManager : BitcoinJobManagerBase<BitcoinJob>
     }
 
     private BitcoinTemplate coin;
+    private IHashAlgorithm headerHasher;
+    private readonly BitcoinShareCacheStats shareCacheStats = new();
+    private AuxChain[] auxChains = Array.Empty<AuxChain>();
+
+    private record AuxChain(BitcoinAuxChainConfig Config, RpcClient Rpc);
 
     protected override object[] GetBlockTemplateParams()
     {
@@ -104,9 +111,109 @@ public class BitcoinJobManager : BitcoinJobManagerBase<BitcoinJob>
         return new RpcResponse<BlockTemplate>(result!.ResultAs<BlockTemplate>());
     }
 
-    private BitcoinJob CreateJob()
+    private BitcoinJob CreateJob(AuxPowWork auxWork)
+    {
+        return new()
+        {
+            ShareCacheStats = shareCacheStats,
+            AuxWork = auxWork
+        };
+    }
+
+    #region Merged Mining
+
+    private async Task<AuxPowBlock> GetAuxBlockAsync(AuxChain chain, CancellationToken ct)
+    {
+        var response = !string.IsNullOrEmpty(chain.Config.Address) ?
+            await chain.Rpc.ExecuteAsync<AuxBlock>(logger, BitcoinCommands.CreateAuxBlock, ct, new[] { chain.Config.Address }) :
+            await chain.Rpc.ExecuteAsync<AuxBlock>(logger, BitcoinCommands.GetAuxBlock, ct);
+
+        if(response.Error != null || response.Response == null)
+        {
+            logger.Warn(() => $"Unable to get {chain.Config.Symbol} aux block. Daemon responded with: {response.Error?.Message}");
+            return null;
+        }
+
+        var result = AuxPowBlock.FromAuxBlock(chain.Config.Symbol, response.Response);
+
+        if(result == null)
+            logger.Warn(() => $"Ignoring malformed {chain.Config.Symbol} aux block");
+
+        return result;
+    }
+
+    /// <summary>
+    /// Fetches the current block of every aux chain. Chains whose daemon fails are skipped
+    /// until the next update.
+    /// </summary>
+    private async Task<AuxPowWork> GetAuxWorkAsync(CancellationToken ct)
     {
-        return new();
+        if(auxChains.Length == 0)
+            return null;
+
+        var blocks = (await Task.WhenAll(auxChains.Select(x => GetAuxBlockAsync(x, ct))))
+            .Where(x => x != null)
+            .ToArray();
+
+        if(blocks.Length == 0)
+            return null;
+
+        // daemons of different chains must never share a chain id
+        var distinct = blocks
+            .GroupBy(x => x.ChainId)
+            .Select(x => x.First())
+            .ToArray();
+
+        if(distinct.Length != blocks.Length)
+            logger.Warn(() => $"Ignoring aux chains with duplicate chain ids: {string.Join(", ", blocks.Except(distinct).Select(x => x.Symbol))}");
+
+        return AuxPowWork.Create(distinct);
+    }
+
+    private async Task SubmitAuxBlocksAsync(BitcoinJob job, Share share, AuxPowProof[] proofs, CancellationToken ct)
+    {
+        foreach(var proof in proofs)
+        {
+            var chain = auxChains.First(x => x.Config.Symbol == proof.Block.Symbol);
+            var block = proof.Block;
+
+            if(!job.RegisterAuxSubmit(block))
+            {
+                logger.Debug(() => $"{block.Symbol} aux block {block.Height} [{block.Hash}] already submitted");
+                continue;
+            }
+
+            logger.Info(() => $"Submitting {block.Symbol} aux block {block.Height} [{block.Hash}]");
+
+            var response = !string.IsNullOrEmpty(chain.Config.Address) ?
+                await chain.Rpc.ExecuteAsync<JToken>(logger, BitcoinCommands.SubmitAuxBlock, ct, new[] { block.Hash, proof.AuxPow }) :
+                await chain.Rpc.ExecuteAsync<JToken>(logger, BitcoinCommands.GetAuxBlock, ct, new[] { block.Hash, proof.AuxPow });
+
+            if(response.Error == null && response.Response?.Type == JTokenType.Boolean && response.Response.Value<bool>())
+            {
+                logger.Info(() => $"Daemon accepted {block.Symbol} aux block {block.Height} [{block.Hash}] submitted by {share.Miner}");
+                continue;
+            }
+
+            var error = response.Error?.Message ?? response.Response?.ToString();
+
+            logger.Warn(() => $"{block.Symbol} aux block {block.Height} submission failed with: {error}");
+            messageBus.SendMessage(new AdminNotification("Aux block submission failed", $"Pool {poolConfig.Id} failed to submit {block.Symbol} aux block {block.Height}: {error}"));
+        }
+    }
+
+    #endregion // Merged Mining
+
+    private void PublishShareCacheStats()
+    {
+        foreach(var (cache, hits, misses) in shareCacheStats.Take())
+        {
+            if(hits > 0)
+                messageBus.SendTelemetry(poolConfig.Id, TelemetryCategory.ShareCache, cache, TimeSpan.Zero, true, total: (int) hits);
+
+            if(misses > 0)
+                messageBus.SendTelemetry(poolConfig.Id, TelemetryCategory.ShareCache, cache, TimeSpan.Zero, false, total: (int) misses);
+        }
     }
 
     protected override void PostChainIdentifyConfigure()
@@ -118,6 +225,16 @@ public class BitcoinJobManager : BitcoinJobManagerBase<BitcoinJob>
             if(!hashInit.DigestInit(poolConfig))
                 logger.Error(()=> $"{hashInit.GetType().Name} initialization failed");
         }
+
+        headerHasher = coin.HeaderHasherValue;
+
+        if(poolConfig.ShareValidationBatchWindow.HasValue)
+        {
+            headerHasher = HashBatchDispatcher.Wrap(headerHasher, TimeSpan.FromTicks((long) (poolConfig.ShareValidationBatchWindow.Value * 10)));
+
+            if(headerHasher is BatchingHashAlgorithm)
+                logger.Info(() => $"Batching share validation across connections within {poolConfig.ShareValidationBatchWindow.Value} microseconds");
+        }
     }
 
     protected override async Task<(bool IsNew, bool Force)> UpdateJob(CancellationToken ct, bool forceUpdate, string via = null, string json = null)
@@ -149,13 +266,24 @@ public class BitcoinJobManager : BitcoinJobManagerBase<BitcoinJob>
             if(isNew)
                 messageBus.NotifyChainHeight(poolConfig.Id, blockTemplate.Height, poolConfig.Template);
 
+            // a new block on any aux chain requires a new coinbase commitment
+            var auxWork = await GetAuxWorkAsync(ct);
+
+            if(!isNew && !forceUpdate && !AuxPowWork.IsSameWork(job.AuxWork, auxWork))
+            {
+                logger.Debug(() => "Aux chain update");
+                forceUpdate = true;
+            }
+
             if(isNew || forceUpdate)
             {
-                job = CreateJob();
+                PublishShareCacheStats();
+
+                job = CreateJob(auxWork);
 
                 job.Init(blockTemplate, NextJobId(),
                     poolConfig, extraPoolConfig, clusterConfig, clock, poolAddressDestination, network, isPoS,
-                    ShareMultiplier, coin.CoinbaseHasherValue, coin.HeaderHasherValue,
+                    ShareMultiplier, coin.CoinbaseHasherValue, headerHasher ?? coin.HeaderHasherValue,
                     !isPoS ? coin.BlockHasherValue : coin.PoSBlockHasherValue ?? coin.BlockHasherValue);
 
                 if(isNew)
@@ -181,6 +309,7 @@ public class BitcoinJobManager : BitcoinJobManagerBase<BitcoinJob>
                         logger.Debug(() => $"Template update {blockTemplate?.Height}");
                 }
 
+                validJobs.Add(job.JobId, job);
                 currentJob = job;
             }
 
@@ -228,14 +357,36 @@ public class BitcoinJobManager : BitcoinJobManagerBase<BitcoinJob>
         base.Configure(pc, cc);
     }
 
+    protected override void ConfigureDaemons()
+    {
+        base.ConfigureDaemons();
+
+        if(extraPoolConfig?.AuxChains?.Length > 0)
+        {
+            var jsonSerializerSettings = ctx.Resolve<JsonSerializerSettings>();
+
+            if(extraPoolConfig.AuxChains.Any(x => string.IsNullOrEmpty(x.Symbol) || x.Daemon == null))
+                throw new PoolStartupException("Aux chains require a symbol and a daemon", poolConfig.Id);
+
+            if(extraPoolConfig.AuxChains.Select(x => x.Symbol).Distinct().Count() != extraPoolConfig.AuxChains.Length)
+                throw new PoolStartupException("Duplicate aux chain symbol", poolConfig.Id);
+
+            auxChains = extraPoolConfig.AuxChains
+                .Select(x => new AuxChain(x, new RpcClient(x.Daemon, jsonSerializerSettings, messageBus, poolConfig.Id)))
+                .ToArray();
+
+            logger.Info(() => $"Merge-mining {string.Join(", ", auxChains.Select(x => x.Config.Symbol))}");
+        }
+    }
+
     public virtual object[] GetSubscriberData(StratumConnection worker)
     {
         Contract.RequiresNonNull(worker);
 
         var context = worker.ContextAs<BitcoinWorkerContext>();
 
-        // assign unique ExtraNonce1 to worker (miner)
-        context.ExtraNonce1 = extraNonceProvider.Next();
+        // assign unique ExtraNonce1 to worker (miner) unless it resumed a previous session
+        context.ExtraNonce1 ??= extraNonceProvider.Next();
 
         // setup response data
         var responseData = new object[]
@@ -247,6 +398,22 @@ public class BitcoinJobManager : BitcoinJobManagerBase<BitcoinJob>
         return responseData;
     }
 
+    /// <summary>
+    /// Keeps the ExtraNonce1 of a session resumed from a previous instance from being assigned again
+    /// </summary>
+    public void ReserveExtraNonce(string extraNonce1)
+    {
+        extraNonceProvider.Reserve(extraNonce1);
+    }
+
+    /// <summary>
+    /// Makes the ExtraNonce1 of a session that won't be resumed available to new subscribers
+    /// </summary>
+    public void ReleaseExtraNonce(string extraNonce1)
+    {
+        extraNonceProvider.Release(extraNonce1);
+    }
+
     public virtual async ValueTask<Share> SubmitShareAsync(StratumConnection worker, object submission,
         CancellationToken ct)
     {
@@ -269,18 +436,19 @@ public class BitcoinJobManager : BitcoinJobManagerBase<BitcoinJob>
         if(string.IsNullOrEmpty(workerValue))
             throw new StratumException(StratumError.Other, "missing or invalid workername");
 
-        BitcoinJob job;
+        var job = validJobs.Get(jobId, out var id);
 
         lock(context)
         {
-            job = context.GetJob(jobId);
+            if(!context.IsValidJob(id))
+                job = null;
         }
 
         if(job == null)
             throw new StratumException(StratumError.JobNotFound, "job not found");
 
         // validate & process
-        var (share, blockHex) = job.ProcessShare(worker, extraNonce2, nTime, nonce, versionBits);
+        var (share, blockHex, auxProofs) = await job.ProcessShareAsync(worker, extraNonce2, nTime, nonce, versionBits);
 
         // enrich share with common data
         share.PoolId = poolConfig.Id;
@@ -319,6 +487,10 @@ public class BitcoinJobManager : BitcoinJobManagerBase<BitcoinJob>
             }
         }
 
+        // submit aux blocks solved by the same hash
+        if(auxProofs != null)
+            await SubmitAuxBlocksAsync(job, share, auxProofs, ct);
+
         return share;
     }
 
@@ -20,6 +20,7 @@ using static Miningcore.Util.ActionUtils;
 namespace Miningcore.Blockchain.Bitcoin;
 
 public abstract class BitcoinJobManagerBase<TJob> : JobManagerBase<TJob>
+    where TJob : class
 {
     protected BitcoinJobManagerBase(
         IComponentContext ctx,
@@ -42,6 +43,7 @@ public abstract class BitcoinJobManagerBase<TJob> : JobManagerBase<TJob>
     protected readonly IExtraNonceProvider extraNonceProvider;
     protected const int ExtranonceBytes = 4;
     public int maxActiveJobs { get; protected set; } = 4;
+    protected JobRing<TJob> validJobs;
     protected bool hasLegacyDaemon;
     protected BitcoinPoolConfigExtra extraPoolConfig;
     protected BitcoinPoolPaymentProcessingConfigExtra extraPoolPaymentProcessingConfig;
@@ -72,7 +74,9 @@ public abstract class BitcoinJobManagerBase<TJob> : JobManagerBase<TJob>
 
         var triggers = new List<IObservable<(bool Force, string Via, string Data)>>
         {
-            blockFound.Select(_ => (false, JobRefreshBy.BlockFound, (string) null))
+            blockFound
+                .Do(_ => rpc.InvalidateSharedRequests())
+                .Select(_ => (false, JobRefreshBy.BlockFound, (string) null))
         };
 
         if(extraPoolConfig?.BtStream == null)
@@ -104,6 +108,7 @@ public abstract class BitcoinJobManagerBase<TJob> : JobManagerBase<TJob>
                         }
                     })
                     .DistinctUntilChanged()
+                    .Do(hash => rpc.InvalidateSharedRequests(hash))
                     .Select(_ => (false, JobRefreshBy.PubSub, (string) null))
                     .Publish()
                     .RefCount();
@@ -375,7 +380,11 @@ public abstract class BitcoinJobManagerBase<TJob> : JobManagerBase<TJob>
     {
         var jsonSerializerSettings = ctx.Resolve<JsonSerializerSettings>();
 
-        rpc = new RpcClient(poolConfig.Daemons.First(), jsonSerializerSettings, messageBus, poolConfig.Id);
+        // SetupJobUpdates invalidates shared requests on every new block
+        rpc = new RpcClient(poolConfig.Daemons.First(), jsonSerializerSettings, messageBus, poolConfig.Id)
+        {
+            Coalescer = RpcRequestCoalescer.Default
+        };
     }
 
     protected override async Task<bool> AreDaemonsHealthyAsync(CancellationToken ct)
@@ -582,6 +591,7 @@ public abstract class BitcoinJobManagerBase<TJob> : JobManagerBase<TJob>
         if(extraPoolConfig?.MaxActiveJobs.HasValue == true)
             maxActiveJobs = extraPoolConfig.MaxActiveJobs.Value;
 
+        validJobs = new JobRing<TJob>(maxActiveJobs);
         hasLegacyDaemon = extraPoolConfig?.HasLegacyDaemon == true;
 
         base.Configure(pc, cc);
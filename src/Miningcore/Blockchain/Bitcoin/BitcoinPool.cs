@@ -1,4 +1,5 @@
 using System.Globalization;
+using System.Net;
 using System.Reactive;
 using System.Reactive.Linq;
 using System.Reactive.Threading.Tasks;
@@ -42,6 +43,7 @@ public class BitcoinPool : PoolBase
     protected object currentJobParams;
     protected BitcoinJobManager manager;
     private BitcoinTemplate coin;
+    private StratumSessionTable sessions;
 
     protected virtual async Task OnSubscribeAsync(StratumConnection connection, Timestamped<JsonRpcRequest> tsRequest)
     {
@@ -53,6 +55,11 @@ public class BitcoinPool : PoolBase
         var context = connection.ContextAs<BitcoinWorkerContext>();
         var requestParams = request.ParamsAs<string[]>();
 
+        // miners pass the subscription id of their previous connection to resume it
+        if(sessions != null && !context.IsSubscribed && requestParams?.Length > 1 &&
+           sessions.TryResume(requestParams[1], out var previous))
+            ResumeSession(connection, context, previous);
+
         var data = new object[]
         {
             new object[]
@@ -219,7 +226,7 @@ public class BitcoinPool : PoolBase
             var requestParams = request.ParamsAs<string[]>();
 
             // submit
-            var share = await manager.SubmitShareAsync(connection, requestParams, ct);
+            var share = await ValidateShareAsync(() => manager.SubmitShareAsync(connection, requestParams, ct));
 
             // Nicehash's stupid validator insists on "error" property present
             // in successful responses which is a violation of the JSON-RPC spec
@@ -237,9 +244,6 @@ public class BitcoinPool : PoolBase
             // publish
             messageBus.SendMessage(share);
 
-            // telemetry
-            PublishTelemetry(TelemetryCategory.Share, clock.Now - tsRequest.Timestamp.UtcDateTime, true);
-
             logger.Info(() => $"[{connection.ConnectionId}] Share accepted: D={Math.Round(share.Difficulty * coin.ShareMultiplier, 3)}");
 
             // update pool stats
@@ -247,18 +251,15 @@ public class BitcoinPool : PoolBase
                 poolStats.LastPoolBlockTime = clock.Now;
 
             // update client stats
-            context.Stats.ValidShares++;
+            context.Stats.RecordAccepted(share.Difficulty, clock.Now);
 
             await UpdateVarDiffAsync(connection, false, ct);
         }
 
         catch(StratumException ex)
         {
-            // telemetry
-            PublishTelemetry(TelemetryCategory.Share, clock.Now - tsRequest.Timestamp.UtcDateTime, false);
-
             // update client stats
-            context.Stats.InvalidShares++;
+            context.Stats.RecordRejected(ex.Code == StratumError.JobNotFound);
             logger.Info(() => $"[{connection.ConnectionId}] Share rejected: {ex.Message} [{context.UserAgent}]");
 
             // banning
@@ -439,6 +440,16 @@ public class BitcoinPool : PoolBase
 
         manager.Configure(poolConfig, clusterConfig);
 
+        if(poolConfig.EnableInternalStratum == true && poolConfig.SessionResumption?.Disabled != true)
+        {
+            var resumption = poolConfig.SessionResumption;
+
+            sessions = new StratumSessionTable(clock,
+                resumption?.MaxSessions ?? 100000,
+                TimeSpan.FromSeconds(resumption?.Timeout ?? 300),
+                state => manager.ReleaseExtraNonce(GetExtraNonce1(state)));
+        }
+
         await manager.StartAsync(ct);
 
         if(poolConfig.EnableInternalStratum == true)
@@ -545,6 +556,77 @@ public class BitcoinPool : PoolBase
         }
     }
 
+    private void ResumeSession(StratumConnection connection, BitcoinWorkerContext context, StratumSessionState state)
+    {
+        // a different port may run a different difficulty range, only the extranonce carries over
+        if(state.LocalPort != connection.LocalEndpoint.Port)
+        {
+            context.ExtraNonce1 = GetExtraNonce1(state);
+        }
+
+        else
+        {
+            context.ResumeState(state, poolConfig.Ports[connection.LocalEndpoint.Port].VarDiff, clock);
+            context.ApplyPendingDifficulty();
+        }
+
+        logger.Info(() => $"[{connection.ConnectionId}] Resumed session {state.ConnectionId} with extranonce1 {context.ExtraNonce1} at difficulty {context.Difficulty}");
+    }
+
+    private static string GetExtraNonce1(StratumSessionState state)
+    {
+        return state.Extra?.GetValueOrDefault(nameof(BitcoinWorkerContext.ExtraNonce1));
+    }
+
+    protected override void OnDisconnect(StratumConnection connection)
+    {
+        base.OnDisconnect(connection);
+
+        if(connection.Context is not BitcoinWorkerContext { ExtraNonce1: not null } context)
+            return;
+
+        if(sessions == null)
+        {
+            manager.ReleaseExtraNonce(context.ExtraNonce1);
+            return;
+        }
+
+        var state = new StratumSessionState
+        {
+            ConnectionId = connection.ConnectionId,
+            LocalPort = connection.LocalEndpoint.Port,
+        };
+
+        context.ExportState(state);
+        sessions.Park(state);
+    }
+
+    protected override bool CanHandoff(StratumConnection connection)
+    {
+        return true;
+    }
+
+    protected override async Task OnResumeAsync(StratumConnection connection, IPEndPoint ipEndPoint, StratumSessionState state)
+    {
+        await base.OnResumeAsync(connection, ipEndPoint, state);
+
+        var context = connection.ContextAs<BitcoinWorkerContext>();
+
+        if(context.ExtraNonce1 != null)
+            manager.ReserveExtraNonce(context.ExtraNonce1);
+
+        // jobs issued by the previous instance are unknown here, move the miner over to ours right away
+        if(context.IsSubscribed && currentJobParams != null)
+        {
+            var minerJobParams = CreateWorkerJob(connection, true);
+
+            context.ApplyPendingDifficulty();
+
+            await connection.NotifyAsync(BitcoinStratumMethods.SetDifficulty, new object[] { context.Difficulty });
+            await connection.NotifyAsync(BitcoinStratumMethods.MiningNotify, minerJobParams);
+        }
+    }
+
     protected override async Task OnVarDiffUpdateAsync(StratumConnection connection, double newDiff, CancellationToken ct)
     {
         await base.OnVarDiffUpdateAsync(connection, newDiff, ct);
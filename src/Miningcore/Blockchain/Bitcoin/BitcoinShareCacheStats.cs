@@ -0,0 +1,38 @@
+namespace Miningcore.Blockchain.Bitcoin;
+
+/// <summary>
+/// Hit and miss counters of the coinbase and midstate caches of <see cref="BitcoinJob"/>,
+/// shared by all jobs of a pool
+/// </summary>
+public class BitcoinShareCacheStats
+{
+    public const string Coinbase = "coinbase";
+    public const string Midstate = "midstate";
+
+    private long coinbaseHits;
+    private long coinbaseMisses;
+    private long midstateHits;
+    private long midstateMisses;
+
+    public void RecordCoinbase(bool hit)
+    {
+        Interlocked.Increment(ref hit ? ref coinbaseHits : ref coinbaseMisses);
+    }
+
+    public void RecordMidstate(bool hit)
+    {
+        Interlocked.Increment(ref hit ? ref midstateHits : ref midstateMisses);
+    }
+
+    /// <summary>
+    /// Returns the counts accumulated since the previous call and resets them
+    /// </summary>
+    public (string Cache, long Hits, long Misses)[] Take()
+    {
+        return new[]
+        {
+            (Coinbase, Interlocked.Exchange(ref coinbaseHits, 0), Interlocked.Exchange(ref coinbaseMisses, 0)),
+            (Midstate, Interlocked.Exchange(ref midstateHits, 0), Interlocked.Exchange(ref midstateMisses, 0)),
+        };
+    }
+}
@@ -1,7 +1,11 @@
 using System.Collections.Generic;
+using System.Globalization;
 using System.Reactive;
 using System.Reactive.Linq;
+using Miningcore.Configuration;
 using Miningcore.Mining;
+using Miningcore.Stratum;
+using Miningcore.Time;
 
 namespace Miningcore.Blockchain.Bitcoin;
 
@@ -28,21 +32,55 @@ public class BitcoinWorkerContext : WorkerContextBase
     public uint? VersionRollingMask { get; internal set; }
 
     /// <summary>
-    /// Current N job(s) assigned to this worker
+    /// Ids of the pool jobs this worker may submit shares for
     /// </summary>
-    public Queue<BitcoinJob> validJobs { get; private set; } = new();
+    private JobWindow validJobs;
 
-    public virtual void AddJob(BitcoinJob job, int maxActiveJobs)
+    public override void ExportState(StratumSessionState state)
     {
-        if(!validJobs.Contains(job))
-            validJobs.Enqueue(job);
+        base.ExportState(state);
+
+        state.Extra = new Dictionary<string, string>
+        {
+            [nameof(ExtraNonce1)] = ExtraNonce1,
+        };
 
-        while(validJobs.Count > maxActiveJobs)
-            validJobs.Dequeue();
+        if(VersionRollingMask.HasValue)
+            state.Extra[nameof(VersionRollingMask)] = VersionRollingMask.Value.ToString(CultureInfo.InvariantCulture);
+    }
+
+    public override void ImportState(StratumSessionState state, VarDiffConfig varDiffConfig)
+    {
+        base.ImportState(state, varDiffConfig);
+
+        if(state.Extra == null)
+            return;
+
+        if(state.Extra.TryGetValue(nameof(ExtraNonce1), out var extraNonce1))
+            ExtraNonce1 = extraNonce1;
+
+        if(state.Extra.TryGetValue(nameof(VersionRollingMask), out var mask))
+            VersionRollingMask = uint.Parse(mask, CultureInfo.InvariantCulture);
+    }
+
+    public override void ResumeState(StratumSessionState state, VarDiffConfig varDiffConfig, IMasterClock clock)
+    {
+        // negotiated by mining.configure on the new connection
+        var mask = VersionRollingMask;
+
+        base.ResumeState(state, varDiffConfig, clock);
+
+        VersionRollingMask = mask;
+    }
+
+    public virtual void AddJob(BitcoinJob job, int maxActiveJobs)
+    {
+        if(JobRing.TryParseId(job.JobId, out var id))
+            validJobs.Add(id, maxActiveJobs);
     }
 
-    public BitcoinJob GetJob(string jobId)
+    public bool IsValidJob(long id)
     {
-        return validJobs.ToArray().FirstOrDefault(x => x.JobId == jobId);
+        return validJobs.Contains(id);
     }
 }
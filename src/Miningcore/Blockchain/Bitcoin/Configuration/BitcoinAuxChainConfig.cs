@@ -0,0 +1,25 @@
+using Miningcore.Configuration;
+
+namespace Miningcore.Blockchain.Bitcoin.Configuration;
+
+/// <summary>
+/// Chain merge-mined on top of the pool's chain via AuxPoW
+/// </summary>
+public class BitcoinAuxChainConfig
+{
+    /// <summary>
+    /// Symbol of the merge-mined coin, used for logging
+    /// </summary>
+    public string Symbol { get; set; }
+
+    /// <summary>
+    /// Daemon of the merge-mined coin
+    /// </summary>
+    public DaemonEndpointConfig Daemon { get; set; }
+
+    /// <summary>
+    /// Reward address passed to createauxblock
+    /// If omitted, getauxblock is used which pays to the daemon's wallet
+    /// </summary>
+    public string Address { get; set; }
+}
@@ -38,4 +38,9 @@ public class BitcoinPoolConfigExtra
     /// Custom Arguments for getblocktemplate RPC
     /// </summary>
     public JToken GBTArgs { get; set; }
+
+    /// <summary>
+    /// Chains merge-mined via AuxPoW
+    /// </summary>
+    public BitcoinAuxChainConfig[] AuxChains { get; set; }
 }
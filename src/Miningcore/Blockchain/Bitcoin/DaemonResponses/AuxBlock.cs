@@ -0,0 +1,36 @@
+using Newtonsoft.Json;
+
+namespace Miningcore.Blockchain.Bitcoin.DaemonResponses;
+
+/// <summary>
+/// Result of createauxblock/getauxblock of a merge-mined chain
+/// </summary>
+public class AuxBlock
+{
+    /// <summary>
+    /// Hash of the aux block, which goes into the aux chain merkle tree
+    /// </summary>
+    public string Hash { get; set; }
+
+    /// <summary>
+    /// Chain id of the aux chain, determines the slot in the aux chain merkle tree
+    /// </summary>
+    public int ChainId { get; set; }
+
+    public string PreviousBlockHash { get; set; }
+    public long CoinbaseValue { get; set; }
+    public string Bits { get; set; }
+    public ulong Height { get; set; }
+
+    /// <summary>
+    /// Target in little-endian hex
+    /// </summary>
+    [JsonProperty("_target")]
+    public string Target { get; set; }
+
+    /// <summary>
+    /// Target in little-endian hex (older daemons)
+    /// </summary>
+    [JsonProperty("target")]
+    public string LegacyTarget { get; set; }
+}
@@ -271,7 +271,7 @@ public class ConcealPool : PoolBase
                 throw new StratumException(StratumError.MinusOne, "duplicate share");
 
             // submit
-            var share = await manager.SubmitShareAsync(connection, submitRequest, job, ct);
+            var share = await ValidateShareAsync(() => manager.SubmitShareAsync(connection, submitRequest, job, ct));
 
             // Nicehash's stupid validator insists on "error" property present
             // in successful responses which is a violation of the JSON-RPC spec
@@ -289,9 +289,6 @@ public class ConcealPool : PoolBase
             // publish
             messageBus.SendMessage(share);
 
-            // telemetry
-            PublishTelemetry(TelemetryCategory.Share, clock.Now - tsRequest.Timestamp.UtcDateTime, true);
-
             logger.Info(() => $"[{connection.ConnectionId}] Share accepted: D={Math.Round(share.Difficulty, 3)}");
 
             // update pool stats
@@ -299,18 +296,15 @@ public class ConcealPool : PoolBase
                 poolStats.LastPoolBlockTime = clock.Now;
 
             // update client stats
-            context.Stats.ValidShares++;
+            context.Stats.RecordAccepted(share.Difficulty, clock.Now);
 
             await UpdateVarDiffAsync(connection, false, ct);
         }
 
         catch(StratumException ex)
         {
-            // telemetry
-            PublishTelemetry(TelemetryCategory.Share, clock.Now - tsRequest.Timestamp.UtcDateTime, false);
-
             // update client stats
-            context.Stats.InvalidShares++;
+            context.Stats.RecordRejected(ex.Code == StratumError.JobNotFound);
             logger.Info(() => $"[{connection.ConnectionId}] Share rejected: {ex.Message} [{context.UserAgent}]");
 
             // banning
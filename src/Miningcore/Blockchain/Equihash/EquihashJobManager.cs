@@ -159,6 +159,7 @@ public class EquihashJobManager : BitcoinJobManagerBase<EquihashJob>
                         logger.Debug(() => $"Template update {blockTemplate.Height}");
                 }
 
+                validJobs.Add(job.JobId, job);
                 currentJob = job;
             }
 
@@ -262,11 +263,12 @@ public class EquihashJobManager : BitcoinJobManagerBase<EquihashJob>
         if(string.IsNullOrEmpty(solution))
             throw new StratumException(StratumError.Other, "missing or invalid solution");
 
-        EquihashJob job;
+        var job = validJobs.Get(jobId, out var id);
 
         lock(context)
         {
-            job = context.GetJob(jobId);
+            if(!context.IsValidJob(id))
+                job = null;
         }
 
         if(job == null)
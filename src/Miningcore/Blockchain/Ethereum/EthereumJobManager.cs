@@ -45,6 +45,9 @@ public class EthereumJobManager : JobManagerBase<EthereumJob>
 
         this.clock = clock;
         this.extraNonceProvider = extraNonceProvider;
+
+        // stratum v1 miners submit by header instead of job id
+        validJobs = new JobRing<EthereumJob>(maxActiveJobs, x => x.BlockTemplate.Header);
     }
     
     private EthereumCoinTemplate coin;
@@ -55,6 +58,8 @@ public class EthereumJobManager : JobManagerBase<EthereumJob>
     private readonly IMasterClock clock;
     private readonly IExtraNonceProvider extraNonceProvider;
     private EthereumPoolConfigExtra extraPoolConfig;
+    public int maxActiveJobs { get; } = 6;
+    private readonly JobRing<EthereumJob> validJobs;
 
     private EthereumJob CreateJob(string jobId, EthereumBlockTemplate blockTemplate, ILogger logger, IEthashLight ethash)
     {
@@ -114,6 +119,7 @@ public class EthereumJobManager : JobManagerBase<EthereumJob>
                 // update template
                 job = CreateJob(jobId, blockTemplate, logger, coin.Ethash);
 
+                validJobs.Add(jobId, job);
                 currentJob = job;
 
                 logger.Info(() => $"New work at height {currentJob.BlockTemplate.Height} and header {currentJob.BlockTemplate.Header} via [{(via ?? "Unknown")}]");
@@ -395,14 +401,12 @@ public class EthereumJobManager : JobManagerBase<EthereumJob>
         var header = request[1];
         var solution = request.Length > 2 ? request[2] : string.Empty;
 
-        EthereumJob job;
+        var job = validJobs.GetByKey(header, out var id);
 
         // stale?
         lock(context)
         {
-            job = context.validJobs.ToArray().FirstOrDefault(x => x.BlockTemplate.Header.Equals(header));
-
-            if(job == null)
+            if(job == null || !context.IsValidJob(id))
                 throw new StratumException(StratumError.MinusOne, "stale share");
         }
 
@@ -419,13 +423,12 @@ public class EthereumJobManager : JobManagerBase<EthereumJob>
         var nonce = request[2];
         var solution = request.Length > 3 ? request[3] : string.Empty;
 
-        EthereumJob job;
+        var job = validJobs.Get(jobId, out var id);
 
         // stale?
         lock(context)
         {
-            // look up job by id
-            if((job = context.GetJob(jobId)) == null)
+            if(job == null || !context.IsValidJob(id))
                 throw new StratumException(StratumError.MinusOne, "stale share");
         }
 
@@ -186,7 +186,7 @@ public class EthereumPool : PoolBase
         // update context
         lock(context)
         {
-            context.AddJob(job, 6);
+            context.AddJob(job, manager.maxActiveJobs);
         }
 
         return job;
@@ -231,9 +231,9 @@ public class EthereumPool : PoolBase
             Share share;
 
             if(!v1)
-                share = await manager.SubmitShareV2Async(connection, submitRequest, ct);
+                share = await ValidateShareAsync(() => manager.SubmitShareV2Async(connection, submitRequest, ct));
             else
-                share = await manager.SubmitShareV1Async(connection, submitRequest, GetWorkerNameFromV1Request(request, context), ct);
+                share = await ValidateShareAsync(() => manager.SubmitShareV1Async(connection, submitRequest, GetWorkerNameFromV1Request(request, context), ct));
 
             // Nicehash's stupid validator insists on "error" property present
             // in successful responses which is a violation of the JSON-RPC spec
@@ -251,9 +251,6 @@ public class EthereumPool : PoolBase
             // publish
             messageBus.SendMessage(share);
 
-            // telemetry
-            PublishTelemetry(TelemetryCategory.Share, clock.Now - tsRequest.Timestamp.UtcDateTime, true);
-
             logger.Info(() => $"[{connection.ConnectionId}] Share accepted: D={Math.Round(share.Difficulty / EthereumConstants.Pow2x32, 3)}");
 
             // update pool stats
@@ -261,18 +258,15 @@ public class EthereumPool : PoolBase
                 poolStats.LastPoolBlockTime = clock.Now;
 
             // update client stats
-            context.Stats.ValidShares++;
+            context.Stats.RecordAccepted(share.Difficulty, clock.Now);
 
             await UpdateVarDiffAsync(connection, false, ct);
         }
 
         catch(StratumException ex)
         {
-            // telemetry
-            PublishTelemetry(TelemetryCategory.Share, clock.Now - tsRequest.Timestamp.UtcDateTime, false);
-
             // update client stats
-            context.Stats.InvalidShares++;
+            context.Stats.RecordRejected(ex.Code == StratumError.JobNotFound);
             logger.Info(() => $"[{connection.ConnectionId}] Share rejected: {ex.Message} [{context.UserAgent}]");
 
             // banning
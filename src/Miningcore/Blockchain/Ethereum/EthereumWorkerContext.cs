@@ -28,21 +28,18 @@ public class EthereumWorkerContext : WorkerContextBase
     public string ExtraNonce1 { get; set; }
 
     /// <summary>
-    /// Current N job(s) assigned to this worker
+    /// Ids of the pool jobs this worker may submit shares for
     /// </summary>
-    public Queue<EthereumJob> validJobs { get; private set; } = new();
+    private JobWindow validJobs;
 
     public virtual void AddJob(EthereumJob job, int maxActiveJobs)
     {
-        if(!validJobs.Contains(job))
-            validJobs.Enqueue(job);
-
-        while(validJobs.Count > maxActiveJobs)
-            validJobs.Dequeue();
+        if(JobRing.TryParseId(job.Id, out var id))
+            validJobs.Add(id, maxActiveJobs);
     }
 
-    public EthereumJob GetJob(string jobId)
+    public bool IsValidJob(long id)
     {
-        return validJobs.ToArray().FirstOrDefault(x => x.Id == jobId);
+        return validJobs.Contains(id);
     }
 }
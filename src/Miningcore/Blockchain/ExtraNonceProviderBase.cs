@@ -1,3 +1,4 @@
+using System.Globalization;
 using System.Security.Cryptography;
 using Miningcore.Mining;
 using Miningcore.Util;
@@ -47,8 +48,7 @@ public class ExtraNonceProviderBase : IExtraNonceProvider
     private readonly ILogger logger;
 
     private const int IdBits = 4;
-    private readonly object counterLock = new();
-    protected ulong counter;
+    protected long counter;
     protected byte id;
     protected readonly int extranonceBytes;
     protected readonly int idShift;
@@ -56,6 +56,12 @@ public class ExtraNonceProviderBase : IExtraNonceProvider
     protected readonly ulong nonceMax;
     protected readonly string stringFormat;
 
+    // values currently held by a session, never handed out again until released
+    private readonly HashSet<ulong> inUse = new();
+
+    // values of sessions that are gone for good, handed out again before the counter advances
+    private readonly Queue<ulong> released = new();
+
     #region IExtraNonceProvider
 
     public int ByteSize => extranonceBytes;
@@ -64,23 +70,95 @@ public class ExtraNonceProviderBase : IExtraNonceProvider
     {
         ulong value;
 
-        lock(counterLock)
+        lock(inUse)
         {
-            counter++;
+            value = NextFree();
+            inUse.Add(value);
+        }
 
-            if(counter > nonceMax)
-            {
-                logger.Warn(()=> $"ExtraNonceProvider range exhausted! Rolling over to 0.");
+        // encode to hex
+        return (((ulong) id << idShift) | value).ToString(stringFormat);
+    }
 
-                counter = 0;
-            }
+    public void Release(string extraNonce)
+    {
+        if(!TryParse(extraNonce, out var value))
+            return;
 
-            // encode to hex
-            value = ((ulong) id << idShift) | counter;
+        lock(inUse)
+        {
+            if(inUse.Remove(value))
+                released.Enqueue(value);
         }
+    }
+
+    /// <summary>
+    /// Makes sure a value handed out by a previous instance (e.g. a session resumed after a handoff)
+    /// is not issued again by this one
+    /// </summary>
+    public void Reserve(string extraNonce)
+    {
+        if(!TryParse(extraNonce, out var value))
+            return;
+
+        lock(inUse)
+        {
+            inUse.Add(value);
 
-        return value.ToString(stringFormat);
+            // keep fresh values clear of reserved ones within the current lap
+            var lap = counter - (long) ((ulong) counter % (nonceMax + 1));
+
+            if(counter < lap + (long) value)
+                counter = lap + (long) value;
+        }
     }
 
     #endregion // IExtraNonceProvider
+
+    /// <summary>
+    /// Released values first, then the counter, skipping values still in use either way (the counter
+    /// may have wrapped around into them). Must be called under the lock.
+    /// </summary>
+    private ulong NextFree()
+    {
+        while(released.TryDequeue(out var value))
+        {
+            if(!inUse.Contains(value))
+                return value;
+        }
+
+        for(var i = 0UL; i <= nonceMax; i++)
+        {
+            var candidate = (ulong) ++counter % (nonceMax + 1);
+
+            if(candidate == 0)
+                logger.Warn(()=> $"ExtraNonceProvider range exhausted! Rolling over to 0.");
+
+            if(!inUse.Contains(candidate))
+                return candidate;
+        }
+
+        // every value is taken, sharing one beats refusing the connection
+        logger.Error(()=> $"All {nonceMax + 1} extranonce values are in use, issuing a duplicate");
+
+        return (ulong) ++counter % (nonceMax + 1);
+    }
+
+    /// <summary>
+    /// Extracts the counter part of a value issued by this instance
+    /// </summary>
+    private bool TryParse(string extraNonce, out ulong value)
+    {
+        value = 0;
+
+        if(!ulong.TryParse(extraNonce, NumberStyles.HexNumber, CultureInfo.InvariantCulture, out var raw))
+            return false;
+
+        // values from a different instance id can't collide with ours
+        if(raw >> idShift != id)
+            return false;
+
+        value = raw & nonceMax;
+        return true;
+    }
 }
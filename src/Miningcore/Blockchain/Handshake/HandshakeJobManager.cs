@@ -117,6 +117,7 @@ public class HandshakeJobManager : BitcoinJobManagerBase<HandshakeJob>
                         logger.Debug(() => $"Template update {blockTemplate?.Height}");
                 }
 
+                validJobs.Add(job.JobId, job);
                 currentJob = job;
             }
 
@@ -217,11 +218,12 @@ public class HandshakeJobManager : BitcoinJobManagerBase<HandshakeJob>
         if(string.IsNullOrEmpty(workerValue))
             throw new StratumException(StratumError.Other, "missing or invalid workername");
 
-        HandshakeJob job;
+        var job = validJobs.Get(jobId, out var id);
 
         lock(context)
         {
-            job = context.GetJob(jobId);
+            if(!context.IsValidJob(id))
+                job = null;
         }
 
         if(job == null)
@@ -286,11 +288,12 @@ public class HandshakeJobManager : BitcoinJobManagerBase<HandshakeJob>
         if(string.IsNullOrEmpty(jobId))
             throw new StratumException(StratumError.JobNotFound, "missing or invalid job");
 
-        HandshakeJob job;
+        var job = validJobs.Get(jobId, out var id);
 
         lock(context)
         {
-            job = context.GetJob(jobId);
+            if(!context.IsValidJob(id))
+                job = null;
         }
 
         if(job == null)
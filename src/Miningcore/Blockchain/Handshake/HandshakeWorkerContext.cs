@@ -23,21 +23,18 @@ public class HandshakeWorkerContext : WorkerContextBase
     public string ExtraNonce1 { get; set; }
 
     /// <summary>
-    /// Current N job(s) assigned to this worker
+    /// Ids of the pool jobs this worker may submit shares for
     /// </summary>
-    public Queue<HandshakeJob> validJobs { get; private set; } = new();
+    private JobWindow validJobs;
 
     public virtual void AddJob(HandshakeJob job, int maxActiveJobs)
     {
-        if(!validJobs.Contains(job))
-            validJobs.Enqueue(job);
-
-        while(validJobs.Count > maxActiveJobs)
-            validJobs.Dequeue();
+        if(JobRing.TryParseId(job.JobId, out var id))
+            validJobs.Add(id, maxActiveJobs);
     }
 
-    public HandshakeJob GetJob(string jobId)
+    public bool IsValidJob(long id)
     {
-        return validJobs.ToArray().FirstOrDefault(x => x.JobId == jobId);
+        return validJobs.Contains(id);
     }
 }
@@ -60,8 +60,8 @@ public abstract class JobManagerBase<TJob>
 
     protected string NextJobId(string format = null)
     {
-        Interlocked.Increment(ref jobId);
-        var value = Interlocked.CompareExchange(ref jobId, 0, int.MinValue);
+        // wraps around through all 32 bits, consecutive ids always differ by one modulo 2^32
+        var value = unchecked((uint) Interlocked.Increment(ref jobId));
 
         if(format != null)
             return value.ToString(format);
@@ -77,9 +77,14 @@ public abstract class JobManagerBase<TJob>
             .Select(x => x.Payload);
     }
 
+    /// <summary>
+    /// Must only be called once the daemon has accepted the block
+    /// </summary>
     protected void OnBlockFound()
     {
         blockFoundSubject.OnNext(Unit.Default);
+
+        messageBus.SendMessage(new BlockAcceptedMessage(poolConfig.Id));
     }
 
     protected abstract Task<bool> AreDaemonsHealthyAsync(CancellationToken ct);
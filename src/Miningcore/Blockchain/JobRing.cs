@@ -0,0 +1,166 @@
+using System.Collections.Concurrent;
+using System.Globalization;
+using System.Numerics;
+using Miningcore.Contracts;
+
+namespace Miningcore.Blockchain;
+
+public static class JobRing
+{
+    /// <summary>
+    /// Parses a job id issued by <see cref="JobManagerBase{TJob}.NextJobId"/> in hex, without allocating
+    /// </summary>
+    public static bool TryParseId(string jobId, out long id)
+    {
+        id = 0;
+
+        return !string.IsNullOrEmpty(jobId) && jobId.Length <= 15 &&
+            long.TryParse(jobId, NumberStyles.AllowHexSpecifier, CultureInfo.InvariantCulture, out id);
+    }
+}
+
+/// <summary>
+/// Pool-wide ring of the most recent jobs, looked up by numeric job id and optionally by a secondary key
+/// </summary>
+/// <remarks>
+/// Lookups are lock-free and don't allocate. Workers don't keep job references, only the range of ids
+/// they may submit shares for (see <see cref="JobWindow"/>), so the ring must hold at least as many jobs as
+/// that range.
+/// </remarks>
+public class JobRing<TJob> where TJob : class
+{
+    public JobRing(int capacity, Func<TJob, string> keySelector = null)
+    {
+        Contract.Requires<ArgumentException>(capacity > 0);
+
+        slots = new Entry[BitOperations.RoundUpToPowerOf2((uint) capacity)];
+        mask = slots.Length - 1;
+
+        if(keySelector != null)
+        {
+            this.keySelector = keySelector;
+            keys = new ConcurrentDictionary<string, Entry>();
+        }
+    }
+
+    private record Entry(long Id, TJob Job, string Key);
+
+    private readonly Entry[] slots;
+    private readonly long mask;
+    private readonly Func<TJob, string> keySelector;
+    private readonly ConcurrentDictionary<string, Entry> keys;
+    private long newest;
+
+    public int Capacity => slots.Length;
+
+    /// <summary>
+    /// Id of the most recently added job, 0 if none (or if the ids just wrapped around)
+    /// </summary>
+    public long Newest => Interlocked.Read(ref newest);
+
+    /// <summary>
+    /// Adds a job, evicting the one added <see cref="Capacity"/> ids before it
+    /// </summary>
+    public long Add(string jobId, TJob job)
+    {
+        Contract.RequiresNonNull(job);
+
+        if(!JobRing.TryParseId(jobId, out var id))
+            throw new ArgumentException($"Invalid job id {jobId}", nameof(jobId));
+
+        var entry = new Entry(id, job, keySelector?.Invoke(job));
+
+        lock(slots)
+        {
+            ref var slot = ref slots[id & mask];
+
+            // only if the key wasn't taken over by a later job
+            if(slot?.Key != null)
+                keys.TryRemove(new KeyValuePair<string, Entry>(slot.Key, slot));
+
+            Volatile.Write(ref slot, entry);
+
+            if(entry.Key != null)
+                keys[entry.Key] = entry;
+
+            Interlocked.Exchange(ref newest, id);
+        }
+
+        return id;
+    }
+
+    /// <summary>
+    /// Returns the job with the given id or null if it is unknown or has been evicted
+    /// </summary>
+    public TJob Get(string jobId, out long id)
+    {
+        if(!JobRing.TryParseId(jobId, out id))
+            return null;
+
+        var entry = Volatile.Read(ref slots[id & mask]);
+
+        return entry?.Id == id ? entry.Job : null;
+    }
+
+    /// <summary>
+    /// Returns the job with the given secondary key or null if it is unknown or has been evicted
+    /// </summary>
+    public TJob GetByKey(string key, out long id)
+    {
+        id = 0;
+
+        if(keys == null || key == null || !keys.TryGetValue(key, out var entry))
+            return null;
+
+        id = entry.Id;
+        return entry.Job;
+    }
+}
+
+/// <summary>
+/// Range of job ids a worker may submit shares for: from the first job it was sent, but no more
+/// than maxActiveJobs behind the latest one
+/// </summary>
+/// <remarks>
+/// Job ids are 32-bit counters that wrap around (see <see cref="JobManagerBase{TJob}.NextJobId"/>),
+/// so ids are compared by their distance modulo 2^32 rather than by value.
+/// Not thread-safe, guarded by the worker context lock like the job queues it replaces.
+/// </remarks>
+public struct JobWindow
+{
+    private uint oldest;
+    private uint newest;
+    private bool hasJobs;
+
+    public void Add(long id, int maxActiveJobs)
+    {
+        if(id is < 0 or > uint.MaxValue)
+            return;
+
+        var value = (uint) id;
+
+        // first job or job ids started over
+        if(!hasJobs || (int) (value - oldest) < 0)
+        {
+            oldest = value;
+            newest = value;
+            hasJobs = true;
+            return;
+        }
+
+        // re-sending a job that is still in the window doesn't move it
+        if((int) (value - newest) <= 0)
+            return;
+
+        newest = value;
+
+        if(newest - oldest >= (uint) maxActiveJobs)
+            oldest = newest - (uint) maxActiveJobs + 1;
+    }
+
+    public bool Contains(long id)
+    {
+        return hasJobs && id is >= 0 and <= uint.MaxValue &&
+            (uint) id - oldest <= newest - oldest;
+    }
+}
@@ -150,6 +150,7 @@ public class NexaJobManager : BitcoinJobManagerBase<NexaJob>
                         logger.Debug(() => $"Template update {blockTemplate?.Height}");
                 }
 
+                validJobs.Add(job.JobId, job);
                 currentJob = job;
             }
 
@@ -237,11 +238,12 @@ public class NexaJobManager : BitcoinJobManagerBase<NexaJob>
         if(extraNonce1 != context.ExtraNonce1)
             throw new StratumException(StratumError.Other, "invalid extranonce");
 
-        NexaJob job;
+        var job = validJobs.Get(jobId, out var id);
 
         lock(context)
         {
-            job = context.GetJob(jobId);
+            if(!context.IsValidJob(id))
+                job = null;
         }
 
         if(job == null)
@@ -967,6 +967,56 @@ public class PostgresConfig : DatabaseConfig
     /// Enable Enabling Npgsql Legacy Timestamp Behavior
     /// </summary>
     public bool? EnableLegacyTimestamps { get; set; }
+
+    /// <summary>
+    /// Optional read-only streaming replicas serving API and reporting queries
+    /// </summary>
+    public PostgresReplicaConfig[] Replicas { get; set; }
+
+    /// <summary>
+    /// Maximum replication lag in seconds tolerated for reads that must observe recent writes (default 1)
+    /// </summary>
+    public double? MaxReplicaLag { get; set; }
+
+    /// <summary>
+    /// Maximum replication lag in seconds tolerated for API and reporting reads (default 30)
+    /// </summary>
+    public double? MaxReplicaStaleness { get; set; }
+
+    /// <summary>
+    /// Interval in seconds at which replica lag is re-measured (default 5)
+    /// </summary>
+    public double? ReplicaLagCheckInterval { get; set; }
+
+    /// <summary>
+    /// Optional staged share ingestion (requires add_share_staging.sql)
+    /// </summary>
+    public PostgresShareStagingConfig ShareStaging { get; set; }
+}
+
+/// <summary>
+/// Shares are copied into an unindexed staging table and moved into the indexed shares table in large sorted batches
+/// </summary>
+public class PostgresShareStagingConfig
+{
+    public bool Enabled { get; set; }
+
+    /// <summary>
+    /// Interval in seconds at which staged shares are merged (default 5)
+    /// </summary>
+    public double? MergeInterval { get; set; }
+
+    /// <summary>
+    /// Maximum number of shares moved per statement (default 100000)
+    /// </summary>
+    public int? MergeBatchSize { get; set; }
+}
+
+/// <summary>
+/// Read replica endpoint. Database, user and password default to those of the primary if omitted.
+/// </summary>
+public class PostgresReplicaConfig : DatabaseConfig
+{
 }
 
 public class TcpProxyProtocolConfig
@@ -995,6 +1045,13 @@ public class PoolEndpoint
     public TcpProxyProtocolConfig TcpProxyProtocol { get; set; }
     public VarDiffConfig VarDiff { get; set; }
 
+    /// <summary>
+    /// Number of share submissions per connection that may be validated concurrently (default 1)
+    /// Intended for ports serving proxies which multiplex many rigs over a single connection.
+    /// Other requests are still processed in order, after all submissions received before them.
+    /// </summary>
+    public int? PipelineDepth { get; set; }
+
     /// <summary>
     /// Enable Transport layer security (TLS)
     /// If set to true, you must specify values for either TlsPemFile or TlsPfxFile
@@ -1086,6 +1143,7 @@ public partial class PoolShareBasedBanningConfig
     public int Time { get; set; } // How many seconds to ban worker for
     public double? MinerEffortPercent { get; set; } // What percent of effort triggers ban
     public int? MinerEffortTime { get; set; } // How many seconds to ban worker for
+    public int? MinerEffortCheckInterval { get; set; } // How often in seconds miner effort is checked (default 10)
 }
 
 public partial class PoolPaymentProcessingConfig
@@ -1211,6 +1269,16 @@ public partial class ApiConfig
     /// Enable serialization of null values in API responses
     /// </summary>
     public bool LegacyNullValueHandling { get; set; }
+
+    /// <summary>
+    /// Maximum number of miner stats responses kept in memory (default 10000, 0 disables the cache)
+    /// </summary>
+    public int? MinerResponseCacheSize { get; set; }
+
+    /// <summary>
+    /// Upper bound in seconds for serving a cached miner stats response that no event has invalidated (default 60)
+    /// </summary>
+    public int? MinerResponseCacheMaxAge { get; set; }
 }
 
 public class ZmqPubSubEndpointConfig
@@ -1290,6 +1358,13 @@ public class ClusterMemoryConfig
     /// WARNING: Don't use this if you don't know what you are doing
     /// </summary>
     public int? RmsmMaximumFreeLargePoolBytes { get; set; }
+
+    /// <summary>
+    /// Upper limit in bytes for native hashing datasets and caches (DAGs, light caches, RandomX datasets ...)
+    /// shared by all pools. Pre-generation of upcoming epochs is skipped and retained caches are evicted
+    /// to stay within the limit. Unlimited if not set.
+    /// </summary>
+    public long? NativeMemoryBudget { get; set; }
 }
 
 public partial class PoolConfig
@@ -1342,6 +1417,30 @@ public partial class PoolConfig
     /// </summary>
     public int? VardiffIdleSweepInterval { get; set; }
 
+    /// <summary>
+    /// CPU cores this pool may spend validating shares. When exceeded, the MinDiff of all VarDiff ports
+    /// is raised so that low hashrate miners submit less often. Unlimited if not set.
+    /// </summary>
+    public double? ShareValidationCpuBudget { get; set; }
+
+    /// <summary>
+    /// Microseconds a share may wait for others to be validated along with it in a single multi-lane native call,
+    /// on algorithms that have one. Shares are validated right away when no other validation is in progress,
+    /// so light load is not affected. The wait is rounded up to whole milliseconds and ends early once a batch is full.
+    /// Disabled if not set.
+    /// </summary>
+    public double? ShareValidationBatchWindow { get; set; }
+
+    /// <summary>
+    /// Lets miners reconnecting with their previous subscription id pick up their old extranonce1 and difficulty
+    /// </summary>
+    public StratumSessionResumptionConfig SessionResumption { get; set; }
+
+    /// <summary>
+    /// Limits new connections per remote address and per address prefix before they are accepted
+    /// </summary>
+    public StratumAdmissionConfig Admission { get; set; }
+
     /// <summary>
     /// Arbitrary extension data
     /// </summary>
@@ -1349,6 +1448,82 @@ public partial class PoolConfig
     public IDictionary<string, object> Extra { get; set; }
 }
 
+public class StratumHandoffConfig
+{
+    /// <summary>
+    /// Hand over listening sockets and live stratum sessions to a newly started instance
+    /// instead of dropping all miners on restart (Linux only)
+    /// </summary>
+    public bool Enabled { get; set; }
+
+    /// <summary>
+    /// Unix domain socket through which the running and the starting instance coordinate the handoff
+    /// </summary>
+    [Required]
+    public string SocketPath { get; set; }
+
+    /// <summary>
+    /// Seconds the new instance waits for all of its pools to come online before releasing the old one
+    /// Default: 300
+    /// </summary>
+    public int? Timeout { get; set; }
+}
+
+/// <summary>
+/// Prefixes are /24 for IPv4 and /64 for IPv6. Limits that are not set are not enforced.
+/// </summary>
+public class StratumAdmissionConfig
+{
+    /// <summary>
+    /// New connections per second allowed from a single address
+    /// </summary>
+    public double? ConnectRate { get; set; }
+
+    /// <summary>
+    /// Connections a single address may open in a burst before ConnectRate applies
+    /// Default: 10
+    /// </summary>
+    public int? ConnectBurst { get; set; }
+
+    /// <summary>
+    /// New connections per second allowed from all addresses of a prefix together
+    /// </summary>
+    public double? PrefixConnectRate { get; set; }
+
+    /// <summary>
+    /// Connections a prefix may open in a burst before PrefixConnectRate applies
+    /// Default: 100
+    /// </summary>
+    public int? PrefixConnectBurst { get; set; }
+
+    /// <summary>
+    /// Concurrent connections allowed from a single address
+    /// </summary>
+    public int? MaxConnectionsPerAddress { get; set; }
+
+    /// <summary>
+    /// Concurrent connections allowed from all addresses of a prefix together
+    /// </summary>
+    public int? MaxConnectionsPerPrefix { get; set; }
+}
+
+public class StratumSessionResumptionConfig
+{
+    public bool Disabled { get; set; }
+
+    /// <summary>
+    /// Seconds the session of a disconnected miner is kept around for resumption
+    /// Default: 300
+    /// </summary>
+    public int? Timeout { get; set; }
+
+    /// <summary>
+    /// Upper bound for the number of disconnected sessions kept per pool, oldest are dropped first
+    /// Default: 100000
+    /// </summary>
+    public int? MaxSessions { get; set; }
+}
+
 public partial class ClusterConfig
 {
     /// <summary>
@@ -1371,6 +1546,7 @@ public partial class ClusterConfig
     public Statistics Statistics { get; set; }
     public NicehashClusterConfig Nicehash { get; set; }
     public ClusterMemoryConfig Memory { get; set; }
+    public StratumHandoffConfig StratumHandoff { get; set; }
 
     /// <summary>
     /// If this is enabled, shares are not written to the database
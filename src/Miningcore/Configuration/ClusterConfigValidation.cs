@@ -1,5 +1,6 @@
 using FluentValidation;
 using System.Security.Cryptography.X509Certificates;
+using Miningcore.Stratum;
 
 namespace Miningcore.Configuration;
 
@@ -68,6 +69,11 @@ public class PoolEndpointValidator : AbstractValidator<PoolEndpoint>
             .GreaterThan(0)
             .WithMessage("Pool Endpoint: Difficulty missing or invalid");
 
+        RuleFor(j => j.PipelineDepth)
+            .InclusiveBetween(1, StratumConnection.MaxPipelineDepth)
+            .When(j => j.PipelineDepth.HasValue)
+            .WithMessage($"Pool Endpoint: PipelineDepth must be between 1 and {StratumConnection.MaxPipelineDepth}");
+
         RuleFor(j => j.TlsPfxFile)
             .NotNull()
             .NotEmpty()
@@ -186,6 +192,51 @@ public class PoolConfigValidator : AbstractValidator<PoolConfig>
 
         RuleForEach(j => j.Daemons)
             .SetValidator(new AuthenticatedNetworkEndpointConfigValidator<DaemonEndpointConfig>());
+
+        RuleFor(j => j.ShareValidationCpuBudget)
+            .GreaterThan(0)
+            .When(j => j.ShareValidationCpuBudget.HasValue)
+            .WithMessage("Pool: shareValidationCpuBudget must be greater than zero");
+
+        RuleFor(j => j.ShareValidationBatchWindow)
+            .GreaterThan(0)
+            .When(j => j.ShareValidationBatchWindow.HasValue)
+            .WithMessage("Pool: shareValidationBatchWindow must be greater than zero");
+
+        RuleFor(j => j.Banning.MinerEffortCheckInterval)
+            .GreaterThan(0)
+            .When(j => j.Banning?.MinerEffortCheckInterval.HasValue == true)
+            .WithMessage("Pool: banning.minerEffortCheckInterval must be greater than zero");
+
+        RuleFor(j => j.Admission.ConnectRate)
+            .GreaterThan(0)
+            .When(j => j.Admission?.ConnectRate.HasValue == true)
+            .WithMessage("Pool: admission.connectRate must be greater than zero");
+
+        RuleFor(j => j.Admission.ConnectBurst)
+            .GreaterThan(0)
+            .When(j => j.Admission?.ConnectBurst.HasValue == true)
+            .WithMessage("Pool: admission.connectBurst must be greater than zero");
+
+        RuleFor(j => j.Admission.PrefixConnectRate)
+            .GreaterThan(0)
+            .When(j => j.Admission?.PrefixConnectRate.HasValue == true)
+            .WithMessage("Pool: admission.prefixConnectRate must be greater than zero");
+
+        RuleFor(j => j.Admission.PrefixConnectBurst)
+            .GreaterThan(0)
+            .When(j => j.Admission?.PrefixConnectBurst.HasValue == true)
+            .WithMessage("Pool: admission.prefixConnectBurst must be greater than zero");
+
+        RuleFor(j => j.Admission.MaxConnectionsPerAddress)
+            .GreaterThan(0)
+            .When(j => j.Admission?.MaxConnectionsPerAddress.HasValue == true)
+            .WithMessage("Pool: admission.maxConnectionsPerAddress must be greater than zero");
+
+        RuleFor(j => j.Admission.MaxConnectionsPerPrefix)
+            .GreaterThan(0)
+            .When(j => j.Admission?.MaxConnectionsPerPrefix.HasValue == true)
+            .WithMessage("Pool: admission.maxConnectionsPerPrefix must be greater than zero");
     }
 }
 
@@ -11,3 +11,24 @@ public interface IHashAlgorithmInit
 {
     bool DigestInit(PoolConfig poolConfig);
 }
+
+/// <summary>
+/// Implemented by algorithms with a native multi-lane path that hashes several inputs per call
+/// </summary>
+/// <remarks>
+/// A batched digest has no per-input arguments, only algorithms whose digest depends on the input alone
+/// (and ignores the extra arguments of <see cref="IHashAlgorithm.Digest"/>) may implement this.
+/// </remarks>
+public interface IHashAlgorithmBatch : IHashAlgorithm
+{
+    /// <summary>
+    /// Maximum number of inputs hashed in lock-step by the kernel selected for this CPU
+    /// </summary>
+    int MaxLanes { get; }
+
+    /// <summary>
+    /// Hashes count inputs of inputLength bytes each, stored back to back in data,
+    /// writing one 32-byte digest per input to result
+    /// </summary>
+    void DigestBatch(ReadOnlySpan<byte> data, int inputLength, Span<byte> result, int count);
+}
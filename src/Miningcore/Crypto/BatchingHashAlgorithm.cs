@@ -0,0 +1,41 @@
+using Miningcore.Contracts;
+
+namespace Miningcore.Crypto;
+
+/// <summary>
+/// Routes digests of a multi-lane algorithm through a <see cref="HashBatchDispatcher"/>
+/// </summary>
+public class BatchingHashAlgorithm : IHashAlgorithm
+{
+    public BatchingHashAlgorithm(IHashAlgorithm hasher, HashBatchDispatcher dispatcher)
+    {
+        Contract.RequiresNonNull(hasher);
+        Contract.RequiresNonNull(dispatcher);
+
+        Hasher = hasher;
+        Dispatcher = dispatcher;
+    }
+
+    /// <summary>
+    /// Wrapped algorithm
+    /// </summary>
+    public IHashAlgorithm Hasher { get; }
+
+    public HashBatchDispatcher Dispatcher { get; }
+
+    /// <remarks>
+    /// Synchronous callers can't wait for a batch without holding up their thread, they are served by the wrapped algorithm
+    /// </remarks>
+    public void Digest(ReadOnlySpan<byte> data, Span<byte> result, params object[] extra)
+    {
+        Hasher.Digest(data, result, extra);
+    }
+
+    /// <summary>
+    /// Hashes data into the first 32 bytes of result, possibly along with other callers' inputs
+    /// </summary>
+    public Task DigestAsync(ReadOnlyMemory<byte> data, Memory<byte> result)
+    {
+        return Dispatcher.DigestAsync(data, result);
+    }
+}
@@ -0,0 +1,231 @@
+using System.Buffers;
+using System.Collections.Concurrent;
+using Miningcore.Contracts;
+
+namespace Miningcore.Crypto;
+
+/// <summary>
+/// Collects share hashes submitted concurrently from many connections and runs them through
+/// a multi-lane native kernel in a single call
+/// </summary>
+/// <remarks>
+/// A hash submitted while no other one is pending or in progress is computed right away on the calling
+/// thread with the algorithm's scalar digest, so latency under light load is unchanged. Otherwise the first
+/// caller to find no open batch becomes its leader: it awaits the batch filling up to the kernel's lane count
+/// or the window running out, whichever comes first, then hashes the batch and completes every other caller's task.
+/// A full batch is closed right away, later requests start a new one. Nothing blocks a thread while waiting.
+/// The window is rounded up to the resolution of the runtime's timers, about a millisecond.
+/// Inputs of a batch must have the same length, others are hashed on their own.
+/// </remarks>
+public class HashBatchDispatcher
+{
+    public HashBatchDispatcher(IHashAlgorithmBatch hasher, TimeSpan window, int maxBatchSize = 0)
+    {
+        Contract.RequiresNonNull(hasher);
+        Contract.Requires<ArgumentException>(window >= TimeSpan.Zero);
+        Contract.Requires<ArgumentException>(maxBatchSize >= 0);
+
+        this.hasher = hasher;
+        this.window = window;
+        this.maxBatchSize = maxBatchSize > 0 ? maxBatchSize : Math.Max(1, hasher.MaxLanes);
+    }
+
+    private class Request
+    {
+        public Request(ReadOnlyMemory<byte> data, Memory<byte> result)
+        {
+            Data = data;
+            Result = result;
+        }
+
+        public ReadOnlyMemory<byte> Data { get; }
+        public Memory<byte> Result { get; }
+        public TaskCompletionSource Completion { get; } = new(TaskCreationOptions.RunContinuationsAsynchronously);
+    }
+
+    private class Batch
+    {
+        public Batch(int capacity, int inputLength)
+        {
+            Requests = new List<Request>(capacity);
+            InputLength = inputLength;
+        }
+
+        public List<Request> Requests { get; }
+        public int InputLength { get; }
+
+        // completed once the batch is closed to new requests
+        public TaskCompletionSource Full { get; } = new(TaskCreationOptions.RunContinuationsAsynchronously);
+    }
+
+    private static readonly ConcurrentDictionary<(IHashAlgorithmBatch, TimeSpan), HashBatchDispatcher> dispatchers = new();
+
+    private readonly IHashAlgorithmBatch hasher;
+    private readonly TimeSpan window;
+    private readonly int maxBatchSize;
+    private readonly object queueLock = new();
+
+    // batch accepting requests, null if none
+    private Batch open;
+
+    // submitted and not completed yet
+    private int active;
+
+    private long inline;
+    private long batches;
+    private long batched;
+
+    /// <summary>
+    /// Hashes computed on their own because nothing else was pending
+    /// </summary>
+    public long Inline => Interlocked.Read(ref inline);
+
+    /// <summary>
+    /// Number of batched native calls
+    /// </summary>
+    public long Batches => Interlocked.Read(ref batches);
+
+    /// <summary>
+    /// Hashes computed as part of a batch
+    /// </summary>
+    public long Batched => Interlocked.Read(ref batched);
+
+    /// <summary>
+    /// Returns the dispatcher shared by all users of hasher or hasher itself if it can't hash several inputs per call
+    /// </summary>
+    public static IHashAlgorithm Wrap(IHashAlgorithm hasher, TimeSpan window)
+    {
+        if(hasher is not IHashAlgorithmBatch batchHasher || batchHasher.MaxLanes < 2)
+            return hasher;
+
+        var dispatcher = dispatchers.GetOrAdd((batchHasher, window), key => new HashBatchDispatcher(key.Item1, key.Item2));
+
+        return new BatchingHashAlgorithm(hasher, dispatcher);
+    }
+
+    /// <summary>
+    /// Hashes data into the first 32 bytes of result, both must stay valid until the task completes
+    /// </summary>
+    public Task DigestAsync(ReadOnlyMemory<byte> data, Memory<byte> result)
+    {
+        Contract.Requires<ArgumentException>(result.Length >= 32);
+
+        // light load, don't wait for company
+        if(Interlocked.Increment(ref active) == 1)
+            return DigestInline(data, result);
+
+        var request = new Request(data, result);
+        Batch batch;
+        var isLeader = false;
+
+        lock(queueLock)
+        {
+            if(open != null && open.InputLength != data.Length)
+                batch = null;
+
+            else
+            {
+                if(open == null)
+                {
+                    open = new Batch(maxBatchSize, data.Length);
+                    isLeader = true;
+                }
+
+                batch = open;
+                batch.Requests.Add(request);
+
+                // closed batches are never added to, so none exceeds the kernel's width
+                if(batch.Requests.Count == maxBatchSize)
+                {
+                    open = null;
+                    batch.Full.TrySetResult();
+                }
+            }
+        }
+
+        if(batch == null)
+            return DigestInline(data, result);
+
+        if(isLeader)
+            _ = RunBatchAsync(batch);
+
+        return request.Completion.Task;
+    }
+
+    private Task DigestInline(ReadOnlyMemory<byte> data, Memory<byte> result)
+    {
+        try
+        {
+            hasher.Digest(data.Span, result.Span);
+            return Task.CompletedTask;
+        }
+
+        catch(Exception ex)
+        {
+            return Task.FromException(ex);
+        }
+
+        finally
+        {
+            Interlocked.Decrement(ref active);
+            Interlocked.Increment(ref inline);
+        }
+    }
+
+    private async Task RunBatchAsync(Batch batch)
+    {
+        if(!batch.Full.Task.IsCompleted)
+        {
+            // Task.Delay truncates to whole milliseconds, a shorter window must not turn into no window at all
+            var delay = TimeSpan.FromMilliseconds(Math.Max(1, Math.Ceiling(window.TotalMilliseconds)));
+
+            using(var cts = new CancellationTokenSource())
+            {
+                await Task.WhenAny(batch.Full.Task, Task.Delay(delay, cts.Token));
+                cts.Cancel();
+            }
+
+            lock(queueLock)
+            {
+                if(open == batch)
+                    open = null;
+            }
+        }
+
+        var requests = batch.Requests;
+        var count = requests.Count;
+        var inputLength = batch.InputLength;
+        var input = ArrayPool<byte>.Shared.Rent(inputLength * count);
+        var output = ArrayPool<byte>.Shared.Rent(32 * count);
+
+        try
+        {
+            for(var i = 0; i < count; i++)
+                requests[i].Data.Span.CopyTo(input.AsSpan(i * inputLength));
+
+            hasher.DigestBatch(input, inputLength, output, count);
+
+            for(var i = 0; i < count; i++)
+            {
+                output.AsSpan(i * 32, 32).CopyTo(requests[i].Result.Span);
+                requests[i].Completion.SetResult();
+            }
+        }
+
+        catch(Exception ex)
+        {
+            foreach(var request in requests)
+                request.Completion.TrySetException(ex);
+        }
+
+        finally
+        {
+            ArrayPool<byte>.Shared.Return(input);
+            ArrayPool<byte>.Shared.Return(output);
+
+            Interlocked.Add(ref active, -count);
+            Interlocked.Increment(ref batches);
+            Interlocked.Add(ref batched, count);
+        }
+    }
+}
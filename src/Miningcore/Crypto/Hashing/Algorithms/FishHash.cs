@@ -19,6 +19,13 @@ public unsafe class FishHash : IHashAlgorithm
     public const byte FishHashKernelPlus = 2;
     public const byte FishHashKernelV2 = 3;
 
+    // light_cache_num_items and full_dataset_num_items of libmultihash
+    private const long LightCacheSize = 1179641L * 64;
+    private const long FullDatasetSize = 37748717L * 128;
+
+    private static readonly object contextLock = new();
+    private static NativeMemoryLease contextLease;
+
     public FishHash(byte fishHashKernel = 1, bool fullContext = false, uint threads = 4)
     {
         Contract.Requires<ArgumentException>(fishHashKernel >= 1);
@@ -33,11 +40,33 @@ public unsafe class FishHash : IHashAlgorithm
             this.handle = Multihash.fishhashGetContext(fullContext);
             if(fullContext)
                 Multihash.fishhashPrebuildDataset(this.handle, threads);
+
+            FishHash.RegisterContext(fullContext);
         }
 
         logger.Debug(() => $"Done generating light cache after {DateTime.Now - started}");
     }
 
+    /// <summary>
+    /// Accounts for the native context, which is a process wide singleton shared by all FishHash variants
+    /// that gets replaced once a full dataset is requested
+    /// </summary>
+    internal static void RegisterContext(bool fullContext)
+    {
+        var size = LightCacheSize + (fullContext ? FullDatasetSize : 0);
+
+        lock(contextLock)
+        {
+            if(contextLease?.Size >= size)
+                return;
+
+            contextLease?.Dispose();
+
+            contextLease = NativeMemoryBudget.Default.Register("FishHash", fullContext ? "full dataset" : "light cache", size,
+                NativeMemoryPriority.Active, fullContext ? TimeSpan.FromMinutes(5) : TimeSpan.FromSeconds(5));
+        }
+    }
+
     public void Digest(ReadOnlySpan<byte> data, Span<byte> result, params object[] extra)
     {
         Contract.Requires<ArgumentException>(this.handle != IntPtr.Zero);
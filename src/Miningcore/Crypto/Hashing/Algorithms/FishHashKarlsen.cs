@@ -29,6 +29,8 @@ public unsafe class FishHashKarlsen : IHashAlgorithm
             this.handle = Multihash.fishhashGetContext(fullContext);
             if(fullContext)
                 Multihash.fishhashPrebuildDataset(this.handle, threads);
+
+            FishHash.RegisterContext(fullContext);
         }
 
         logger.Debug(() => $"Done generating light cache after {DateTime.Now - started}");
@@ -3,8 +3,18 @@ using Miningcore.Native;
 
 namespace Miningcore.Crypto.Hashing.Algorithms;
 
+public enum NeoScryptKernel
+{
+    Auto = 0,
+    Scalar = 1,
+    Sse2 = 2,
+    Avx2 = 3,
+}
+
 [Identifier("neoscrypt")]
-public unsafe class NeoScrypt : IHashAlgorithm
+public unsafe class NeoScrypt :
+    IHashAlgorithm,
+    IHashAlgorithmBatch
 {
     public NeoScrypt(uint profile)
     {
@@ -13,6 +23,15 @@ public unsafe class NeoScrypt : IHashAlgorithm
 
     private readonly uint profile;
 
+    private static readonly Lazy<NeoScryptKernel> kernel = new(() => (NeoScryptKernel) Multihash.neoscrypt_kernel());
+
+    /// <summary>
+    /// Best kernel available on this CPU
+    /// </summary>
+    public static NeoScryptKernel Kernel => kernel.Value;
+
+    public int MaxLanes => Kernel == NeoScryptKernel.Avx2 ? 2 : 1;
+
     public void Digest(ReadOnlySpan<byte> data, Span<byte> result, params object[] extra)
     {
         Contract.Requires<ArgumentException>(data.Length == 80);
@@ -26,4 +45,28 @@ public unsafe class NeoScrypt : IHashAlgorithm
             }
         }
     }
+
+    public void DigestBatch(ReadOnlySpan<byte> data, int inputLength, Span<byte> result, int count)
+    {
+        DigestBatch(data, inputLength, result, count, NeoScryptKernel.Auto);
+    }
+
+    /// <summary>
+    /// Batch digest using a specific kernel. Kernels not supported by the CPU are downgraded.
+    /// </summary>
+    public void DigestBatch(ReadOnlySpan<byte> data, int inputLength, Span<byte> result, int count, NeoScryptKernel kernel)
+    {
+        Contract.Requires<ArgumentException>(inputLength == 80);
+        Contract.Requires<ArgumentException>(count >= 0);
+        Contract.Requires<ArgumentException>(data.Length >= inputLength * count);
+        Contract.Requires<ArgumentException>(result.Length >= 32 * count);
+
+        fixed (byte* input = data)
+        {
+            fixed (byte* output = result)
+            {
+                Multihash.neoscrypt_batch(input, output, (uint) count, profile, (uint) kernel);
+            }
+        }
+    }
 }
@@ -0,0 +1,52 @@
+using Miningcore.Contracts;
+using Miningcore.Native;
+
+namespace Miningcore.Crypto.Hashing.Algorithms;
+
+public enum PwxformKernel
+{
+    Auto = 0,
+    Scalar = 1,
+    Sse2 = 2,
+    Avx = 3,
+    Xop = 4,
+}
+
+/// <summary>
+/// Runtime selected Salsa20 and pwxform kernels shared by the yespower and yescrypt families
+/// </summary>
+public static class Pwxform
+{
+    private static readonly Lazy<PwxformKernel> kernel = new(() => (PwxformKernel) Multihash.yespower_kernel());
+
+    /// <summary>
+    /// Best kernel available on this CPU
+    /// </summary>
+    public static PwxformKernel Kernel => kernel.Value;
+
+    /// <summary>
+    /// Digest using a specific kernel. Kernels not supported by the CPU are downgraded.
+    /// </summary>
+    /// <remarks>
+    /// The kernel is a per-thread setting of the native library, which is restored to
+    /// <see cref="PwxformKernel.Auto"/> before returning
+    /// </remarks>
+    public static void Digest(IHashAlgorithm hasher, ReadOnlySpan<byte> data, Span<byte> result, PwxformKernel kernel)
+    {
+        Contract.RequiresNonNull(hasher);
+
+        Multihash.yespower_set_kernel((uint) kernel);
+        Multihash.yescrypt_set_kernel((uint) kernel);
+
+        try
+        {
+            hasher.Digest(data, result);
+        }
+
+        finally
+        {
+            Multihash.yespower_set_kernel((uint) PwxformKernel.Auto);
+            Multihash.yescrypt_set_kernel((uint) PwxformKernel.Auto);
+        }
+    }
+}
@@ -4,7 +4,9 @@ using Miningcore.Native;
 namespace Miningcore.Crypto.Hashing.Algorithms;
 
 [Identifier("scrypt")]
-public unsafe class Scrypt : IHashAlgorithm
+public unsafe class Scrypt :
+    IHashAlgorithm,
+    IHashAlgorithmBatch
 {
     public Scrypt(uint n, uint r)
     {
@@ -15,6 +17,12 @@ public unsafe class Scrypt : IHashAlgorithm
     private readonly uint n;
     private readonly uint r;
 
+    private static readonly Lazy<int> maxLanes = new(() => (int) Multihash.scrypt_lanes());
+
+    public const int MidstateSize = 8;
+
+    public int MaxLanes => maxLanes.Value;
+
     public void Digest(ReadOnlySpan<byte> data, Span<byte> result, params object[] extra)
     {
         Contract.Requires<ArgumentException>(result.Length >= 32);
@@ -27,4 +35,53 @@ public unsafe class Scrypt : IHashAlgorithm
             }
         }
     }
+
+    public void DigestBatch(ReadOnlySpan<byte> data, int inputLength, Span<byte> result, int count)
+    {
+        DigestBatch(data, inputLength, result, count, ReadOnlySpan<uint>.Empty);
+    }
+
+    /// <summary>
+    /// Batch digest of inputs sharing the same 64-byte prefix. The midstate must have been
+    /// computed by <see cref="ComputeMidstate"/> from that prefix. Pass lanes to cap the
+    /// kernel width (0 = widest supported).
+    /// </summary>
+    public void DigestBatch(ReadOnlySpan<byte> data, int inputLength, Span<byte> result, int count,
+        ReadOnlySpan<uint> midstate, int lanes = 0)
+    {
+        Contract.Requires<ArgumentException>(count >= 0);
+        Contract.Requires<ArgumentException>(data.Length >= inputLength * count);
+        Contract.Requires<ArgumentException>(result.Length >= 32 * count);
+        Contract.Requires<ArgumentException>(midstate.IsEmpty || (midstate.Length == MidstateSize && inputLength > 64));
+
+        fixed (byte* input = data)
+        {
+            fixed (byte* output = result)
+            {
+                fixed (uint* ms = midstate)
+                {
+                    Multihash.scrypt_batch(input, output, (uint) count, n, r, (uint) inputLength,
+                        midstate.IsEmpty ? null : ms, (uint) lanes);
+                }
+            }
+        }
+    }
+
+    /// <summary>
+    /// Computes the SHA-256 midstate of the first 64 bytes of a block header. It stays valid
+    /// for every header sharing that prefix (same job and merkle root prefix).
+    /// </summary>
+    public static void ComputeMidstate(ReadOnlySpan<byte> header, Span<uint> midstate)
+    {
+        Contract.Requires<ArgumentException>(header.Length >= 64);
+        Contract.Requires<ArgumentException>(midstate.Length >= MidstateSize);
+
+        fixed (byte* input = header)
+        {
+            fixed (uint* output = midstate)
+            {
+                Multihash.scrypt_midstate(input, output);
+            }
+        }
+    }
 }
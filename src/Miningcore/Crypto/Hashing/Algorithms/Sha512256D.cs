@@ -3,9 +3,33 @@ using Miningcore.Native;
 
 namespace Miningcore.Crypto.Hashing.Algorithms;
 
+public enum Sha512256DKernel
+{
+    Auto = 0,
+    Scalar = 1,
+    Avx2 = 2,
+    Avx512 = 3,
+}
+
 [Identifier("sha512/256d")]
-public unsafe class Sha512256D : IHashAlgorithm
+public unsafe class Sha512256D :
+    IHashAlgorithm,
+    IHashAlgorithmBatch
 {
+    private static readonly Lazy<Sha512256DKernel> kernel = new(() => (Sha512256DKernel) Multihash.sha512_256_kernel());
+
+    /// <summary>
+    /// Best kernel available on this CPU
+    /// </summary>
+    public static Sha512256DKernel Kernel => kernel.Value;
+
+    public int MaxLanes => Kernel switch
+    {
+        Sha512256DKernel.Avx512 => 8,
+        Sha512256DKernel.Avx2 => 4,
+        _ => 1
+    };
+
     public void Digest(ReadOnlySpan<byte> data, Span<byte> result, params object[] extra)
     {
         Contract.Requires<ArgumentException>(result.Length >= 32);
@@ -19,4 +43,28 @@ public unsafe class Sha512256D : IHashAlgorithm
             }
         }
     }
+
+    public void DigestBatch(ReadOnlySpan<byte> data, int inputLength, Span<byte> result, int count)
+    {
+        DigestBatch(data, inputLength, result, count, Sha512256DKernel.Auto);
+    }
+
+    /// <summary>
+    /// Batch digest using a specific kernel. Kernels not supported by the CPU are downgraded.
+    /// </summary>
+    public void DigestBatch(ReadOnlySpan<byte> data, int inputLength, Span<byte> result, int count, Sha512256DKernel kernel)
+    {
+        Contract.Requires<ArgumentException>(inputLength >= 0);
+        Contract.Requires<ArgumentException>(count >= 0);
+        Contract.Requires<ArgumentException>(data.Length >= inputLength * count);
+        Contract.Requires<ArgumentException>(result.Length >= 32 * count);
+
+        fixed (byte* input = data)
+        {
+            fixed (byte* output = result)
+            {
+                Multihash.sha512_256d_batch(input, output, (uint) count, (uint) inputLength, (uint) kernel);
+            }
+        }
+    }
 }
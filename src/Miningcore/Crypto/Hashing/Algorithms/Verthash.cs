@@ -12,10 +12,16 @@ namespace Miningcore.Crypto.Hashing.Algorithms;
 [Identifier("verthash")]
 public unsafe class Verthash :
     IHashAlgorithm,
-    IHashAlgorithmInit
+    IHashAlgorithmInit,
+    IHashAlgorithmBatch
 {
     internal static IMessageBus messageBus;
 
+    // VERTHASH_MAX_LANES in h2.c, larger batches are processed in chunks of this size
+    private const int Lanes = 16;
+
+    public int MaxLanes => Lanes;
+
     public void Digest(ReadOnlySpan<byte> data, Span<byte> result, params object[] extra)
     {
         Contract.Requires<ArgumentException>(data.Length == 80);
@@ -34,8 +40,36 @@ public unsafe class Verthash :
         messageBus?.SendTelemetry("Verthash", TelemetryCategory.Hash, sw.Elapsed);
     }
 
+    /// <summary>
+    /// Hashes queued headers with their data file lookups interleaved, which hides most of the
+    /// memory latency a single hash spends waiting on random reads
+    /// </summary>
+    public void DigestBatch(ReadOnlySpan<byte> data, int inputLength, Span<byte> result, int count)
+    {
+        Contract.Requires<ArgumentException>(inputLength == 80);
+        Contract.Requires<ArgumentException>(count >= 0);
+        Contract.Requires<ArgumentException>(data.Length >= inputLength * count);
+        Contract.Requires<ArgumentException>(result.Length >= 32 * count);
+
+        var sw = Stopwatch.StartNew();
+
+        fixed (byte* input = data)
+        {
+            fixed (byte* output = result)
+            {
+                Multihash.verthash_batch(input, output, (uint) inputLength, (uint) count);
+            }
+        }
+
+        messageBus?.SendTelemetry("Verthash", TelemetryCategory.Hash, sw.Elapsed);
+    }
+
     private static readonly ILogger logger = LogManager.GetCurrentClassLogger();
 
+    // the data file is loaded into memory once per process
+    private static readonly object memoryLock = new();
+    private static NativeMemoryLease memoryLease;
+
     public bool DigestInit(PoolConfig poolConfig)
     {
         var vertHashDataFile = "verthash.dat";
@@ -45,6 +79,15 @@ public unsafe class Verthash :
 
         logger.Info(()=> $"Loading verthash data file {vertHashDataFile}");
 
-        return Multihash.verthash_init(vertHashDataFile, false) == 0;
+        if(Multihash.verthash_init(vertHashDataFile, false) != 0)
+            return false;
+
+        lock(memoryLock)
+        {
+            memoryLease ??= NativeMemoryBudget.Default.Register("Verthash", vertHashDataFile, new FileInfo(vertHashDataFile).Length,
+                NativeMemoryPriority.Active, TimeSpan.FromSeconds(10));
+        }
+
+        return true;
     }
 }
@@ -1,4 +1,5 @@
 using System.Diagnostics;
+using System.Runtime.InteropServices;
 using Miningcore.Extensions;
 using Miningcore.Messaging;
 using Miningcore.Native;
@@ -10,6 +11,14 @@ namespace Miningcore.Crypto.Hashing.Equihash;
 
 public abstract class EquihashSolver
 {
+    protected EquihashSolver(uint n, uint k, string personalization, string telemetryName)
+    {
+        this.personalization = personalization;
+        this.telemetryName = telemetryName;
+
+        verifier = new VerifierHandle(n, k, personalization);
+    }
+
     private static int maxThreads = 1;
 
     public static int MaxThreads
@@ -26,79 +35,59 @@ public abstract class EquihashSolver
 
     internal static IMessageBus messageBus;
 
-    protected static readonly Lazy<Semaphore> sem = new(() =>
-        new Semaphore(maxThreads, maxThreads));
+    protected static readonly Lazy<SemaphoreSlim> sem = new(() =>
+        new SemaphoreSlim(maxThreads, maxThreads));
 
-    protected string personalization;
+    protected readonly string personalization;
+    private readonly string telemetryName;
+    private readonly VerifierHandle verifier;
 
     public string Personalization => personalization;
 
     /// <summary>
-    /// Verify an Equihash solution
+    /// Native Blake2b state personalised for (n, k, personalization), created once and
+    /// cloned by every verification instead of being re-derived from the parameter block
     /// </summary>
-    /// <param name="header">header including nonce (140 bytes)</param>
-    /// <param name="solution">equihash solution without size-preamble</param>
-    /// <returns></returns>
-    public abstract bool Verify(ReadOnlySpan<byte> header, ReadOnlySpan<byte> solution);
-}
-
-public unsafe class EquihashSolver_200_9 : EquihashSolver
-{
-    public EquihashSolver_200_9(string personalization)
+    private sealed class VerifierHandle : SafeHandle
     {
-        this.personalization = personalization;
-    }
-
-    public override bool Verify(ReadOnlySpan<byte> header, ReadOnlySpan<byte> solution)
-    {
-        var sw = Stopwatch.StartNew();
-
-        try
+        public VerifierHandle(uint n, uint k, string personalization) : base(IntPtr.Zero, true)
         {
-            sem.Value.WaitOne();
+            SetHandle(Multihash.equihash_verifier_create(n, k, personalization));
 
-            fixed (byte* h = header)
-            {
-                fixed (byte* s = solution)
-                {
-                    var result = Multihash.equihash_verify_200_9(h, header.Length, s, solution.Length, personalization);
-
-                    messageBus?.SendTelemetry("Equihash 200-9", TelemetryCategory.Hash, sw.Elapsed, result);
-
-                    return result;
-                }
-            }
+            if(IsInvalid)
+                throw new NotSupportedException($"Equihash {n}-{k} is not supported");
         }
 
-        finally
+        public override bool IsInvalid => handle == IntPtr.Zero;
+
+        protected override bool ReleaseHandle()
         {
-            sem.Value.Release();
+            Multihash.equihash_verifier_destroy(handle);
+            return true;
         }
     }
-}
 
-public unsafe class EquihashSolver_144_5 : EquihashSolver
-{
-    public EquihashSolver_144_5(string personalization)
-    {
-        this.personalization = personalization;
-    }
-
-    public override bool Verify(ReadOnlySpan<byte> header, ReadOnlySpan<byte> solution)
+    /// <summary>
+    /// Verify an Equihash solution
+    /// </summary>
+    /// <param name="header">header including nonce (140 bytes)</param>
+    /// <param name="solution">equihash solution without size-preamble</param>
+    /// <returns></returns>
+    public unsafe bool Verify(ReadOnlySpan<byte> header, ReadOnlySpan<byte> solution)
     {
         var sw = Stopwatch.StartNew();
 
+        sem.Value.Wait();
+
         try
         {
-            sem.Value.WaitOne();
-
             fixed (byte* h = header)
             {
                 fixed (byte* s = solution)
                 {
-                    var result = Multihash.equihash_verify_144_5(h, header.Length, s, solution.Length, personalization);
+                    var result = Multihash.equihash_verifier_verify(verifier, h, header.Length, s, solution.Length);
 
-                    messageBus?.SendTelemetry(personalization ?? "Equihash 144-5", TelemetryCategory.Hash, sw.Elapsed, result);
+                    messageBus?.SendTelemetry(telemetryName, TelemetryCategory.Hash, sw.Elapsed, result);
 
                     return result;
                 }
@@ -112,37 +101,23 @@ public unsafe class EquihashSolver_144_5 : EquihashSolver
     }
 }
 
-public unsafe class EquihashSolver_96_5 : EquihashSolver
+public class EquihashSolver_200_9 : EquihashSolver
 {
-    public EquihashSolver_96_5(string personalization)
+    public EquihashSolver_200_9(string personalization) : base(200, 9, personalization, "Equihash 200-9")
     {
-        this.personalization = personalization;
     }
+}
 
-    public override bool Verify(ReadOnlySpan<byte> header, ReadOnlySpan<byte> solution)
+public class EquihashSolver_144_5 : EquihashSolver
+{
+    public EquihashSolver_144_5(string personalization) : base(144, 5, personalization, personalization ?? "Equihash 144-5")
     {
-        var sw = Stopwatch.StartNew();
-
-        try
-        {
-            sem.Value.WaitOne();
-
-            fixed (byte* h = header)
-            {
-                fixed (byte* s = solution)
-                {
-                    var result = Multihash.equihash_verify_96_5(h, header.Length, s, solution.Length, personalization);
-
-                    messageBus?.SendTelemetry("Equihash 96-5", TelemetryCategory.Hash, sw.Elapsed, result);
-
-                    return result;
-                }
-            }
-        }
+    }
+}
 
-        finally
-        {
-            sem.Value.Release();
-        }
+public class EquihashSolver_96_5 : EquihashSolver
+{
+    public EquihashSolver_96_5(string personalization) : base(96, 5, personalization, "Equihash 96-5")
+    {
     }
 }
@@ -27,6 +27,7 @@ public class Cache : IEthashCache
     public ulong Epoch { get; }
     private string dagDir;
     public DateTime LastUsed { get; set; }
+    public NativeMemoryLease MemoryLease { get; set; }
     
     public static unsafe string GetDefaultdagDirectory()
     {
@@ -52,21 +53,27 @@ public class Cache : IEthashCache
     
     public void Dispose()
     {
-        if(handle != IntPtr.Zero)
+        // wait for a generation in progress
+        lock(genLock)
         {
-            // Full DAG
-            if(!string.IsNullOrEmpty(dagDir))
+            if(handle != IntPtr.Zero)
             {
-                EtcHash.ethash_full_delete(handle);
-            }
-            // Light Cache
-            else
-            {
-                EtcHash.ethash_light_delete(handle);
-            }
+                // Full DAG
+                if(!string.IsNullOrEmpty(dagDir))
+                {
+                    EtcHash.ethash_full_delete(handle);
+                }
+                // Light Cache
+                else
+                {
+                    EtcHash.ethash_light_delete(handle);
+                }
             
-            handle = IntPtr.Zero;
+                handle = IntPtr.Zero;
+            }
         }
+
+        MemoryLease?.Dispose();
     }
 
     public async Task GenerateAsync(ILogger logger, ulong epochLength, ulong hardForkBlock, CancellationToken ct)
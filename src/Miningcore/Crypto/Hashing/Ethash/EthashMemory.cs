@@ -0,0 +1,27 @@
+namespace Miningcore.Crypto.Hashing.Ethash;
+
+/// <summary>
+/// Memory footprint of ethash style light caches and DAGs, used for native memory budgeting
+/// </summary>
+public static class EthashMemory
+{
+    // Initial sizes and growth per epoch from the ethash specification.
+    // The real sizes are slightly smaller since they are rounded down to a prime number of items.
+    private const long CacheBytesInit = 1L << 24;
+    private const long CacheBytesGrowth = 1L << 17;
+    private const long DatasetBytesInit = 1L << 30;
+    private const long DatasetBytesGrowth = 1L << 23;
+
+    public static readonly TimeSpan CacheRebuildCost = TimeSpan.FromSeconds(2);
+    public static readonly TimeSpan DatasetRebuildCost = TimeSpan.FromMinutes(10);
+
+    public static long GetCacheSize(ulong epoch)
+    {
+        return CacheBytesInit + CacheBytesGrowth * (long) epoch;
+    }
+
+    public static long GetDatasetSize(ulong epoch)
+    {
+        return DatasetBytesInit + DatasetBytesGrowth * (long) epoch;
+    }
+}
@@ -1,4 +1,6 @@
 using Miningcore.Blockchain.Progpow;
+using Miningcore.Crypto.Hashing.Ethash;
+using Miningcore.Native;
 using NLog;
 
 namespace Miningcore.Crypto.Hashing.Progpow.Firopow;
@@ -15,12 +17,15 @@ public class FiropowLight : IProgpowLight
     private readonly object cacheLock = new();
     private readonly Dictionary<int, Cache> caches = new();
     private Cache future;
+    private int? deniedEpoch;
     public string AlgoName { get; } = "FiroPow";
 
     public void Dispose()
     {
         foreach(var value in caches.Values)
             value.Dispose();
+
+        future?.Dispose();
     }
 
     public async Task<IProgpowCache> GetCacheAsync(ILogger logger, int block, CancellationToken ct)
@@ -33,7 +38,14 @@ public class FiropowLight : IProgpowLight
             if(numCaches == 0)
                 numCaches = 3;
 
-            if(!caches.TryGetValue(epoch, out result))
+            // caches evicted by the native memory budget are about to be disposed by Release
+            if(caches.TryGetValue(epoch, out result) && result.MemoryLease?.IsEvicted == true)
+            {
+                caches.Remove(epoch);
+                result = null;
+            }
+
+            if(result == null)
             {
                 // No cached cache, evict the oldest if the cache limit was reached
                 while(caches.Count >= numCaches)
@@ -48,7 +60,7 @@ public class FiropowLight : IProgpowLight
                 }
 
                 // If we have the new cache pre-generated, use that, otherwise create a new one
-                if(future != null && future.Epoch == epoch)
+                if(future != null && future.Epoch == epoch && future.MemoryLease?.IsEvicted != true)
                 {
                     logger.Debug(() => $"Using pre-generated cache for epoch {epoch}");
 
@@ -62,21 +74,53 @@ public class FiropowLight : IProgpowLight
                     result = new Cache(epoch);
                 }
 
+                // only the new epoch backs current work, older ones are kept around for late shares
+                foreach(var value in caches.Values)
+                    value.MemoryLease?.SetPriority(NativeMemoryPriority.Cache);
+
+                if(result.MemoryLease != null)
+                    result.MemoryLease.SetPriority(NativeMemoryPriority.Active);
+
+                else
+                {
+                    var cache = result;
+
+                    result.MemoryLease = NativeMemoryBudget.Default.Register(AlgoName, $"epoch {epoch}", GetMemorySize(epoch),
+                        NativeMemoryPriority.Active, RebuildCost, () => Release(cache));
+                }
+
                 caches[epoch] = result;
             }
 
             // If we used up the future cache, or need a refresh, regenerate
-            else if(future == null || future.Epoch <= epoch)
+            else if((future == null || future.Epoch <= epoch) && deniedEpoch != epoch + 1)
             {
-                logger.Info(() => $"Pre-generating cache for epoch {epoch + 1}");
-                future = new Cache(epoch + 1);
+                var next = new Cache(epoch + 1);
+
+                // pre-generate only if it fits the native memory budget
+                next.MemoryLease = NativeMemoryBudget.Default.TryAdmit(AlgoName, $"epoch {next.Epoch}",
+                    GetMemorySize(next.Epoch), RebuildCost, () => Release(next));
+
+                if(next.MemoryLease != null)
+                {
+                    logger.Info(() => $"Pre-generating cache for epoch {epoch + 1}");
+
+                    if(future != null)
+                        Release(future);
+
+                    future = next;
 
 #pragma warning disable 4014
-                future.GenerateAsync(logger, ct);
+                    future.GenerateAsync(logger, ct);
 #pragma warning restore 4014
+                }
+
+                else
+                    deniedEpoch = next.Epoch;
             }
 
             result.LastUsed = DateTime.Now;
+            result.MemoryLease?.Touch();
         }
 
         // get/generate current one
@@ -84,4 +128,32 @@ public class FiropowLight : IProgpowLight
 
         return result;
     }
+
+    private static TimeSpan RebuildCost => EthashMemory.CacheRebuildCost;
+
+    private static long GetMemorySize(int epoch)
+    {
+        return EthashMemory.GetCacheSize((ulong) epoch);
+    }
+
+    /// <summary>
+    /// Drops a cache evicted by the native memory budget or superseded before it was used
+    /// </summary>
+    private void Release(Cache cache)
+    {
+        // deferred since the budget may evict while we are holding cacheLock
+        Task.Run(() =>
+        {
+            lock(cacheLock)
+            {
+                if(future == cache)
+                    future = null;
+
+                else if(caches.TryGetValue(cache.Epoch, out var value) && value == cache)
+                    caches.Remove(cache.Epoch);
+            }
+
+            cache.Dispose();
+        });
+    }
 }
\ No newline at end of file
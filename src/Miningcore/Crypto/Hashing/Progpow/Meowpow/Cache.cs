@@ -25,14 +25,21 @@ public class Cache : IProgpowCache
     public int Epoch { get; }
     public byte[] SeedHash { get; set; }
     public DateTime LastUsed { get; set; }
+    public NativeMemoryLease MemoryLease { get; set; }
 
     public void Dispose()
     {
-        if(handle != IntPtr.Zero)
+        // wait for a generation in progress
+        lock(genLock)
         {
-            MeowPow.DestroyContext(handle);
-            handle = IntPtr.Zero;
+            if(handle != IntPtr.Zero)
+            {
+                MeowPow.DestroyContext(handle);
+                handle = IntPtr.Zero;
+            }
         }
+
+        MemoryLease?.Dispose();
     }
 
     public async Task GenerateAsync(ILogger logger, CancellationToken ct)
@@ -0,0 +1,130 @@
+using System.Buffers.Binary;
+using System.Numerics;
+using System.Security.Cryptography;
+using Miningcore.Contracts;
+
+namespace Miningcore.Crypto;
+
+/// <summary>
+/// SHA-256 with access to the intermediate state after the first 64-byte block.
+/// Lets share validation hash an 80-byte block header from a precomputed midstate
+/// when only the trailing 16 bytes (merkle-root tail, time, bits, nonce) differ.
+/// </summary>
+public static class Sha256Midstate
+{
+    public const int BlockSize = 64;
+    public const int StateSize = 8;
+
+    private static readonly uint[] iv =
+    {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+
+    private static readonly uint[] k =
+    {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    /// <summary>
+    /// Computes the SHA-256 state after absorbing the first 64-byte block
+    /// </summary>
+    public static void Compute(ReadOnlySpan<byte> block, Span<uint> state)
+    {
+        Contract.Requires<ArgumentException>(block.Length >= BlockSize);
+        Contract.Requires<ArgumentException>(state.Length >= StateSize);
+
+        iv.CopyTo(state);
+        Compress(state, block);
+    }
+
+    /// <summary>
+    /// Double SHA-256 of an 80-byte message whose first 64 bytes have been absorbed into <paramref name="midstate"/>
+    /// </summary>
+    /// <param name="midstate">state returned by <see cref="Compute"/></param>
+    /// <param name="tail">the remaining 16 bytes of the message</param>
+    /// <param name="result">receives the 32-byte digest</param>
+    public static void DigestDouble80(ReadOnlySpan<uint> midstate, ReadOnlySpan<byte> tail, Span<byte> result)
+    {
+        Contract.Requires<ArgumentException>(midstate.Length >= StateSize);
+        Contract.Requires<ArgumentException>(tail.Length == 16);
+        Contract.Requires<ArgumentException>(result.Length >= 32);
+
+        // second block: tail, padding and message length in bits
+        Span<byte> block = stackalloc byte[BlockSize];
+        block.Clear();
+        tail.CopyTo(block);
+        block[16] = 0x80;
+        BinaryPrimitives.WriteUInt64BigEndian(block[56..], 80 * 8);
+
+        Span<uint> state = stackalloc uint[StateSize];
+        midstate[..StateSize].CopyTo(state);
+        Compress(state, block);
+
+        Span<byte> first = stackalloc byte[32];
+
+        for(var i = 0; i < StateSize; i++)
+            BinaryPrimitives.WriteUInt32BigEndian(first[(i * 4)..], state[i]);
+
+        SHA256.HashData(first, result);
+    }
+
+    private static void Compress(Span<uint> state, ReadOnlySpan<byte> block)
+    {
+        Span<uint> w = stackalloc uint[64];
+
+        for(var i = 0; i < 16; i++)
+            w[i] = BinaryPrimitives.ReadUInt32BigEndian(block[(i * 4)..]);
+
+        for(var i = 16; i < 64; i++)
+        {
+            var s0 = BitOperations.RotateRight(w[i - 15], 7) ^ BitOperations.RotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            var s1 = BitOperations.RotateRight(w[i - 2], 17) ^ BitOperations.RotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        var a = state[0];
+        var b = state[1];
+        var c = state[2];
+        var d = state[3];
+        var e = state[4];
+        var f = state[5];
+        var g = state[6];
+        var h = state[7];
+
+        for(var i = 0; i < 64; i++)
+        {
+            var s1 = BitOperations.RotateRight(e, 6) ^ BitOperations.RotateRight(e, 11) ^ BitOperations.RotateRight(e, 25);
+            var ch = (e & f) ^ (~e & g);
+            var t1 = h + s1 + ch + k[i] + w[i];
+            var s0 = BitOperations.RotateRight(a, 2) ^ BitOperations.RotateRight(a, 13) ^ BitOperations.RotateRight(a, 22);
+            var maj = (a & b) ^ (a & c) ^ (b & c);
+            var t2 = s0 + maj;
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
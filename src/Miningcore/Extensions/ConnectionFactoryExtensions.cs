@@ -31,6 +31,31 @@ public static class ConnectionFactoryExtensions
         }
     }
 
+    /// <summary>
+    /// Run the specified action providing it with a fresh connection routed according to <paramref name="intent"/>.
+    /// </summary>
+    public static async Task Run(this IConnectionFactory factory, ConnectionIntent intent,
+        Func<IDbConnection, Task> action)
+    {
+        using(var con = await factory.OpenConnectionAsync(intent))
+        {
+            await action(con);
+        }
+    }
+
+    /// <summary>
+    /// Run the specified action providing it with a fresh connection routed according to <paramref name="intent"/>.
+    /// </summary>
+    /// <returns>The result returned by the action</returns>
+    public static async Task<T> Run<T>(this IConnectionFactory factory, ConnectionIntent intent,
+        Func<IDbConnection, Task<T>> action)
+    {
+        using(var con = await factory.OpenConnectionAsync(intent))
+        {
+            return await action(con);
+        }
+    }
+
     /// <summary>
     /// Run the specified action inside a transaction. If the action throws an exception,
     /// the transaction is rolled back. Otherwise it is commited.
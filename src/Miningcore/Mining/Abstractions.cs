@@ -1,5 +1,6 @@
 using Miningcore.Blockchain;
 using Miningcore.Configuration;
+using Miningcore.Stratum;
 
 namespace Miningcore.Mining;
 
@@ -11,5 +12,7 @@ public interface IMiningPool
     double ShareMultiplier { get; }
     void Configure(PoolConfig pc, ClusterConfig cc);
     double HashrateFromShares(double shares, double interval);
+    ShareCounters GetShareCounters();
+    AdmissionCounters GetAdmissionCounters();
     Task RunAsync(CancellationToken ct);
 }
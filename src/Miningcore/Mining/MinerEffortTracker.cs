@@ -0,0 +1,70 @@
+using System.Collections.Concurrent;
+using Miningcore.Blockchain;
+
+namespace Miningcore.Mining;
+
+/// <summary>
+/// Per-miner effort (sum of share difficulty over network difficulty) since the last block found by the pool,
+/// accumulated from the accepted-share stream so checking it doesn't take a database round-trip
+/// </summary>
+public class MinerEffortTracker
+{
+    private class Entry
+    {
+        public double Effort;
+    }
+
+    private ConcurrentDictionary<string, Entry> efforts = new();
+
+    /// <summary>
+    /// Number of miners with effort recorded since the last reset
+    /// </summary>
+    public int Count => efforts.Count;
+
+    public void Record(Share share)
+    {
+        // the block's own share doesn't count towards the next one, the reset itself waits
+        // for the daemon to accept the block (see BlockAcceptedMessage)
+        if(share.IsBlockCandidate)
+            return;
+
+        if(string.IsNullOrEmpty(share.Miner) || share.NetworkDifficulty <= 0)
+            return;
+
+        Add(share.Miner, share.Difficulty / share.NetworkDifficulty);
+    }
+
+    public void Add(string miner, double effort)
+    {
+        var entry = efforts.GetOrAdd(miner, _ => new Entry());
+        var current = Volatile.Read(ref entry.Effort);
+
+        while(true)
+        {
+            var previous = Interlocked.CompareExchange(ref entry.Effort, current + effort, current);
+
+            // compare bits as NaN never equals itself
+            if(BitConverter.DoubleToInt64Bits(previous) == BitConverter.DoubleToInt64Bits(current))
+                break;
+
+            current = previous;
+        }
+    }
+
+    public double GetEffort(string miner)
+    {
+        if(string.IsNullOrEmpty(miner) || !efforts.TryGetValue(miner, out var entry))
+            return 0;
+
+        return Volatile.Read(ref entry.Effort);
+    }
+
+    /// <summary>
+    /// Starts over after a block has been found
+    /// </summary>
+    public void Reset()
+    {
+        // swap instead of clearing, shares recorded concurrently land in either instance and are simply dropped with the old one
+        Volatile.Write(ref efforts, new ConcurrentDictionary<string, Entry>());
+    }
+}
@@ -1,4 +1,5 @@
 using System.Collections.Concurrent;
+using System.Diagnostics;
 using System.Globalization;
 using System.Net;
 using System.Reactive.Disposables;
@@ -70,6 +71,8 @@ public abstract class PoolBase : StratumServer,
     protected readonly NicehashService nicehashService;
     protected readonly CompositeDisposable disposables = new();
     protected BlockchainStats blockchainStats;
+    protected ValidationCostFloor validationCostFloor;
+    protected MinerEffortTracker minerEffortTracker;
     protected static readonly TimeSpan maxShareAge = TimeSpan.FromSeconds(6);
     protected static readonly TimeSpan loginFailureBanTimeout = TimeSpan.FromSeconds(10);
     protected static readonly Regex regexStaticDiff = new(@";?d=(\d*(\.\d+)?)", RegexOptions.Compiled);
@@ -110,36 +113,143 @@ public abstract class PoolBase : StratumServer,
         connection.SetContext(context);
 
         // expect miner to establish communication within a certain time
-        EnsureNoZombieClient(connection);
+        SetupConnectionTimers(connection, true);
     }
 
-    private void EnsureNoZombieClient(StratumConnection connection)
+    protected override Task OnResumeAsync(StratumConnection connection, IPEndPoint ipEndPoint, StratumSessionState state)
     {
-        Observable.Timer(clock.Now.AddSeconds(10))
-            .TakeUntil(connection.Terminated)
-            .Where(_ => connection.IsAlive)
-            .Subscribe(_ =>
-            {
-                try
-                {
-                    if(connection.LastReceive == null)
-                    {
-                        logger.Info(() => $"[{connection.ConnectionId}] Booting zombie-worker (post-connect silence)");
+        var context = CreateWorkerContext();
+        var poolEndpoint = poolConfig.Ports[ipEndPoint.Port];
+        var varDiff = poolConfig.EnableInternalStratum == true ? poolEndpoint.VarDiff : null;
 
-                        Disconnect(connection);
-                    }
-                }
+        context.ImportState(state, varDiff);
+        connection.SetContext(context);
 
-                catch(Exception ex)
-                {
-                    logger.Error(ex);
-                }
-            }, ex =>
-            {
-                logger.Error(ex, nameof(EnsureNoZombieClient));
-            });
+        SetupConnectionTimers(connection, connection.LastReceive == null);
+
+        return Task.CompletedTask;
+    }
+
+    #region Connection Timers
+
+    private class ConnectionTimers
+    {
+        public StratumConnection Connection;
+        public TimerWheel.Timer Silence;
+        public TimerWheel.Timer Idle;
+        public TimerWheel.Timer VarDiffIdle;
     }
 
+    private static readonly TimeSpan postConnectSilenceTimeout = TimeSpan.FromSeconds(10);
+    private readonly ConcurrentDictionary<string, ConnectionTimers> connectionTimers = new();
+
+    /// <summary>
+    /// Arms the deadlines of a new connection on the server's timer wheel
+    /// </summary>
+    private void SetupConnectionTimers(StratumConnection connection, bool expectLogin)
+    {
+        var timers = new ConnectionTimers { Connection = connection };
+
+        if(expectLogin)
+        {
+            timers.Silence = timerWheel.CreateTimer(OnPostConnectSilence, timers);
+            timers.Silence.Arm(postConnectSilenceTimeout);
+        }
+
+        if(poolConfig.ClientConnectionTimeout > 0)
+        {
+            timers.Idle = timerWheel.CreateTimer(OnIdleTimeout, timers);
+            timers.Idle.Arm(TimeSpan.FromSeconds(poolConfig.ClientConnectionTimeout));
+        }
+
+        if(connection.Context.VarDiff != null)
+        {
+            // relative to the connect time, so retargets are spread out instead of coming in waves
+            timers.VarDiffIdle = timerWheel.CreateTimer(OnVarDiffIdle, timers);
+            timers.VarDiffIdle.Arm(TimeSpan.FromSeconds(poolConfig.VardiffIdleSweepInterval ?? 30));
+        }
+
+        connectionTimers[connection.ConnectionId] = timers;
+    }
+
+    private void ReleaseConnectionTimers(StratumConnection connection)
+    {
+        if(!connectionTimers.TryRemove(connection.ConnectionId, out var timers))
+            return;
+
+        timers.Silence?.Cancel();
+        timers.Idle?.Cancel();
+        timers.VarDiffIdle?.Cancel();
+    }
+
+    private void OnPostConnectSilence(object state)
+    {
+        var connection = ((ConnectionTimers) state).Connection;
+
+        if(connection.IsAlive && connection.LastReceive == null)
+        {
+            logger.Info(() => $"[{connection.ConnectionId}] Booting zombie-worker (post-connect silence)");
+
+            Disconnect(connection);
+        }
+    }
+
+    private void OnIdleTimeout(object state)
+    {
+        var timers = (ConnectionTimers) state;
+        var connection = timers.Connection;
+
+        if(!connection.IsAlive)
+        {
+            ReleaseConnectionTimers(connection);
+            return;
+        }
+
+        var timeout = TimeSpan.FromSeconds(poolConfig.ClientConnectionTimeout);
+        var idle = clock.Now - connection.Context.LastActivity;
+
+        if(connection.Context.IsAuthorized && idle > timeout)
+        {
+            logger.Info(() => $"[{connection.ConnectionId}] Booting zombie-worker (idle-timeout exceeded)");
+
+            Disconnect(connection);
+            return;
+        }
+
+        // there has been activity since the timer was armed, check again once the remainder has passed
+        timers.Idle.Arm(idle > TimeSpan.Zero && idle < timeout ? timeout - idle : timeout);
+    }
+
+    private void OnVarDiffIdle(object state)
+    {
+        var timers = (ConnectionTimers) state;
+        var connection = timers.Connection;
+
+        if(!connection.IsAlive)
+        {
+            ReleaseConnectionTimers(connection);
+            return;
+        }
+
+        // a retarget notifies the miner, keep that off the wheel
+        if(connection.Context.IsAuthorized)
+        {
+            Task.Run(() => Guard(() => UpdateVarDiffAsync(connection, true, CancellationToken.None),
+                ex => logger.Error(() => $"[{connection.ConnectionId}] Error updating vardiff: {ex.Message}")));
+        }
+
+        timers.VarDiffIdle.Arm(TimeSpan.FromSeconds(poolConfig.VardiffIdleSweepInterval ?? 30));
+    }
+
+    protected override void OnDisconnect(StratumConnection connection)
+    {
+        base.OnDisconnect(connection);
+
+        ReleaseConnectionTimers(connection);
+    }
+
+    #endregion // Connection Timers
+
     #region VarDiff
 
     protected async Task UpdateVarDiffAsync(StratumConnection connection, bool idle, CancellationToken ct)
@@ -152,9 +262,11 @@ public abstract class PoolBase : StratumServer,
 
             var poolEndpoint = poolConfig.Ports[connection.LocalEndpoint.Port];
 
+            var minDiff = validationCostFloor?.GetMinDiff(poolEndpoint.VarDiff.MinDiff);
+
             var newDiff = !idle ?
-                VarDiffManager.Update(context, poolEndpoint.VarDiff, clock) :
-                VarDiffManager.IdleUpdate(context, poolEndpoint.VarDiff, clock);
+                VarDiffManager.Update(context, poolEndpoint.VarDiff, clock, minDiff) :
+                VarDiffManager.IdleUpdate(context, poolEndpoint.VarDiff, clock, minDiff);
 
             if(newDiff != null)
             {
@@ -165,24 +277,106 @@ public abstract class PoolBase : StratumServer,
         }
     }
 
-    private async Task RunVardiffIdleUpdaterAsync(int interval, CancellationToken ct)
+    protected virtual Task OnVarDiffUpdateAsync(StratumConnection connection, double newDiff, CancellationToken _)
     {
-        await Guard(async () =>
+        connection.Context.EnqueueNewDifficulty(newDiff);
+
+        return Task.CompletedTask;
+    }
+
+    /// <summary>
+    /// Runs share validation, feeding the time it takes (rejected shares included) to the validation cost floor
+    /// </summary>
+    protected async Task<T> ValidateShareAsync<T>(Func<Task<T>> validate)
+    {
+        if(validationCostFloor == null)
+            return await validate();
+
+        var sw = Stopwatch.StartNew();
+
+        try
         {
-            using var timer = new PeriodicTimer(TimeSpan.FromSeconds(interval));
+            return await validate();
+        }
 
-            while(await timer.WaitForNextTickAsync(ct))
-            {
-                logger.Debug(() => "Vardiff Idle Update pass begins");
+        finally
+        {
+            validationCostFloor.Record(sw.Elapsed);
+        }
+    }
 
-                await Guard(() => ForEachMinerAsync(async (connection, _ct) =>
-                {
-                    await Guard(() => UpdateVarDiffAsync(connection, true, _ct),
-                        ex => logger.Error(() => $"[{connection.ConnectionId}] Error updating vardiff: {ex.Message}"));
-                }, ct));
+    /// <summary>
+    /// Synchronous variant of <see cref="ValidateShareAsync{T}"/>
+    /// </summary>
+    protected T ValidateShare<T>(Func<T> validate)
+    {
+        if(validationCostFloor == null)
+            return validate();
+
+        var sw = Stopwatch.StartNew();
+
+        try
+        {
+            return validate();
+        }
+
+        finally
+        {
+            validationCostFloor.Record(sw.Elapsed);
+        }
+    }
+
+    #endregion // VarDiff
+
+    #region Miner Effort
+
+    private bool IsMinerEffortBanningEnabled => poolConfig.Banning?.Enabled == true &&
+        poolConfig.Banning.MinerEffortPercent.HasValue && poolConfig.Banning.MinerEffortTime.HasValue;
+
+    private async Task SetupMinerEffortTrackingAsync(CancellationToken ct)
+    {
+        minerEffortTracker = new MinerEffortTracker();
+
+        disposables.Add(messageBus.Listen<Share>()
+            .Where(x => x.PoolId == poolConfig.Id)
+            .Subscribe(minerEffortTracker.Record));
+
+        // a candidate the daemon rejected doesn't end the round
+        disposables.Add(messageBus.Listen<BlockAcceptedMessage>()
+            .Where(x => x.PoolId == poolConfig.Id)
+            .Subscribe(_ => minerEffortTracker.Reset()));
 
-                logger.Debug(() => "Vardiff Idle Update pass ends");
+        if(clusterConfig.ShareRelay != null)
+            return;
+
+        // pick up the effort accumulated since the last block before we went down
+        try
+        {
+            var lastBlockTime = await cf.Run(ConnectionIntent.ReadStale, con => blocksRepo.GetLastPoolBlockTimeAsync(con, poolConfig.Id, ct));
+
+            if(lastBlockTime.HasValue)
+            {
+                var efforts = await cf.Run(ConnectionIntent.ReadStale, con => shareRepo.GetMinerEffortsBetweenCreatedAsync(con, poolConfig.Id, lastBlockTime.Value, clock.Now, ct));
+
+                foreach(var effort in efforts)
+                    minerEffortTracker.Add(effort.Key, effort.Value);
             }
+        }
+
+        catch(Exception ex)
+        {
+            logger.Warn(ex, () => "Unable to load miner effort");
+        }
+    }
+
+    private async Task RunMinerEffortCheckerAsync(int interval, CancellationToken ct)
+    {
+        await Guard(async () =>
+        {
+            using var timer = new PeriodicTimer(TimeSpan.FromSeconds(interval));
+
+            while(await timer.WaitForNextTickAsync(ct))
+                CheckMinerEffort();
         }, ex =>
         {
             if(ex is not OperationCanceledException)
@@ -190,14 +384,38 @@ public abstract class PoolBase : StratumServer,
         });
     }
 
-    protected virtual Task OnVarDiffUpdateAsync(StratumConnection connection, double newDiff, CancellationToken _)
+    protected void CheckMinerEffort()
     {
-        connection.Context.EnqueueNewDifficulty(newDiff);
+        foreach(var connection in connections.Values)
+        {
+            try
+            {
+                if(connection.IsAlive && connection.Context.IsAuthorized)
+                    SuspiciousMinerEffortCheck(connection);
+            }
 
-        return Task.CompletedTask;
+            catch(Exception ex)
+            {
+                logger.Error(() => $"[{connection.ConnectionId}] Error checking miner effort: {ex.Message}");
+            }
+        }
     }
 
-    #endregion // VarDiff
+    private void SuspiciousMinerEffortCheck(StratumConnection connection)
+    {
+        var minerEffort = minerEffortTracker.GetEffort(connection.Context.Miner);
+
+        if(minerEffort > 0 && minerEffort >= poolConfig.Banning.MinerEffortPercent.Value)
+        {
+            logger.Info(() => $"[{connection.ConnectionId}] Detected suspicious over-sharing-worker: Current effort {minerEffort} over {poolConfig.Banning.MinerEffortPercent.Value}%. Banning worker for {poolConfig.Banning.MinerEffortTime.Value} seconds");
+
+            banManager.Ban(connection.RemoteEndpoint.Address, TimeSpan.FromSeconds(poolConfig.Banning.MinerEffortTime.Value));
+
+            Disconnect(connection);
+        }
+    }
+
+    #endregion // Miner Effort
 
     protected Task ForEachMinerAsync(Func<StratumConnection, CancellationToken, Task> func)
     {
@@ -214,9 +432,6 @@ public abstract class PoolBase : StratumServer,
             {
                 if(!_ct.IsCancellationRequested && connection.IsAlive && connection.Context.IsAuthorized)
                 {
-                    await SuspiciousMinerEffortCheck(connection, ct);
-                    ZombieCheck(connection);
-
                     await func(connection, _ct);
                 }
             }
@@ -230,38 +445,6 @@ public abstract class PoolBase : StratumServer,
         });
     }
 
-    protected async Task SuspiciousMinerEffortCheck(StratumConnection connection, CancellationToken ct)
-    {
-        if(poolConfig.Banning?.Enabled == true && poolConfig.Banning?.MinerEffortPercent.HasValue == true && poolConfig.Banning?.MinerEffortTime.HasValue == true)
-        {
-            var lastBlockTime = await cf.Run(con => blocksRepo.GetLastPoolBlockTimeAsync(con, poolConfig.Id, ct));
-            DateTime dateStart = (lastBlockTime.HasValue) ? lastBlockTime.Value : connection.Context.Created;
-            var minerEffort = await cf.Run(con => shareRepo.GetMinerEffortBetweenCreatedAsync(con, poolConfig.Id, connection.Context.Miner, dateStart, clock.Now, ct));
-            if(minerEffort.HasValue)
-            {
-                logger.Debug(() => $"[{connection.Context.Miner}] Checking effort for worker: {minerEffort.Value}%");
-
-                if(minerEffort.Value >= poolConfig.Banning.MinerEffortPercent.Value)
-                {
-                    banManager.Ban(connection.RemoteEndpoint.Address, TimeSpan.FromSeconds(poolConfig.Banning.MinerEffortTime.Value));
-
-                    throw new Exception($"Detected suspicious over-sharing-worker: Current effort over {poolConfig.Banning.MinerEffortPercent.Value}%. Banning worker for {poolConfig.Banning.MinerEffortTime.Value} seconds");
-                }
-            }
-        }
-    }
-
-    protected void ZombieCheck(StratumConnection connection)
-    {
-        if(poolConfig.ClientConnectionTimeout > 0)
-        {
-            var lastActivityAgo = clock.Now - connection.Context.LastActivity;
-
-            if(lastActivityAgo.TotalSeconds > poolConfig.ClientConnectionTimeout)
-                throw new Exception($"Detected zombie-worker (idle-timeout exceeded)");
-        }
-    }
-
     protected void SetupBanManagement()
     {
         if(poolConfig.Banning?.Enabled == true)
@@ -283,7 +466,7 @@ public abstract class PoolBase : StratumServer,
         {
             logger.Debug(() => "Loading pool stats");
 
-            var stats = await cf.Run(con => statsRepo.GetLastPoolStatsAsync(con, poolConfig.Id, ct));
+            var stats = await cf.Run(ConnectionIntent.ReadStale, con => statsRepo.GetLastPoolStatsAsync(con, poolConfig.Id, ct));
 
             if(stats != null)
             {
@@ -337,17 +520,29 @@ public abstract class PoolBase : StratumServer,
 
         var varDiffEnabled = ipEndpoints.Any(x => x.PoolEndpoint.VarDiff != null);
 
+        if(IsMinerEffortBanningEnabled)
+            await SetupMinerEffortTrackingAsync(ct);
+
         var tasks = new List<Task>
         {
             base.RunAsync(ct, ipEndpoints)
         };
 
-        if(varDiffEnabled)
-            tasks.Add(RunVardiffIdleUpdaterAsync(poolConfig.VardiffIdleSweepInterval ?? 30, ct));
+        if(minerEffortTracker != null)
+            tasks.Add(RunMinerEffortCheckerAsync(poolConfig.Banning.MinerEffortCheckInterval ?? 10, ct));
+
+        if(varDiffEnabled && poolConfig.ShareValidationCpuBudget.HasValue)
+            SetupValidationCostFloor(poolConfig.ShareValidationCpuBudget.Value);
 
         await Task.WhenAll(tasks);
     }
 
+    private void SetupValidationCostFloor(double cpuBudget)
+    {
+        // fed by ValidateShareAsync
+        validationCostFloor = new ValidationCostFloor(cpuBudget, clock, logger);
+    }
+
     protected virtual async Task<double?> GetNicehashStaticMinDiff(WorkerContextBase context, string coinName, string algoName)
     {
         if(context.IsNicehash && clusterConfig.Nicehash?.EnableAutoDiff == true)
@@ -0,0 +1,82 @@
+using System.Diagnostics;
+using Microsoft.Extensions.Hosting;
+using Miningcore.Configuration;
+using Miningcore.Contracts;
+using Miningcore.Persistence;
+using Miningcore.Persistence.Repositories;
+using NLog;
+
+namespace Miningcore.Mining;
+
+/// <summary>
+/// Moves shares recorded into the staging table over to the indexed shares table in large sorted batches
+/// </summary>
+public class ShareMerger : BackgroundService
+{
+    public ShareMerger(IConnectionFactory cf,
+        IShareRepository shareRepo,
+        ClusterConfig clusterConfig)
+    {
+        Contract.RequiresNonNull(cf);
+        Contract.RequiresNonNull(shareRepo);
+        Contract.RequiresNonNull(clusterConfig);
+
+        this.cf = cf;
+        this.shareRepo = shareRepo;
+
+        var config = clusterConfig.Persistence?.Postgres?.ShareStaging;
+
+        mergeInterval = TimeSpan.FromSeconds(config?.MergeInterval ?? 5);
+        batchSize = config?.MergeBatchSize ?? 100000;
+    }
+
+    private static readonly ILogger logger = LogManager.GetCurrentClassLogger();
+    private readonly IConnectionFactory cf;
+    private readonly IShareRepository shareRepo;
+    private readonly TimeSpan mergeInterval;
+    private readonly int batchSize;
+
+    private async Task MergeAsync(CancellationToken ct)
+    {
+        var sw = Stopwatch.StartNew();
+        var total = 0;
+        int moved;
+
+        // keep going while the backlog fills whole batches
+        do
+        {
+            moved = await cf.Run(con => shareRepo.MergeStagedSharesAsync(con, batchSize, ct));
+            total += moved;
+        } while(moved == batchSize && !ct.IsCancellationRequested);
+
+        if(total > 0)
+            logger.Debug(() => $"Merged {total} staged shares in {sw.Elapsed.TotalMilliseconds:0} ms");
+    }
+
+    protected override async Task ExecuteAsync(CancellationToken ct)
+    {
+        logger.Info(() => "Online");
+
+        using var timer = new PeriodicTimer(mergeInterval);
+
+        do
+        {
+            try
+            {
+                await MergeAsync(ct);
+            }
+
+            catch(OperationCanceledException)
+            {
+                // ignored
+            }
+
+            catch(Exception ex)
+            {
+                logger.Error(ex);
+            }
+        } while(await timer.WaitForNextTickAsync(ct));
+
+        logger.Info(() => "Offline");
+    }
+}
@@ -110,7 +110,7 @@ public class StatsRecorder : BackgroundService
 
             // fetch stats for window
             var result = await readFaultPolicy.ExecuteAsync(() =>
-                cf.Run(con => shareRepo.GetHashAccumulationBetweenAsync(con, poolId, timeFrom, now, ct)));
+                cf.Run(ConnectionIntent.Read, con => shareRepo.GetHashAccumulationBetweenAsync(con, poolId, timeFrom, now, ct)));
 
             var byMiner = result.GroupBy(x => x.Miner).ToArray();
 
@@ -168,7 +168,7 @@ public class StatsRecorder : BackgroundService
             });
 
             // retrieve most recent miner/worker non-zero hashrate sample
-            var previousMinerWorkerHashrates = await cf.Run(con =>
+            var previousMinerWorkerHashrates = await cf.Run(ConnectionIntent.Read, con =>
                 statsRepo.GetPoolMinerWorkerHashratesAsync(con, poolId, ct));
 
             const char keySeparator = '.';
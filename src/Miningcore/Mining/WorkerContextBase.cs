@@ -1,14 +1,132 @@
+using CircularBuffer;
 using Miningcore.Configuration;
+using Miningcore.Extensions;
 using Miningcore.Nicehash.API;
+using Miningcore.Stratum;
 using Miningcore.Time;
 using Miningcore.VarDiff;
 
 namespace Miningcore.Mining;
 
+/// <summary>
+/// Point-in-time copy of share counters, summed over connections when sampled for a pool
+/// </summary>
+public readonly record struct ShareCounters(long Accepted, long Rejected, long Stale, double AcceptedDifficulty, DateTime? LastShare)
+{
+    public static ShareCounters operator +(ShareCounters a, ShareCounters b)
+    {
+        return new ShareCounters(
+            a.Accepted + b.Accepted,
+            a.Rejected + b.Rejected,
+            a.Stale + b.Stale,
+            a.AcceptedDifficulty + b.AcceptedDifficulty,
+            a.LastShare > b.LastShare || !b.LastShare.HasValue ? a.LastShare : b.LastShare);
+    }
+}
+
+/// <summary>
+/// Per-connection share counters. Updated with interlocked operations on the share path
+/// and sampled by the metrics publisher instead of publishing an event per share.
+/// </summary>
 public class ShareStats
 {
-    public int ValidShares { get; set; }
-    public int InvalidShares { get; set; }
+    private int validShares;
+    private int invalidShares;
+    private long accepted;
+    private long rejected;
+    private long stale;
+    private double acceptedDifficulty;
+    private long lastShareTicks;
+
+    /// <summary>
+    /// Valid shares since the last ban check
+    /// </summary>
+    public int ValidShares
+    {
+        get => Volatile.Read(ref validShares);
+        set => Volatile.Write(ref validShares, value);
+    }
+
+    /// <summary>
+    /// Invalid shares since the last ban check
+    /// </summary>
+    public int InvalidShares
+    {
+        get => Volatile.Read(ref invalidShares);
+        set => Volatile.Write(ref invalidShares, value);
+    }
+
+    public void RecordAccepted(double difficulty, DateTime now)
+    {
+        Interlocked.Increment(ref validShares);
+        Interlocked.Increment(ref accepted);
+        Add(ref acceptedDifficulty, difficulty);
+        Interlocked.Exchange(ref lastShareTicks, now.Ticks);
+    }
+
+    public void RecordRejected(bool isStale)
+    {
+        Interlocked.Increment(ref invalidShares);
+        Interlocked.Increment(ref rejected);
+
+        if(isStale)
+            Interlocked.Increment(ref stale);
+    }
+
+    /// <summary>
+    /// Folds the counters of a closed connection into this instance
+    /// </summary>
+    public void Add(ShareCounters counters)
+    {
+        Interlocked.Add(ref accepted, counters.Accepted);
+        Interlocked.Add(ref rejected, counters.Rejected);
+        Interlocked.Add(ref stale, counters.Stale);
+        Add(ref acceptedDifficulty, counters.AcceptedDifficulty);
+
+        if(counters.LastShare.HasValue)
+        {
+            var ticks = counters.LastShare.Value.Ticks;
+            var current = Interlocked.Read(ref lastShareTicks);
+
+            while(ticks > current)
+            {
+                var previous = Interlocked.CompareExchange(ref lastShareTicks, ticks, current);
+
+                if(previous == current)
+                    break;
+
+                current = previous;
+            }
+        }
+    }
+
+    public ShareCounters Sample()
+    {
+        var ticks = Interlocked.Read(ref lastShareTicks);
+
+        return new ShareCounters(
+            Interlocked.Read(ref accepted),
+            Interlocked.Read(ref rejected),
+            Interlocked.Read(ref stale),
+            Volatile.Read(ref acceptedDifficulty),
+            ticks != 0 ? new DateTime(ticks, DateTimeKind.Utc) : null);
+    }
+
+    private static void Add(ref double location, double value)
+    {
+        var current = Volatile.Read(ref location);
+
+        while(true)
+        {
+            var previous = Interlocked.CompareExchange(ref location, current + value, current);
+
+            // compare bits as NaN never equals itself
+            if(BitConverter.DoubleToInt64Bits(previous) == BitConverter.DoubleToInt64Bits(current))
+                break;
+
+            current = previous;
+        }
+    }
 }
 
 public class WorkerContextBase
@@ -102,4 +220,103 @@ public class WorkerContextBase
         Difficulty = difficulty;
     }
 
+    /// <summary>
+    /// Captures the state required to resume this worker in another process
+    /// </summary>
+    public virtual void ExportState(StratumSessionState state)
+    {
+        state.Created = Created;
+        state.LastActivity = LastActivity;
+        state.IsAuthorized = IsAuthorized;
+        state.IsSubscribed = IsSubscribed;
+        state.Difficulty = Difficulty;
+        state.PreviousDifficulty = PreviousDifficulty;
+        state.PendingDifficulty = pendingDifficulty;
+        state.Miner = Miner;
+        state.Worker = Worker;
+        state.UserAgent = UserAgent;
+        state.ValidShares = Stats?.ValidShares ?? 0;
+        state.InvalidShares = Stats?.InvalidShares ?? 0;
+
+        if(VarDiff != null)
+        {
+            lock(VarDiff)
+            {
+                state.VarDiff = new VarDiffState
+                {
+                    LastTs = VarDiff.LastTs,
+                    LastRetarget = VarDiff.LastRetarget,
+                    TimeBufferCapacity = VarDiff.TimeBuffer?.Capacity ?? 0,
+                    TimeBuffer = VarDiff.TimeBuffer?.ToArray(),
+                    Created = VarDiff.Created,
+                    LastUpdate = VarDiff.LastUpdate,
+                };
+            }
+        }
+    }
+
+    /// <summary>
+    /// Restores a worker previously exported by <see cref="ExportState"/>
+    /// </summary>
+    public virtual void ImportState(StratumSessionState state, VarDiffConfig varDiffConfig)
+    {
+        Created = state.Created;
+        LastActivity = state.LastActivity;
+        IsAuthorized = state.IsAuthorized;
+        IsSubscribed = state.IsSubscribed;
+        Difficulty = state.Difficulty;
+        PreviousDifficulty = state.PreviousDifficulty;
+        pendingDifficulty = state.PendingDifficulty;
+        Miner = state.Miner;
+        Worker = state.Worker;
+        UserAgent = state.UserAgent;
+
+        Stats = new ShareStats
+        {
+            ValidShares = state.ValidShares,
+            InvalidShares = state.InvalidShares
+        };
+
+        // VarDiff stays off if it was disabled for this session (static diff, Nicehash, suggested diff)
+        if(state.VarDiff != null && varDiffConfig != null)
+        {
+            VarDiff = new VarDiffContext
+            {
+                LastTs = state.VarDiff.LastTs,
+                LastRetarget = state.VarDiff.LastRetarget,
+                Created = state.VarDiff.Created,
+                LastUpdate = state.VarDiff.LastUpdate,
+                Config = varDiffConfig
+            };
+
+            if(state.VarDiff.TimeBuffer != null && state.VarDiff.TimeBufferCapacity > 0)
+                VarDiff.TimeBuffer = new CircularBuffer<double>(state.VarDiff.TimeBufferCapacity, state.VarDiff.TimeBuffer);
+        }
+
+        else
+            VarDiff = null;
+    }
+
+    /// <summary>
+    /// Carries difficulty and VarDiff history of a disconnected session over to a new connection.
+    /// Identity and share stats have to be re-established through authorization.
+    /// </summary>
+    public virtual void ResumeState(StratumSessionState state, VarDiffConfig varDiffConfig, IMasterClock clock)
+    {
+        var created = Created;
+
+        ImportState(state, varDiffConfig);
+
+        Created = created;
+        LastActivity = clock.Now;
+        IsAuthorized = false;
+        IsSubscribed = false;
+        Miner = null;
+        Worker = null;
+        Stats = new ShareStats();
+
+        // the time spent disconnected is no share interval
+        if(VarDiff?.LastTs != null)
+            VarDiff.LastTs = clock.Now.ToUnixSeconds();
+    }
 }
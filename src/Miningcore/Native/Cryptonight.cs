@@ -131,14 +131,18 @@ public static unsafe class Cryptonight
 
     internal static BlockingCollection<Context> contexts = null;
 
+    // max_mem_size of libcryptonight
+    private const long ContextSize = 20 * 1024 * 1024;
+
     public class Context : IDisposable
     {
         public Context()
         {
-            handle = new Lazy<IntPtr>(alloc_context);
+            handle = new Lazy<IntPtr>(Allocate);
         }
 
         private Lazy<IntPtr> handle;
+        private NativeMemoryLease memoryLease;
 
         public bool IsValid => handle.IsValueCreated && handle.Value != IntPtr.Zero;
         public IntPtr Handle => handle.Value;
@@ -150,6 +154,16 @@ public static unsafe class Cryptonight
                 free_context(handle.Value);
                 handle = null;
             }
+
+            memoryLease?.Dispose();
+        }
+
+        private IntPtr Allocate()
+        {
+            memoryLease = NativeMemoryBudget.Default.Register("Cryptonight", "context", ContextSize,
+                NativeMemoryPriority.Active, TimeSpan.Zero);
+
+            return alloc_context();
         }
     }
 
@@ -0,0 +1,114 @@
+using System.Runtime.InteropServices;
+using Miningcore.Contracts;
+
+// ReSharper disable InconsistentNaming
+
+namespace Miningcore.Native;
+
+public enum CuckooVariant
+{
+    Cortex = 0,
+    C29s = 1,
+    C29v = 2,
+    C29b = 3,
+    C29i = 4,
+}
+
+public enum CuckooKernel
+{
+    Auto = 0,
+    Scalar = 1,
+    Avx2 = 2,
+    Avx512 = 3,
+}
+
+public enum CuckooVerifyResult
+{
+    Ok = 0,
+    HeaderLength = 1,
+    TooBig = 2,
+    TooSmall = 3,
+    NonMatching = 4,
+    Branch = 5,
+    DeadEnd = 6,
+    ShortCycle = 7,
+    Unbalanced = 8,
+}
+
+/// <summary>
+/// Cuckaroo and cuckarood solution verification for Cortex and the C29 variants
+/// </summary>
+public static unsafe class CuckooCycle
+{
+    [DllImport("libcortexcuckoocycle", EntryPoint = "cuckoo_verify_export", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int cuckoo_verify(uint variant, byte* header, uint headerLength, uint* solution, uint kernel);
+
+    [DllImport("libcortexcuckoocycle", EntryPoint = "cuckoo_verify_batch_export", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void cuckoo_verify_batch(uint variant, byte* headers, uint headerLength, uint* solutions, int* results, uint count, uint kernel);
+
+    [DllImport("libcortexcuckoocycle", EntryPoint = "cuckoo_kernel_export", CallingConvention = CallingConvention.Cdecl)]
+    public static extern uint cuckoo_kernel();
+
+    private static readonly Lazy<CuckooKernel> kernel = new(() => (CuckooKernel) cuckoo_kernel());
+
+    /// <summary>
+    /// Best kernel available on this CPU
+    /// </summary>
+    public static CuckooKernel Kernel => kernel.Value;
+
+    /// <summary>
+    /// Number of edges in a solution of the given variant
+    /// </summary>
+    public static int ProofSize(CuckooVariant variant)
+    {
+        return variant switch
+        {
+            CuckooVariant.Cortex => 42,
+            CuckooVariant.C29s => 32,
+            CuckooVariant.C29v => 32,
+            CuckooVariant.C29b => 40,
+            CuckooVariant.C29i => 48,
+            _ => throw new ArgumentOutOfRangeException(nameof(variant))
+        };
+    }
+
+    public static CuckooVerifyResult Verify(CuckooVariant variant, ReadOnlySpan<byte> header, ReadOnlySpan<uint> solution,
+        CuckooKernel kernel = CuckooKernel.Auto)
+    {
+        Contract.Requires<ArgumentException>(solution.Length == ProofSize(variant));
+
+        fixed (byte* h = header)
+        {
+            fixed (uint* s = solution)
+            {
+                return (CuckooVerifyResult) cuckoo_verify((uint) variant, h, (uint) header.Length, s, (uint) kernel);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Verifies count solutions against their headers, both stored back to back. Edges of all solutions
+    /// share the vector lanes, so a batch is considerably faster than verifying one by one.
+    /// Kernels not supported by the CPU are downgraded.
+    /// </summary>
+    public static void VerifyBatch(CuckooVariant variant, ReadOnlySpan<byte> headers, int headerLength,
+        ReadOnlySpan<uint> solutions, Span<CuckooVerifyResult> results, int count, CuckooKernel kernel = CuckooKernel.Auto)
+    {
+        Contract.Requires<ArgumentException>(headerLength >= 0);
+        Contract.Requires<ArgumentException>(count >= 0);
+        Contract.Requires<ArgumentException>(headers.Length >= headerLength * count);
+        Contract.Requires<ArgumentException>(solutions.Length >= ProofSize(variant) * count);
+        Contract.Requires<ArgumentException>(results.Length >= count);
+
+        fixed (byte* h = headers)
+        {
+            fixed (uint* s = solutions)
+            {
+                fixed (CuckooVerifyResult* r = results)
+                {
+                    cuckoo_verify_batch((uint) variant, h, (uint) headerLength, s, (int*) r, (uint) count, (uint) kernel);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,81 @@
+using System.Runtime.InteropServices;
+
+// ReSharper disable InconsistentNaming
+
+namespace Miningcore.Native;
+
+/// <summary>
+/// Minimal libc surface needed for passing file descriptors between processes of the same user (Linux, 64-bit)
+/// </summary>
+public static unsafe class LibC
+{
+    public const int SOL_SOCKET = 1;
+    public const int SCM_RIGHTS = 1;
+    public const int SO_PEERCRED = 17;
+
+    public const int MSG_TRUNC = 0x20;
+    public const int MSG_CTRUNC = 0x08;
+    public const int MSG_NOSIGNAL = 0x4000;
+    public const int MSG_CMSG_CLOEXEC = 0x40000000;
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct iovec
+    {
+        public void* iov_base;
+        public nuint iov_len;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct msghdr
+    {
+        public void* msg_name;
+        public uint msg_namelen;
+        public iovec* msg_iov;
+        public nuint msg_iovlen;
+        public void* msg_control;
+        public nuint msg_controllen;
+        public int msg_flags;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct cmsghdr
+    {
+        public nuint cmsg_len;
+        public int cmsg_level;
+        public int cmsg_type;
+    }
+
+    public static int CMSG_ALIGN(int len) => (len + sizeof(nuint) - 1) & ~(sizeof(nuint) - 1);
+    public static int CMSG_SPACE(int len) => CMSG_ALIGN(sizeof(cmsghdr)) + CMSG_ALIGN(len);
+    public static int CMSG_LEN(int len) => CMSG_ALIGN(sizeof(cmsghdr)) + len;
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ucred
+    {
+        public int pid;
+        public uint uid;
+        public uint gid;
+    }
+
+    public static byte* CMSG_DATA(cmsghdr* cmsg) => (byte*) cmsg + CMSG_ALIGN(sizeof(cmsghdr));
+
+    [DllImport("libc", SetLastError = true)]
+    public static extern nint sendmsg(int sockfd, msghdr* msg, int flags);
+
+    [DllImport("libc", SetLastError = true)]
+    public static extern nint recvmsg(int sockfd, msghdr* msg, int flags);
+
+    [DllImport("libc", SetLastError = true)]
+    public static extern int dup(int fd);
+
+    [DllImport("libc", SetLastError = true)]
+    public static extern int close(int fd);
+
+    [DllImport("libc", SetLastError = true)]
+    public static extern int getsockopt(int sockfd, int level, int optname, void* optval, uint* optlen);
+
+    [DllImport("libc", SetLastError = true)]
+    public static extern int chmod([MarshalAs(UnmanagedType.LPUTF8Str)] string path, uint mode);
+
+    [DllImport("libc")]
+    public static extern uint geteuid();
+}
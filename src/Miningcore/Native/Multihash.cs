@@ -7,6 +7,15 @@ public static unsafe class Multihash
     [DllImport("libmultihash", EntryPoint = "scrypt_export", CallingConvention = CallingConvention.Cdecl)]
     public static extern void scrypt(byte* input, void* output, uint n, uint r, uint inputLength);
 
+    [DllImport("libmultihash", EntryPoint = "scrypt_batch_export", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void scrypt_batch(byte* inputs, void* outputs, uint count, uint n, uint r, uint inputLength, uint* midstate, uint lanes);
+
+    [DllImport("libmultihash", EntryPoint = "scrypt_midstate_export", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void scrypt_midstate(byte* input, uint* midstate);
+
+    [DllImport("libmultihash", EntryPoint = "scrypt_lanes_export", CallingConvention = CallingConvention.Cdecl)]
+    public static extern uint scrypt_lanes();
+
     [DllImport("libmultihash", EntryPoint = "quark_export", CallingConvention = CallingConvention.Cdecl)]
     public static extern void quark(byte* input, void* output, uint inputLength);
 
@@ -61,12 +70,21 @@ public static unsafe class Multihash
     [DllImport("libmultihash", EntryPoint = "verthash_export", CallingConvention = CallingConvention.Cdecl)]
     public static extern int verthash(byte* input, void* output, int inputLength);
 
+    [DllImport("libmultihash", EntryPoint = "verthash_batch_export", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int verthash_batch(byte* inputs, void* outputs, uint inputLength, uint count);
+
     [DllImport("libmultihash", EntryPoint = "verthash_init_export", CallingConvention = CallingConvention.Cdecl)]
     public static extern int verthash_init(string filename, bool createIfMissing);
 
     [DllImport("libmultihash", EntryPoint = "neoscrypt_export", CallingConvention = CallingConvention.Cdecl)]
     public static extern void neoscrypt(byte* input, void* output, uint inputLength, uint profile);
 
+    [DllImport("libmultihash", EntryPoint = "neoscrypt_batch_export", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void neoscrypt_batch(byte* inputs, void* outputs, uint count, uint profile, uint kernel);
+
+    [DllImport("libmultihash", EntryPoint = "neoscrypt_kernel_export", CallingConvention = CallingConvention.Cdecl)]
+    public static extern uint neoscrypt_kernel();
+
     [DllImport("libmultihash", EntryPoint = "scryptn_export", CallingConvention = CallingConvention.Cdecl)]
     public static extern void scryptn(byte* input, void* output, uint nFactor, uint inputLength);
 
@@ -154,18 +172,25 @@ public static unsafe class Multihash
     [DllImport("libmultihash", EntryPoint = "lyra2rev3_export", CallingConvention = CallingConvention.Cdecl)]
     public static extern void lyra2rev3(byte* input, void* output);
 
-    [DllImport("libmultihash", EntryPoint = "equihash_verify_200_9_export", CallingConvention = CallingConvention.Cdecl)]
-    public static extern bool equihash_verify_200_9(byte* header, int headerLength, byte* solution, int solutionLength, string personalization);
+    [DllImport("libmultihash", EntryPoint = "equihash_verifier_create_export", CallingConvention = CallingConvention.Cdecl)]
+    public static extern IntPtr equihash_verifier_create(uint n, uint k, string personalization);
 
-    [DllImport("libmultihash", EntryPoint = "equihash_verify_144_5_export", CallingConvention = CallingConvention.Cdecl)]
-    public static extern bool equihash_verify_144_5(byte* header, int headerLength, byte* solution, int solutionLength, string personalization);
+    [DllImport("libmultihash", EntryPoint = "equihash_verifier_destroy_export", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void equihash_verifier_destroy(IntPtr verifier);
 
-    [DllImport("libmultihash", EntryPoint = "equihash_verify_96_5_export", CallingConvention = CallingConvention.Cdecl)]
-    public static extern bool equihash_verify_96_5(byte* header, int headerLength, byte* solution, int solutionLength, string personalization);
+    [DllImport("libmultihash", EntryPoint = "equihash_verifier_verify_export", CallingConvention = CallingConvention.Cdecl)]
+    [return: MarshalAs(UnmanagedType.U1)]
+    public static extern bool equihash_verifier_verify(SafeHandle verifier, byte* header, int headerLength, byte* solution, int solutionLength);
 
     [DllImport("libmultihash", EntryPoint = "sha512_256_export", CallingConvention = CallingConvention.Cdecl)]
     public static extern void sha512_256(byte* input, void* output, uint inputLength);
 
+    [DllImport("libmultihash", EntryPoint = "sha512_256d_batch_export", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void sha512_256d_batch(byte* inputs, void* outputs, uint count, uint inputLength, uint kernel);
+
+    [DllImport("libmultihash", EntryPoint = "sha512_256_kernel_export", CallingConvention = CallingConvention.Cdecl)]
+    public static extern uint sha512_256_kernel();
+
     [DllImport("libmultihash", EntryPoint = "sha256dt_export", CallingConvention = CallingConvention.Cdecl)]
     public static extern void sha256dt(byte* input, void* output);
     
@@ -187,6 +212,12 @@ public static unsafe class Multihash
     [DllImport("libmultihash", EntryPoint = "yescryptR32_export", CallingConvention = CallingConvention.Cdecl)]
     public static extern void yescryptR32(byte* input, void* output, uint inputLength);
 
+    [DllImport("libmultihash", EntryPoint = "yescrypt_kernel_export", CallingConvention = CallingConvention.Cdecl)]
+    public static extern uint yescrypt_kernel();
+
+    [DllImport("libmultihash", EntryPoint = "yescrypt_set_kernel_export", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void yescrypt_set_kernel(uint kernel);
+
     [DllImport("libmultihash", EntryPoint = "allium_export", CallingConvention = CallingConvention.Cdecl)]
     public static extern void allium(byte* input, void* output, uint inputLength);
 
@@ -208,6 +239,12 @@ public static unsafe class Multihash
     [DllImport("libmultihash", EntryPoint = "yespowerTIDE_export", CallingConvention = CallingConvention.Cdecl)]
     public static extern void yespowerTIDE(byte* input, void* output, uint inputLength);
 
+    [DllImport("libmultihash", EntryPoint = "yespower_kernel_export", CallingConvention = CallingConvention.Cdecl)]
+    public static extern uint yespower_kernel();
+
+    [DllImport("libmultihash", EntryPoint = "yespower_set_kernel_export", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void yespower_set_kernel(uint kernel);
+
     [DllImport("libmultihash", EntryPoint = "flex_export", CallingConvention = CallingConvention.Cdecl)]
     public static extern void flex(byte* input, void* output);
 
@@ -0,0 +1,295 @@
+using Miningcore.Contracts;
+using Miningcore.Time;
+using NLog;
+
+namespace Miningcore.Native;
+
+public enum NativeMemoryPriority
+{
+    /// <summary>
+    /// Speculative pre-build (next epoch or seed), may be evicted
+    /// </summary>
+    Prefetch = 0,
+
+    /// <summary>
+    /// Retained for reuse (previous epochs), may be evicted
+    /// </summary>
+    Cache = 1,
+
+    /// <summary>
+    /// Backs current work, never evicted
+    /// </summary>
+    Active = 2,
+}
+
+/// <summary>
+/// Process-wide budget for large native allocations such as DAGs, light caches and RandomX datasets
+/// </summary>
+/// <remarks>
+/// Owners register their allocations along with a priority and the time it takes to rebuild them.
+/// When a registration doesn't fit, evictable entries are released in cost-weighted LRU order:
+/// lowest priority first, then the entry that has been idle longest relative to its rebuild cost.
+/// Eviction callbacks run on the registering thread after the budget's lock has been released,
+/// owners must therefore not register while holding a lock their own eviction callback takes.
+/// </remarks>
+public class NativeMemoryBudget
+{
+    public NativeMemoryBudget(long budget = 0, IMasterClock clock = null)
+    {
+        Contract.Requires<ArgumentException>(budget >= 0);
+
+        Budget = budget;
+        this.clock = clock ?? new StandardClock();
+    }
+
+    private static readonly ILogger logger = LogManager.GetCurrentClassLogger();
+
+    private readonly IMasterClock clock;
+    private readonly List<NativeMemoryLease> leases = new();
+    private long used;
+
+    /// <summary>
+    /// Budget shared by all native owners of this process
+    /// </summary>
+    public static NativeMemoryBudget Default { get; set; } = new();
+
+    /// <summary>
+    /// Budget in bytes, zero means unlimited
+    /// </summary>
+    public long Budget { get; set; }
+
+    /// <summary>
+    /// Bytes currently registered
+    /// </summary>
+    public long Used
+    {
+        get
+        {
+            lock(leases)
+            {
+                return used;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Registers an allocation that is about to be made, evicting colder entries to make room.
+    /// Allocations required for current work are always admitted, even beyond the budget.
+    /// </summary>
+    /// <param name="evict">Releases the allocation when it is evicted (optional)</param>
+    public NativeMemoryLease Register(string owner, string key, long size, NativeMemoryPriority priority,
+        TimeSpan rebuildCost, Action evict = null)
+    {
+        Contract.Requires<ArgumentException>(priority != NativeMemoryPriority.Prefetch, "use TryAdmit for pre-builds");
+
+        var lease = new NativeMemoryLease(this, owner, key, size, priority, rebuildCost, evict, clock.Now);
+        List<NativeMemoryLease> victims;
+
+        lock(leases)
+        {
+            victims = SelectVictims(size, NativeMemoryPriority.Cache, false);
+            Add(lease, victims);
+
+            if(Budget > 0 && used > Budget)
+                logger.Warn(() => $"Native memory budget of {FormatSize(Budget)} exceeded by {FormatSize(used - Budget)} registering {owner} {key}");
+        }
+
+        Evict(victims, lease);
+        return lease;
+    }
+
+    /// <summary>
+    /// Admission control for pre-builds. A pre-build may displace retained caches, but never
+    /// other pre-builds or allocations backing current work.
+    /// </summary>
+    /// <returns>The lease, or null if the pre-build must not start</returns>
+    public NativeMemoryLease TryAdmit(string owner, string key, long size, TimeSpan rebuildCost, Action evict = null)
+    {
+        var lease = new NativeMemoryLease(this, owner, key, size, NativeMemoryPriority.Prefetch, rebuildCost, evict, clock.Now);
+        List<NativeMemoryLease> victims;
+
+        lock(leases)
+        {
+            victims = SelectVictims(size, NativeMemoryPriority.Cache, true);
+
+            if(victims == null)
+            {
+                logger.Info(() => $"Not pre-building {owner} {key}: {FormatSize(size)} exceeds what is left of the native memory budget");
+                return null;
+            }
+
+            Add(lease, victims);
+        }
+
+        Evict(victims, lease);
+        return lease;
+    }
+
+    /// <summary>
+    /// Registered bytes per owner
+    /// </summary>
+    public IReadOnlyDictionary<string, long> GetUsage()
+    {
+        lock(leases)
+        {
+            return leases
+                .GroupBy(x => x.Owner)
+                .ToDictionary(x => x.Key, x => x.Sum(y => y.Size));
+        }
+    }
+
+    internal DateTime Now => clock.Now;
+
+    internal void Release(NativeMemoryLease lease)
+    {
+        lock(leases)
+        {
+            if(leases.Remove(lease))
+                used -= lease.Size;
+        }
+    }
+
+    /// <summary>
+    /// Picks entries at or below maxPriority in eviction order until size fits.
+    /// In strict mode returns null when evicting everything eligible wouldn't be enough.
+    /// </summary>
+    private List<NativeMemoryLease> SelectVictims(long size, NativeMemoryPriority maxPriority, bool strict)
+    {
+        var result = new List<NativeMemoryLease>();
+
+        if(Budget == 0)
+            return result;
+
+        var free = Budget - used;
+
+        if(size <= free)
+            return result;
+
+        var now = clock.Now;
+
+        var candidates = leases
+            .Where(x => x.Priority <= maxPriority && (!strict || x.Priority == NativeMemoryPriority.Cache))
+            .OrderBy(x => x.Priority)
+            .ThenByDescending(x => x.GetEvictionScore(now));
+
+        foreach(var candidate in candidates)
+        {
+            result.Add(candidate);
+            free += candidate.Size;
+
+            if(size <= free)
+                return result;
+        }
+
+        return strict ? null : result;
+    }
+
+    private void Add(NativeMemoryLease lease, List<NativeMemoryLease> victims)
+    {
+        foreach(var victim in victims)
+        {
+            leases.Remove(victim);
+            used -= victim.Size;
+        }
+
+        leases.Add(lease);
+        used += lease.Size;
+    }
+
+    private static void Evict(List<NativeMemoryLease> victims, NativeMemoryLease lease)
+    {
+        foreach(var victim in victims)
+        {
+            logger.Info(() => $"Evicting {victim.Owner} {victim.Key} ({FormatSize(victim.Size)}) in favour of {lease.Owner} {lease.Key}");
+
+            try
+            {
+                victim.OnEvicted();
+            }
+
+            catch(Exception ex)
+            {
+                logger.Error(ex, () => $"Error evicting {victim.Owner} {victim.Key}");
+            }
+        }
+    }
+
+    private static string FormatSize(long size)
+    {
+        return $"{size / (1024.0 * 1024):0.#} MB";
+    }
+}
+
+/// <summary>
+/// Allocation registered with a <see cref="NativeMemoryBudget"/>. Disposing releases it from the budget.
+/// </summary>
+public sealed class NativeMemoryLease : IDisposable
+{
+    internal NativeMemoryLease(NativeMemoryBudget budget, string owner, string key, long size,
+        NativeMemoryPriority priority, TimeSpan rebuildCost, Action evict, DateTime now)
+    {
+        Contract.Requires<ArgumentException>(!string.IsNullOrEmpty(owner));
+        Contract.Requires<ArgumentException>(size >= 0);
+
+        this.budget = budget;
+        this.evict = evict;
+        Owner = owner;
+        Key = key;
+        Size = size;
+        Priority = priority;
+        RebuildCost = rebuildCost;
+        lastUsed = now.Ticks;
+    }
+
+    private readonly NativeMemoryBudget budget;
+    private Action evict;
+    private long lastUsed;
+
+    public string Owner { get; }
+    public string Key { get; }
+    public long Size { get; }
+    public NativeMemoryPriority Priority { get; private set; }
+    public TimeSpan RebuildCost { get; }
+    public bool IsEvicted { get; private set; }
+
+    public DateTime LastUsed => new(Interlocked.Read(ref lastUsed), DateTimeKind.Utc);
+
+    /// <summary>
+    /// Marks the allocation as used, which makes it less likely to be evicted
+    /// </summary>
+    public void Touch()
+    {
+        Interlocked.Exchange(ref lastUsed, budget.Now.Ticks);
+    }
+
+    /// <summary>
+    /// Changes the priority, for example when a pre-built epoch becomes current or a current one is retired
+    /// </summary>
+    public void SetPriority(NativeMemoryPriority priority)
+    {
+        Priority = priority;
+        Touch();
+    }
+
+    public void Dispose()
+    {
+        evict = null;
+        budget.Release(this);
+    }
+
+    internal double GetEvictionScore(DateTime now)
+    {
+        var idle = Math.Max(0, (now - LastUsed).TotalSeconds);
+
+        // entries which are cheap to rebuild go first
+        return idle / Math.Max(RebuildCost.TotalSeconds, 0.001);
+    }
+
+    internal void OnEvicted()
+    {
+        IsEvicted = true;
+
+        var action = Interlocked.Exchange(ref evict, null);
+        action?.Invoke();
+    }
+}
@@ -66,10 +66,17 @@ public static unsafe class RandomARQ
     [DllImport("librandomarq", EntryPoint = "randomx_calculate_hash", CallingConvention = CallingConvention.Cdecl)]
     private static extern void calculate_hash(IntPtr machine, byte* input, int inputSize, byte* output);
 
+    // RANDOMX_ARGON_MEMORY KiB and RANDOMX_DATASET_ITEM_SIZE
+    private const long CacheSize = 262144L * 1024;
+    private const long DatasetItemSize = 64;
+    private static readonly TimeSpan CacheRebuildCost = TimeSpan.FromSeconds(1);
+    private static readonly TimeSpan DatasetRebuildCost = TimeSpan.FromSeconds(30);
+
     public class GenContext
     {
         public DateTime LastAccess { get; set; } = DateTime.Now;
         public int VmCount { get; init; }
+        public NativeMemoryLease MemoryLease { get; set; }
     }
 
     public class RxDataSet : IDisposable
@@ -188,7 +195,10 @@ public static unsafe class RandomARQ
                 if (vmCount == -1)
                     vmCount = Environment.ProcessorCount;
 
+                var lease = RegisterMemory(realm, seedHex, flags, vmCount);
+
                 seed = CreateSeed(realm, seedHex, flags, vmCount);
+                seed.Item1.MemoryLease = lease;
 
                 seeds[seedHex] = seed;
             }
@@ -222,6 +232,16 @@ public static unsafe class RandomARQ
         return seed;
     }
 
+    private static NativeMemoryLease RegisterMemory(string realm, string seedHex, RandomX.randomx_flags flags, int vmCount)
+    {
+        // in fast-mode each VM owns a dataset, otherwise just the cache
+        var fullMem = (flags & RandomX.randomx_flags.RANDOMX_FLAG_FULL_MEM) != 0;
+        var size = fullMem ? (long) dataset_item_count() * DatasetItemSize : CacheSize;
+
+        return NativeMemoryBudget.Default.Register($"RandomARQ {realm}", seedHex, size * vmCount,
+            NativeMemoryPriority.Active, fullMem ? DatasetRebuildCost : CacheRebuildCost);
+    }
+
     public static void DeleteSeed(string realm, string seedHex)
     {
         Tuple<GenContext, BlockingCollection<RxVm>> seed;
@@ -237,6 +257,7 @@ public static unsafe class RandomARQ
 
         // dispose all VMs
         var (ctx, col) = seed;
+        ctx.MemoryLease?.Dispose();
         var remaining = ctx.VmCount;
 
         while (remaining > 0)
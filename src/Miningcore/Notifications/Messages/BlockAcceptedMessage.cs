@@ -0,0 +1,14 @@
+namespace Miningcore.Notifications.Messages;
+
+/// <summary>
+/// Published by a job manager once the daemon has accepted a block submitted by the pool
+/// </summary>
+public record BlockAcceptedMessage
+{
+    public BlockAcceptedMessage(string poolId)
+    {
+        PoolId = poolId;
+    }
+
+    public string PoolId { get; }
+}
@@ -1,10 +1,14 @@
+using System.Collections.Concurrent;
 using System.Reactive;
 using System.Reactive.Concurrency;
 using System.Reactive.Linq;
 using System.Reactive.Threading.Tasks;
 using Microsoft.Extensions.Hosting;
 using Miningcore.Messaging;
+using Miningcore.Mining;
+using Miningcore.Native;
 using Miningcore.Notifications.Messages;
+using Miningcore.Stratum;
 using NLog;
 using Prometheus;
 using static Miningcore.Util.ActionUtils;
@@ -23,6 +27,10 @@ public class MetricsPublisher : BackgroundService
     private static readonly ILogger logger = LogManager.GetCurrentClassLogger();
 
     private readonly IMessageBus messageBus;
+    private readonly ConcurrentDictionary<string, IMiningPool> pools = new();
+    private readonly Dictionary<string, ShareCounters> lastShareCounters = new();
+    private readonly Dictionary<string, AdmissionCounters> lastAdmissionCounters = new();
+    private readonly HashSet<string> nativeMemoryOwners = new();
 
     private Summary btStreamLatencySummary;
     private Counter shareCounter;
@@ -31,9 +39,16 @@ public class MetricsPublisher : BackgroundService
     private Summary apiRequestDurationSummary;
     private Counter validShareCounter;
     private Counter invalidShareCounter;
+    private Counter staleShareCounter;
+    private Counter shareDifficultyCounter;
+    private Gauge lastShareGauge;
     private Summary hashComputationSummary;
     private Gauge poolConnectionsGauge;
     private Gauge poolHashrateGauge;
+    private Counter shareCacheCounter;
+    private Counter admissionCounter;
+    private Gauge nativeMemoryGauge;
+    private Gauge nativeMemoryBudgetGauge;
 
     private void CreateMetrics()
     {
@@ -67,6 +82,21 @@ public class MetricsPublisher : BackgroundService
             LabelNames = new[] { "pool" }
         });
 
+        staleShareCounter = Metrics.CreateCounter("miningcore_stale_shares_total", "Stale received shares per pool", new CounterConfiguration
+        {
+            LabelNames = new[] { "pool" }
+        });
+
+        shareDifficultyCounter = Metrics.CreateCounter("miningcore_share_difficulty_total", "Sum of the difficulty of valid shares per pool", new CounterConfiguration
+        {
+            LabelNames = new[] { "pool" }
+        });
+
+        lastShareGauge = Metrics.CreateGauge("miningcore_last_share_timestamp", "Unix time of the last valid share per pool", new GaugeConfiguration
+        {
+            LabelNames = new[] { "pool" }
+        });
+
         rpcRequestDurationSummary = Metrics.CreateSummary("miningcore_rpcrequest_execution_time", "RPC request execution time ms", new SummaryConfiguration
         {
             LabelNames = new[] { "pool", "method" }
@@ -86,6 +116,103 @@ public class MetricsPublisher : BackgroundService
         {
             LabelNames = new[] { "algo" }
         });
+
+        shareCacheCounter = Metrics.CreateCounter("miningcore_share_cache_total", "Share validation cache lookups per pool", new CounterConfiguration
+        {
+            LabelNames = new[] { "pool", "cache", "result" }
+        });
+
+        admissionCounter = Metrics.CreateCounter("miningcore_stratum_admission_total", "Admission control decisions on new stratum connections per pool", new CounterConfiguration
+        {
+            LabelNames = new[] { "pool", "result" }
+        });
+
+        nativeMemoryGauge = Metrics.CreateGauge("miningcore_native_memory_bytes", "Native memory held by datasets and caches per owner", new GaugeConfiguration
+        {
+            LabelNames = new[] { "owner" }
+        });
+
+        nativeMemoryBudgetGauge = Metrics.CreateGauge("miningcore_native_memory_budget_bytes", "Native memory budget (0 = unlimited)");
+
+        // share counters are kept per connection and only sampled when scraped
+        Metrics.DefaultRegistry.AddBeforeCollectCallback(() => Guard(CollectShareCounters, ex=> logger.Error(ex.Message)));
+        Metrics.DefaultRegistry.AddBeforeCollectCallback(() => Guard(CollectAdmissionCounters, ex=> logger.Error(ex.Message)));
+        Metrics.DefaultRegistry.AddBeforeCollectCallback(() => Guard(CollectNativeMemory, ex=> logger.Error(ex.Message)));
+    }
+
+    private void CollectShareCounters()
+    {
+        lock(lastShareCounters)
+        {
+            foreach(var pool in pools.Values)
+            {
+                var poolId = pool.Config.Id;
+                var current = pool.GetShareCounters();
+                var last = lastShareCounters.GetValueOrDefault(poolId);
+
+                // a connection closing while being sampled can make counters lag behind, never count backwards
+                var accepted = Math.Max(current.Accepted, last.Accepted);
+                var rejected = Math.Max(current.Rejected, last.Rejected);
+                var stale = Math.Max(current.Stale, last.Stale);
+                var difficulty = Math.Max(current.AcceptedDifficulty, last.AcceptedDifficulty);
+
+                shareCounter.WithLabels(poolId).Inc(accepted - last.Accepted + rejected - last.Rejected);
+                validShareCounter.WithLabels(poolId).Inc(accepted - last.Accepted);
+                invalidShareCounter.WithLabels(poolId).Inc(rejected - last.Rejected);
+                staleShareCounter.WithLabels(poolId).Inc(stale - last.Stale);
+                shareDifficultyCounter.WithLabels(poolId).Inc(difficulty - last.AcceptedDifficulty);
+
+                if(current.LastShare.HasValue)
+                    lastShareGauge.WithLabels(poolId).Set(((DateTimeOffset) current.LastShare.Value).ToUnixTimeSeconds());
+
+                lastShareCounters[poolId] = new ShareCounters(accepted, rejected, stale, difficulty, current.LastShare);
+            }
+        }
+    }
+
+    private void CollectAdmissionCounters()
+    {
+        lock(lastAdmissionCounters)
+        {
+            foreach(var pool in pools.Values)
+            {
+                var poolId = pool.Config.Id;
+                var current = pool.GetAdmissionCounters();
+                var last = lastAdmissionCounters.GetValueOrDefault(poolId);
+
+                if(current == last)
+                    continue;
+
+                admissionCounter.WithLabels(poolId, "accepted").Inc(current.Accepted - last.Accepted);
+                admissionCounter.WithLabels(poolId, "address_rate").Inc(current.AddressRate - last.AddressRate);
+                admissionCounter.WithLabels(poolId, "prefix_rate").Inc(current.PrefixRate - last.PrefixRate);
+                admissionCounter.WithLabels(poolId, "address_limit").Inc(current.AddressLimit - last.AddressLimit);
+                admissionCounter.WithLabels(poolId, "prefix_limit").Inc(current.PrefixLimit - last.PrefixLimit);
+
+                lastAdmissionCounters[poolId] = current;
+            }
+        }
+    }
+
+    private void CollectNativeMemory()
+    {
+        var budget = NativeMemoryBudget.Default;
+        var usage = budget.GetUsage();
+
+        lock(nativeMemoryOwners)
+        {
+            // owners which released everything drop to zero
+            foreach(var owner in nativeMemoryOwners.Where(x => !usage.ContainsKey(x)))
+                nativeMemoryGauge.WithLabels(owner).Set(0);
+
+            foreach(var (owner, bytes) in usage)
+            {
+                nativeMemoryGauge.WithLabels(owner).Set(bytes);
+                nativeMemoryOwners.Add(owner);
+            }
+        }
+
+        nativeMemoryBudgetGauge.Set(budget.Budget);
     }
 
     private void OnTelemetryEvent(TelemetryEvent msg)
@@ -123,9 +250,21 @@ public class MetricsPublisher : BackgroundService
             case TelemetryCategory.Hash:
                 hashComputationSummary.WithLabels(msg.GroupId).Observe(msg.Elapsed.TotalMilliseconds);
                 break;
+
+            case TelemetryCategory.ShareCache:
+                shareCacheCounter.WithLabels(msg.GroupId, msg.Info, msg.Success == true ? "hit" : "miss").Inc(msg.Total);
+                break;
         }
     }
 
+    private void OnPoolStatusNotification(PoolStatusNotification msg)
+    {
+        if(msg.Status == PoolStatus.Online)
+            pools[msg.Pool.Config.Id] = msg.Pool;
+        else
+            pools.TryRemove(msg.Pool.Config.Id, out _);
+    }
+
     private void OnHashrateNotification(HashrateNotification msg)
     {
         poolHashrateGauge.WithLabels(msg.PoolId).Set(msg.Hashrate);
@@ -143,7 +282,11 @@ public class MetricsPublisher : BackgroundService
             .Do(x=> Guard(()=> OnHashrateNotification(x), ex=> logger.Error(ex.Message)))
             .Select(_=> Unit.Default);
 
-        return Observable.Merge(telemetryEvents, hashrateNotifications)
+        var poolStatusNotifications = messageBus.Listen<PoolStatusNotification>()
+            .Do(x=> Guard(()=> OnPoolStatusNotification(x), ex=> logger.Error(ex.Message)))
+            .Select(_=> Unit.Default);
+
+        return Observable.Merge(telemetryEvents, hashrateNotifications, poolStatusNotifications)
             .ToTask(ct);
     }
 }
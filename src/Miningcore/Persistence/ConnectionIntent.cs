@@ -0,0 +1,22 @@
+namespace Miningcore.Persistence;
+
+/// <summary>
+/// Declares what a caller intends to do with a connection so the factory can route it
+/// </summary>
+public enum ConnectionIntent
+{
+    /// <summary>
+    /// Writes, transactions and anything the payout pipeline depends on. Always served by the primary.
+    /// </summary>
+    Write,
+
+    /// <summary>
+    /// Reads that must observe recent writes. May be served by a replica lagging no more than MaxReplicaLag.
+    /// </summary>
+    Read,
+
+    /// <summary>
+    /// Reporting and API reads that tolerate slightly outdated data. May be served by a replica lagging no more than MaxReplicaStaleness.
+    /// </summary>
+    ReadStale,
+}
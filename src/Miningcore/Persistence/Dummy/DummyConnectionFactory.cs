@@ -12,7 +12,7 @@ public class DummyConnectionFactory : IConnectionFactory
     /// This implementation ensures that Glimpse.ADO is able to collect data
     /// </summary>
     /// <returns></returns>
-    public Task<IDbConnection> OpenConnectionAsync()
+    public Task<IDbConnection> OpenConnectionAsync(ConnectionIntent intent = ConnectionIntent.Write)
     {
         throw new NotImplementedException();
     }
@@ -4,5 +4,5 @@ namespace Miningcore.Persistence;
 
 public interface IConnectionFactory
 {
-    Task<IDbConnection> OpenConnectionAsync();
+    Task<IDbConnection> OpenConnectionAsync(ConnectionIntent intent = ConnectionIntent.Write);
 }
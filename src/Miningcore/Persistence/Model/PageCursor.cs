@@ -0,0 +1,7 @@
+namespace Miningcore.Persistence.Model;
+
+/// <summary>
+/// Position of the last row of a page ordered by (created, id) descending.
+/// The next page starts strictly below it, so no earlier rows are scanned.
+/// </summary>
+public record PageCursor(DateTime Created, long Id);
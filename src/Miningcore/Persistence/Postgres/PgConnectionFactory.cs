@@ -1,4 +1,5 @@
 using System.Data;
+using Dapper;
 using Npgsql;
 
 namespace Miningcore.Persistence.Postgres;
@@ -12,10 +13,26 @@ public class PgConnectionFactory : IConnectionFactory
 
     private readonly string connectionString;
 
-    public async Task<IDbConnection> OpenConnectionAsync()
+    private const string ReplicationLagQuery = @"SELECT CASE
+        WHEN NOT pg_is_in_recovery() THEN 0
+        WHEN pg_last_wal_receive_lsn() = pg_last_wal_replay_lsn() THEN 0
+        ELSE COALESCE(EXTRACT(EPOCH FROM now() - pg_last_xact_replay_timestamp()), 0) END";
+
+    public async Task<IDbConnection> OpenConnectionAsync(ConnectionIntent intent = ConnectionIntent.Write)
     {
         var con = new NpgsqlConnection(connectionString);
         await con.OpenAsync();
         return con;
     }
+
+    /// <summary>
+    /// Measures how far a streaming replica is behind its primary. A replica which has
+    /// replayed everything it received reports zero regardless of primary write activity.
+    /// </summary>
+    public static async Task<TimeSpan> GetReplicationLagAsync(IDbConnection con, CancellationToken ct)
+    {
+        var seconds = await con.ExecuteScalarAsync<double>(new CommandDefinition(ReplicationLagQuery, cancellationToken: ct));
+
+        return TimeSpan.FromSeconds(Math.Max(0, seconds));
+    }
 }
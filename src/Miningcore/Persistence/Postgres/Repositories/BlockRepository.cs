@@ -1,4 +1,5 @@
 using System.Data;
+using System.Text;
 using AutoMapper;
 using Dapper;
 using Miningcore.Persistence.Model;
@@ -94,6 +95,51 @@ public class BlockRepository : IBlockRepository
             .ToArray();
     }
 
+    public async Task<Block[]> PageBlocksAsync(IDbConnection con, string poolId, BlockStatus[] status,
+        PageCursor after, int pageSize, CancellationToken ct)
+    {
+        var query = new StringBuilder("SELECT * FROM blocks WHERE poolid = @poolid AND status = ANY(@status) ");
+
+        if(after != null)
+            query.Append("AND (created, id) < (@created, @id) ");
+
+        query.Append("ORDER BY created DESC, id DESC FETCH NEXT @pageSize ROWS ONLY");
+
+        return (await con.QueryAsync<Entities.Block>(new CommandDefinition(query.ToString(), new
+        {
+            poolId,
+            status = status.Select(x => x.ToString().ToLower()).ToArray(),
+            created = after?.Created,
+            id = after?.Id,
+            pageSize
+        }, cancellationToken: ct)))
+            .Select(mapper.Map<Block>)
+            .ToArray();
+    }
+
+    public async Task<Block[]> PageMinerBlocksAsync(IDbConnection con, string poolId, string address, BlockStatus[] status,
+        PageCursor after, int pageSize, CancellationToken ct)
+    {
+        var query = new StringBuilder("SELECT * FROM blocks WHERE poolid = @poolid AND miner = @address AND status = ANY(@status) ");
+
+        if(after != null)
+            query.Append("AND (created, id) < (@created, @id) ");
+
+        query.Append("ORDER BY created DESC, id DESC FETCH NEXT @pageSize ROWS ONLY");
+
+        return (await con.QueryAsync<Entities.Block>(new CommandDefinition(query.ToString(), new
+        {
+            poolId,
+            address,
+            status = status.Select(x => x.ToString().ToLower()).ToArray(),
+            created = after?.Created,
+            id = after?.Id,
+            pageSize
+        }, cancellationToken: ct)))
+            .Select(mapper.Map<Block>)
+            .ToArray();
+    }
+
     public async Task<Block[]> GetPendingBlocksForPoolAsync(IDbConnection con, string poolId)
     {
         const string query = @"SELECT * FROM blocks WHERE poolid = @poolid AND status = @status";
@@ -83,6 +83,39 @@ public class PaymentRepository : IPaymentRepository
             .ToArray();
     }
 
+    public async Task<Payment[]> PagePaymentsAsync(IDbConnection con, string poolId, string address, PageCursor after, int pageSize, CancellationToken ct)
+    {
+        var query = new StringBuilder("SELECT * FROM payments WHERE poolid = @poolid ");
+
+        if(!string.IsNullOrEmpty(address))
+            query.Append(" AND address = @address ");
+
+        if(after != null)
+            query.Append(" AND (created, id) < (@created, @id) ");
+
+        query.Append("ORDER BY created DESC, id DESC FETCH NEXT @pageSize ROWS ONLY");
+
+        return (await con.QueryAsync<Entities.Payment>(new CommandDefinition(query.ToString(),
+                new { poolId, address, created = after?.Created, id = after?.Id, pageSize }, cancellationToken: ct)))
+            .Select(mapper.Map<Payment>)
+            .ToArray();
+    }
+
+    public async Task<BalanceChange[]> PageBalanceChangesAsync(IDbConnection con, string poolId, string address, PageCursor after, int pageSize, CancellationToken ct)
+    {
+        var query = new StringBuilder("SELECT * FROM balance_changes WHERE poolid = @poolid AND address = @address ");
+
+        if(after != null)
+            query.Append(" AND (created, id) < (@created, @id) ");
+
+        query.Append("ORDER BY created DESC, id DESC FETCH NEXT @pageSize ROWS ONLY");
+
+        return (await con.QueryAsync<Entities.BalanceChange>(new CommandDefinition(query.ToString(),
+                new { poolId, address, created = after?.Created, id = after?.Id, pageSize }, cancellationToken: ct)))
+            .Select(mapper.Map<BalanceChange>)
+            .ToArray();
+    }
+
     public async Task<AmountByDate[]> PageMinerPaymentsByDayAsync(IDbConnection con, string poolId, string address, int page, int pageSize, CancellationToken ct)
     {
        const string query = @"SELECT SUM(amount) AS amount, date_trunc('day', created) AS date FROM payments WHERE poolid = @poolid
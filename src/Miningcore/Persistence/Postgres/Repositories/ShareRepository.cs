@@ -1,6 +1,7 @@
 using System.Data;
 using AutoMapper;
 using Dapper;
+using Miningcore.Configuration;
 using Miningcore.Persistence.Model;
 using Miningcore.Persistence.Model.Projections;
 using Miningcore.Persistence.Repositories;
@@ -11,12 +12,26 @@ namespace Miningcore.Persistence.Postgres.Repositories;
 
 public class ShareRepository : IShareRepository
 {
-    public ShareRepository(IMapper mapper)
+    public ShareRepository(IMapper mapper, ClusterConfig clusterConfig) :
+        this(mapper, clusterConfig.Persistence?.Postgres?.ShareStaging?.Enabled == true)
+    {
+    }
+
+    public ShareRepository(IMapper mapper, bool staging)
     {
         this.mapper = mapper;
+        this.staging = staging;
+
+        sharesTable = staging ? "shares_all" : "shares";
     }
 
     private readonly IMapper mapper;
+    private readonly bool staging;
+
+    /// <summary>
+    /// Relation queried by readers, includes staged shares not merged yet
+    /// </summary>
+    private readonly string sharesTable;
 
     public async Task BatchInsertAsync(IDbConnection con, IDbTransaction tx, IEnumerable<Share> shares, CancellationToken ct)
     {
@@ -25,7 +40,7 @@ public class ShareRepository : IShareRepository
 
         var pgCon = (NpgsqlConnection) con;
 
-        const string query = @"COPY shares (poolid, blockheight, difficulty,
+        var query = @$"COPY {(staging ? "shares_staging" : "shares")} (poolid, blockheight, difficulty,
             networkdifficulty, miner, worker, useragent, ipaddress, source, created) FROM STDIN (FORMAT BINARY)";
 
         await using(var writer = await pgCon.BeginBinaryImportAsync(query, ct))
@@ -50,10 +65,23 @@ public class ShareRepository : IShareRepository
         }
     }
 
+    public Task<int> MergeStagedSharesAsync(IDbConnection con, int batchSize, CancellationToken ct)
+    {
+        // Moves a batch in a single statement, readers of shares_all see each share exactly once.
+        // Sorting by the leading index columns keeps B-tree inserts local.
+        const string query = @"WITH moved AS (
+                DELETE FROM shares_staging WHERE ctid = ANY(ARRAY(SELECT ctid FROM shares_staging LIMIT @batchSize))
+                RETURNING poolid, blockheight, difficulty, networkdifficulty, miner, worker, useragent, ipaddress, source, created)
+            INSERT INTO shares (poolid, blockheight, difficulty, networkdifficulty, miner, worker, useragent, ipaddress, source, created)
+            SELECT * FROM moved ORDER BY poolid, miner, created";
+
+        return con.ExecuteAsync(new CommandDefinition(query, new { batchSize }, cancellationToken: ct));
+    }
+
     public async Task<Share[]> ReadSharesBeforeAsync(IDbConnection con, string poolId, DateTime before,
         bool inclusive, int pageSize, CancellationToken ct)
     {
-        var query = @$"SELECT * FROM shares WHERE poolid = @poolId AND created {(inclusive ? " <= " : " < ")} @before
+        var query = @$"SELECT * FROM {sharesTable} WHERE poolid = @poolId AND created {(inclusive ? " <= " : " < ")} @before
             ORDER BY created DESC FETCH NEXT @pageSize ROWS ONLY";
 
         return (await con.QueryAsync<Entities.Share>(new CommandDefinition(query, new { poolId, before, pageSize }, cancellationToken: ct)))
@@ -63,35 +91,50 @@ public class ShareRepository : IShareRepository
 
     public Task<long> CountSharesBeforeAsync(IDbConnection con, IDbTransaction tx, string poolId, DateTime before, CancellationToken ct)
     {
-        const string query = "SELECT count(*) FROM shares WHERE poolid = @poolId AND created < @before";
+        var query = $"SELECT count(*) FROM {sharesTable} WHERE poolid = @poolId AND created < @before";
 
         return con.QuerySingleAsync<long>(new CommandDefinition(query, new { poolId, before }, tx, cancellationToken: ct));
     }
 
     public Task<long> CountSharesByMinerAsync(IDbConnection con, IDbTransaction tx, string poolId, string miner, CancellationToken ct)
     {
-        const string query = "SELECT count(*) FROM shares WHERE poolid = @poolId AND miner = @miner";
+        var query = $"SELECT count(*) FROM {sharesTable} WHERE poolid = @poolId AND miner = @miner";
 
         return con.QuerySingleAsync<long>(new CommandDefinition(query, new { poolId, miner}, tx, cancellationToken: ct));
     }
 
     public Task<double?> GetEffortBetweenCreatedAsync(IDbConnection con, string poolId, double shareConst, DateTime start, DateTime end, CancellationToken ct)
     {
-        const string query = "SELECT SUM((difficulty * @shareConst) / networkdifficulty) FROM shares WHERE poolid = @poolId AND created > @start AND created < @end";
+        var query = $"SELECT SUM((difficulty * @shareConst) / networkdifficulty) FROM {sharesTable} WHERE poolid = @poolId AND created > @start AND created < @end";
 
         return con.QuerySingleAsync<double?>(new CommandDefinition(query, new { poolId, shareConst, start, end }, cancellationToken: ct));
     }
 
     public Task<double?> GetMinerEffortBetweenCreatedAsync(IDbConnection con, string poolId, string miner, DateTime start, DateTime end, CancellationToken ct)
     {
-        const string query = "SELECT SUM(difficulty / networkdifficulty) FROM shares WHERE poolid = @poolId AND miner = @miner AND created > @start AND created < @end";
+        var query = $"SELECT SUM(difficulty / networkdifficulty) FROM {sharesTable} WHERE poolid = @poolId AND miner = @miner AND created > @start AND created < @end";
 
         return con.QuerySingleAsync<double?>(new CommandDefinition(query, new { poolId, miner, start, end }, cancellationToken: ct));
     }
 
+    public async Task<KeyValuePair<string, double>[]> GetMinerEffortsBetweenCreatedAsync(IDbConnection con, string poolId, DateTime start, DateTime end, CancellationToken ct)
+    {
+        var query = @$"SELECT miner AS key, SUM(difficulty / networkdifficulty) AS value FROM {sharesTable}
+            WHERE poolid = @poolId AND created > @start AND created < @end
+            GROUP BY miner";
+
+        return (await con.QueryAsync<KeyValuePair<string, double>>(new CommandDefinition(query, new { poolId, start, end }, cancellationToken: ct)))
+            .ToArray();
+    }
+
     public async Task DeleteSharesByMinerAsync(IDbConnection con, IDbTransaction tx, string poolId, string miner, CancellationToken ct)
     {
         const string query = "DELETE FROM shares WHERE poolid = @poolId AND miner = @miner";
+        const string queryStaged = "DELETE FROM shares_staging WHERE poolid = @poolId AND miner = @miner";
+
+        // staged shares first, a concurrent merge then either completes before shares is cleaned up or waits for us
+        if(staging)
+            await con.ExecuteAsync(new CommandDefinition(queryStaged, new { poolId, miner}, tx, cancellationToken: ct));
 
         await con.ExecuteAsync(new CommandDefinition(query, new { poolId, miner}, tx, cancellationToken: ct));
     }
@@ -99,34 +142,39 @@ public class ShareRepository : IShareRepository
     public async Task DeleteSharesBeforeAsync(IDbConnection con, IDbTransaction tx, string poolId, DateTime before, CancellationToken ct)
     {
         const string query = "DELETE FROM shares WHERE poolid = @poolId AND created < @before";
+        const string queryStaged = "DELETE FROM shares_staging WHERE poolid = @poolId AND created < @before";
+
+        // staged shares first, a concurrent merge then either completes before shares is cleaned up or waits for us
+        if(staging)
+            await con.ExecuteAsync(new CommandDefinition(queryStaged, new { poolId, before }, tx, cancellationToken: ct));
 
         await con.ExecuteAsync(new CommandDefinition(query, new { poolId, before }, tx, cancellationToken: ct));
     }
 
     public Task<double?> GetAccumulatedShareDifficultyBetweenAsync(IDbConnection con, string poolId, DateTime start, DateTime end, CancellationToken ct)
     {
-        const string query = "SELECT SUM(difficulty) FROM shares WHERE poolid = @poolId AND created > @start AND created < @end";
+        var query = $"SELECT SUM(difficulty) FROM {sharesTable} WHERE poolid = @poolId AND created > @start AND created < @end";
 
         return con.QuerySingleAsync<double?>(new CommandDefinition(query, new { poolId, start, end }, cancellationToken: ct));
     }
 
     public Task<double?> GetMinerShareDifficultyBetweenAsync(IDbConnection con, string poolId, string miner, DateTime start, DateTime end, CancellationToken ct)
     {
-        const string query = "SELECT SUM(difficulty / networkdifficulty) FROM shares WHERE poolid = @poolId AND miner = @miner AND created > @start AND created < @end";
+        var query = $"SELECT SUM(difficulty / networkdifficulty) FROM {sharesTable} WHERE poolid = @poolId AND miner = @miner AND created > @start AND created < @end";
 
         return con.QuerySingleAsync<double?>(new CommandDefinition(query, new { poolId, miner, start, end }, cancellationToken: ct));
     }
 
     public Task<double?> GetEffectiveAccumulatedShareDifficultyBetweenAsync(IDbConnection con, string poolId, DateTime start, DateTime end, CancellationToken ct)
     {
-        const string query = "SELECT SUM(difficulty / networkdifficulty) FROM shares WHERE poolid = @poolId AND created > @start AND created < @end";
+        var query = $"SELECT SUM(difficulty / networkdifficulty) FROM {sharesTable} WHERE poolid = @poolId AND created > @start AND created < @end";
 
         return con.QuerySingleAsync<double?>(new CommandDefinition(query, new { poolId, start, end }, cancellationToken: ct));
     }
 
     public async Task<MinerWorkerHashes[]> GetHashAccumulationBetweenAsync(IDbConnection con, string poolId, DateTime start, DateTime end, CancellationToken ct)
     {
-        const string query = @"SELECT SUM(difficulty), COUNT(difficulty), MIN(created) AS firstshare, MAX(created) AS lastshare, miner, worker FROM shares
+        var query = @$"SELECT SUM(difficulty), COUNT(difficulty), MIN(created) AS firstshare, MAX(created) AS lastshare, miner, worker FROM {sharesTable}
             WHERE poolid = @poolId AND created >= @start AND created <= @end
             GROUP BY miner, worker";
 
@@ -137,11 +185,11 @@ public class ShareRepository : IShareRepository
     public async Task<KeyValuePair<string, double>[]> GetAccumulatedUserAgentShareDifficultyBetweenAsync(
         IDbConnection con, string poolId, DateTime start, DateTime end, bool byVersion, CancellationToken ct)
     {
-        const string query = @"SELECT SUM(difficulty) AS value, REGEXP_REPLACE(useragent, '/.+', '') AS key FROM shares
+        var query = @$"SELECT SUM(difficulty) AS value, REGEXP_REPLACE(useragent, '/.+', '') AS key FROM {sharesTable}
                 WHERE poolid = @poolId AND created > @start AND created < @end
                 GROUP BY key ORDER BY value DESC";
 
-        const string queryByVersion = @"SELECT SUM(difficulty) AS value, useragent AS key FROM shares
+        var queryByVersion = @$"SELECT SUM(difficulty) AS value, useragent AS key FROM {sharesTable}
             WHERE poolid = @poolId AND created > @start AND created < @end
             GROUP BY key ORDER BY value DESC";
 
@@ -151,7 +199,7 @@ public class ShareRepository : IShareRepository
 
     public async Task<string[]> GetRecentyUsedIpAddressesAsync(IDbConnection con, IDbTransaction tx, string poolId, string miner, CancellationToken ct)
     {
-        const string query = @"SELECT DISTINCT s.ipaddress FROM (SELECT * FROM shares
+        var query = @$"SELECT DISTINCT s.ipaddress FROM (SELECT * FROM {sharesTable}
             WHERE poolid = @poolId and miner = @miner ORDER BY CREATED DESC LIMIT 100) s";
 
         return (await con.QueryAsync<string>(new CommandDefinition(query, new { poolId, miner }, tx, cancellationToken: ct)))
@@ -1,6 +1,8 @@
 using System.Data;
+using System.Text;
 using AutoMapper;
 using Dapper;
+using Miningcore.Configuration;
 using Miningcore.Persistence.Model;
 using Miningcore.Persistence.Model.Projections;
 using Miningcore.Persistence.Repositories;
@@ -11,14 +13,17 @@ namespace Miningcore.Persistence.Postgres.Repositories;
 
 public class StatsRepository : IStatsRepository
 {
-    public StatsRepository(IMapper mapper, IMasterClock clock)
+    public StatsRepository(IMapper mapper, IMasterClock clock, ClusterConfig clusterConfig)
     {
         this.mapper = mapper;
         this.clock = clock;
+
+        sharesTable = clusterConfig.Persistence?.Postgres?.ShareStaging?.Enabled == true ? "shares_all" : "shares";
     }
 
     private readonly IMapper mapper;
     private readonly IMasterClock clock;
+    private readonly string sharesTable;
     private static readonly TimeSpan MinerStatsMaxAge = TimeSpan.FromMinutes(20);
 
     public async Task InsertPoolStatsAsync(IDbConnection con, IDbTransaction tx, PoolStats stats, CancellationToken ct)
@@ -87,7 +92,7 @@ public class StatsRepository : IStatsRepository
 
     public async Task<MinerStats> GetMinerStatsAsync(IDbConnection con, IDbTransaction tx, string poolId, string miner, CancellationToken ct)
     {
-        var query = @"SELECT (SELECT SUM(difficulty) FROM shares WHERE poolid = @poolId AND miner = @miner) AS pendingshares,
+        var query = @$"SELECT (SELECT SUM(difficulty) FROM {sharesTable} WHERE poolid = @poolId AND miner = @miner) AS pendingshares,
             (SELECT amount FROM balances WHERE poolid = @poolId AND address = @miner) AS pendingbalance,
             (SELECT SUM(amount) FROM payments WHERE poolid = @poolId and address = @miner) as totalpaid,
             (SELECT SUM(amount) FROM payments WHERE poolid = @poolId and address = @miner and created >= date_trunc('day', now())) as todaypaid";
@@ -341,6 +346,36 @@ public class StatsRepository : IStatsRepository
             .ToArray();
     }
 
+    public async Task<MinerWorkerPerformanceStats[]> PagePoolMinersByHashrateAsync(IDbConnection con, string poolId,
+        DateTime from, MinerWorkerPerformanceStats after, int pageSize, CancellationToken ct)
+    {
+        var query = new StringBuilder(
+            @"WITH tmp AS
+            (
+            	SELECT
+            		ms.miner,
+            		ms.hashrate,
+            		ms.sharespersecond,
+            		ROW_NUMBER() OVER(PARTITION BY ms.miner ORDER BY ms.hashrate DESC) AS rk
+            	FROM (SELECT miner, SUM(hashrate) AS hashrate, SUM(sharespersecond) AS sharespersecond
+                   FROM minerstats
+                   WHERE poolid = @poolid AND created >= @from GROUP BY miner, created) ms
+            )
+            SELECT t.miner, t.hashrate, t.sharespersecond
+            FROM tmp t
+            WHERE t.rk = 1 ");
+
+        if(after != null)
+            query.Append("AND (t.hashrate, t.miner) < (@hashrate, @miner) ");
+
+        query.Append("ORDER by t.hashrate DESC, t.miner DESC FETCH NEXT @pageSize ROWS ONLY");
+
+        return (await con.QueryAsync<Entities.MinerWorkerPerformanceStats>(new CommandDefinition(query.ToString(),
+                new { poolId, from, hashrate = after?.Hashrate, miner = after?.Miner, pageSize }, cancellationToken: ct)))
+            .Select(mapper.Map<MinerWorkerPerformanceStats>)
+            .ToArray();
+    }
+
     public Task<int> DeletePoolStatsBeforeAsync(IDbConnection con, DateTime date, CancellationToken ct)
     {
         const string query = @"DELETE FROM poolstats WHERE created < @date";
@@ -0,0 +1,7 @@
+SET ROLE miningcore;
+
+CREATE INDEX IF NOT EXISTS IDX_BLOCKS_POOL_CREATED_ID on blocks(poolid, created desc, id desc);
+CREATE INDEX IF NOT EXISTS IDX_BLOCKS_POOL_MINER_CREATED_ID on blocks(poolid, miner, created desc, id desc);
+CREATE INDEX IF NOT EXISTS IDX_BALANCE_CHANGES_POOL_ADDRESS_CREATED_ID on balance_changes(poolid, address, created desc, id desc);
+CREATE INDEX IF NOT EXISTS IDX_PAYMENTS_POOL_CREATED_ID on payments(poolid, created desc, id desc);
+CREATE INDEX IF NOT EXISTS IDX_PAYMENTS_POOL_ADDRESS_CREATED_ID on payments(poolid, address, created desc, id desc);
@@ -0,0 +1,25 @@
+SET ROLE miningcore;
+
+-- Append-only landing table for staged share ingestion. It carries no indexes,
+-- rows are moved into shares by the share merger in large sorted batches.
+-- Declaring it UNLOGGED saves another round of WAL, at the price of losing
+-- shares not yet merged if the database server crashes.
+CREATE TABLE IF NOT EXISTS shares_staging
+(
+	poolid TEXT NOT NULL,
+	blockheight BIGINT NOT NULL,
+	difficulty DOUBLE PRECISION NOT NULL,
+	networkdifficulty DOUBLE PRECISION NOT NULL,
+	miner TEXT NOT NULL,
+	worker TEXT NULL,
+	useragent TEXT NULL,
+	ipaddress TEXT NOT NULL,
+	source TEXT NULL,
+	created TIMESTAMPTZ NOT NULL
+);
+
+-- Everything recorded so far, merged or not
+CREATE OR REPLACE VIEW shares_all AS
+	SELECT poolid, blockheight, difficulty, networkdifficulty, miner, worker, useragent, ipaddress, source, created FROM shares
+	UNION ALL
+	SELECT poolid, blockheight, difficulty, networkdifficulty, miner, worker, useragent, ipaddress, source, created FROM shares_staging;
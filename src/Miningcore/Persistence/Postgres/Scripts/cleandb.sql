@@ -1,4 +1,6 @@
-﻿DROP TABLE shares;
+﻿DROP VIEW IF EXISTS shares_all;
+DROP TABLE IF EXISTS shares_staging;
+DROP TABLE shares;
 DROP TABLE blocks;
 DROP TABLE balances;
 DROP TABLE payments;
@@ -18,6 +18,25 @@ CREATE INDEX IDX_SHARES_POOL_MINER on shares(poolid, miner);
 CREATE INDEX IDX_SHARES_POOL_CREATED ON shares(poolid, created);
 CREATE INDEX IDX_SHARES_POOL_MINER_DIFFICULTY on shares(poolid, miner, difficulty);
 
+CREATE TABLE shares_staging
+(
+	poolid TEXT NOT NULL,
+	blockheight BIGINT NOT NULL,
+	difficulty DOUBLE PRECISION NOT NULL,
+	networkdifficulty DOUBLE PRECISION NOT NULL,
+	miner TEXT NOT NULL,
+	worker TEXT NULL,
+	useragent TEXT NULL,
+	ipaddress TEXT NOT NULL,
+	source TEXT NULL,
+	created TIMESTAMPTZ NOT NULL
+);
+
+CREATE VIEW shares_all AS
+	SELECT poolid, blockheight, difficulty, networkdifficulty, miner, worker, useragent, ipaddress, source, created FROM shares
+	UNION ALL
+	SELECT poolid, blockheight, difficulty, networkdifficulty, miner, worker, useragent, ipaddress, source, created FROM shares_staging;
+
 CREATE TABLE blocks
 (
 	id BIGSERIAL NOT NULL PRIMARY KEY,
@@ -39,6 +58,8 @@ CREATE TABLE blocks
 
 CREATE INDEX IDX_BLOCKS_POOL_BLOCK_STATUS on blocks(poolid, blockheight, status);
 CREATE INDEX IDX_BLOCKS_POOL_BLOCK_TYPE on blocks(poolid, blockheight, type);
+CREATE INDEX IDX_BLOCKS_POOL_CREATED_ID on blocks(poolid, created desc, id desc);
+CREATE INDEX IDX_BLOCKS_POOL_MINER_CREATED_ID on blocks(poolid, miner, created desc, id desc);
 
 CREATE TABLE balances
 (
@@ -63,6 +84,7 @@ CREATE TABLE balance_changes
 );
 
 CREATE INDEX IDX_BALANCE_CHANGES_POOL_ADDRESS_CREATED on balance_changes(poolid, address, created desc);
+CREATE INDEX IDX_BALANCE_CHANGES_POOL_ADDRESS_CREATED_ID on balance_changes(poolid, address, created desc, id desc);
 CREATE INDEX IDX_BALANCE_CHANGES_POOL_TAGS on balance_changes USING gin (tags);
 
 CREATE TABLE miner_settings
@@ -88,6 +110,8 @@ CREATE TABLE payments
 );
 
 CREATE INDEX IDX_PAYMENTS_POOL_COIN_WALLET on payments(poolid, coin, address);
+CREATE INDEX IDX_PAYMENTS_POOL_CREATED_ID on payments(poolid, created desc, id desc);
+CREATE INDEX IDX_PAYMENTS_POOL_ADDRESS_CREATED_ID on payments(poolid, address, created desc, id desc);
 
 CREATE TABLE poolstats
 (
@@ -1,5 +1,6 @@
 SET ROLE miningcore;
 
+DROP VIEW IF EXISTS shares_all;
 DROP TABLE shares;
 
 CREATE TABLE shares
@@ -18,3 +19,8 @@ CREATE TABLE shares
 
 CREATE INDEX IDX_SHARES_CREATED ON SHARES(created);
 CREATE INDEX IDX_SHARES_MINER_DIFFICULTY on SHARES(miner, difficulty);
+
+CREATE VIEW shares_all AS
+	SELECT poolid, blockheight, difficulty, networkdifficulty, miner, worker, useragent, ipaddress, source, created FROM shares
+	UNION ALL
+	SELECT poolid, blockheight, difficulty, networkdifficulty, miner, worker, useragent, ipaddress, source, created FROM shares_staging;
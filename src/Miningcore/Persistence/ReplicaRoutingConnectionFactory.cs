@@ -0,0 +1,132 @@
+using System.Data;
+using Miningcore.Time;
+using NLog;
+using Contract = Miningcore.Contracts.Contract;
+
+namespace Miningcore.Persistence;
+
+/// <summary>
+/// Routes connections by intent: writes go to the primary, reads are spread across
+/// read-only replicas as long as their replication lag stays within the bound of the intent.
+/// Falls back to the primary whenever no replica qualifies.
+/// </summary>
+public class ReplicaRoutingConnectionFactory : IConnectionFactory
+{
+    public ReplicaRoutingConnectionFactory(IConnectionFactory primary, IReadOnlyList<IConnectionFactory> replicas,
+        Func<IDbConnection, CancellationToken, Task<TimeSpan>> lagProbe, IMasterClock clock,
+        TimeSpan maxLag, TimeSpan maxStaleness, TimeSpan probeInterval)
+    {
+        Contract.RequiresNonNull(primary);
+        Contract.RequiresNonNull(replicas);
+        Contract.RequiresNonNull(lagProbe);
+        Contract.RequiresNonNull(clock);
+
+        this.primary = primary;
+        this.replicas = replicas.Select(x => new Replica(x)).ToArray();
+        this.lagProbe = lagProbe;
+        this.clock = clock;
+        this.maxLag = maxLag;
+        this.maxStaleness = maxStaleness;
+        this.probeInterval = probeInterval;
+    }
+
+    private static readonly ILogger logger = LogManager.GetCurrentClassLogger();
+
+    private readonly IConnectionFactory primary;
+    private readonly Replica[] replicas;
+    private readonly Func<IDbConnection, CancellationToken, Task<TimeSpan>> lagProbe;
+    private readonly IMasterClock clock;
+    private readonly TimeSpan maxLag;
+    private readonly TimeSpan maxStaleness;
+    private readonly TimeSpan probeInterval;
+    private int next = -1;
+
+    private class Replica
+    {
+        public Replica(IConnectionFactory factory)
+        {
+            Factory = factory;
+        }
+
+        public readonly IConnectionFactory Factory;
+
+        // last measured lag in ticks, long.MaxValue when unknown or unreachable
+        public long LagTicks = long.MaxValue;
+        public long ProbedTicks;
+        public int Probing;
+    }
+
+    public async Task<IDbConnection> OpenConnectionAsync(ConnectionIntent intent = ConnectionIntent.Write)
+    {
+        if(intent == ConnectionIntent.Write || replicas.Length == 0)
+            return await primary.OpenConnectionAsync(ConnectionIntent.Write);
+
+        var bound = intent == ConnectionIntent.Read ? maxLag : maxStaleness;
+        var start = (uint) Interlocked.Increment(ref next);
+
+        for(var i = 0; i < replicas.Length; i++)
+        {
+            var replica = replicas[(start + (uint) i) % (uint) replicas.Length];
+            var con = await TryOpenReplicaAsync(replica, bound);
+
+            if(con != null)
+                return con;
+        }
+
+        return await primary.OpenConnectionAsync(ConnectionIntent.Write);
+    }
+
+    private async Task<IDbConnection> TryOpenReplicaAsync(Replica replica, TimeSpan bound)
+    {
+        var now = clock.Now.Ticks;
+        var probeDue = now - Interlocked.Read(ref replica.ProbedTicks) >= probeInterval.Ticks;
+
+        // only one caller re-measures the lag, everybody else goes by the previous sample
+        var probe = probeDue && Interlocked.CompareExchange(ref replica.Probing, 1, 0) == 0;
+
+        // don't bother connecting to a replica known to be too far behind
+        if(!probe && Interlocked.Read(ref replica.LagTicks) > bound.Ticks)
+            return null;
+
+        IDbConnection con = null;
+
+        try
+        {
+            con = await replica.Factory.OpenConnectionAsync(ConnectionIntent.ReadStale);
+
+            if(probe)
+            {
+                var lag = await lagProbe(con, CancellationToken.None);
+
+                Interlocked.Exchange(ref replica.LagTicks, lag.Ticks);
+                Interlocked.Exchange(ref replica.ProbedTicks, now);
+
+                if(lag > maxStaleness)
+                    logger.Warn(() => $"Read replica is lagging {lag.TotalSeconds:0.#}s behind primary");
+            }
+
+            if(Interlocked.Read(ref replica.LagTicks) <= bound.Ticks)
+                return con;
+
+            con.Dispose();
+            return null;
+        }
+
+        catch(Exception ex)
+        {
+            con?.Dispose();
+
+            Interlocked.Exchange(ref replica.LagTicks, long.MaxValue);
+            Interlocked.Exchange(ref replica.ProbedTicks, now);
+
+            logger.Warn(() => $"Read replica unavailable, falling back to primary: {ex.Message}");
+            return null;
+        }
+
+        finally
+        {
+            if(probe)
+                Interlocked.Exchange(ref replica.Probing, 0);
+        }
+    }
+}
@@ -11,6 +11,8 @@ public interface IPaymentRepository
 
     Task<Payment[]> PagePaymentsAsync(IDbConnection con, string poolId, string address, int page, int pageSize, CancellationToken ct);
     Task<BalanceChange[]> PageBalanceChangesAsync(IDbConnection con, string poolId, string address, int page, int pageSize, CancellationToken ct);
+    Task<Payment[]> PagePaymentsAsync(IDbConnection con, string poolId, string address, PageCursor after, int pageSize, CancellationToken ct);
+    Task<BalanceChange[]> PageBalanceChangesAsync(IDbConnection con, string poolId, string address, PageCursor after, int pageSize, CancellationToken ct);
     Task<AmountByDate[]> PageMinerPaymentsByDayAsync(IDbConnection con, string poolId, string address, int page, int pageSize, CancellationToken ct);
     Task<uint> GetPaymentsCountAsync(IDbConnection con, string poolId, string address, CancellationToken ct);
     Task<uint> GetMinerPaymentsByDayCountAsync(IDbConnection con, string poolId, string address);
@@ -45,6 +45,8 @@ using Miningcore.Persistence;
 using Miningcore.Persistence.Dummy;
 using Miningcore.Persistence.Postgres;
 using Miningcore.Persistence.Postgres.Repositories;
+using Miningcore.Stratum;
+using Miningcore.Time;
 using Miningcore.Util;
 using NBitcoin.Zcash;
 using Newtonsoft.Json;
@@ -301,6 +303,9 @@ public class Program : BackgroundService
         {
             services.AddHostedService<ShareRecorder>();
             services.AddHostedService<ShareReceiver>();
+
+            if(clusterConfig.Persistence?.Postgres?.ShareStaging?.Enabled == true)
+                services.AddHostedService<ShareMerger>();
         }
 
         else
@@ -355,6 +360,23 @@ public class Program : BackgroundService
         var amConf = new MapperConfiguration(cfg => { cfg.AddProfile(new AutoMapperProfile()); });
         builder.Register((ctx, parms) => amConf.CreateMapper());
 
+        builder.Register(ctx => new MinerResponseCache(ctx.Resolve<IMessageBus>(), ctx.Resolve<IMasterClock>(),
+                clusterConfig.Api?.MinerResponseCacheSize ?? 10_000,
+                TimeSpan.FromSeconds(clusterConfig.Api?.MinerResponseCacheMaxAge ?? 60)))
+            .SingleInstance();
+
+        if(clusterConfig.StratumHandoff?.Enabled == true)
+        {
+            if(SessionHandoff.IsSupported)
+            {
+                builder.RegisterInstance(new SessionHandoff(clusterConfig.StratumHandoff.SocketPath,
+                    TimeSpan.FromSeconds(clusterConfig.StratumHandoff.Timeout ?? 300)));
+            }
+
+            else
+                logger.Warn(() => "Stratum handoff is not supported on this platform");
+        }
+
         ConfigurePersistence(builder);
     }
 
@@ -372,6 +394,12 @@ public class Program : BackgroundService
         var coinTemplates = LoadCoinTemplates();
         logger.Info($"{coinTemplates.Keys.Count} coins loaded from '{string.Join(", ", clusterConfig.CoinTemplates)}'");
 
+        // take over from a running instance or get ready to hand over to the next one
+        container.ResolveOptional<SessionHandoff>()?.Start(
+            id => pools.TryGetValue(id, out var pool) ? pool as StratumServer : null,
+            clusterConfig.Pools.Count(x => x.Enabled && x.EnableInternalStratum == true),
+            hal.StopApplication);
+
         var tasks = clusterConfig.Pools
             .Where(config => config.Enabled)
             .Select(config => RunPool(config, coinTemplates, ct));
@@ -791,6 +819,9 @@ public class Program : BackgroundService
         rmsmOptions.MaximumLargePoolFreeBytes = clusterConfig.Memory?.RmsmMaximumFreeLargePoolBytes ?? 0x800000;   // 8 MB
         rmsm = new RecyclableMemoryStreamManager(rmsmOptions);
 
+        // Configure native memory budget
+        NativeMemoryBudget.Default.Budget = clusterConfig.Memory?.NativeMemoryBudget ?? 0;
+
         // Configure Equihash
         EquihashSolver.messageBus = messageBus;
         EquihashSolver.MaxThreads = clusterConfig.EquihashMaxThreads ?? 1;
@@ -905,8 +936,66 @@ public class Program : BackgroundService
         if(string.IsNullOrEmpty(pgConfig.User))
             throw new PoolStartupException("Postgres configuration: invalid or missing 'user'");
 
+        if(pgConfig.ShareStaging?.MergeInterval <= 0)
+            throw new PoolStartupException("Postgres configuration: 'shareStaging.mergeInterval' must be greater than zero");
+
+        if(pgConfig.ShareStaging?.MergeBatchSize <= 0)
+            throw new PoolStartupException("Postgres configuration: 'shareStaging.mergeBatchSize' must be greater than zero");
+
         // build connection string
-        var connectionString = new StringBuilder($"Server={pgConfig.Host};Port={pgConfig.Port};Database={pgConfig.Database};User Id={pgConfig.User};Password={pgConfig.Password};");
+        var connectionString = BuildPostgresConnectionString(pgConfig, pgConfig);
+
+        logger.Debug(()=> $"Using postgres connection string: {connectionString}");
+
+        // register connection factory
+        if(pgConfig.Replicas?.Length > 0)
+        {
+            var replicas = pgConfig.Replicas.Select((replica, i) =>
+            {
+                if(string.IsNullOrEmpty(replica.Host))
+                    throw new PoolStartupException($"Postgres configuration: invalid or missing 'host' for replica {i}");
+
+                if(replica.Port == 0)
+                    throw new PoolStartupException($"Postgres configuration: invalid or missing 'port' for replica {i}");
+
+                var replicaConnectionString = BuildPostgresConnectionString(pgConfig, replica);
+
+                logger.Debug(()=> $"Using postgres replica connection string: {replicaConnectionString}");
+
+                return new PgConnectionFactory(replicaConnectionString);
+            }).ToArray();
+
+            var maxLag = TimeSpan.FromSeconds(pgConfig.MaxReplicaLag ?? 1);
+            var maxStaleness = TimeSpan.FromSeconds(pgConfig.MaxReplicaStaleness ?? 30);
+            var probeInterval = TimeSpan.FromSeconds(pgConfig.ReplicaLagCheckInterval ?? 5);
+
+            builder.Register(ctx => new ReplicaRoutingConnectionFactory(new PgConnectionFactory(connectionString), replicas,
+                    PgConnectionFactory.GetReplicationLagAsync, ctx.Resolve<IMasterClock>(), maxLag, maxStaleness, probeInterval))
+                .AsImplementedInterfaces()
+                .SingleInstance();
+        }
+
+        else
+        {
+            builder.RegisterInstance(new PgConnectionFactory(connectionString))
+                .AsImplementedInterfaces();
+        }
+
+        // register repositories
+        builder.RegisterAssemblyTypes(Assembly.GetExecutingAssembly())
+            .Where(t =>
+                t?.Namespace?.StartsWith(typeof(ShareRepository).Namespace) == true)
+            .AsImplementedInterfaces()
+            .SingleInstance();
+    }
+
+    private static string BuildPostgresConnectionString(PostgresConfig pgConfig, DatabaseConfig endpoint)
+    {
+        var database = !string.IsNullOrEmpty(endpoint.Database) ? endpoint.Database : pgConfig.Database;
+        var user = !string.IsNullOrEmpty(endpoint.User) ? endpoint.User : pgConfig.User;
+        var password = endpoint.Password ?? pgConfig.Password;
+
+        var connectionString = new StringBuilder($"Server={endpoint.Host};Port={endpoint.Port};Database={database};User Id={user};Password={password};");
 
         if(pgConfig.Tls)
         {
@@ -927,18 +1016,7 @@ public class Program : BackgroundService
 
         connectionString.Append($"CommandTimeout={pgConfig.CommandTimeout ?? 300};");
 
-        logger.Debug(()=> $"Using postgres connection string: {connectionString}");
-
-        // register connection factory
-        builder.RegisterInstance(new PgConnectionFactory(connectionString.ToString()))
-            .AsImplementedInterfaces();
-
-        // register repositories
-        builder.RegisterAssemblyTypes(Assembly.GetExecutingAssembly())
-            .Where(t =>
-                t?.Namespace?.StartsWith(typeof(ShareRepository).Namespace) == true)
-            .AsImplementedInterfaces()
-            .SingleInstance();
+        return connectionString.ToString();
     }
 
     private static void ConfigureDummyPersistence(ContainerBuilder builder)
@@ -39,6 +39,8 @@ public class RpcClient
         {
             ContractResolver = serializerSettings.ContractResolver!
         };
+
+        daemonKey = $"{(endPoint.Ssl || endPoint.Http2 ? Uri.UriSchemeHttps : Uri.UriSchemeHttp)}://{endPoint.User}@{endPoint.Host}:{endPoint.Port}{endPoint.HttpPath}";
     }
 
     private readonly JsonSerializerSettings serializerSettings;
@@ -46,6 +48,27 @@ public class RpcClient
     private readonly JsonSerializer serializer;
     private readonly IMessageBus messageBus;
     private readonly string poolId;
+    private readonly string daemonKey;
+
+    /// <summary>
+    /// Read-only methods shared with other clients of the same daemon and how long their results may be reused
+    /// </summary>
+    /// <remarks>
+    /// Names follow the Bitcoin daemon API, see <see cref="Coalescer"/> for which clients take part.
+    /// </remarks>
+    private static readonly Dictionary<string, TimeSpan> sharedMethods = new()
+    {
+        // kept short and dropped on every block notification, so a template never outlives its block
+        ["getblocktemplate"] = TimeSpan.FromMilliseconds(500),
+
+        ["getblockchaininfo"] = TimeSpan.FromSeconds(1),
+        ["getnetworkinfo"] = TimeSpan.FromSeconds(1),
+        ["getmininginfo"] = TimeSpan.FromSeconds(1),
+        ["getdifficulty"] = TimeSpan.FromSeconds(1),
+        ["getconnectioncount"] = TimeSpan.FromSeconds(1),
+        ["getinfo"] = TimeSpan.FromSeconds(1),
+        ["get_info"] = TimeSpan.FromSeconds(1),
+    };
 
     private static readonly HttpClient httpClient = new(new HttpClientHandler
     {
@@ -56,6 +79,15 @@ public class RpcClient
 
     #region API-Surface
 
+    /// <summary>
+    /// Coalesces read-only requests with other clients of the same daemon, null (the default) disables sharing
+    /// </summary>
+    /// <remarks>
+    /// Only set this where the owner calls <see cref="InvalidateSharedRequests"/> on every new block,
+    /// currently the Bitcoin family job managers.
+    /// </remarks>
+    public RpcRequestCoalescer Coalescer { get; set; }
+
     public async Task<RpcResponse<TResponse>> ExecuteAsync<TResponse>(ILogger logger, string method, CancellationToken ct,
         object payload = null, bool throwOnError = false)
         where TResponse : class
@@ -64,7 +96,7 @@ public class RpcClient
 
         try
         {
-            var response = await RequestAsync(logger, ct, config, method, payload);
+            var response = await RequestSharedAsync(logger, ct, method, payload);
 
             if(response.Result is JToken token)
                 return new RpcResponse<TResponse>(token.ToObject<TResponse>(serializer), response.Error);
@@ -110,6 +142,15 @@ public class RpcClient
         }
     }
 
+    /// <summary>
+    /// Stops handing out shared responses of this daemon that were requested before now
+    /// </summary>
+    /// <param name="token">Identifies the event, a block hash for example. Invalidations by other pools for the same token are ignored.</param>
+    public void InvalidateSharedRequests(string token = null)
+    {
+        Coalescer?.Invalidate(daemonKey, token);
+    }
+
     public IObservable<byte[]> WebsocketSubscribe(ILogger logger, CancellationToken ct, DaemonEndpointConfig endPoint,
         string method, object payload = null,
         JsonSerializerSettings payloadJsonSerializerSettings = null)
@@ -132,6 +173,18 @@ public class RpcClient
 
     #endregion // API-Surface
 
+    private Task<JsonRpcResponse> RequestSharedAsync(ILogger logger, CancellationToken ct, string method, object payload)
+    {
+        if(Coalescer == null || !sharedMethods.TryGetValue(method, out var maxAge))
+            return RequestAsync(logger, ct, config, method, payload);
+
+        var key = $"{method} {JsonConvert.SerializeObject(payload, serializerSettings)}";
+
+        // a shared request outlives the caller that started it
+        return Coalescer.RunAsync(daemonKey, key, maxAge, () => RequestAsync(logger, CancellationToken.None, config, method, payload))
+            .WaitAsync(ct);
+    }
+
     private async Task<JsonRpcResponse> RequestAsync(ILogger logger, CancellationToken ct, DaemonEndpointConfig endPoint, string method, object payload)
     {
         var sw = Stopwatch.StartNew();
@@ -0,0 +1,149 @@
+using System.Collections.Concurrent;
+using Miningcore.JsonRpc;
+using Miningcore.Time;
+
+namespace Miningcore.Rpc;
+
+/// <summary>
+/// Process-wide single-flight cache for read-only daemon requests
+/// </summary>
+/// <remarks>
+/// Pools talking to the same daemon share requests by key (daemon, method and parameters).
+/// A caller joins a request that is still in flight or that completed no longer than maxAge ago,
+/// otherwise it starts a new one. Failed requests are never cached.
+/// Invalidating a daemon (for example on a new block notification) prevents callers from joining
+/// any request to it that started before, so a stale template is never handed out after a block.
+/// </remarks>
+public class RpcRequestCoalescer
+{
+    public RpcRequestCoalescer(IMasterClock clock = null)
+    {
+        this.clock = clock ?? new StandardClock();
+    }
+
+    private class Flight
+    {
+        public Flight(DateTime started, Task<JsonRpcResponse> task)
+        {
+            Started = started;
+            Task = task;
+        }
+
+        public DateTime Started { get; }
+        public Task<JsonRpcResponse> Task { get; }
+
+        // DateTime ticks, zero while in flight
+        public long Completed;
+    }
+
+    private record Invalidation(DateTime Time, string Token);
+
+    private readonly IMasterClock clock;
+    private readonly ConcurrentDictionary<string, Flight> flights = new();
+    private readonly ConcurrentDictionary<string, Invalidation> invalidations = new();
+
+    private long requests;
+    private long coalesced;
+
+    /// <summary>
+    /// Cache shared by all RPC clients of this process
+    /// </summary>
+    public static RpcRequestCoalescer Default { get; set; } = new();
+
+    /// <summary>
+    /// Total number of requests routed through this instance
+    /// </summary>
+    public long Requests => Interlocked.Read(ref requests);
+
+    /// <summary>
+    /// Number of requests answered by joining another caller's request
+    /// </summary>
+    public long Coalesced => Interlocked.Read(ref coalesced);
+
+    /// <summary>
+    /// Returns the result of an in-flight or recent request for key or executes a new one
+    /// </summary>
+    /// <param name="daemon">Daemon the request is sent to, scope of <see cref="Invalidate"/></param>
+    /// <param name="key">Identifies the request within the daemon's scope</param>
+    /// <param name="maxAge">How long a completed response may be reused, zero joins in-flight requests only</param>
+    /// <param name="execute">Executes the request, must not depend on a caller's cancellation token</param>
+    public Task<JsonRpcResponse> RunAsync(string daemon, string key, TimeSpan maxAge, Func<Task<JsonRpcResponse>> execute)
+    {
+        Interlocked.Increment(ref requests);
+
+        var cacheKey = daemon + "\n" + key;
+        var now = clock.Now;
+
+        invalidations.TryGetValue(daemon, out var invalidation);
+
+        while(true)
+        {
+            if(flights.TryGetValue(cacheKey, out var existing) && IsUsable(existing, now, maxAge, invalidation))
+            {
+                Interlocked.Increment(ref coalesced);
+                return existing.Task;
+            }
+
+            var tcs = new TaskCompletionSource<JsonRpcResponse>(TaskCreationOptions.RunContinuationsAsynchronously);
+            var flight = new Flight(now, tcs.Task);
+
+            var won = existing != null ?
+                flights.TryUpdate(cacheKey, flight, existing) :
+                flights.TryAdd(cacheKey, flight);
+
+            // lost the race against another caller, try joining its request
+            if(!won)
+                continue;
+
+            Execute(cacheKey, flight, tcs, execute);
+
+            return flight.Task;
+        }
+    }
+
+    /// <summary>
+    /// Prevents requests to daemon that started before now from being reused
+    /// </summary>
+    /// <param name="token">Identifies the event (a block hash for example). Repeated invalidations with the same token are ignored,
+    /// so pools receiving the same notification one after another don't discard each other's fresh requests.</param>
+    public void Invalidate(string daemon, string token = null)
+    {
+        var invalidation = new Invalidation(clock.Now, token);
+
+        invalidations.AddOrUpdate(daemon, invalidation, (_, existing) =>
+            token != null && existing.Token == token ? existing : invalidation);
+    }
+
+    private static bool IsUsable(Flight flight, DateTime now, TimeSpan maxAge, Invalidation invalidation)
+    {
+        if(invalidation != null && flight.Started < invalidation.Time)
+            return false;
+
+        var completed = Interlocked.Read(ref flight.Completed);
+
+        return completed == 0 || now.Ticks - completed <= maxAge.Ticks;
+    }
+
+    private async void Execute(string cacheKey, Flight flight, TaskCompletionSource<JsonRpcResponse> tcs,
+        Func<Task<JsonRpcResponse>> execute)
+    {
+        try
+        {
+            var response = await execute();
+
+            Interlocked.Exchange(ref flight.Completed, clock.Now.Ticks);
+
+            if(response?.Error != null)
+                flights.TryRemove(new KeyValuePair<string, Flight>(cacheKey, flight));
+
+            tcs.SetResult(response);
+        }
+
+        catch(Exception ex)
+        {
+            flights.TryRemove(new KeyValuePair<string, Flight>(cacheKey, flight));
+
+            tcs.SetException(ex);
+        }
+    }
+}
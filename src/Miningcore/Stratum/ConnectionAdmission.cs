@@ -0,0 +1,257 @@
+using System.Buffers.Binary;
+using System.Collections.Concurrent;
+using System.Diagnostics;
+using System.Net;
+using Miningcore.Configuration;
+using Miningcore.Contracts;
+
+namespace Miningcore.Stratum;
+
+public enum AdmissionResult
+{
+    Accepted,
+    AddressRate,
+    PrefixRate,
+    AddressLimit,
+    PrefixLimit,
+}
+
+public readonly record struct AdmissionCounters(long Accepted, long AddressRate, long PrefixRate, long AddressLimit, long PrefixLimit);
+
+/// <summary>
+/// Accept-time admission control by remote address and by its /24 (IPv4) or /64 (IPv6) prefix
+/// </summary>
+/// <remarks>
+/// Token buckets limit how fast new connections come in, caps limit how many are open at once.
+/// Cheap enough to run on the accept loop for every socket. Every admitted connection must be released exactly once.
+/// </remarks>
+public class ConnectionAdmission
+{
+    public ConnectionAdmission(StratumAdmissionConfig config)
+    {
+        Contract.RequiresNonNull(config);
+
+        addressRate = config.ConnectRate ?? 0;
+        addressBurst = config.ConnectBurst ?? DefaultAddressBurst;
+        prefixRate = config.PrefixConnectRate ?? 0;
+        prefixBurst = config.PrefixConnectBurst ?? DefaultPrefixBurst;
+        maxPerAddress = config.MaxConnectionsPerAddress ?? 0;
+        maxPerPrefix = config.MaxConnectionsPerPrefix ?? 0;
+    }
+
+    private const int DefaultAddressBurst = 10;
+    private const int DefaultPrefixBurst = 100;
+
+    private readonly record struct Key(ulong High, ulong Low);
+
+    private class Entry
+    {
+        public Entry(double tokens, long refilled)
+        {
+            Tokens = tokens;
+            Refilled = refilled;
+        }
+
+        public double Tokens;
+        public long Refilled;
+        public int Connections;
+        public bool Removed;
+    }
+
+    private readonly double addressRate;
+    private readonly int addressBurst;
+    private readonly double prefixRate;
+    private readonly int prefixBurst;
+    private readonly int maxPerAddress;
+    private readonly int maxPerPrefix;
+
+    private readonly ConcurrentDictionary<Key, Entry> addresses = new();
+    private readonly ConcurrentDictionary<Key, Entry> prefixes = new();
+    private readonly long[] counters = new long[(int) AdmissionResult.PrefixLimit + 1];
+
+    /// <summary>
+    /// Number of addresses and prefixes currently tracked
+    /// </summary>
+    public int Count => addresses.Count + prefixes.Count;
+
+    /// <summary>
+    /// Decides whether a new connection from address may be accepted and counts it if so
+    /// </summary>
+    public AdmissionResult TryAdmit(IPAddress address)
+    {
+        var key = GetKey(address, out var prefixKey);
+        AdmissionResult result;
+
+        while(true)
+        {
+            var now = Stopwatch.GetTimestamp();
+            var entry = addresses.GetOrAdd(key, static (_, x) => new Entry(x.Burst, x.Now), (Burst: addressBurst, Now: now));
+            var prefix = prefixes.GetOrAdd(prefixKey, static (_, x) => new Entry(x.Burst, x.Now), (Burst: prefixBurst, Now: now));
+
+            // always prefix first
+            lock(prefix)
+            {
+                lock(entry)
+                {
+                    // lost a race with Prune
+                    if(entry.Removed || prefix.Removed)
+                        continue;
+
+                    if(maxPerAddress > 0 && entry.Connections >= maxPerAddress)
+                        result = AdmissionResult.AddressLimit;
+                    else if(maxPerPrefix > 0 && prefix.Connections >= maxPerPrefix)
+                        result = AdmissionResult.PrefixLimit;
+                    else if(addressRate > 0 && Refill(entry, addressRate, addressBurst, now) < 1)
+                        result = AdmissionResult.AddressRate;
+                    else if(prefixRate > 0 && Refill(prefix, prefixRate, prefixBurst, now) < 1)
+                        result = AdmissionResult.PrefixRate;
+                    else
+                    {
+                        if(addressRate > 0)
+                            entry.Tokens--;
+
+                        if(prefixRate > 0)
+                            prefix.Tokens--;
+
+                        entry.Connections++;
+                        prefix.Connections++;
+
+                        result = AdmissionResult.Accepted;
+                    }
+                }
+            }
+
+            break;
+        }
+
+        Interlocked.Increment(ref counters[(int) result]);
+        return result;
+    }
+
+    /// <summary>
+    /// Counts a connection that bypasses admission, like a session taken over from another process
+    /// </summary>
+    public void Acquire(IPAddress address)
+    {
+        var key = GetKey(address, out var prefixKey);
+
+        while(true)
+        {
+            var now = Stopwatch.GetTimestamp();
+            var entry = addresses.GetOrAdd(key, static (_, x) => new Entry(x.Burst, x.Now), (Burst: addressBurst, Now: now));
+            var prefix = prefixes.GetOrAdd(prefixKey, static (_, x) => new Entry(x.Burst, x.Now), (Burst: prefixBurst, Now: now));
+
+            lock(prefix)
+            {
+                lock(entry)
+                {
+                    if(entry.Removed || prefix.Removed)
+                        continue;
+
+                    entry.Connections++;
+                    prefix.Connections++;
+                    return;
+                }
+            }
+        }
+    }
+
+    /// <summary>
+    /// Releases a connection previously admitted or acquired
+    /// </summary>
+    public void Release(IPAddress address)
+    {
+        var key = GetKey(address, out var prefixKey);
+
+        // entries with open connections are never pruned
+        if(addresses.TryGetValue(key, out var entry))
+        {
+            lock(entry)
+            {
+                entry.Connections = Math.Max(0, entry.Connections - 1);
+            }
+        }
+
+        if(prefixes.TryGetValue(prefixKey, out var prefix))
+        {
+            lock(prefix)
+            {
+                prefix.Connections = Math.Max(0, prefix.Connections - 1);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Forgets addresses and prefixes without open connections whose buckets have filled up again
+    /// </summary>
+    public int Prune()
+    {
+        var now = Stopwatch.GetTimestamp();
+
+        return Prune(addresses, addressRate, addressBurst, now) +
+            Prune(prefixes, prefixRate, prefixBurst, now);
+    }
+
+    public AdmissionCounters GetCounters()
+    {
+        return new AdmissionCounters(
+            Interlocked.Read(ref counters[(int) AdmissionResult.Accepted]),
+            Interlocked.Read(ref counters[(int) AdmissionResult.AddressRate]),
+            Interlocked.Read(ref counters[(int) AdmissionResult.PrefixRate]),
+            Interlocked.Read(ref counters[(int) AdmissionResult.AddressLimit]),
+            Interlocked.Read(ref counters[(int) AdmissionResult.PrefixLimit]));
+    }
+
+    private static int Prune(ConcurrentDictionary<Key, Entry> entries, double rate, int burst, long now)
+    {
+        var count = 0;
+
+        foreach(var (key, entry) in entries)
+        {
+            lock(entry)
+            {
+                if(entry.Connections > 0 || (rate > 0 && Refill(entry, rate, burst, now) < burst))
+                    continue;
+
+                entry.Removed = true;
+                entries.TryRemove(key, out _);
+                count++;
+            }
+        }
+
+        return count;
+    }
+
+    private static double Refill(Entry entry, double rate, int burst, long now)
+    {
+        var elapsed = (double) (now - entry.Refilled) / Stopwatch.Frequency;
+
+        entry.Tokens = Math.Min(burst, entry.Tokens + elapsed * rate);
+        entry.Refilled = now;
+
+        return entry.Tokens;
+    }
+
+    private static Key GetKey(IPAddress address, out Key prefix)
+    {
+        Span<byte> bytes = stackalloc byte[16];
+
+        if(!address.TryWriteBytes(bytes, out var written))
+            throw new ArgumentException("Unsupported address", nameof(address));
+
+        if(written == 4 || address.IsIPv4MappedToIPv6)
+        {
+            var v4 = BinaryPrimitives.ReadUInt32BigEndian(written == 4 ? bytes : bytes[12..]);
+
+            // outside of any IPv6 /64 in use
+            prefix = new Key(ulong.MaxValue, v4 & 0xffffff00);
+            return new Key(ulong.MaxValue, v4);
+        }
+
+        var high = BinaryPrimitives.ReadUInt64BigEndian(bytes);
+        var low = BinaryPrimitives.ReadUInt64BigEndian(bytes[8..]);
+
+        prefix = new Key(high, 0);
+        return new Key(high, low);
+    }
+}
@@ -0,0 +1,484 @@
+using System.Net.Sockets;
+using System.Runtime.InteropServices;
+using System.Text;
+using Miningcore.Native;
+using Newtonsoft.Json;
+using Newtonsoft.Json.Converters;
+using Newtonsoft.Json.Serialization;
+using NLog;
+using static Miningcore.Util.ActionUtils;
+
+namespace Miningcore.Stratum;
+
+public enum SessionHandoffMessageType
+{
+    /// <summary>
+    /// Successor asks for the sockets and sessions of a pool
+    /// </summary>
+    Request,
+
+    /// <summary>
+    /// A live connection (one descriptor attached)
+    /// </summary>
+    Session,
+
+    /// <summary>
+    /// Listening sockets (one descriptor per port attached)
+    /// </summary>
+    Listeners,
+
+    /// <summary>
+    /// Nothing more to come for this pool
+    /// </summary>
+    Done,
+
+    /// <summary>
+    /// Successor is up, the predecessor may exit
+    /// </summary>
+    Release,
+}
+
+public class SessionHandoffMessage
+{
+    public SessionHandoffMessageType Type { get; set; }
+    public string PoolId { get; set; }
+    public int[] Ports { get; set; }
+    public StratumSessionState State { get; set; }
+}
+
+/// <summary>
+/// Zero-downtime restarts: a starting instance (the successor) connects to the Unix domain socket
+/// of the running one (the predecessor) and receives listening sockets and live stratum sessions
+/// of each of its pools via SCM_RIGHTS, along with the serialized worker state of every session.
+/// Once all of its pools are up, the successor releases the predecessor and takes over the
+/// handoff socket for the next restart. Linux only.
+/// </summary>
+/// <remarks>
+/// The handoff socket is only accessible to its owner and both ends check that the peer runs under
+/// the same user before any descriptor changes hands.
+/// </remarks>
+public class SessionHandoff : IDisposable
+{
+    public SessionHandoff(string socketPath, TimeSpan timeout)
+    {
+        this.socketPath = socketPath;
+        this.timeout = timeout;
+    }
+
+    private static readonly ILogger logger = LogManager.GetCurrentClassLogger();
+
+    private const int MaxMessageSize = 0x40000;
+    private const int MaxDescriptors = 64;
+    private const int EAGAIN = 11;
+    private const int EINTR = 4;
+    private const uint SocketMode = 0x180; // 0600
+    private static readonly TimeSpan pollInterval = TimeSpan.FromMilliseconds(100);
+
+    private static readonly JsonSerializerSettings serializerSettings = new()
+    {
+        ContractResolver = new CamelCasePropertyNamesContractResolver(),
+        NullValueHandling = NullValueHandling.Ignore,
+        Converters = { new StringEnumConverter() }
+    };
+
+    private readonly string socketPath;
+    private readonly TimeSpan timeout;
+    private readonly CancellationTokenSource cts = new();
+    private Func<string, StratumServer> lookup;
+    private Action released;
+    private Socket listener;
+    private int pendingPools;
+    private int isReleased;
+
+    public bool IsSuccessor { get; private set; }
+
+    public static bool IsSupported => RuntimeInformation.IsOSPlatform(OSPlatform.Linux);
+
+    /// <summary>
+    /// Determines whether another instance is running and either prepares to take over from it
+    /// or starts accepting handoff requests
+    /// </summary>
+    /// <param name="lookup">Resolves the stratum server of a pool by id</param>
+    /// <param name="poolCount">Number of pools expected to report via <see cref="OnPoolReady"/></param>
+    /// <param name="released">Invoked once a successor has taken over</param>
+    public void Start(Func<string, StratumServer> lookup, int poolCount, Action released)
+    {
+        this.lookup = lookup;
+        this.released = released;
+
+        using(var probe = Connect())
+        {
+            IsSuccessor = probe != null;
+        }
+
+        if(IsSuccessor)
+        {
+            logger.Info(() => $"Running instance found at {socketPath}, taking over its stratum sessions");
+
+            pendingPools = poolCount;
+
+            // don't wait forever for pools that fail to start
+            Task.Run(async () =>
+            {
+                if(poolCount > 0)
+                    await Task.Delay(timeout, cts.Token);
+
+                await ReleaseAsync();
+            }, cts.Token);
+        }
+
+        else
+            Listen();
+    }
+
+    /// <summary>
+    /// Successor side: requests the sockets and sessions of a pool from the predecessor.
+    /// Returns the channel to read them from or null if there is nothing to take over.
+    /// </summary>
+    public async Task<Socket> RequestAsync(string poolId, CancellationToken ct)
+    {
+        if(!IsSuccessor || Volatile.Read(ref isReleased) != 0)
+            return null;
+
+        var channel = Connect();
+
+        if(channel == null)
+            return null;
+
+        try
+        {
+            await SendAsync(channel, new SessionHandoffMessage { Type = SessionHandoffMessageType.Request, PoolId = poolId }, null, ct);
+        }
+
+        catch
+        {
+            channel.Dispose();
+            throw;
+        }
+
+        return channel;
+    }
+
+    /// <summary>
+    /// Successor side: signals that a pool is serving. The predecessor is released once all pools have reported.
+    /// </summary>
+    public void OnPoolReady(string poolId)
+    {
+        if(IsSuccessor && Interlocked.Decrement(ref pendingPools) == 0)
+            _ = ReleaseAsync();
+    }
+
+    private async Task ReleaseAsync()
+    {
+        if(Interlocked.Exchange(ref isReleased, 1) != 0)
+            return;
+
+        await Guard(async () =>
+        {
+            using var channel = Connect();
+
+            if(channel != null)
+            {
+                await SendAsync(channel, new SessionHandoffMessage { Type = SessionHandoffMessageType.Release }, null, cts.Token);
+
+                // wait for the predecessor to let go of the handoff socket
+                var (_, descriptors) = await ReceiveAsync(channel, cts.Token);
+                Close(descriptors);
+
+                logger.Info(() => "Released previous instance");
+            }
+        }, ex => logger.Warn(() => $"Failed to release previous instance: {ex.Message}"));
+
+        // next in line
+        Guard(Listen, ex => logger.Error(() => $"Unable to listen for handoff requests on {socketPath}: {ex.Message}"));
+    }
+
+    private Socket Connect()
+    {
+        if(!File.Exists(socketPath))
+            return null;
+
+        var socket = new Socket(AddressFamily.Unix, SocketType.Seqpacket, ProtocolType.Unspecified);
+
+        try
+        {
+            socket.Connect(new UnixDomainSocketEndPoint(socketPath));
+        }
+
+        catch(SocketException)
+        {
+            // stale socket file
+            socket.Dispose();
+            return null;
+        }
+
+        try
+        {
+            VerifyPeer(socket);
+        }
+
+        catch
+        {
+            socket.Dispose();
+            throw;
+        }
+
+        return socket;
+    }
+
+    /// <summary>
+    /// Throws unless the process at the other end of the channel runs under our own user
+    /// </summary>
+    private static unsafe void VerifyPeer(Socket channel)
+    {
+        LibC.ucred cred;
+        var length = (uint) sizeof(LibC.ucred);
+
+        if(LibC.getsockopt((int) channel.Handle, LibC.SOL_SOCKET, LibC.SO_PEERCRED, &cred, &length) != 0)
+            throw new IOException($"Unable to determine handoff peer credentials (errno {Marshal.GetLastWin32Error()})");
+
+        var uid = LibC.geteuid();
+
+        if(cred.uid != uid)
+            throw new UnauthorizedAccessException($"Handoff peer (pid {cred.pid}) runs as uid {cred.uid}, expected {uid}");
+    }
+
+    private void Listen()
+    {
+        if(File.Exists(socketPath))
+            File.Delete(socketPath);
+
+        listener = new Socket(AddressFamily.Unix, SocketType.Seqpacket, ProtocolType.Unspecified);
+        listener.Bind(new UnixDomainSocketEndPoint(socketPath));
+
+        // before listening, nobody can connect yet
+        if(LibC.chmod(socketPath, SocketMode) != 0)
+            throw new IOException($"Unable to restrict access to {socketPath} (errno {Marshal.GetLastWin32Error()})");
+
+        listener.Listen();
+
+        logger.Info(() => $"Accepting stratum handoff requests on {socketPath}");
+
+        Task.Run(() => AcceptAsync(listener, cts.Token));
+    }
+
+    private async Task AcceptAsync(Socket socket, CancellationToken ct)
+    {
+        while(!ct.IsCancellationRequested)
+        {
+            Socket channel;
+
+            try
+            {
+                channel = await socket.AcceptAsync(ct);
+            }
+
+            catch(Exception ex) when(ex is OperationCanceledException or ObjectDisposedException)
+            {
+                break;
+            }
+
+            if(!await ServeAsync(channel, ct))
+                break;
+        }
+    }
+
+    /// <summary>
+    /// Predecessor side. Returns false once released.
+    /// </summary>
+    private async Task<bool> ServeAsync(Socket channel, CancellationToken ct)
+    {
+        using(channel)
+        {
+            try
+            {
+                VerifyPeer(channel);
+
+                var (msg, descriptors) = await ReceiveAsync(channel, ct);
+                Close(descriptors);
+
+                switch(msg?.Type)
+                {
+                    case SessionHandoffMessageType.Request:
+                        var server = lookup?.Invoke(msg.PoolId);
+
+                        if(server != null)
+                            await server.HandoffAsync(channel, ct);
+                        else
+                            await SendAsync(channel, new SessionHandoffMessage { Type = SessionHandoffMessageType.Done, PoolId = msg.PoolId }, null, ct);
+                        break;
+
+                    case SessionHandoffMessageType.Release:
+                        logger.Info(() => "Successor has taken over");
+
+                        listener.Dispose();
+                        released?.Invoke();
+                        return false;
+                }
+            }
+
+            catch(Exception ex)
+            {
+                logger.Error(() => $"Stratum handoff failed: {ex.Message}");
+            }
+        }
+
+        return true;
+    }
+
+    #region Transport
+
+    public static Task SendAsync(Socket channel, SessionHandoffMessage msg, IReadOnlyList<int> descriptors, CancellationToken ct)
+    {
+        var payload = Encoding.UTF8.GetBytes(JsonConvert.SerializeObject(msg, serializerSettings));
+
+        if(payload.Length > MaxMessageSize)
+            throw new InvalidDataException($"Handoff message exceeds maximum of {MaxMessageSize} bytes");
+
+        if(descriptors?.Count > MaxDescriptors)
+            throw new InvalidDataException($"Too many descriptors for a single handoff message: {descriptors.Count}");
+
+        return Task.Run(() => Send(channel, payload, descriptors, ct), ct);
+    }
+
+    /// <summary>
+    /// Returns a null message if the peer has closed the channel. Received descriptors are owned by the caller.
+    /// </summary>
+    public static async Task<(SessionHandoffMessage Message, int[] Descriptors)> ReceiveAsync(Socket channel, CancellationToken ct)
+    {
+        var (payload, descriptors) = await Task.Run(() => Receive(channel, ct), ct);
+
+        try
+        {
+            var msg = payload?.Length > 0 ? JsonConvert.DeserializeObject<SessionHandoffMessage>(Encoding.UTF8.GetString(payload), serializerSettings) : null;
+
+            return (msg, descriptors);
+        }
+
+        catch
+        {
+            Close(descriptors);
+            throw;
+        }
+    }
+
+    public static void Close(IEnumerable<int> descriptors)
+    {
+        if(descriptors == null)
+            return;
+
+        foreach(var fd in descriptors)
+            LibC.close(fd);
+    }
+
+    private static unsafe void Send(Socket channel, byte[] payload, IReadOnlyList<int> descriptors, CancellationToken ct)
+    {
+        var count = descriptors?.Count ?? 0;
+        var controlLength = count > 0 ? LibC.CMSG_SPACE(count * sizeof(int)) : 0;
+        var control = stackalloc byte[LibC.CMSG_SPACE(MaxDescriptors * sizeof(int))];
+
+        fixed(byte* data = payload)
+        {
+            var iov = new LibC.iovec { iov_base = data, iov_len = (nuint) payload.Length };
+            var msg = new LibC.msghdr { msg_iov = &iov, msg_iovlen = 1 };
+
+            if(count > 0)
+            {
+                new Span<byte>(control, controlLength).Clear();
+
+                var cmsg = (LibC.cmsghdr*) control;
+                cmsg->cmsg_len = (nuint) LibC.CMSG_LEN(count * sizeof(int));
+                cmsg->cmsg_level = LibC.SOL_SOCKET;
+                cmsg->cmsg_type = LibC.SCM_RIGHTS;
+
+                var fds = (int*) LibC.CMSG_DATA(cmsg);
+
+                for(var i = 0; i < count; i++)
+                    fds[i] = descriptors[i];
+
+                msg.msg_control = control;
+                msg.msg_controllen = (nuint) controlLength;
+            }
+
+            while(true)
+            {
+                var result = LibC.sendmsg((int) channel.Handle, &msg, LibC.MSG_NOSIGNAL);
+
+                if(result >= 0)
+                {
+                    if(result != payload.Length)
+                        throw new IOException($"Short write on handoff channel ({result} of {payload.Length} bytes)");
+
+                    return;
+                }
+
+                Wait(channel, Marshal.GetLastWin32Error(), SelectMode.SelectWrite, ct);
+            }
+        }
+    }
+
+    private static unsafe (byte[], int[]) Receive(Socket channel, CancellationToken ct)
+    {
+        var buffer = new byte[MaxMessageSize];
+        var controlLength = LibC.CMSG_SPACE(MaxDescriptors * sizeof(int));
+        var control = stackalloc byte[controlLength];
+
+        fixed(byte* data = buffer)
+        {
+            var iov = new LibC.iovec { iov_base = data, iov_len = (nuint) buffer.Length };
+            var msg = new LibC.msghdr { msg_iov = &iov, msg_iovlen = 1, msg_control = control, msg_controllen = (nuint) controlLength };
+
+            nint result;
+
+            while((result = LibC.recvmsg((int) channel.Handle, &msg, LibC.MSG_CMSG_CLOEXEC)) < 0)
+                Wait(channel, Marshal.GetLastWin32Error(), SelectMode.SelectRead, ct);
+
+            // collect descriptors first so that they get closed if anything is wrong with the message
+            var descriptors = new List<int>();
+            var header = msg.msg_controllen >= (nuint) sizeof(LibC.cmsghdr) ? (LibC.cmsghdr*) control : null;
+
+            while(header != null)
+            {
+                if(header->cmsg_level == LibC.SOL_SOCKET && header->cmsg_type == LibC.SCM_RIGHTS)
+                {
+                    var n = ((int) header->cmsg_len - LibC.CMSG_LEN(0)) / sizeof(int);
+                    var fds = (int*) LibC.CMSG_DATA(header);
+
+                    for(var i = 0; i < n; i++)
+                        descriptors.Add(fds[i]);
+                }
+
+                var next = (byte*) header + LibC.CMSG_ALIGN((int) header->cmsg_len);
+
+                header = header->cmsg_len > 0 && next + sizeof(LibC.cmsghdr) <= control + (int) msg.msg_controllen ?
+                    (LibC.cmsghdr*) next : null;
+            }
+
+            if((msg.msg_flags & (LibC.MSG_TRUNC | LibC.MSG_CTRUNC)) != 0)
+            {
+                Close(descriptors);
+                throw new InvalidDataException("Truncated handoff message");
+            }
+
+            return (buffer[..(int) result], descriptors.ToArray());
+        }
+    }
+
+    private static void Wait(Socket channel, int errno, SelectMode mode, CancellationToken ct)
+    {
+        if(errno != EAGAIN && errno != EINTR)
+            throw new IOException($"Handoff channel error (errno {errno})");
+
+        ct.ThrowIfCancellationRequested();
+
+        channel.Poll((int) pollInterval.TotalMilliseconds * 1000, mode);
+    }
+
+    #endregion // Transport
+
+    public void Dispose()
+    {
+        cts.Cancel();
+        listener?.Dispose();
+    }
+}
@@ -7,6 +7,7 @@ using System.Reactive;
 using System.Reactive.Disposables;
 using System.Reactive.Linq;
 using System.Reactive.Subjects;
+using System.Runtime.ExceptionServices;
 using System.Security.Authentication;
 using System.Security.Cryptography.X509Certificates;
 using System.Text;
@@ -16,6 +17,7 @@ using Miningcore.Configuration;
 using Miningcore.Extensions;
 using Miningcore.JsonRpc;
 using Miningcore.Mining;
+using Miningcore.Native;
 using Miningcore.Time;
 using Miningcore.Util;
 using Newtonsoft.Json;
@@ -27,7 +29,8 @@ namespace Miningcore.Stratum;
 
 public class StratumConnection
 {
-    public StratumConnection(ILogger logger, RecyclableMemoryStreamManager rmsm, IMasterClock clock, string connectionId, bool gpdrCompliantLogging)
+    public StratumConnection(ILogger logger, RecyclableMemoryStreamManager rmsm, IMasterClock clock, string connectionId, bool gpdrCompliantLogging,
+        TimerWheel timerWheel = null)
     {
         this.logger = logger;
         this.rmsm = rmsm;
@@ -43,6 +46,8 @@ public class StratumConnection
         ConnectionId = connectionId;
         IsAlive = true;
         this.gpdrCompliantLogging = gpdrCompliantLogging;
+
+        sendTimer = timerWheel?.CreateTimer(OnSendTimeout);
     }
 
     private readonly ILogger logger;
@@ -57,8 +62,19 @@ public class StratumConnection
     private readonly BufferBlock<object> sendQueue;
     private WorkerContextBase context;
     private readonly Subject<Unit> terminated = new();
+    private CancellationTokenSource receiveCts;
+    private TaskCompletionSource<DetachedConnection> detach;
+    private byte[] pendingReceive;
     private bool expectingProxyHeader;
     private bool gpdrCompliantLogging;
+    private SemaphoreSlim pipelineSlots;
+    private int pipelineDepth;
+    private Exception pipelineError;
+    private readonly TimerWheel.Timer sendTimer;
+    private CancellationTokenSource sendCts;
+
+    // Environment.TickCount64 when the message being sent was started, zero while idle
+    private long sendStarted;
 
     private static readonly JsonSerializer serializer = new()
     {
@@ -66,6 +82,21 @@ public class StratumConnection
     };
 
     private const int SendQueueCapacity = 16;
+
+    /// <summary>
+    /// Upper bound for <see cref="PoolEndpoint.PipelineDepth"/>, every pipelined request may have a response queued
+    /// </summary>
+    public const int MaxPipelineDepth = SendQueueCapacity / 2;
+
+    // Share submissions across the supported protocols. They only read connection state and
+    // every response carries the id of its request, so they may complete out of order.
+    private static readonly HashSet<string> pipelinedMethods = new()
+    {
+        "mining.submit",
+        "eth_submitWork",
+        "submit",
+    };
+
     private static readonly TimeSpan sendTimeout = TimeSpan.FromMilliseconds(5000);
 
     #region API-Surface
@@ -81,6 +112,34 @@ public class StratumConnection
 
         expectingProxyHeader = endpoint.PoolEndpoint.TcpProxyProtocol?.Enable == true;
 
+        await RunAsync(socket, ct, endpoint, cert, true, onRequestAsync, onCompleted, onError);
+    }
+
+    /// <summary>
+    /// Picks up a session handed over by another process
+    /// </summary>
+    /// <param name="pending">Inbound data the previous owner had received but not yet processed</param>
+    public async void ResumeAsync(Socket socket, CancellationToken ct,
+        StratumEndpoint endpoint, IPEndPoint remoteEndpoint, byte[] pending,
+        Func<StratumConnection, JsonRpcRequest, CancellationToken, Task> onRequestAsync,
+        Action<StratumConnection> onCompleted,
+        Action<StratumConnection, Exception> onError)
+    {
+        LocalEndpoint = endpoint.IPEndPoint;
+        RemoteEndpoint = remoteEndpoint;
+
+        if(pending?.Length > 0)
+            await receivePipe.Writer.WriteAsync(pending, ct);
+
+        await RunAsync(socket, ct, endpoint, null, false, onRequestAsync, onCompleted, onError);
+    }
+
+    private async Task RunAsync(Socket socket, CancellationToken ct,
+        StratumEndpoint endpoint, X509Certificate2 cert, bool handshake,
+        Func<StratumConnection, JsonRpcRequest, CancellationToken, Task> onRequestAsync,
+        Action<StratumConnection> onCompleted,
+        Action<StratumConnection, Exception> onError)
+    {
         try
         {
             // prepare socket
@@ -90,14 +149,24 @@ public class StratumConnection
             // create stream
             networkStream = new NetworkStream(socket, true);
 
+            if(endpoint.PoolEndpoint.PipelineDepth > 1)
+            {
+                pipelineDepth = Math.Min(endpoint.PoolEndpoint.PipelineDepth.Value, MaxPipelineDepth);
+                pipelineSlots = new SemaphoreSlim(pipelineDepth, pipelineDepth);
+            }
+
             using var cts = CancellationTokenSource.CreateLinkedTokenSource(ct);
+            using var receiveSource = receiveCts = CancellationTokenSource.CreateLinkedTokenSource(cts.Token);
+            using var sendSource = sendCts = CancellationTokenSource.CreateLinkedTokenSource(cts.Token);
 
-            using(var disposables = new CompositeDisposable(networkStream))
+            var disposables = new CompositeDisposable(networkStream);
+
+            try
             {
-                var tls = endpoint.PoolEndpoint.Tls;
+                var tls = handshake && endpoint.PoolEndpoint.Tls;
 
                 // auto-detect SSL
-                if(endpoint.PoolEndpoint.TlsAuto)
+                if(handshake && endpoint.PoolEndpoint.TlsAuto)
                     tls = await DetectSslHandshake(socket, cts.Token);
 
                 if(tls)
@@ -118,19 +187,24 @@ public class StratumConnection
 
                     logger.Info(() => $"[{ConnectionId}] {sslStream.SslProtocol.ToString().ToUpper()}-{sslStream.CipherAlgorithm.ToString().ToUpper()} Connection from {RemoteEndpoint.Address.CensorOrReturn(gpdrCompliantLogging)}:{RemoteEndpoint.Port} accepted on port {endpoint.IPEndPoint.Port}");
                 }
-                else
+                else if(handshake)
                     logger.Info(() => $"[{ConnectionId}] Connection from {RemoteEndpoint.Address.CensorOrReturn(gpdrCompliantLogging)}:{RemoteEndpoint.Port} accepted on port {endpoint.IPEndPoint.Port}");
+                else
+                    logger.Info(() => $"[{ConnectionId}] Connection from {RemoteEndpoint.Address.CensorOrReturn(gpdrCompliantLogging)}:{RemoteEndpoint.Port} resumed on port {endpoint.IPEndPoint.Port}");
 
                 // Async I/O loop(s)
                 var tasks = new[]
                 {
-                    FillReceivePipeAsync(cts.Token),
+                    FillReceivePipeAsync(receiveCts.Token),
                     ProcessReceivePipeAsync(cts.Token, endpoint.PoolEndpoint.TcpProxyProtocol, onRequestAsync),
                     ProcessSendQueueAsync(cts.Token)
                 };
 
                 await Task.WhenAny(tasks);
 
+                if(detach != null && await TryDetachAsync(socket, tasks))
+                    return;
+
                 // We are done with this client, make sure all tasks complete
                 await receivePipe.Reader.CompleteAsync();
                 await receivePipe.Writer.CompleteAsync();
@@ -147,6 +221,13 @@ public class StratumConnection
                 else
                     onError(this, error);
             }
+
+            finally
+            {
+                // a detached socket lives on in another process and must not be shut down
+                if(!IsDetached)
+                    disposables.Dispose();
+            }
         }
 
         catch(Exception ex)
@@ -156,19 +237,61 @@ public class StratumConnection
 
         finally
         {
+            sendTimer?.Cancel();
+
             // Release external observables
             IsAlive = false;
             terminated.OnNext(Unit.Default);
 
-            logger.Info(() => $"[{ConnectionId}] Connection closed");
+            detach?.TrySetResult(null);
+
+            logger.Info(() => IsDetached ? $"[{ConnectionId}] Connection handed off" : $"[{ConnectionId}] Connection closed");
         }
     }
 
+    /// <summary>
+    /// Winds down the I/O loops without closing the socket. Requests already received are
+    /// processed and queued responses are flushed before the descriptor is released.
+    /// </summary>
+    private async Task<bool> TryDetachAsync(Socket socket, Task[] tasks)
+    {
+        // receiving was stopped on purpose, anything else means the connection is gone anyway
+        if(!receiveCts.IsCancellationRequested || tasks[0].IsFaulted || tasks[1].IsCompleted || tasks[2].IsCompleted)
+            return false;
+
+        await receivePipe.Writer.CompleteAsync();
+        await Task.WhenAny(tasks[1]);
+
+        sendQueue.Complete();
+        await Task.WhenAny(tasks[2]);
+
+        if(tasks[1].IsFaulted || tasks[2].Exception?.InnerException is not InvalidOperationException)
+            return false;
+
+        // hand out a duplicate so that closing our end leaves the connection intact
+        var fd = LibC.dup((int) socket.Handle);
+
+        if(fd == -1)
+            return false;
+
+        IsDetached = true;
+        socket.Dispose();
+
+        detach.TrySetResult(new DetachedConnection(fd, pendingReceive));
+        return true;
+    }
+
     public string ConnectionId { get; }
     public IPEndPoint LocalEndpoint { get; private set; }
     public IPEndPoint RemoteEndpoint { get; private set; }
     public DateTime? LastReceive { get; set; }
     public bool IsAlive { get; set; }
+
+    /// <summary>
+    /// Address this connection is counted under by admission control, if any
+    /// </summary>
+    public IPAddress AdmittedAddress { get; set; }
+
     public IObservable<Unit> Terminated => terminated.AsObservable();
     public WorkerContextBase Context => context;
 
@@ -218,6 +341,41 @@ public class StratumConnection
         networkStream.Close();
     }
 
+    public record DetachedConnection(int Descriptor, byte[] Pending);
+
+    public bool IsDetached { get; private set; }
+    public bool IsTls => networkStream is SslStream;
+
+    /// <summary>
+    /// Stops serving the connection without closing it so that it can be handed over to another process.
+    /// Returns the socket descriptor (owned by the caller) and any unprocessed inbound data
+    /// or null if the connection cannot be detached.
+    /// </summary>
+    public Task<DetachedConnection> DetachAsync()
+    {
+        var cts = receiveCts;
+
+        if(IsTls || cts == null || !IsAlive)
+            return Task.FromResult<DetachedConnection>(null);
+
+        var tcs = new TaskCompletionSource<DetachedConnection>(TaskCreationOptions.RunContinuationsAsynchronously);
+
+        if(Interlocked.CompareExchange(ref detach, tcs, null) != null)
+            return Task.FromResult<DetachedConnection>(null);
+
+        try
+        {
+            cts.Cancel();
+        }
+
+        catch(ObjectDisposedException)
+        {
+            tcs.TrySetResult(null);
+        }
+
+        return tcs.Task;
+    }
+
     #endregion // API-Surface
 
     private Task SendAsync<T>(T payload)
@@ -266,6 +424,8 @@ public class StratumConnection
 
             var result = await receivePipe.Reader.ReadAsync(ct);
 
+            ThrowIfPipelineFaulted();
+
             var buffer = result.Buffer;
             SequencePosition? position;
 
@@ -291,11 +451,19 @@ public class StratumConnection
                 }
             } while(position != null);
 
+            // keep an incomplete request around for whoever takes over a detached connection
+            if(result.IsCompleted && detach != null && buffer.Length > 0)
+                pendingReceive = buffer.ToArray();
+
             receivePipe.Reader.AdvanceTo(buffer.Start, buffer.End);
 
             if(result.IsCompleted)
                 break;
         }
+
+        // requests still in flight must respond before the connection is completed or handed off
+        await DrainPipelineAsync(ct);
+        ThrowIfPipelineFaulted();
     }
 
     private async Task<bool> DetectSslHandshake(Socket socket, CancellationToken ct)
@@ -359,13 +527,61 @@ public class StratumConnection
         // append newline
         stream.WriteByte((byte) '\n');
 
-        using var cts = CancellationTokenSource.CreateLinkedTokenSource(ct);
-        cts.CancelAfter(sendTimeout);
-
-        // send
         stream.Position = 0;
-        await stream.CopyToAsync(networkStream, cts.Token);
-        await networkStream.FlushAsync(cts.Token);
+
+        if(sendTimer == null)
+        {
+            using var cts = CancellationTokenSource.CreateLinkedTokenSource(ct);
+            cts.CancelAfter(sendTimeout);
+
+            // send
+            await stream.CopyToAsync(networkStream, cts.Token);
+            await networkStream.FlushAsync(cts.Token);
+            return;
+        }
+
+        // the deadline lives on the pool's timer wheel, arming it doesn't allocate
+        Volatile.Write(ref sendStarted, Environment.TickCount64);
+        sendTimer.Arm(sendTimeout);
+
+        try
+        {
+            await stream.CopyToAsync(networkStream, sendCts.Token);
+            await networkStream.FlushAsync(sendCts.Token);
+        }
+
+        finally
+        {
+            Volatile.Write(ref sendStarted, 0);
+            sendTimer.Cancel();
+        }
+    }
+
+    private void OnSendTimeout(object _)
+    {
+        var started = Volatile.Read(ref sendStarted);
+
+        if(started == 0)
+            return;
+
+        var elapsed = TimeSpan.FromMilliseconds(Environment.TickCount64 - started);
+
+        // a later message may have started in the meantime
+        if(elapsed < sendTimeout)
+        {
+            sendTimer.Arm(sendTimeout - elapsed);
+            return;
+        }
+
+        try
+        {
+            sendCts.Cancel();
+        }
+
+        catch(ObjectDisposedException)
+        {
+            // connection is gone already
+        }
     }
 
     private async Task ProcessRequestAsync(
@@ -381,7 +597,72 @@ public class StratumConnection
         if(request == null)
             throw new JsonException("Unable to deserialize request");
 
-        await onRequestAsync(this, request, ct);
+        if(pipelineSlots == null)
+        {
+            await onRequestAsync(this, request, ct);
+            return;
+        }
+
+        if(!pipelinedMethods.Contains(request.Method))
+        {
+            // state changing requests observe the effects of all submissions received before them
+            await DrainPipelineAsync(ct);
+            ThrowIfPipelineFaulted();
+
+            await onRequestAsync(this, request, ct);
+            return;
+        }
+
+        await pipelineSlots.WaitAsync(ct);
+        ThrowIfPipelineFaulted();
+
+        _ = ProcessPipelinedRequestAsync(ct, onRequestAsync, request);
+    }
+
+    private async Task ProcessPipelinedRequestAsync(
+        CancellationToken ct,
+        Func<StratumConnection, JsonRpcRequest, CancellationToken, Task> onRequestAsync,
+        JsonRpcRequest request)
+    {
+        try
+        {
+            // validation is mostly synchronous, get off the receive loop before it starts
+            await Task.Run(() => onRequestAsync(this, request, ct), ct);
+        }
+
+        catch(Exception ex)
+        {
+            // fail the connection the same way a sequentially processed request would
+            if(Interlocked.CompareExchange(ref pipelineError, ex, null) == null)
+                receivePipe.Reader.CancelPendingRead();
+        }
+
+        finally
+        {
+            pipelineSlots.Release();
+        }
+    }
+
+    /// <summary>
+    /// Waits for all pipelined requests to complete
+    /// </summary>
+    private async Task DrainPipelineAsync(CancellationToken ct)
+    {
+        if(pipelineSlots == null)
+            return;
+
+        for(var i = 0; i < pipelineDepth; i++)
+            await pipelineSlots.WaitAsync(ct);
+
+        pipelineSlots.Release(pipelineDepth);
+    }
+
+    private void ThrowIfPipelineFaulted()
+    {
+        var error = Volatile.Read(ref pipelineError);
+
+        if(error != null)
+            ExceptionDispatchInfo.Throw(error);
     }
 
     /// <summary>
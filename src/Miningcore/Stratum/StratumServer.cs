@@ -15,6 +15,8 @@ using Miningcore.Configuration;
 using Miningcore.Extensions;
 using Miningcore.JsonRpc;
 using Miningcore.Messaging;
+using Miningcore.Mining;
+using Miningcore.Native;
 using Miningcore.Notifications.Messages;
 using Miningcore.Time;
 using Miningcore.Util;
@@ -42,6 +44,8 @@ public abstract class StratumServer
         this.messageBus = messageBus;
         this.rmsm = rmsm;
         this.clock = clock;
+
+        handoff = ctx.ResolveOptional<SessionHandoff>();
     }
 
     static StratumServer()
@@ -71,6 +75,9 @@ public abstract class StratumServer
     }
 
     protected readonly ConcurrentDictionary<string, StratumConnection> connections = new();
+
+    // share counters of connections that are gone
+    private readonly ShareStats closedShareStats = new();
     protected static readonly ConcurrentDictionary<string, X509Certificate2> certs = new();
     protected static readonly HashSet<int> ignoredSocketErrors;
 
@@ -85,37 +92,92 @@ public abstract class StratumServer
     protected PoolConfig poolConfig;
     protected IBanManager banManager;
     protected ILogger logger;
-
-    protected Task RunAsync(CancellationToken ct, params StratumEndpoint[] endpoints)
+    protected SessionHandoff handoff;
+
+    /// <summary>
+    /// Drives the deadlines of all connections of this server
+    /// </summary>
+    protected readonly TimerWheel timerWheel = new(TimeSpan.FromMilliseconds(100));
+    private readonly ConcurrentDictionary<int, (Socket Socket, StratumEndpoint Endpoint)> listeners = new();
+    private CancellationTokenSource acceptCts;
+    private CancellationToken runCt;
+    private ConnectionAdmission admission;
+
+    protected async Task RunAsync(CancellationToken ct, params StratumEndpoint[] endpoints)
     {
         Contract.RequiresNonNull(endpoints);
 
+        if(poolConfig.Admission != null)
+            admission = new ConnectionAdmission(poolConfig.Admission);
+
+        // take over listening sockets and live sessions from a previous instance
+        var adopted = await ReceiveHandoffAsync(endpoints, ct);
+
         logger.Info(() => $"Stratum ports {string.Join(", ", endpoints.Select(x => $"{x.IPEndPoint.Address}:{x.IPEndPoint.Port}").ToArray())} online");
 
+        runCt = ct;
+        acceptCts = CancellationTokenSource.CreateLinkedTokenSource(ct);
+
         var tasks = endpoints.Select(port =>
         {
-            var server = new Socket(SocketType.Stream, ProtocolType.Tcp);
-            server.SetSocketOption(SocketOptionLevel.Socket, SocketOptionName.ReuseAddress, true);
-            server.Bind(port.IPEndPoint);
-            server.Listen();
+            if(!adopted.TryGetValue(port.IPEndPoint.Port, out var server))
+            {
+                server = new Socket(SocketType.Stream, ProtocolType.Tcp);
+                server.SetSocketOption(SocketOptionLevel.Socket, SocketOptionName.ReuseAddress, true);
+                server.Bind(port.IPEndPoint);
+                server.Listen();
+            }
+
+            listeners[port.IPEndPoint.Port] = (server, port);
 
-            return Listen(server, port, ct);
+            return Listen(server, port, acceptCts.Token, ct);
         }).ToArray();
 
-        return Task.WhenAll(tasks);
+        handoff?.OnPoolReady(poolConfig.Id);
+
+        // connections outlive the listeners after a handoff, so does the wheel
+        tasks = tasks.Append(timerWheel.RunAsync(ct)).ToArray();
+
+        if(admission != null)
+            tasks = tasks.Append(RunAdmissionPrunerAsync(ct)).ToArray();
+
+        await Task.WhenAll(tasks);
+    }
+
+    private async Task RunAdmissionPrunerAsync(CancellationToken ct)
+    {
+        using var timer = new PeriodicTimer(TimeSpan.FromMinutes(1));
+
+        try
+        {
+            while(await timer.WaitForNextTickAsync(ct))
+            {
+                var count = admission.Prune();
+
+                logger.Debug(() => $"Pruned {count} idle admission entries");
+            }
+        }
+
+        catch(OperationCanceledException)
+        {
+            // ignored
+        }
     }
 
-    private async Task Listen(Socket server, StratumEndpoint port, CancellationToken ct)
+    private async Task Listen(Socket server, StratumEndpoint port, CancellationToken acceptCt, CancellationToken ct)
     {
         var cert = GetTlsCert(port);
 
-        while(!ct.IsCancellationRequested)
+        while(!acceptCt.IsCancellationRequested)
         {
             try
             {
-                var socket = await server.AcceptAsync(ct);
+                var socket = await server.AcceptAsync(acceptCt);
+
+                if(!Admit(socket, port, out var admittedAddress))
+                    continue;
 
-                AcceptConnection(socket, port, cert, ct);
+                AcceptConnection(socket, port, cert, admittedAddress, ct);
             }
 
             catch(OperationCanceledException)
@@ -137,32 +199,90 @@ public abstract class StratumServer
         }
     }
 
-    private void AcceptConnection(Socket socket, StratumEndpoint port, X509Certificate2 cert, CancellationToken ct)
+    /// <summary>
+    /// Runs admission control on a freshly accepted socket and closes it right away if it is over the limits
+    /// </summary>
+    private bool Admit(Socket socket, StratumEndpoint port, out IPAddress admittedAddress)
     {
-        Task.Run(() => Guard(() =>
+        admittedAddress = null;
+
+        // behind a proxy all connections come from the proxy's address
+        if(admission == null || port.PoolEndpoint.TcpProxyProtocol?.Enable == true)
+            return true;
+
+        if(socket.RemoteEndPoint is not IPEndPoint remoteEndpoint)
+            return true;
+
+        var result = admission.TryAdmit(remoteEndpoint.Address);
+
+        if(result != AdmissionResult.Accepted)
         {
-            var remoteEndpoint = (IPEndPoint) socket.RemoteEndPoint;
+            Refuse(socket, remoteEndpoint.Address, result);
+            return false;
+        }
+
+        admittedAddress = remoteEndpoint.Address;
+        return true;
+    }
 
-            if(remoteEndpoint == null)
+    private void Refuse(Socket socket, IPAddress address, AdmissionResult result)
+    {
+        logger.Debug(() => $"Refusing connection from {address.CensorOrReturn(clusterConfig.Logging.GPDRCompliant)}: {result}");
+
+        // reset instead of a graceful close, nothing was sent yet
+        socket.Close(0);
+    }
+
+    private void AcceptConnection(Socket socket, StratumEndpoint port, X509Certificate2 cert, IPAddress admittedAddress, CancellationToken ct)
+    {
+        // not cancelled through ct: a task that never runs would keep the admission slot forever
+        Task.Run(() =>
+        {
+            // socket and admission slot pass to the connection once it is registered, until then they are released here
+            var registered = false;
+
+            try
             {
-                socket.Close();
-                return;
-            }
+                Guard(() =>
+                {
+                    if(ct.IsCancellationRequested)
+                        return;
 
-            // dispose of banned clients as early as possible
-            if (DisconnectIfBanned(socket, remoteEndpoint))
-                return;
+                    var remoteEndpoint = (IPEndPoint) socket.RemoteEndPoint;
 
-            // init connection
-            var connection = new StratumConnection(logger, rmsm, clock, CorrelationIdGenerator.GetNextId(), clusterConfig.Logging.GPDRCompliant);
+                    if(remoteEndpoint == null)
+                        return;
 
-            logger.Info(() => $"[{connection.ConnectionId}] Accepting connection from {remoteEndpoint.Address.CensorOrReturn(clusterConfig.Logging.GPDRCompliant)}:{remoteEndpoint.Port} ...");
+                    // dispose of banned clients as early as possible
+                    if (DisconnectIfBanned(socket, remoteEndpoint))
+                        return;
 
-            RegisterConnection(connection);
-            OnConnect(connection, port.IPEndPoint);
+                    // init connection
+                    var connection = new StratumConnection(logger, rmsm, clock, CorrelationIdGenerator.GetNextId(), clusterConfig.Logging.GPDRCompliant, timerWheel)
+                    {
+                        AdmittedAddress = admittedAddress
+                    };
 
-            connection.DispatchAsync(socket, ct, port, remoteEndpoint, cert, OnRequestAsync, OnConnectionComplete, OnConnectionError);
-        }, ex=> logger.Error(ex)), ct);
+                    logger.Info(() => $"[{connection.ConnectionId}] Accepting connection from {remoteEndpoint.Address.CensorOrReturn(clusterConfig.Logging.GPDRCompliant)}:{remoteEndpoint.Port} ...");
+
+                    RegisterConnection(connection);
+                    registered = true;
+
+                    OnConnect(connection, port.IPEndPoint);
+
+                    connection.DispatchAsync(socket, ct, port, remoteEndpoint, cert, OnRequestAsync, OnConnectionComplete, OnConnectionError);
+                }, ex=> logger.Error(ex));
+            }
+
+            finally
+            {
+                if(!registered)
+                {
+                    ReleaseAdmission(admittedAddress);
+                    socket.Close();
+                }
+            }
+        });
     }
 
     protected void RegisterConnection(StratumConnection connection)
@@ -178,11 +298,307 @@ public abstract class StratumServer
         var result = connections.TryRemove(connection.ConnectionId, out _);
         Debug.Assert(result);
 
+        if(connection.Context?.Stats != null)
+            closedShareStats.Add(connection.Context.Stats.Sample());
+
+        ReleaseAdmission(connection.AdmittedAddress);
+
         PublishTelemetry(TelemetryCategory.Connections, TimeSpan.Zero, true, connections.Count);
     }
 
+    /// <summary>
+    /// Share counters summed over all connections this server has handled
+    /// </summary>
+    /// <remarks>
+    /// A connection closing while this runs may be missed once, so consumers must treat a lower value as a glitch.
+    /// </remarks>
+    public ShareCounters GetShareCounters()
+    {
+        var result = closedShareStats.Sample();
+
+        foreach(var connection in connections.Values)
+        {
+            var stats = connection.Context?.Stats;
+
+            if(stats != null)
+                result += stats.Sample();
+        }
+
+        return result;
+    }
+
+    /// <summary>
+    /// Outcomes of admission control on new connections, all zero if admission control is off
+    /// </summary>
+    public AdmissionCounters GetAdmissionCounters()
+    {
+        return admission?.GetCounters() ?? default;
+    }
+
+    private void ReleaseAdmission(IPAddress address)
+    {
+        if(address != null)
+            admission?.Release(address);
+    }
+
     protected abstract void OnConnect(StratumConnection connection, IPEndPoint portItem1);
 
+    /// <summary>
+    /// Called after a connection has been closed, but not when it was handed off to another process
+    /// </summary>
+    protected virtual void OnDisconnect(StratumConnection connection)
+    {
+    }
+
+    #region Session Handoff
+
+    /// <summary>
+    /// Whether the session can be resumed by another process
+    /// </summary>
+    protected virtual bool CanHandoff(StratumConnection connection)
+    {
+        return false;
+    }
+
+    /// <summary>
+    /// Restores the worker context of a session taken over from another process
+    /// </summary>
+    protected virtual Task OnResumeAsync(StratumConnection connection, IPEndPoint ipEndPoint, StratumSessionState state)
+    {
+        return Task.CompletedTask;
+    }
+
+    /// <summary>
+    /// Hands over all sessions that can be resumed elsewhere, followed by the listening sockets.
+    /// Sessions that can't be handed over stay with this instance until it shuts down.
+    /// </summary>
+    public async Task HandoffAsync(Socket channel, CancellationToken ct)
+    {
+        Contract.RequiresNonNull(channel);
+
+        // stop accepting, new connections queue up in the backlog until the successor takes over
+        acceptCts?.Cancel();
+
+        try
+        {
+            await HandoffSessionsAsync(channel, ct);
+        }
+
+        catch
+        {
+            // the successor may not have received the listening sockets, keep serving them
+            ResumeAccepting();
+            throw;
+        }
+    }
+
+    private async Task HandoffSessionsAsync(Socket channel, CancellationToken ct)
+    {
+        var count = 0;
+
+        foreach(var connection in connections.Values)
+        {
+            if(!CanHandoff(connection))
+                continue;
+
+            var detached = await connection.DetachAsync();
+
+            if(detached == null)
+                continue;
+
+            try
+            {
+                var state = new StratumSessionState
+                {
+                    ConnectionId = connection.ConnectionId,
+                    RemoteAddress = connection.RemoteEndpoint.Address.ToString(),
+                    RemotePort = connection.RemoteEndpoint.Port,
+                    LocalPort = connection.LocalEndpoint.Port,
+                    LastReceive = connection.LastReceive,
+                    Pending = detached.Pending,
+                };
+
+                connection.Context.ExportState(state);
+
+                await SessionHandoff.SendAsync(channel, new SessionHandoffMessage
+                {
+                    Type = SessionHandoffMessageType.Session,
+                    PoolId = poolConfig.Id,
+                    State = state
+                }, new[] { detached.Descriptor }, ct);
+
+                count++;
+            }
+
+            catch(Exception ex)
+            {
+                logger.Error(() => $"[{connection.ConnectionId}] Session handoff failed: {ex.Message}");
+            }
+
+            finally
+            {
+                LibC.close(detached.Descriptor);
+                UnregisterConnection(connection);
+            }
+        }
+
+        // listening sockets last so that the successor has restored all sessions before accepting new ones
+        var ports = listeners.Keys.ToArray();
+        var descriptors = ports.Select(port => LibC.dup((int) listeners[port].Socket.Handle)).ToArray();
+
+        try
+        {
+            await SessionHandoff.SendAsync(channel, new SessionHandoffMessage
+            {
+                Type = SessionHandoffMessageType.Listeners,
+                PoolId = poolConfig.Id,
+                Ports = ports
+            }, descriptors, ct);
+        }
+
+        finally
+        {
+            SessionHandoff.Close(descriptors);
+        }
+
+        await SessionHandoff.SendAsync(channel, new SessionHandoffMessage { Type = SessionHandoffMessageType.Done, PoolId = poolConfig.Id }, null, ct);
+
+        logger.Info(() => $"Handed off {count} session(s) and {ports.Length} stratum port(s)");
+    }
+
+    private void ResumeAccepting()
+    {
+        if(runCt.IsCancellationRequested)
+            return;
+
+        acceptCts = CancellationTokenSource.CreateLinkedTokenSource(runCt);
+
+        foreach(var (server, port) in listeners.Values)
+            _ = Listen(server, port, acceptCts.Token, runCt);
+
+        logger.Info(() => $"Resumed accepting on stratum port(s) {string.Join(", ", listeners.Keys)}");
+    }
+
+    private async Task<Dictionary<int, Socket>> ReceiveHandoffAsync(StratumEndpoint[] endpoints, CancellationToken ct)
+    {
+        var result = new Dictionary<int, Socket>();
+
+        if(handoff?.IsSuccessor != true)
+            return result;
+
+        try
+        {
+            using var channel = await handoff.RequestAsync(poolConfig.Id, ct);
+
+            if(channel == null)
+                return result;
+
+            var count = 0;
+
+            while(true)
+            {
+                var (msg, descriptors) = await SessionHandoff.ReceiveAsync(channel, ct);
+
+                if(msg == null || msg.Type == SessionHandoffMessageType.Done)
+                {
+                    SessionHandoff.Close(descriptors);
+                    break;
+                }
+
+                switch(msg.Type)
+                {
+                    case SessionHandoffMessageType.Session when descriptors.Length == 1:
+                        // a session that can't be restored must not cost us the listening sockets that follow
+                        try
+                        {
+                            await ResumeConnectionAsync(descriptors[0], msg.State, endpoints, ct);
+                            count++;
+                        }
+
+                        catch(Exception ex) when(ex is not OperationCanceledException)
+                        {
+                            logger.Error(() => $"[{msg.State?.ConnectionId}] Failed to resume session: {ex.Message}");
+                        }
+                        break;
+
+                    case SessionHandoffMessageType.Listeners when descriptors.Length == msg.Ports?.Length:
+                        for(var i = 0; i < descriptors.Length; i++)
+                            result[msg.Ports[i]] = new Socket(new SafeSocketHandle((IntPtr) descriptors[i], true));
+                        break;
+
+                    default:
+                        SessionHandoff.Close(descriptors);
+                        break;
+                }
+            }
+
+            logger.Info(() => $"Resumed {count} session(s) and {result.Count} stratum port(s) from previous instance");
+        }
+
+        catch(Exception ex)
+        {
+            if(ex is OperationCanceledException)
+                throw;
+
+            logger.Error(() => $"Stratum handoff failed: {ex.Message}");
+        }
+
+        // ports no longer configured
+        foreach(var port in result.Keys.Where(port => endpoints.All(x => x.IPEndPoint.Port != port)).ToArray())
+        {
+            result[port].Dispose();
+            result.Remove(port);
+        }
+
+        return result;
+    }
+
+    private async Task ResumeConnectionAsync(int descriptor, StratumSessionState state, StratumEndpoint[] endpoints, CancellationToken ct)
+    {
+        var socket = new Socket(new SafeSocketHandle((IntPtr) descriptor, true));
+        var port = endpoints.FirstOrDefault(x => x.IPEndPoint.Port == state?.LocalPort);
+
+        if(port == null || !IPAddress.TryParse(state.RemoteAddress, out var remoteAddress) ||
+           state.RemotePort is < IPEndPoint.MinPort or > IPEndPoint.MaxPort)
+        {
+            // port no longer configured or bogus state, the miner will reconnect
+            socket.Dispose();
+            return;
+        }
+
+        var remoteEndpoint = new IPEndPoint(remoteAddress, state.RemotePort);
+
+        var connection = new StratumConnection(logger, rmsm, clock, state.ConnectionId, clusterConfig.Logging.GPDRCompliant, timerWheel)
+        {
+            LastReceive = state.LastReceive
+        };
+
+        // resumed sessions count against the limits but are never refused
+        if(admission != null && port.PoolEndpoint.TcpProxyProtocol?.Enable != true)
+        {
+            admission.Acquire(remoteEndpoint.Address);
+            connection.AdmittedAddress = remoteEndpoint.Address;
+        }
+
+        RegisterConnection(connection);
+
+        try
+        {
+            await OnResumeAsync(connection, port.IPEndPoint, state);
+        }
+
+        catch
+        {
+            UnregisterConnection(connection);
+            socket.Dispose();
+            throw;
+        }
+
+        connection.ResumeAsync(socket, ct, port, remoteEndpoint, state.Pending, OnRequestAsync, OnConnectionComplete, OnConnectionError);
+    }
+
+    #endregion // Session Handoff
+
     protected async Task OnRequestAsync(StratumConnection connection, JsonRpcRequest request, CancellationToken ct)
     {
         // boot pre-connected clients
@@ -276,6 +692,7 @@ public abstract class StratumServer
         }
 
         UnregisterConnection(connection);
+        OnDisconnect(connection);
     }
 
     protected void OnConnectionComplete(StratumConnection connection)
@@ -283,6 +700,7 @@ public abstract class StratumServer
         logger.Debug(() => $"[{connection.ConnectionId}] Received EOF");
 
         UnregisterConnection(connection);
+        OnDisconnect(connection);
     }
 
     protected void Disconnect(StratumConnection connection)
@@ -0,0 +1,51 @@
+namespace Miningcore.Stratum;
+
+/// <summary>
+/// Serialized state of a live stratum session handed over to another process
+/// </summary>
+public class StratumSessionState
+{
+    public string ConnectionId { get; set; }
+    public string RemoteAddress { get; set; }
+    public int RemotePort { get; set; }
+    public int LocalPort { get; set; }
+    public DateTime? LastReceive { get; set; }
+
+    /// <summary>
+    /// Inbound data received but not yet processed (an incomplete request line)
+    /// </summary>
+    public byte[] Pending { get; set; }
+
+    public DateTime Created { get; set; }
+    public DateTime LastActivity { get; set; }
+    public bool IsAuthorized { get; set; }
+    public bool IsSubscribed { get; set; }
+    public double Difficulty { get; set; }
+    public double? PreviousDifficulty { get; set; }
+    public double? PendingDifficulty { get; set; }
+    public string Miner { get; set; }
+    public string Worker { get; set; }
+    public string UserAgent { get; set; }
+    public int ValidShares { get; set; }
+    public int InvalidShares { get; set; }
+
+    /// <summary>
+    /// Null if VarDiff was disabled for the session
+    /// </summary>
+    public VarDiffState VarDiff { get; set; }
+
+    /// <summary>
+    /// Coin-family specific worker context properties
+    /// </summary>
+    public Dictionary<string, string> Extra { get; set; }
+}
+
+public class VarDiffState
+{
+    public double? LastTs { get; set; }
+    public double LastRetarget { get; set; }
+    public int TimeBufferCapacity { get; set; }
+    public double[] TimeBuffer { get; set; }
+    public DateTime Created { get; set; }
+    public DateTime? LastUpdate { get; set; }
+}
@@ -0,0 +1,135 @@
+using Miningcore.Time;
+using Contract = Miningcore.Contracts.Contract;
+
+namespace Miningcore.Stratum;
+
+/// <summary>
+/// Bounded table of recently disconnected sessions keyed by the session id the miner
+/// was handed on subscribe. Sessions nobody came back for within the timeout, or that
+/// had to make room for newer ones, are passed to the expiry callback so that resources
+/// bound to them (extranonce ranges) can be reclaimed.
+/// </summary>
+public class StratumSessionTable
+{
+    public StratumSessionTable(IMasterClock clock, int capacity, TimeSpan timeout, Action<StratumSessionState> expired)
+    {
+        Contract.RequiresNonNull(clock);
+        Contract.Requires<ArgumentException>(capacity > 0);
+
+        this.clock = clock;
+        this.capacity = capacity;
+        this.timeout = timeout;
+        this.expired = expired;
+    }
+
+    private record Entry(StratumSessionState State, DateTime Expires);
+
+    private readonly IMasterClock clock;
+    private readonly int capacity;
+    private readonly TimeSpan timeout;
+    private readonly Action<StratumSessionState> expired;
+    private readonly object sync = new();
+    private readonly Dictionary<string, LinkedListNode<Entry>> map = new();
+
+    // insertion order equals expiry order since every entry gets the same timeout
+    private readonly LinkedList<Entry> entries = new();
+
+    public int Count
+    {
+        get
+        {
+            lock(sync)
+            {
+                return map.Count;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Keeps the state of a disconnected session around for resumption
+    /// </summary>
+    public void Park(StratumSessionState state)
+    {
+        Contract.RequiresNonNull(state);
+        Contract.RequiresNonNull(state.ConnectionId);
+
+        List<StratumSessionState> dropped;
+
+        lock(sync)
+        {
+            dropped = Sweep();
+
+            if(map.Remove(state.ConnectionId, out var existing))
+            {
+                entries.Remove(existing);
+                dropped.Add(existing.Value.State);
+            }
+
+            map[state.ConnectionId] = entries.AddLast(new Entry(state, clock.Now + timeout));
+
+            while(map.Count > capacity)
+            {
+                var oldest = entries.First;
+
+                entries.RemoveFirst();
+                map.Remove(oldest.Value.State.ConnectionId);
+                dropped.Add(oldest.Value.State);
+            }
+        }
+
+        Expire(dropped);
+    }
+
+    /// <summary>
+    /// Removes and returns the parked session if it has not expired yet
+    /// </summary>
+    public bool TryResume(string sessionId, out StratumSessionState state)
+    {
+        List<StratumSessionState> dropped;
+        state = null;
+
+        lock(sync)
+        {
+            dropped = Sweep();
+
+            if(!string.IsNullOrEmpty(sessionId) && map.Remove(sessionId, out var item))
+            {
+                entries.Remove(item);
+                state = item.Value.State;
+            }
+        }
+
+        Expire(dropped);
+
+        return state != null;
+    }
+
+    /// <summary>
+    /// Drops expired entries. Assumes to be called with lock held.
+    /// </summary>
+    private List<StratumSessionState> Sweep()
+    {
+        var result = new List<StratumSessionState>();
+        var now = clock.Now;
+
+        while(entries.First != null && entries.First.Value.Expires <= now)
+        {
+            var entry = entries.First.Value;
+
+            entries.RemoveFirst();
+            map.Remove(entry.State.ConnectionId);
+            result.Add(entry.State);
+        }
+
+        return result;
+    }
+
+    private void Expire(List<StratumSessionState> dropped)
+    {
+        if(expired == null)
+            return;
+
+        foreach(var state in dropped)
+            expired(state);
+    }
+}
@@ -0,0 +1,270 @@
+using Miningcore.Contracts;
+using NLog;
+
+namespace Miningcore.Time;
+
+/// <summary>
+/// Hashed hierarchical timer wheel for large numbers of coarse deadlines, like per-connection timeouts
+/// </summary>
+/// <remarks>
+/// Four levels of 64 slots each. Arming and cancelling are O(1) and don't allocate, a timer is created once
+/// and re-armed for the lifetime of its owner. A tick only visits the timers that are due, plus a cascade
+/// of one higher level slot every 64 ticks. Deadlines are rounded to the tick and may fire up to one tick early.
+/// Callbacks run on the thread advancing the wheel and must be short. A callback can still run right after
+/// a concurrent <see cref="Timer.Cancel"/>, so it has to check that its condition still holds.
+/// </remarks>
+public class TimerWheel
+{
+    public TimerWheel(TimeSpan tick)
+    {
+        Contract.Requires<ArgumentException>(tick >= TimeSpan.FromMilliseconds(1));
+
+        Tick = tick;
+        tickMs = (long) tick.TotalMilliseconds;
+        startMs = Environment.TickCount64;
+    }
+
+    public class Timer
+    {
+        internal Timer(TimerWheel wheel, Action<object> callback, object state)
+        {
+            this.wheel = wheel;
+            this.callback = callback;
+            this.state = state;
+        }
+
+        internal readonly TimerWheel wheel;
+        internal readonly Action<object> callback;
+        internal readonly object state;
+        internal Timer next;
+        internal Timer prev;
+        internal long expires;
+        internal int slot = -1;
+
+        public bool IsArmed => Volatile.Read(ref slot) != -1;
+
+        /// <summary>
+        /// Arms the timer, moving the deadline if it is already armed
+        /// </summary>
+        public void Arm(TimeSpan delay)
+        {
+            wheel.Arm(this, delay);
+        }
+
+        /// <summary>
+        /// Returns false if the timer wasn't armed
+        /// </summary>
+        public bool Cancel()
+        {
+            return wheel.Cancel(this);
+        }
+    }
+
+    private const int SlotBits = 6;
+    private const int SlotCount = 1 << SlotBits;
+    private const int SlotMask = SlotCount - 1;
+    private const int LevelCount = 4;
+    private const long MaxTicks = (1L << (SlotBits * LevelCount)) - 1;
+
+    private static readonly ILogger logger = LogManager.GetCurrentClassLogger();
+
+    private readonly long tickMs;
+    private readonly long startMs;
+    private readonly Timer[] slots = new Timer[LevelCount * SlotCount];
+    private readonly object advanceLock = new();
+    private readonly List<Timer> due = new();
+    private long currentTick;
+    private int count;
+
+    public TimeSpan Tick { get; }
+
+    /// <summary>
+    /// Number of armed timers
+    /// </summary>
+    public int Count => Volatile.Read(ref count);
+
+    public Timer CreateTimer(Action<object> callback, object state = null)
+    {
+        Contract.RequiresNonNull(callback);
+
+        return new Timer(this, callback, state);
+    }
+
+    /// <summary>
+    /// Advances the wheel every tick until cancelled
+    /// </summary>
+    public async Task RunAsync(CancellationToken ct)
+    {
+        using var timer = new PeriodicTimer(Tick);
+
+        try
+        {
+            while(await timer.WaitForNextTickAsync(ct))
+                Advance();
+        }
+
+        catch(OperationCanceledException)
+        {
+            // ignored
+        }
+    }
+
+    /// <summary>
+    /// Runs the callbacks of all timers that are due by now and returns their number
+    /// </summary>
+    public int Advance()
+    {
+        return AdvanceTo((Environment.TickCount64 - startMs) / tickMs);
+    }
+
+    /// <summary>
+    /// Runs the callbacks of all timers due up to and including tick and returns their number
+    /// </summary>
+    public int AdvanceTo(long tick)
+    {
+        var fired = 0;
+
+        lock(advanceLock)
+        {
+            while(true)
+            {
+                lock(slots)
+                {
+                    if(currentTick >= tick)
+                        break;
+
+                    currentTick++;
+
+                    var index = (int) (currentTick & SlotMask);
+
+                    if(index == 0)
+                        Cascade(1);
+
+                    for(var timer = slots[index]; timer != null;)
+                    {
+                        var next = timer.next;
+
+                        timer.next = null;
+                        timer.prev = null;
+                        Volatile.Write(ref timer.slot, -1);
+
+                        due.Add(timer);
+                        timer = next;
+                    }
+
+                    slots[index] = null;
+                    count -= due.Count;
+                }
+
+                // outside the lock, callbacks may re-arm their timer
+                foreach(var timer in due)
+                {
+                    try
+                    {
+                        timer.callback(timer.state);
+                    }
+
+                    catch(Exception ex)
+                    {
+                        logger.Error(ex);
+                    }
+                }
+
+                fired += due.Count;
+                due.Clear();
+            }
+        }
+
+        return fired;
+    }
+
+    private void Arm(Timer timer, TimeSpan delay)
+    {
+        var ticks = Math.Max(1, (long) Math.Ceiling(delay.TotalMilliseconds / tickMs));
+
+        lock(slots)
+        {
+            if(timer.slot != -1)
+                Unlink(timer);
+            else
+                count++;
+
+            timer.expires = currentTick + ticks;
+            Link(timer);
+        }
+    }
+
+    private bool Cancel(Timer timer)
+    {
+        lock(slots)
+        {
+            if(timer.slot == -1)
+                return false;
+
+            Unlink(timer);
+            Volatile.Write(ref timer.slot, -1);
+            count--;
+
+            return true;
+        }
+    }
+
+    private void Link(Timer timer)
+    {
+        // deadlines beyond the last level are parked there and placed again when their slot is cascaded
+        var expires = Math.Clamp(timer.expires, currentTick, currentTick + MaxTicks);
+        var delta = expires - currentTick;
+        var level = 0;
+
+        while(level < LevelCount - 1 && delta >= 1L << (SlotBits * (level + 1)))
+            level++;
+
+        var index = level * SlotCount + (int) ((expires >> (SlotBits * level)) & SlotMask);
+        var head = slots[index];
+
+        timer.prev = null;
+        timer.next = head;
+
+        if(head != null)
+            head.prev = timer;
+
+        slots[index] = timer;
+        Volatile.Write(ref timer.slot, index);
+    }
+
+    private void Unlink(Timer timer)
+    {
+        if(timer.prev != null)
+            timer.prev.next = timer.next;
+        else
+            slots[timer.slot] = timer.next;
+
+        if(timer.next != null)
+            timer.next.prev = timer.prev;
+
+        timer.next = null;
+        timer.prev = null;
+    }
+
+    /// <summary>
+    /// Distributes the timers of the current slot of a level over the levels below
+    /// </summary>
+    private void Cascade(int level)
+    {
+        var index = (int) ((currentTick >> (SlotBits * level)) & SlotMask);
+        var slot = level * SlotCount + index;
+        var timer = slots[slot];
+
+        slots[slot] = null;
+
+        while(timer != null)
+        {
+            var next = timer.next;
+            Link(timer);
+            timer = next;
+        }
+
+        if(index == 0 && level < LevelCount - 1)
+            Cascade(level + 1);
+    }
+}
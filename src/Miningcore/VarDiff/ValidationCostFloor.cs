@@ -0,0 +1,118 @@
+using Miningcore.Contracts;
+using Miningcore.Time;
+using NLog;
+
+namespace Miningcore.VarDiff;
+
+/// <summary>
+/// Derives a dynamic minimum difficulty from the CPU time a pool spends validating shares
+/// </summary>
+/// <remarks>
+/// Validation time is accumulated over a window. When it exceeds the budget, the floor applied to
+/// each port's MinDiff is raised in proportion, which stretches the share interval of workers mining at
+/// the floor while leaving faster workers alone. Once utilization drops well below the budget the floor
+/// is relaxed again.
+/// </remarks>
+public class ValidationCostFloor
+{
+    /// <param name="cpuBudget">CPU cores that may be spent on share validation</param>
+    public ValidationCostFloor(double cpuBudget, IMasterClock clock, ILogger logger = null, TimeSpan? window = null)
+    {
+        Contract.Requires<ArgumentException>(cpuBudget > 0);
+        Contract.RequiresNonNull(clock);
+
+        CpuBudget = cpuBudget;
+        this.clock = clock;
+        this.logger = logger;
+        this.window = window ?? TimeSpan.FromSeconds(30);
+        windowStart = clock.Now.Ticks;
+    }
+
+    // Workers only pick up a raised floor on their next retarget. Raising in small steps and holding
+    // for a few windows afterwards keeps the floor from running away while they catch up.
+    private const double MaxRaise = 2;
+    private const int RaiseHoldWindows = 4;
+
+    // relax in small steps once utilization falls below this fraction of the budget
+    private const double RelaxThreshold = 0.5;
+    private const double RelaxTarget = 0.75;
+    private const double MaxRelax = 0.9;
+
+    private readonly IMasterClock clock;
+    private readonly ILogger logger;
+    private readonly TimeSpan window;
+    private readonly object updateLock = new();
+    private long busyTicks;
+    private long windowStart;
+    private double scale = 1;
+    private int hold;
+
+    public double CpuBudget { get; }
+
+    /// <summary>
+    /// Factor applied to the configured MinDiff
+    /// </summary>
+    public double Scale => Volatile.Read(ref scale);
+
+    /// <summary>
+    /// CPU cores spent on validation during the last complete window
+    /// </summary>
+    public double Utilization { get; private set; }
+
+    public void Record(TimeSpan elapsed)
+    {
+        Interlocked.Add(ref busyTicks, elapsed.Ticks);
+    }
+
+    /// <summary>
+    /// Effective minimum difficulty for a port
+    /// </summary>
+    public double GetMinDiff(double minDiff)
+    {
+        var now = clock.Now.Ticks;
+
+        if(now - Interlocked.Read(ref windowStart) >= window.Ticks)
+            Update(now);
+
+        return minDiff * Scale;
+    }
+
+    private void Update(long now)
+    {
+        lock(updateLock)
+        {
+            var elapsed = now - windowStart;
+
+            // someone else got here first
+            if(elapsed < window.Ticks)
+                return;
+
+            var busy = Interlocked.Exchange(ref busyTicks, 0);
+            Interlocked.Exchange(ref windowStart, now);
+
+            Utilization = busy / (double) elapsed;
+
+            var current = scale;
+            var next = current;
+
+            if(hold > 0)
+                hold--;
+
+            else if(Utilization > CpuBudget)
+            {
+                next = current * Math.Min(Utilization / CpuBudget, MaxRaise);
+                hold = RaiseHoldWindows;
+            }
+
+            else if(current > 1 && Utilization < CpuBudget * RelaxThreshold)
+                next = Math.Max(1, current * Math.Max(Utilization / (CpuBudget * RelaxTarget), MaxRelax));
+
+            if(next != current)
+            {
+                Volatile.Write(ref scale, next);
+
+                logger?.Info(() => $"Share validation used {Utilization:0.##} of {CpuBudget:0.##} CPU cores, MinDiff scaled by {next:0.###}");
+            }
+        }
+    }
+}
@@ -11,7 +11,8 @@ public static class VarDiffManager
     private const int BufferSize = 10;  // Last 10 shares should be enough
     private const double SafetyMargin = 1;    // ensure we don't miss a cycle due a sub-second fraction delta;
 
-    public static double? Update(WorkerContextBase context, VarDiffConfig options, IMasterClock clock)
+    /// <param name="minDiffOverride">Dynamic minimum difficulty replacing <see cref="VarDiffConfig.MinDiff"/></param>
+    public static double? Update(WorkerContextBase context, VarDiffConfig options, IMasterClock clock, double? minDiffOverride = null)
     {
         var ctx = context.VarDiff;
         var difficulty = context.Difficulty;
@@ -24,7 +25,7 @@ public static class VarDiffManager
 
             if(ctx.LastTs.HasValue)
             {
-                var minDiff = options.MinDiff;
+                var minDiff = minDiffOverride ?? options.MinDiff;
                 var maxDiff = options.MaxDiff ?? Math.Max(minDiff, double.MaxValue); // for regtest
                 var timeDelta = ts - ctx.LastTs.Value;
 
@@ -44,7 +45,10 @@ public static class VarDiffManager
                 var tMin = options.TargetTime - variance;
                 var tMax = options.TargetTime + variance;
 
-                if(ts - ctx.LastRetarget < options.RetargetTime || avg >= tMin && avg <= tMax)
+                // with a dynamic floor, workers below it are retargeted even if their share rate is on target
+                var belowFloor = minDiffOverride.HasValue && difficulty < minDiff;
+
+                if(ts - ctx.LastRetarget < options.RetargetTime || avg >= tMin && avg <= tMax && !belowFloor)
                     return null;
 
                 // Possible New Diff
@@ -70,7 +74,8 @@ public static class VarDiffManager
         return null;
     }
 
-    public static double? IdleUpdate(WorkerContextBase context, VarDiffConfig options, IMasterClock clock)
+    /// <param name="minDiffOverride">Dynamic minimum difficulty replacing <see cref="VarDiffConfig.MinDiff"/></param>
+    public static double? IdleUpdate(WorkerContextBase context, VarDiffConfig options, IMasterClock clock, double? minDiffOverride = null)
     {
         var ctx = context.VarDiff;
         var difficulty = context.Difficulty;
@@ -99,7 +104,7 @@ public static class VarDiffManager
             // update the last time
             ctx.LastTs = ts;
 
-            var minDiff = options.MinDiff;
+            var minDiff = minDiffOverride ?? options.MinDiff;
             var maxDiff = options.MaxDiff ?? Math.Max(minDiff, double.MaxValue); // for regtest
 
             // Always calculate the time until now even there is no share submitted.
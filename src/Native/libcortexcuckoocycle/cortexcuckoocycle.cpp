@@ -1,12 +1,9 @@
 #include "cortexcuckoocycle.hpp"
 #include <stdint.h>
 
-#include "cuckaroo/cuckaroo.hpp"
+#include "cuckoo-verify.h"
 
 int32_t cortexcuckoocycle(const char *header, int headerLen, const char *solution)
 {
-    siphash_keys keys;
-    cuckaroo_cortex_setheader(header, headerLen, &keys);
-    int res = cuckaroo_cortex_verify((cuckaroo_cortex_word_t* )solution, keys);
-    return res;
+    return cuckoo_verify(CUCKOO_VARIANT_CORTEX, (const unsigned char *) header, headerLen, (const uint32_t *) solution, CUCKOO_KERNEL_AUTO);
 }
@@ -0,0 +1,168 @@
+/*
+ * Multi-lane Cuckoo-cycle verification kernel template.
+ *
+ * This file is included by cuckoo-verify.cpp once per kernel with the
+ * following macros defined:
+ *
+ *   CK_SUFFIX          suffix appended to every generated symbol
+ *   CK_TARGET          GCC target string the kernel is compiled for
+ *   CK_LANES           items processed per call, one per 64-bit vector lane
+ *   CK_VEC             vector type
+ *   CK_ADD, CK_XOR     64-bit lane add, bitwise xor
+ *   CK_AND             bitwise and
+ *   CK_ROTL(v, n)      64-bit rotate left by a constant
+ *   CK_ROTL32(v)       64-bit rotate left by 32
+ *   CK_ROTLV(v, n)     64-bit rotate left by the lanes of n
+ *   CK_SELECT(a, b, x, i)  lanes of b where x equals i, lanes of a elsewhere
+ *   CK_SET1(x)         broadcast a 64-bit constant
+ *   CK_LOAD, CK_STORE  aligned load and store of CK_LANES words
+ *
+ * Lane l of every vector holds the state of item l. Unused lanes repeat
+ * the first item and their results are dropped.
+ */
+
+#define CK_CAT_(a, b) a##b
+#define CK_CAT(a, b) CK_CAT_(a, b)
+#define CK(name) CK_CAT(name, CK_SUFFIX)
+#define CK_FN static __attribute__((target(CK_TARGET)))
+
+#define CK_SIPROUND() do { \
+    v0 = CK_ADD(v0, v1); v2 = CK_ADD(v2, v3); v1 = CK_ROTL(v1, 13); \
+    v3 = CK_ROTL(v3, 16); v1 = CK_XOR(v1, v0); v3 = CK_XOR(v3, v2); \
+    v0 = CK_ROTL32(v0); v2 = CK_ADD(v2, v1); v0 = CK_ADD(v0, v3); \
+    v1 = CK_ROTL(v1, 17); v3 = CK_ROTLV(v3, rot_e); \
+    v1 = CK_XOR(v1, v2); v3 = CK_XOR(v3, v0); v2 = CK_ROTL32(v2); \
+} while (0)
+
+#define CK_G(r, i, a, b, c, d) do { \
+    a = CK_ADD(CK_ADD(a, b), w[cuckoo_blake2b_sigma[r][2 * (i)]]); \
+    d = CK_ROTL32(CK_XOR(d, a)); \
+    c = CK_ADD(c, d); \
+    b = CK_ROTL(CK_XOR(b, c), 40); \
+    a = CK_ADD(CK_ADD(a, b), w[cuckoo_blake2b_sigma[r][2 * (i) + 1]]); \
+    d = CK_ROTL(CK_XOR(d, a), 48); \
+    c = CK_ADD(c, d); \
+    b = CK_ROTL(CK_XOR(b, c), 1); \
+} while (0)
+
+/* Siphash keys of n <= CK_LANES headers of len bytes each, stored back to
+ * back: the unkeyed blake2b-256 digest read as four little endian words */
+CK_FN void CK(cuckoo_keys)(const unsigned char *headers, unsigned int len,
+                           unsigned int n, siphash_keys *keys) {
+    uint64_t m[16][CK_LANES] __attribute__((aligned(64)));
+    CK_VEC h[8], v[16], w[16];
+    const unsigned int block_nb = len ? (len + 127) / 128 : 1;
+    unsigned int b, i, j, l, r;
+
+    for (i = 0; i < 8; i++)
+        h[i] = CK_SET1(cuckoo_blake2b_iv[i]);
+
+    /* digest length 32, no key, fanout and depth 1 */
+    h[0] = CK_XOR(h[0], CK_SET1(0x01010020ULL));
+
+    for (b = 0; b < block_nb; b++) {
+        const int last = b == block_nb - 1;
+
+        for (l = 0; l < CK_LANES; l++) {
+            const unsigned char *msg = headers + (l < n ? l : 0) * len;
+
+            for (j = 0; j < 16; j++)
+                m[j][l] = cuckoo_msg_word(msg, len, (b << 7) + (j << 3));
+        }
+
+        for (j = 0; j < 16; j++)
+            w[j] = CK_LOAD(m[j]);
+
+        for (i = 0; i < 8; i++) {
+            v[i] = h[i];
+            v[i + 8] = CK_SET1(cuckoo_blake2b_iv[i]);
+        }
+
+        v[12] = CK_XOR(v[12], CK_SET1((uint64_t) (last ? len : (b + 1) << 7)));
+
+        if (last)
+            v[14] = CK_XOR(v[14], CK_SET1(~0ULL));
+
+        for (r = 0; r < 12; r++) {
+            const unsigned int s = r % 10;
+
+            CK_G(s, 0, v[0], v[4], v[ 8], v[12]);
+            CK_G(s, 1, v[1], v[5], v[ 9], v[13]);
+            CK_G(s, 2, v[2], v[6], v[10], v[14]);
+            CK_G(s, 3, v[3], v[7], v[11], v[15]);
+            CK_G(s, 4, v[0], v[5], v[10], v[15]);
+            CK_G(s, 5, v[1], v[6], v[11], v[12]);
+            CK_G(s, 6, v[2], v[7], v[ 8], v[13]);
+            CK_G(s, 7, v[3], v[4], v[ 9], v[14]);
+        }
+
+        for (i = 0; i < 8; i++)
+            h[i] = CK_XOR(h[i], CK_XOR(v[i], v[i + 8]));
+    }
+
+    for (j = 0; j < 4; j++)
+        CK_STORE(m[j], h[j]);
+
+    for (l = 0; l < n; l++) {
+        keys[l].k0 = m[0][l];
+        keys[l].k1 = m[1][l];
+        keys[l].k2 = m[2][l];
+        keys[l].k3 = m[3][l];
+    }
+}
+
+/* Edge hashes of n <= CK_LANES edges, each under its own keys. The siphash
+ * state is chained through the 64 edges of a block, an edge hashes to its
+ * own output xored with that of the last edge of its block. */
+CK_FN void CK(cuckoo_sipblocks)(const siphash_keys *const *keys, const uint32_t *edges,
+                                uint64_t *out, unsigned int n, unsigned int rot) {
+    uint64_t k[5][CK_LANES] __attribute__((aligned(64)));
+    CK_VEC v0, v1, v2, v3, nonce, index, x, result;
+    const CK_VEC one = CK_SET1(1), ff = CK_SET1(0xff), rot_e = CK_SET1(rot);
+    unsigned int i, l;
+
+    for (l = 0; l < CK_LANES; l++) {
+        const unsigned int src = l < n ? l : 0;
+
+        k[0][l] = keys[src]->k0;
+        k[1][l] = keys[src]->k1;
+        k[2][l] = keys[src]->k2;
+        k[3][l] = keys[src]->k3;
+        k[4][l] = edges[src];
+    }
+
+    v0 = CK_LOAD(k[0]);
+    v1 = CK_LOAD(k[1]);
+    v2 = CK_LOAD(k[2]);
+    v3 = CK_LOAD(k[3]);
+    nonce = CK_AND(CK_LOAD(k[4]), CK_SET1(~(uint64_t) CUCKOO_EDGE_BLOCK_MASK));
+    index = CK_AND(CK_LOAD(k[4]), CK_SET1(CUCKOO_EDGE_BLOCK_MASK));
+    result = CK_SET1(0);
+    x = result;
+
+    for (i = 0; i < CUCKOO_EDGE_BLOCK_SIZE; i++) {
+        v3 = CK_XOR(v3, nonce);
+        CK_SIPROUND(); CK_SIPROUND();
+        v0 = CK_XOR(v0, nonce);
+        v2 = CK_XOR(v2, ff);
+        CK_SIPROUND(); CK_SIPROUND(); CK_SIPROUND(); CK_SIPROUND();
+
+        x = CK_XOR(CK_XOR(v0, v1), CK_XOR(v2, v3));
+        result = CK_SELECT(result, x, index, i);
+        nonce = CK_ADD(nonce, one);
+    }
+
+    /* x now holds the last output of every block, which isn't xored with itself */
+    result = CK_SELECT(CK_XOR(result, x), x, index, CUCKOO_EDGE_BLOCK_MASK);
+    CK_STORE(k[0], result);
+
+    for (l = 0; l < n; l++)
+        out[l] = k[0][l];
+}
+
+#undef CK_SIPROUND
+#undef CK_G
+#undef CK_CAT_
+#undef CK_CAT
+#undef CK
+#undef CK_FN
@@ -0,0 +1,433 @@
+// Cuck(at)oo Cycle, a memory-hard proof-of-work
+// Copyright (c) 2013-2019 John Tromp
+//
+// Cuckaroo and cuckarood verifiers for all supported variants. Edge hashing
+// runs one edge per vector lane with AVX2 (four) or AVX-512 (eight), key
+// derivation one header per lane, both selected at runtime by CPU feature.
+
+#include <string.h>
+#include "cuckoo-verify.h"
+#include "crypto/blake2.h"
+#include "crypto/siphash.hpp"
+
+#define CUCKOO_EDGE_BLOCK_BITS 6
+#define CUCKOO_EDGE_BLOCK_SIZE (1 << CUCKOO_EDGE_BLOCK_BITS)
+#define CUCKOO_EDGE_BLOCK_MASK (CUCKOO_EDGE_BLOCK_SIZE - 1)
+#define CUCKOO_MAX_PROOFSIZE 48
+
+// solutions verified together, bounds the stack used by a batch
+#define CUCKOO_CHUNK 8
+
+struct cuckoo_params
+{
+	uint32_t edge_bits;
+	uint32_t proof_size;
+	uint32_t rot_e;
+	bool directed;
+};
+
+static const cuckoo_params cuckoo_variants[CUCKOO_VARIANT_COUNT] =
+{
+	{ 30, 42, 21, false },		// cortex
+	{ 29, 32, 21, false },		// c29s
+	{ 29, 32, 25, true },		// c29v
+	{ 29, 40, 21, false },		// c29b
+	{ 29, 48, 21, false },		// c29i
+};
+
+static const uint64_t cuckoo_blake2b_iv[8] =
+{
+	0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+	0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+};
+
+static const uint8_t cuckoo_blake2b_sigma[10][16] =
+{
+	{  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+	{ 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 },
+	{ 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 },
+	{  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 },
+	{  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 },
+	{  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 },
+	{ 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 },
+	{ 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 },
+	{  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 },
+	{ 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0 },
+};
+
+// fills keys from blake2b-256 of the header, as cuckaroo_setheader does
+static void cuckoo_keys(const unsigned char *header, unsigned int len, siphash_keys *keys)
+{
+	char hdrkey[32];
+	blake2b((void *)hdrkey, sizeof(hdrkey), (const void *)header, len, 0, 0);
+	keys->setkeys(hdrkey);
+}
+
+// returns siphash output for given edge, the reference fills a buffer with the whole block
+template <int rotE>
+static uint64_t cuckoo_sipblock(const siphash_keys &keys, const uint32_t edge)
+{
+	siphash_state<rotE> shs(keys);
+	const uint32_t edge0 = edge & ~CUCKOO_EDGE_BLOCK_MASK;
+	const uint32_t index = edge & CUCKOO_EDGE_BLOCK_MASK;
+	uint64_t result = 0;
+
+	for (uint32_t i = 0; i < CUCKOO_EDGE_BLOCK_SIZE; i++)
+	{
+		shs.hash24(edge0 + i);
+
+		if (i == index)
+			result = shs.xor_lanes();
+	}
+
+	const uint64_t last = shs.xor_lanes();
+	return index == CUCKOO_EDGE_BLOCK_MASK ? last : result ^ last;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CUCKOO_SIMD
+#endif
+
+#ifdef CUCKOO_SIMD
+
+#include <immintrin.h>
+
+// little endian message word at byte offset pos of the zero padded message
+static inline uint64_t cuckoo_msg_word(const unsigned char *msg, unsigned int len, unsigned int pos)
+{
+	uint64_t result = 0;
+
+	if (pos + 8 <= len)
+		memcpy(&result, &msg[pos], 8);
+	else if (pos < len)
+		memcpy(&result, &msg[pos], len - pos);
+
+	return le64toh(result);
+}
+
+// AVX2, four lanes
+#define CK_SUFFIX _avx2
+#define CK_TARGET "avx2"
+#define CK_LANES 4
+#define CK_VEC __m256i
+#define CK_ADD _mm256_add_epi64
+#define CK_XOR _mm256_xor_si256
+#define CK_AND _mm256_and_si256
+#define CK_ROTL(v, n) _mm256_or_si256(_mm256_slli_epi64(v, n), _mm256_srli_epi64(v, 64 - (n)))
+#define CK_ROTL32(v) _mm256_shuffle_epi32(v, 0xb1)
+#define CK_ROTLV(v, n) _mm256_or_si256(_mm256_sllv_epi64(v, n), _mm256_srlv_epi64(v, _mm256_sub_epi64(_mm256_set1_epi64x(64), n)))
+#define CK_SELECT(a, b, x, i) _mm256_blendv_epi8(a, b, _mm256_cmpeq_epi64(x, _mm256_set1_epi64x(i)))
+#define CK_SET1(x) _mm256_set1_epi64x((long long) (x))
+#define CK_LOAD(p) _mm256_load_si256((const __m256i *) (p))
+#define CK_STORE(p, v) _mm256_store_si256((__m256i *) (p), v)
+#include "cuckoo-simd.h"
+#undef CK_SUFFIX
+#undef CK_TARGET
+#undef CK_LANES
+#undef CK_VEC
+#undef CK_ADD
+#undef CK_XOR
+#undef CK_AND
+#undef CK_ROTL
+#undef CK_ROTL32
+#undef CK_ROTLV
+#undef CK_SELECT
+#undef CK_SET1
+#undef CK_LOAD
+#undef CK_STORE
+
+// AVX-512, eight lanes
+#define CK_SUFFIX _avx512
+#define CK_TARGET "avx512f"
+#define CK_LANES 8
+#define CK_VEC __m512i
+#define CK_ADD _mm512_add_epi64
+#define CK_XOR _mm512_xor_si512
+#define CK_AND _mm512_and_si512
+// zero-masked forms with a full mask: the unmasked ones read an undefined vector, which gcc 12 warns about
+#define CK_ROTL(v, n) _mm512_maskz_rol_epi64((__mmask8) 0xff, v, n)
+#define CK_ROTL32(v) _mm512_maskz_rol_epi64((__mmask8) 0xff, v, 32)
+#define CK_ROTLV(v, n) _mm512_maskz_rolv_epi64((__mmask8) 0xff, v, n)
+#define CK_SELECT(a, b, x, i) _mm512_mask_mov_epi64(a, _mm512_cmpeq_epi64_mask(x, _mm512_set1_epi64(i)), b)
+#define CK_SET1(x) _mm512_set1_epi64((long long) (x))
+#define CK_LOAD(p) _mm512_load_si512((const void *) (p))
+#define CK_STORE(p, v) _mm512_store_si512((void *) (p), v)
+#include "cuckoo-simd.h"
+#undef CK_SUFFIX
+#undef CK_TARGET
+#undef CK_LANES
+#undef CK_VEC
+#undef CK_ADD
+#undef CK_XOR
+#undef CK_AND
+#undef CK_ROTL
+#undef CK_ROTL32
+#undef CK_ROTLV
+#undef CK_SELECT
+#undef CK_SET1
+#undef CK_LOAD
+#undef CK_STORE
+
+#endif // CUCKOO_SIMD
+
+unsigned int cuckoo_kernel(void)
+{
+#ifdef CUCKOO_SIMD
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx512f"))
+		return CUCKOO_KERNEL_AVX512;
+	if (__builtin_cpu_supports("avx2"))
+		return CUCKOO_KERNEL_AVX2;
+#endif
+
+	return CUCKOO_KERNEL_SCALAR;
+}
+
+unsigned int cuckoo_proof_size(unsigned int variant)
+{
+	return variant < CUCKOO_VARIANT_COUNT ? cuckoo_variants[variant].proof_size : 0;
+}
+
+// keys for count headers of len bytes stored back to back
+static void cuckoo_keys_batch(const unsigned char *headers, unsigned int len, unsigned int count,
+	siphash_keys *keys, unsigned int kernel)
+{
+	unsigned int i = 0;
+#ifdef CUCKOO_SIMD
+	if (kernel == CUCKOO_KERNEL_AVX512)
+	{
+		for (; i < count; i += 8)
+		{
+			const unsigned int n = count - i < 8 ? count - i : 8;
+
+			// a short tail is cheaper on the narrower kernel
+			if (n <= 4)
+				cuckoo_keys_avx2(&headers[i * len], len, n, &keys[i]);
+			else
+				cuckoo_keys_avx512(&headers[i * len], len, n, &keys[i]);
+		}
+	}
+	else if (kernel == CUCKOO_KERNEL_AVX2)
+	{
+		for (; i < count; i += 4)
+		{
+			const unsigned int n = count - i < 4 ? count - i : 4;
+
+			cuckoo_keys_avx2(&headers[i * len], len, n, &keys[i]);
+		}
+	}
+#endif
+
+	for (; i < count; i++)
+		cuckoo_keys(&headers[i * len], len, &keys[i]);
+}
+
+// hashes count edges, each under its own keys, into sips[pos[i]]
+static void cuckoo_sipblocks(const siphash_keys *const *keys, const uint32_t *edges, const uint32_t *pos,
+	uint64_t *sips, unsigned int count, unsigned int rot_e, unsigned int kernel)
+{
+	unsigned int i = 0;
+#ifdef CUCKOO_SIMD
+	uint64_t out[8];
+
+	if (kernel == CUCKOO_KERNEL_AVX512)
+	{
+		for (; i < count; i += 8)
+		{
+			const unsigned int n = count - i < 8 ? count - i : 8;
+
+			if (n <= 4)
+				cuckoo_sipblocks_avx2(&keys[i], &edges[i], out, n, rot_e);
+			else
+				cuckoo_sipblocks_avx512(&keys[i], &edges[i], out, n, rot_e);
+
+			for (unsigned int l = 0; l < n; l++)
+				sips[pos[i + l]] = out[l];
+		}
+	}
+	else if (kernel == CUCKOO_KERNEL_AVX2)
+	{
+		for (; i < count; i += 4)
+		{
+			const unsigned int n = count - i < 4 ? count - i : 4;
+
+			cuckoo_sipblocks_avx2(&keys[i], &edges[i], out, n, rot_e);
+
+			for (unsigned int l = 0; l < n; l++)
+				sips[pos[i + l]] = out[l];
+		}
+	}
+#endif
+
+	for (; i < count; i++)
+		sips[pos[i]] = rot_e == 25 ? cuckoo_sipblock<25>(*keys[i], edges[i]) : cuckoo_sipblock<21>(*keys[i], edges[i]);
+}
+
+// checks that edges are in range, ascending and, for directed graphs, balanced
+static int cuckoo_check_edges(const cuckoo_params &params, const uint32_t *edges)
+{
+	uint32_t ndir[2] = { 0, 0 };
+
+	for (uint32_t n = 0; n < params.proof_size; n++)
+	{
+		if (params.directed)
+		{
+			const uint32_t dir = edges[n] & 1;
+
+			if (ndir[dir] >= params.proof_size / 2)
+				return CUCKOO_POW_UNBALANCED;
+
+			ndir[dir]++;
+		}
+
+		if (edges[n] >> params.edge_bits)
+			return CUCKOO_POW_TOO_BIG;
+		if (n && edges[n] <= edges[n-1])
+			return CUCKOO_POW_TOO_SMALL;
+	}
+
+	return CUCKOO_POW_OK;
+}
+
+// verify that hashed edges form a cycle
+static int cuckoo_check_cycle(const cuckoo_params &params, const uint32_t *edges, const uint64_t *sips)
+{
+	const uint32_t proof_size = params.proof_size;
+	uint32_t uvs[2*CUCKOO_MAX_PROOFSIZE];
+	uint32_t xor0 = 0, xor1 = 0;
+
+	if (!params.directed)
+	{
+		const uint32_t edgemask = ((uint32_t)1 << params.edge_bits) - 1;
+
+		for (uint32_t n = 0; n < proof_size; n++)
+		{
+			xor0 ^= uvs[2*n  ] = sips[n] & edgemask;
+			xor1 ^= uvs[2*n+1] = (sips[n] >> 32) & edgemask;
+		}
+
+		if (xor0 | xor1)		// optional check for obviously bad proofs
+			return CUCKOO_POW_NON_MATCHING;
+
+		uint32_t n = 0, i = 0, j;
+		do						// follow cycle
+		{
+			for (uint32_t k = j = i; (k = (k+2) % (2*proof_size)) != i; )
+			{
+				if (uvs[k] == uvs[i])	// find other edge endpoint identical to one at i
+				{
+					if (j != i)			// already found one before
+						return CUCKOO_POW_BRANCH;
+					j = k;
+				}
+			}
+			if (j == i) return CUCKOO_POW_DEAD_END;	// no matching endpoint
+			i = j^1;
+			n++;
+		} while (i != 0);		// must cycle back to start or we would have found branch
+		return n == proof_size ? CUCKOO_POW_OK : CUCKOO_POW_SHORT_CYCLE;
+	}
+
+	// cuckarood: edges alternate direction, nodes have one bit less
+	const uint32_t nodemask = ((uint32_t)1 << (params.edge_bits - 1)) - 1;
+	uint32_t ndir[2] = { 0, 0 };
+
+	for (uint32_t n = 0; n < proof_size; n++)
+	{
+		const uint32_t dir = edges[n] & 1;
+
+		xor0 ^= uvs[4 * ndir[dir] + 2 * dir    ] =  sips[n]        & nodemask;
+		xor1 ^= uvs[4 * ndir[dir] + 2 * dir + 1] = (sips[n] >> 32) & nodemask;
+		ndir[dir]++;
+	}
+
+	if (xor0 | xor1)			// optional check for obviously bad proofs
+		return CUCKOO_POW_NON_MATCHING;
+
+	uint32_t n = 0, i = 0, j;
+	do							// follow cycle
+	{
+		for (uint32_t k = ((j = i) % 4) ^ 2; k < 2*proof_size; k += 4)
+		{
+			if (uvs[k] == uvs[i])	// find reverse direction edge endpoint identical to one at i
+			{
+				if (j != i)			// already found one before
+					return CUCKOO_POW_BRANCH;
+				j = k;
+			}
+		}
+		if (j == i) return CUCKOO_POW_DEAD_END;	// no matching endpoint
+		i = j^1;
+		n++;
+	} while (i != 0);			// must cycle back to start or we would have found branch
+	return n == proof_size ? CUCKOO_POW_OK : CUCKOO_POW_SHORT_CYCLE;
+}
+
+void cuckoo_verify_batch(unsigned int variant, const unsigned char *headers, unsigned int header_len,
+	const uint32_t *edges, int32_t *results, unsigned int count, unsigned int kernel)
+{
+	if (variant >= CUCKOO_VARIANT_COUNT)
+	{
+		for (unsigned int i = 0; i < count; i++)
+			results[i] = CUCKOO_POW_BAD_VARIANT;
+		return;
+	}
+
+	const cuckoo_params &params = cuckoo_variants[variant];
+	const uint32_t proof_size = params.proof_size;
+	const unsigned int best = cuckoo_kernel();
+
+	if (kernel == CUCKOO_KERNEL_AUTO || kernel > best)
+		kernel = best;
+
+	siphash_keys keys[CUCKOO_CHUNK];
+	uint64_t sips[CUCKOO_CHUNK * CUCKOO_MAX_PROOFSIZE];
+	const siphash_keys *item_keys[CUCKOO_CHUNK * CUCKOO_MAX_PROOFSIZE];
+	uint32_t item_edges[CUCKOO_CHUNK * CUCKOO_MAX_PROOFSIZE];
+	uint32_t item_pos[CUCKOO_CHUNK * CUCKOO_MAX_PROOFSIZE];
+
+	for (unsigned int c = 0; c < count; c += CUCKOO_CHUNK)
+	{
+		const unsigned int n = count - c < CUCKOO_CHUNK ? count - c : CUCKOO_CHUNK;
+		const uint32_t *chunk_edges = &edges[c * proof_size];
+		unsigned int items = 0;
+
+		cuckoo_keys_batch(&headers[c * header_len], header_len, n, keys, kernel);
+
+		// edges of all well formed solutions in the chunk share the vector lanes
+		for (unsigned int s = 0; s < n; s++)
+		{
+			const uint32_t *solution = &chunk_edges[s * proof_size];
+
+			results[c + s] = cuckoo_check_edges(params, solution);
+
+			if (results[c + s] != CUCKOO_POW_OK)
+				continue;
+
+			for (uint32_t e = 0; e < proof_size; e++, items++)
+			{
+				item_keys[items] = &keys[s];
+				item_edges[items] = solution[e];
+				item_pos[items] = s * proof_size + e;
+			}
+		}
+
+		cuckoo_sipblocks(item_keys, item_edges, item_pos, sips, items, params.rot_e, kernel);
+
+		for (unsigned int s = 0; s < n; s++)
+		{
+			if (results[c + s] == CUCKOO_POW_OK)
+				results[c + s] = cuckoo_check_cycle(params, &chunk_edges[s * proof_size], &sips[s * proof_size]);
+		}
+	}
+}
+
+int cuckoo_verify(unsigned int variant, const unsigned char *header, unsigned int header_len,
+	const uint32_t *edges, unsigned int kernel)
+{
+	int32_t result;
+
+	cuckoo_verify_batch(variant, header, header_len, edges, &result, 1, kernel);
+	return result;
+}
@@ -0,0 +1,44 @@
+#ifndef CUCKOO_VERIFY_H
+#define CUCKOO_VERIFY_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// variants: siphash keys are the blake2b-256 digest of the header
+#define CUCKOO_VARIANT_CORTEX 0 // cuckaroo, 30 edge bits, 42-cycles
+#define CUCKOO_VARIANT_C29S   1 // cuckaroo, 29 edge bits, 32-cycles
+#define CUCKOO_VARIANT_C29V   2 // cuckarood, 29 edge bits, 32-cycles
+#define CUCKOO_VARIANT_C29B   3 // cuckaroo, 29 edge bits, 40-cycles
+#define CUCKOO_VARIANT_C29I   4 // cuckaroo, 29 edge bits, 48-cycles
+#define CUCKOO_VARIANT_COUNT  5
+
+#define CUCKOO_KERNEL_AUTO   0
+#define CUCKOO_KERNEL_SCALAR 1
+#define CUCKOO_KERNEL_AVX2   2
+#define CUCKOO_KERNEL_AVX512 3
+
+enum cuckoo_verify_code { CUCKOO_POW_OK, CUCKOO_POW_HEADER_LENGTH, CUCKOO_POW_TOO_BIG, CUCKOO_POW_TOO_SMALL, CUCKOO_POW_NON_MATCHING, CUCKOO_POW_BRANCH, CUCKOO_POW_DEAD_END, CUCKOO_POW_SHORT_CYCLE, CUCKOO_POW_UNBALANCED, CUCKOO_POW_BAD_VARIANT = -1 };
+
+// best kernel available on this CPU
+unsigned int cuckoo_kernel(void);
+
+// number of edges in a solution, 0 for unknown variants
+unsigned int cuckoo_proof_size(unsigned int variant);
+
+// verifies a solution of cuckoo_proof_size(variant) ascending edges against a header
+int cuckoo_verify(unsigned int variant, const unsigned char *header, unsigned int header_len,
+                  const uint32_t *edges, unsigned int kernel);
+
+// verifies count (header, solution) pairs, headers of header_len bytes and solutions stored back to back;
+// kernel is one of CUCKOO_KERNEL_*, AUTO picks the best one available and a kernel the CPU lacks is downgraded
+void cuckoo_verify_batch(unsigned int variant, const unsigned char *headers, unsigned int header_len,
+                         const uint32_t *edges, int32_t *results, unsigned int count, unsigned int kernel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -16,6 +16,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
 #include "cortexcuckoocycle.hpp"
+#include "cuckoo-verify.h"
 
 #ifdef _WIN32
 #define MODULE_API __declspec(dllexport)
@@ -26,4 +27,19 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 extern "C" MODULE_API int32_t cortexcuckoocycle_export(const char *header, int headerLen, const char *solution)
 {
     return cortexcuckoocycle(header, headerLen, solution);
-}
\ No newline at end of file
+}
+
+extern "C" MODULE_API int32_t cuckoo_verify_export(uint32_t variant, const unsigned char *header, uint32_t headerLen, const uint32_t *solution, uint32_t kernel)
+{
+    return cuckoo_verify(variant, header, headerLen, solution, kernel);
+}
+
+extern "C" MODULE_API void cuckoo_verify_batch_export(uint32_t variant, const unsigned char *headers, uint32_t headerLen, const uint32_t *solutions, int32_t *results, uint32_t count, uint32_t kernel)
+{
+    cuckoo_verify_batch(variant, headers, headerLen, solutions, results, count, kernel);
+}
+
+extern "C" MODULE_API uint32_t cuckoo_kernel_export()
+{
+    return cuckoo_kernel();
+}
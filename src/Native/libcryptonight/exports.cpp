@@ -37,8 +37,6 @@ extern "C" {
     #include "c29/int-util.h"
 }
 
-#include "c29.h"
-
 
 #if (defined(__AES__) && (__AES__ == 1)) || (defined(__ARM_FEATURE_CRYPTO) && (__ARM_FEATURE_CRYPTO == 1))
 #define SOFT_AES false
@@ -73,3 +73,66 @@ bool verifyEH_144_5(const char *hdr, const std::vector<unsigned char> &soln, con
 
     return isValid;
 }
+
+struct EhVerifier
+{
+    unsigned int n;
+    unsigned int k;
+    size_t solution_size;
+
+    // state after absorbing the parameter block, cloned for every verification
+    // (kept as raw bytes since the handle itself is not guaranteed to be 64-byte aligned)
+    unsigned char base_state[sizeof(crypto_generichash_blake2b_state)];
+};
+
+EhVerifier* createEhVerifier(unsigned int n, unsigned int k, const char *personalization)
+{
+    size_t solution_size;
+
+    if (n == 200 && k == 9)
+        solution_size = 1344;
+    else if (n == 144 && k == 5)
+        solution_size = 100;
+    else if (n == 96 && k == 5)
+        solution_size = 68;
+    else
+        return NULL;
+
+    if (personalization == NULL)
+        personalization = default_personalization;
+
+    crypto_generichash_blake2b_state state;
+    EhInitialiseState(n, k, state, personalization);
+
+    EhVerifier *verifier = new EhVerifier();
+    verifier->n = n;
+    verifier->k = k;
+    verifier->solution_size = solution_size;
+    memcpy(verifier->base_state, &state, sizeof(state));
+
+    return verifier;
+}
+
+void destroyEhVerifier(EhVerifier *verifier)
+{
+    delete verifier;
+}
+
+bool verifyEH(const EhVerifier *verifier, const char *hdr, const std::vector<unsigned char> &soln)
+{
+    if (soln.size() != verifier->solution_size)
+        return false;
+
+    // Hash state
+    crypto_generichash_blake2b_state state;
+    memcpy(&state, verifier->base_state, sizeof(state));
+
+    crypto_generichash_blake2b_update(&state, (const unsigned char*)hdr, 140);
+
+    if (verifier->n == 200)
+        return Eh200_9.IsValidSolution(state, soln);
+    if (verifier->n == 144)
+        return Eh144_5.IsValidSolution(state, soln);
+
+    return Eh96_5.IsValidSolution(state, soln);
+}
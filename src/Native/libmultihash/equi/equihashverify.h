@@ -11,6 +11,13 @@ bool verifyEH_200_9(const char*, const std::vector<unsigned char>&, const char *
 bool verifyEH_144_5(const char*, const std::vector<unsigned char>&, const char *personalization);
 bool verifyEH_96_5(const char*, const std::vector<unsigned char>&, const char *personalization);
 
+// Personalised Blake2b state for a fixed (n, k, personalization), created once and shared between threads
+struct EhVerifier;
+
+EhVerifier* createEhVerifier(unsigned int n, unsigned int k, const char *personalization);
+void destroyEhVerifier(EhVerifier *verifier);
+bool verifyEH(const EhVerifier *verifier, const char *hdr, const std::vector<unsigned char>& soln);
+
 #ifdef __cplusplus
 }
 #endif
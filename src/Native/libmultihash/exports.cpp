@@ -86,6 +86,21 @@ extern "C" MODULE_API void scrypt_export(const char* input, char* output, uint32
 	scrypt_N_R_1_256(input, output, N, R, input_len);
 }
 
+extern "C" MODULE_API void scrypt_batch_export(const char* inputs, char* outputs, uint32_t count, uint32_t N, uint32_t R, uint32_t input_len, const uint32_t* midstate, uint32_t lanes)
+{
+	scrypt_N_R_1_256_batch(inputs, outputs, count, N, R, input_len, midstate, lanes);
+}
+
+extern "C" MODULE_API void scrypt_midstate_export(const char* input, uint32_t* midstate)
+{
+	scrypt_midstate(input, midstate);
+}
+
+extern "C" MODULE_API uint32_t scrypt_lanes_export()
+{
+	return scrypt_max_lanes();
+}
+
 extern "C" MODULE_API void quark_export(const char* input, char* output, uint32_t input_len)
 {
 	quark_hash(input, output, input_len);
@@ -161,9 +176,19 @@ extern "C" MODULE_API void x15_export(const char* input, char* output, uint32_t
 	x15_hash(input, output, input_len);
 }
 
-extern "C" MODULE_API void neoscrypt_export(const unsigned char* input, unsigned char* output, uint32_t profile)
+extern "C" MODULE_API void neoscrypt_export(const unsigned char* input, unsigned char* output, uint32_t input_len, uint32_t profile)
+{
+	neoscrypt_batch(input, output, 1, profile, NEOSCRYPT_KERNEL_AUTO);
+}
+
+extern "C" MODULE_API void neoscrypt_batch_export(const unsigned char* inputs, unsigned char* outputs, uint32_t count, uint32_t profile, uint32_t kernel)
+{
+	neoscrypt_batch(inputs, outputs, count, profile, kernel);
+}
+
+extern "C" MODULE_API uint32_t neoscrypt_kernel_export()
 {
-	neoscrypt(input, output, profile);
+	return neoscrypt_kernel();
 }
 
 extern "C" MODULE_API void scryptn_export(const char* input, char* output, uint32_t nFactor, uint32_t input_len)
@@ -318,6 +343,16 @@ extern "C" MODULE_API void sha512_256_export(const unsigned char* input, unsigne
     sha512_256(input, input_len, output);
 }
 
+extern "C" MODULE_API void sha512_256d_batch_export(const unsigned char* inputs, unsigned char* outputs, uint32_t count, uint32_t input_len, uint32_t kernel)
+{
+    sha512_256d_batch(inputs, outputs, count, input_len, kernel);
+}
+
+extern "C" MODULE_API uint32_t sha512_256_kernel_export()
+{
+    return sha512_256_kernel();
+}
+
 extern "C" MODULE_API void sha256dt_export(const char* input, char* output)
 {
     sha256dt_hash(input, output);
@@ -333,6 +368,11 @@ extern "C" MODULE_API int verthash_export(const unsigned char* input, unsigned c
     return verthash(input, input_len, output);
 }
 
+extern "C" MODULE_API int verthash_batch_export(const unsigned char* inputs, unsigned char* outputs, uint32_t input_len, uint32_t count)
+{
+    return verthash_batch(inputs, input_len, count, outputs);
+}
+
 extern "C" MODULE_API void x16s_export(const char* input, char* output, uint32_t input_len)
 {
     x16s_hash(input, output, input_len);
@@ -376,6 +416,27 @@ extern "C" MODULE_API bool equihash_verify_96_5_export(const char* header, int h
     return verifyEH_96_5(header, vecSolution, personalization);
 }
 
+extern "C" MODULE_API void* equihash_verifier_create_export(unsigned int n, unsigned int k, const char *personalization)
+{
+    return createEhVerifier(n, k, personalization);
+}
+
+extern "C" MODULE_API void equihash_verifier_destroy_export(void *verifier)
+{
+    destroyEhVerifier((EhVerifier*) verifier);
+}
+
+extern "C" MODULE_API bool equihash_verifier_verify_export(const void *verifier, const char* header, int header_length, const char* solution, int solution_length)
+{
+    if (header_length != 140) {
+        return false;
+    }
+
+    const std::vector<unsigned char> vecSolution(solution, solution + solution_length);
+
+    return verifyEH((const EhVerifier*) verifier, header, vecSolution);
+}
+
 extern "C" MODULE_API void minotaurx_export(const char* input, char* output)
 {
     minotaurx_hash(input, output);
@@ -406,6 +467,16 @@ extern "C" MODULE_API void yescryptR32_export(const char *input, char *output, u
     yescryptR32_hash(input, output, input_len);
 }
 
+extern "C" MODULE_API uint32_t yescrypt_kernel_export()
+{
+    return yescrypt_kernel();
+}
+
+extern "C" MODULE_API void yescrypt_set_kernel_export(uint32_t kernel)
+{
+    yescrypt_set_kernel(kernel);
+}
+
 extern "C" MODULE_API void cpupower_export(const char *input, char *output, uint32_t input_len)
 {
     cpupower_hash(input, output, input_len);
@@ -436,6 +507,16 @@ extern "C" MODULE_API void yespowerTIDE_export(const char *input, char *output,
     yespowerTIDE_hash(input, output, input_len);
 }
 
+extern "C" MODULE_API uint32_t yespower_kernel_export()
+{
+    return yespower_kernel();
+}
+
+extern "C" MODULE_API void yespower_set_kernel_export(uint32_t kernel)
+{
+    yespower_set_kernel(kernel);
+}
+
 extern "C" MODULE_API void allium_export(const char *input, char *output, uint32_t input_len)
 {
     allium_hash(input, output, input_len);
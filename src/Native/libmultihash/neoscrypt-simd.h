@@ -0,0 +1,465 @@
+/*
+ * Intrinsics based NeoScrypt kernel template.
+ *
+ * This file is included by neoscrypt.c once per kernel with the following
+ * macros defined:
+ *
+ *   NS_SUFFIX          suffix appended to every generated symbol
+ *   NS_TARGET          GCC target string the kernel is compiled for
+ *   NS_LANES           hashes processed per call (1 or 2)
+ *   NS_VEC             vector type, one 16 byte chunk per lane
+ *   NS_ADD, NS_XOR     32-bit lane add, bitwise xor
+ *   NS_SHUF(v, imm)    32-bit shuffle within each 128-bit lane
+ *   NS_ROTL(v, n)      32-bit rotate left
+ *   NS_ROTL16(v), NS_ROTL8(v)  specialised rotates for ChaCha
+ *   NS_WORD0(v, l)     word 0 of lane l
+ *   NS_GATHER(p, stride)      build a vector from the chunk at p, p + stride, ...
+ *   NS_SCATTER(v, p, stride)  inverse of NS_GATHER
+ *
+ * Each 64 byte block is held in four vectors (rows). ChaCha works on the
+ * natural row layout and rotates rows into diagonals between half rounds.
+ * Salsa works on the diagonal layout introduced by Colin Percival's SSE2
+ * scrypt, which the caller applies before and removes after the Salsa SMix.
+ */
+
+#define NS_CAT_(a, b) a##b
+#define NS_CAT(a, b) NS_CAT_(a, b)
+#define NS(name) NS_CAT(name, NS_SUFFIX)
+#define NS_FN static __attribute__((target(NS_TARGET)))
+
+/* BLAKE2s compression of a single 64 byte block into h */
+NS_FN void NS(blake2s_compress)(__m128i *row1, __m128i *row2, const uint *m,
+  uint t0, uint f0) {
+    __m128i a = *row1, b = *row2;
+    __m128i c = _mm_loadu_si128((const __m128i *) &blake2s_IV[0]);
+    __m128i d = _mm_xor_si128(_mm_loadu_si128((const __m128i *) &blake2s_IV[4]),
+      _mm_set_epi32(0, (int) f0, 0, (int) t0));
+    __m128i mx, my;
+    uint i;
+
+#define B2S_ROTR(x, n) _mm_or_si128(_mm_srli_epi32(x, n), _mm_slli_epi32(x, 32 - (n)))
+#define B2S_G(mm, r1, r2) \
+    a = _mm_add_epi32(_mm_add_epi32(a, b), mm); \
+    d = B2S_ROTR(_mm_xor_si128(d, a), r1); \
+    c = _mm_add_epi32(c, d); \
+    b = B2S_ROTR(_mm_xor_si128(b, c), r2);
+
+    for(i = 0; i < 10; i++) {
+        const uchar *s = blake2s_sigma[i];
+
+        mx = _mm_set_epi32((int) m[s[6]], (int) m[s[4]], (int) m[s[2]], (int) m[s[0]]);
+        my = _mm_set_epi32((int) m[s[7]], (int) m[s[5]], (int) m[s[3]], (int) m[s[1]]);
+        B2S_G(mx, 16, 12);
+        B2S_G(my, 8, 7);
+
+        /* diagonalise */
+        b = _mm_shuffle_epi32(b, 0x39);
+        c = _mm_shuffle_epi32(c, 0x4E);
+        d = _mm_shuffle_epi32(d, 0x93);
+
+        mx = _mm_set_epi32((int) m[s[14]], (int) m[s[12]], (int) m[s[10]], (int) m[s[8]]);
+        my = _mm_set_epi32((int) m[s[15]], (int) m[s[13]], (int) m[s[11]], (int) m[s[9]]);
+        B2S_G(mx, 16, 12);
+        B2S_G(my, 8, 7);
+
+        /* undiagonalise */
+        b = _mm_shuffle_epi32(b, 0x93);
+        c = _mm_shuffle_epi32(c, 0x4E);
+        d = _mm_shuffle_epi32(d, 0x39);
+    }
+
+#undef B2S_G
+#undef B2S_ROTR
+
+    *row1 = _mm_xor_si128(*row1, _mm_xor_si128(a, c));
+    *row2 = _mm_xor_si128(*row2, _mm_xor_si128(b, d));
+}
+
+/* BLAKE2s with a 64 byte input and a 32 byte key producing 32 bytes,
+ * the FastKDF PRF */
+NS_FN void NS(blake2s_prf)(const uchar *input, const uchar *key, uchar *output) {
+    uint m[16];
+    __m128i h0 = _mm_loadu_si128((const __m128i *) &blake2s_IV_P_XOR_KDF[0]);
+    __m128i h1 = _mm_loadu_si128((const __m128i *) &blake2s_IV_P_XOR_KDF[4]);
+
+    memcpy(m, key, 32);
+    memset(&m[8], 0, 32);
+    NS(blake2s_compress)(&h0, &h1, m, 64, 0);
+
+    memcpy(m, input, 64);
+    NS(blake2s_compress)(&h0, &h1, m, 128, ~0U);
+
+    _mm_storeu_si128((__m128i *) &output[0], h0);
+    _mm_storeu_si128((__m128i *) &output[16], h1);
+}
+
+/* FastKDF, same contract as neoscrypt_fastkdf() with N = 32 */
+NS_FN void NS(fastkdf)(const uchar *password, uint password_len,
+  const uchar *salt, uint salt_len, uchar *output, uint output_len) {
+    const uint kdf_buf_size = FASTKDF_BUFFER_SIZE,
+      prf_input_size = 64, prf_key_size = 32, prf_output_size = 32;
+    uchar A[FASTKDF_BUFFER_SIZE + 64] __attribute__((aligned(64)));
+    uchar B[FASTKDF_BUFFER_SIZE + 32] __attribute__((aligned(64)));
+    uchar prf_output[32] __attribute__((aligned(16)));
+    uint bufptr, a, b, i, j;
+
+    if(password_len > kdf_buf_size)
+       password_len = kdf_buf_size;
+
+    a = kdf_buf_size / password_len;
+    for(i = 0; i < a; i++)
+      memcpy(&A[i * password_len], &password[0], password_len);
+    b = kdf_buf_size - a * password_len;
+    if(b)
+      memcpy(&A[a * password_len], &password[0], b);
+    memcpy(&A[kdf_buf_size], &password[0], prf_input_size);
+
+    if(salt_len > kdf_buf_size)
+       salt_len = kdf_buf_size;
+
+    a = kdf_buf_size / salt_len;
+    for(i = 0; i < a; i++)
+      memcpy(&B[i * salt_len], &salt[0], salt_len);
+    b = kdf_buf_size - a * salt_len;
+    if(b)
+      memcpy(&B[a * salt_len], &salt[0], b);
+    memcpy(&B[kdf_buf_size], &salt[0], prf_key_size);
+
+    for(i = 0, bufptr = 0; i < 32; i++) {
+        NS(blake2s_prf)(&A[bufptr], &B[bufptr], prf_output);
+
+        /* sum of the output bytes */
+        {
+            __m128i s0 = _mm_sad_epu8(_mm_load_si128((const __m128i *) &prf_output[0]), _mm_setzero_si128());
+            __m128i s1 = _mm_sad_epu8(_mm_load_si128((const __m128i *) &prf_output[16]), _mm_setzero_si128());
+
+            s0 = _mm_add_epi64(s0, s1);
+            bufptr = (uint) (_mm_cvtsi128_si32(s0) + _mm_cvtsi128_si32(_mm_srli_si128(s0, 8)));
+        }
+        bufptr &= (kdf_buf_size - 1);
+
+        for(j = 0; j < prf_output_size; j++)
+          B[bufptr + j] ^= prf_output[j];
+
+        if(bufptr < prf_key_size)
+          memcpy(&B[kdf_buf_size + bufptr], &B[bufptr],
+            MIN(prf_output_size, prf_key_size - bufptr));
+        else if((kdf_buf_size - bufptr) < prf_output_size)
+          memcpy(&B[0], &B[kdf_buf_size],
+            prf_output_size - (kdf_buf_size - bufptr));
+    }
+
+    if(output_len > kdf_buf_size)
+      output_len = kdf_buf_size;
+
+    a = kdf_buf_size - bufptr;
+    if(a >= output_len) {
+        for(j = 0; j < output_len; j++)
+          output[j] = B[bufptr + j] ^ A[j];
+    } else {
+        for(j = 0; j < a; j++)
+          output[j] = B[bufptr + j] ^ A[j];
+        for(j = 0; j < output_len - a; j++)
+          output[a + j] = B[j] ^ A[a + j];
+    }
+}
+
+/* Salsa20 on a diagonal layout block, rounds must be a multiple of 2 */
+NS_FN void NS(salsa)(NS_VEC *X, uint rounds) {
+    NS_VEC X0 = X[0], X1 = X[1], X2 = X[2], X3 = X[3], T;
+
+    for(; rounds; rounds -= 2) {
+        /* columns */
+        T = NS_ADD(X0, X3); X1 = NS_XOR(X1, NS_ROTL(T,  7));
+        T = NS_ADD(X1, X0); X2 = NS_XOR(X2, NS_ROTL(T,  9));
+        T = NS_ADD(X2, X1); X3 = NS_XOR(X3, NS_ROTL(T, 13));
+        T = NS_ADD(X3, X2); X0 = NS_XOR(X0, NS_ROTL(T, 18));
+
+        X1 = NS_SHUF(X1, 0x93);
+        X2 = NS_SHUF(X2, 0x4E);
+        X3 = NS_SHUF(X3, 0x39);
+
+        /* rows */
+        T = NS_ADD(X0, X1); X3 = NS_XOR(X3, NS_ROTL(T,  7));
+        T = NS_ADD(X3, X0); X2 = NS_XOR(X2, NS_ROTL(T,  9));
+        T = NS_ADD(X2, X3); X1 = NS_XOR(X1, NS_ROTL(T, 13));
+        T = NS_ADD(X1, X2); X0 = NS_XOR(X0, NS_ROTL(T, 18));
+
+        X1 = NS_SHUF(X1, 0x39);
+        X2 = NS_SHUF(X2, 0x4E);
+        X3 = NS_SHUF(X3, 0x93);
+    }
+
+    X[0] = NS_ADD(X[0], X0);
+    X[1] = NS_ADD(X[1], X1);
+    X[2] = NS_ADD(X[2], X2);
+    X[3] = NS_ADD(X[3], X3);
+}
+
+/* ChaCha20 on a natural layout block, rounds must be a multiple of 2 */
+NS_FN void NS(chacha)(NS_VEC *X, uint rounds) {
+    NS_VEC X0 = X[0], X1 = X[1], X2 = X[2], X3 = X[3];
+
+#define NS_QUARTER \
+    X0 = NS_ADD(X0, X1); X3 = NS_ROTL16(NS_XOR(X3, X0)); \
+    X2 = NS_ADD(X2, X3); X1 = NS_ROTL(NS_XOR(X1, X2), 12); \
+    X0 = NS_ADD(X0, X1); X3 = NS_ROTL8(NS_XOR(X3, X0)); \
+    X2 = NS_ADD(X2, X3); X1 = NS_ROTL(NS_XOR(X1, X2), 7);
+
+    for(; rounds; rounds -= 2) {
+        /* columns */
+        NS_QUARTER
+
+        X1 = NS_SHUF(X1, 0x39);
+        X2 = NS_SHUF(X2, 0x4E);
+        X3 = NS_SHUF(X3, 0x93);
+
+        /* diagonals */
+        NS_QUARTER
+
+        X1 = NS_SHUF(X1, 0x93);
+        X2 = NS_SHUF(X2, 0x4E);
+        X3 = NS_SHUF(X3, 0x39);
+    }
+
+#undef NS_QUARTER
+
+    X[0] = NS_ADD(X[0], X0);
+    X[1] = NS_ADD(X[1], X1);
+    X[2] = NS_ADD(X[2], X2);
+    X[3] = NS_ADD(X[3], X3);
+}
+
+/* ChaCha20 on Z and Salsa20 on X in one instruction stream; the two are
+ * independent, so interleaving them hides the latency of each round chain */
+NS_FN void NS(chacha_salsa)(NS_VEC *Z, NS_VEC *X, uint rounds) {
+    NS_VEC Z0 = Z[0], Z1 = Z[1], Z2 = Z[2], Z3 = Z[3];
+    NS_VEC X0 = X[0], X1 = X[1], X2 = X[2], X3 = X[3], T;
+
+    for(; rounds; rounds -= 2) {
+        Z0 = NS_ADD(Z0, Z1); T = NS_ADD(X0, X3);
+        Z3 = NS_ROTL16(NS_XOR(Z3, Z0)); X1 = NS_XOR(X1, NS_ROTL(T,  7));
+        Z2 = NS_ADD(Z2, Z3); T = NS_ADD(X1, X0);
+        Z1 = NS_ROTL(NS_XOR(Z1, Z2), 12); X2 = NS_XOR(X2, NS_ROTL(T,  9));
+        Z0 = NS_ADD(Z0, Z1); T = NS_ADD(X2, X1);
+        Z3 = NS_ROTL8(NS_XOR(Z3, Z0)); X3 = NS_XOR(X3, NS_ROTL(T, 13));
+        Z2 = NS_ADD(Z2, Z3); T = NS_ADD(X3, X2);
+        Z1 = NS_ROTL(NS_XOR(Z1, Z2), 7); X0 = NS_XOR(X0, NS_ROTL(T, 18));
+
+        Z1 = NS_SHUF(Z1, 0x39); X1 = NS_SHUF(X1, 0x93);
+        Z2 = NS_SHUF(Z2, 0x4E); X2 = NS_SHUF(X2, 0x4E);
+        Z3 = NS_SHUF(Z3, 0x93); X3 = NS_SHUF(X3, 0x39);
+
+        Z0 = NS_ADD(Z0, Z1); T = NS_ADD(X0, X1);
+        Z3 = NS_ROTL16(NS_XOR(Z3, Z0)); X3 = NS_XOR(X3, NS_ROTL(T,  7));
+        Z2 = NS_ADD(Z2, Z3); T = NS_ADD(X3, X0);
+        Z1 = NS_ROTL(NS_XOR(Z1, Z2), 12); X2 = NS_XOR(X2, NS_ROTL(T,  9));
+        Z0 = NS_ADD(Z0, Z1); T = NS_ADD(X2, X3);
+        Z3 = NS_ROTL8(NS_XOR(Z3, Z0)); X1 = NS_XOR(X1, NS_ROTL(T, 13));
+        Z2 = NS_ADD(Z2, Z3); T = NS_ADD(X1, X2);
+        Z1 = NS_ROTL(NS_XOR(Z1, Z2), 7); X0 = NS_XOR(X0, NS_ROTL(T, 18));
+
+        Z1 = NS_SHUF(Z1, 0x93); X1 = NS_SHUF(X1, 0x39);
+        Z2 = NS_SHUF(Z2, 0x4E); X2 = NS_SHUF(X2, 0x4E);
+        Z3 = NS_SHUF(Z3, 0x39); X3 = NS_SHUF(X3, 0x93);
+    }
+
+    Z[0] = NS_ADD(Z[0], Z0); X[0] = NS_ADD(X[0], X0);
+    Z[1] = NS_ADD(Z[1], Z1); X[1] = NS_ADD(X[1], X1);
+    Z[2] = NS_ADD(Z[2], Z2); X[2] = NS_ADD(X[2], X2);
+    Z[3] = NS_ADD(Z[3], Z3); X[3] = NS_ADD(X[3], X3);
+}
+
+NS_FN void NS(blkxor)(NS_VEC *dst, const NS_VEC *src, uint chunks) {
+    uint i;
+
+    for(i = 0; i < chunks; i++)
+      dst[i] = NS_XOR(dst[i], src[i]);
+}
+
+NS_FN void NS(blkshuffle)(NS_VEC *X, NS_VEC *Y, uint r) {
+    uint i;
+
+    memcpy(Y, X, 8 * r * sizeof(NS_VEC));
+    for(i = 0; i < r; i++)
+      memcpy(&X[4 * i], &Y[4 * 2 * i], 4 * sizeof(NS_VEC));
+    for(i = 0; i < r; i++)
+      memcpy(&X[4 * (i + r)], &Y[4 * (2 * i + 1)], 4 * sizeof(NS_VEC));
+}
+
+/* Block mixer, see neoscrypt_blkmix() */
+NS_FN void NS(blkmix)(NS_VEC *X, NS_VEC *Y, uint r, uint mixmode) {
+    const uint mixer = mixmode >> 8, rounds = mixmode & 0xFF;
+    uint i;
+
+    for(i = 0; i < 2 * r; i++) {
+        if(i) NS(blkxor)(&X[4 * i], &X[4 * (i - 1)], 4);
+        else  NS(blkxor)(&X[0], &X[4 * (2 * r - 1)], 4);
+        if(mixer)
+          NS(chacha)(&X[4 * i], rounds);
+        else
+          NS(salsa)(&X[4 * i], rounds);
+    }
+
+    if(r > 1)
+      NS(blkshuffle)(X, Y, r);
+}
+
+/* ChaCha block mixer on Z and Salsa block mixer on X at once */
+NS_FN void NS(blkmix2)(NS_VEC *Z, NS_VEC *X, NS_VEC *Y, uint r, uint rounds) {
+    uint i;
+
+    for(i = 0; i < 2 * r; i++) {
+        if(i) {
+            NS(blkxor)(&Z[4 * i], &Z[4 * (i - 1)], 4);
+            NS(blkxor)(&X[4 * i], &X[4 * (i - 1)], 4);
+        } else {
+            NS(blkxor)(&Z[0], &Z[4 * (2 * r - 1)], 4);
+            NS(blkxor)(&X[0], &X[4 * (2 * r - 1)], 4);
+        }
+        NS(chacha_salsa)(&Z[4 * i], &X[4 * i], rounds);
+    }
+
+    if(r > 1) {
+        NS(blkshuffle)(Z, Y, r);
+        NS(blkshuffle)(X, Y, r);
+    }
+}
+
+/* X ^= V_j where every lane picks its own j = integerify(X) mod N */
+NS_FN void NS(blkxor_vj)(NS_VEC *X, const NS_VEC *V, uint r, uint N) {
+    const uint chunks = 8 * r;
+    const uint last = 4 * (2 * r - 1);
+    uint k, l;
+
+    for(l = 0; l < NS_LANES; l++) {
+        const uint j = NS_WORD0(X[last], l) & (N - 1);
+
+        for(k = 0; k < chunks; k++) {
+            __m128i *x = (__m128i *) X + k * NS_LANES + l;
+
+            _mm_store_si128(x, _mm_xor_si128(_mm_load_si128(x),
+              _mm_load_si128((const __m128i *) V + (j * chunks + k) * NS_LANES + l)));
+        }
+    }
+}
+
+/* X = SMix(X) over all lanes, V = N * r * 8 vectors */
+NS_FN void NS(smix)(NS_VEC *X, NS_VEC *V, NS_VEC *Y, uint r, uint N, uint mixmode) {
+    const uint chunks = 8 * r;
+    uint i;
+
+    for(i = 0; i < N; i++) {
+        memcpy(&V[i * chunks], X, chunks * sizeof(NS_VEC));
+        NS(blkmix)(X, Y, r, mixmode);
+    }
+
+    for(i = 0; i < N; i++) {
+        NS(blkxor_vj)(X, V, r, N);
+        NS(blkmix)(X, Y, r, mixmode);
+    }
+}
+
+/* Z = SMix_ChaCha(Z) and X = SMix_Salsa(X) interleaved, each with its own V */
+NS_FN void NS(smix2)(NS_VEC *Z, NS_VEC *X, NS_VEC *Vz, NS_VEC *Vx, NS_VEC *Y,
+  uint r, uint N, uint rounds) {
+    const uint chunks = 8 * r;
+    uint i;
+
+    for(i = 0; i < N; i++) {
+        memcpy(&Vz[i * chunks], Z, chunks * sizeof(NS_VEC));
+        memcpy(&Vx[i * chunks], X, chunks * sizeof(NS_VEC));
+        NS(blkmix2)(Z, X, Y, r, rounds);
+    }
+
+    for(i = 0; i < N; i++) {
+        NS(blkxor_vj)(Z, Vz, r, N);
+        NS(blkxor_vj)(X, Vx, r, N);
+        NS(blkmix2)(Z, X, Y, r, rounds);
+    }
+}
+
+/* Permute every 64 byte block of buf into (inverse = 0) or out of
+ * (inverse = 1) the Salsa diagonal layout */
+NS_FN void NS(salsa_layout)(uchar *buf, uint blocks, int inverse) {
+    uint tmp[16], *w;
+    uint b, i;
+
+    for(b = 0; b < blocks; b++) {
+        w = (uint *) &buf[b * BLOCK_SIZE];
+        memcpy(tmp, w, BLOCK_SIZE);
+        for(i = 0; i < 16; i++) {
+            if(inverse)
+              w[(i * 5) & 15] = tmp[i];
+            else
+              w[i] = tmp[(i * 5) & 15];
+        }
+    }
+}
+
+/* NeoScrypt over NS_LANES passwords of 80 bytes, see neoscrypt() */
+NS_FN void NS(neoscrypt)(const uchar *passwords, uchar *outputs,
+  uint N, uint r, uint dblmix, uint mixmode, uchar *work) {
+    const uint chunks = 8 * r;
+    const uint lane_size = r * 2 * BLOCK_SIZE;
+    NS_VEC *X, *Y, *Z, *V;
+    uchar *lanes[NS_LANES];
+    uint i, l;
+
+    X = (NS_VEC *) work;
+    Y = &X[chunks];
+    Z = &Y[chunks];
+    V = &Z[chunks];
+    for(l = 0; l < NS_LANES; l++)
+      lanes[l] = (uchar *) &V[(dblmix ? 2 : 1) * N * chunks] + l * lane_size;
+
+    /* X = KDF(password, salt) */
+    for(l = 0; l < NS_LANES; l++)
+      NS(fastkdf)(&passwords[l * 80], 80, &passwords[l * 80], 80,
+        lanes[l], lane_size);
+
+    /* Z = X for ChaCha in the natural layout */
+    if(dblmix) {
+        for(i = 0; i < chunks; i++)
+          Z[i] = NS_GATHER(lanes[0] + i * 16, lane_size);
+    }
+
+    for(l = 0; l < NS_LANES; l++)
+      NS(salsa_layout)(lanes[l], 2 * r, 0);
+
+    for(i = 0; i < chunks; i++)
+      X[i] = NS_GATHER(lanes[0] + i * 16, lane_size);
+
+    if(dblmix)
+      NS(smix2)(Z, X, V, &V[N * chunks], Y, r, N, mixmode & 0xFF);
+    else
+      NS(smix)(X, V, Y, r, N, mixmode);
+
+    for(i = 0; i < chunks; i++)
+      NS_SCATTER(X[i], lanes[0] + i * 16, lane_size);
+
+    for(l = 0; l < NS_LANES; l++)
+      NS(salsa_layout)(lanes[l], 2 * r, 1);
+
+    /* X ^= Z, Z is stored with the lanes interleaved per chunk */
+    if(dblmix) {
+        for(l = 0; l < NS_LANES; l++) {
+            for(i = 0; i < chunks; i++) {
+                __m128i *x = (__m128i *) (lanes[l] + i * 16);
+
+                _mm_store_si128(x, _mm_xor_si128(_mm_load_si128(x),
+                  _mm_load_si128((const __m128i *) Z + i * NS_LANES + l)));
+            }
+        }
+    }
+
+    /* output = KDF(password, X) */
+    for(l = 0; l < NS_LANES; l++)
+      NS(fastkdf)(&passwords[l * 80], 80, lanes[l], lane_size,
+        &outputs[l * 32], 32);
+}
+
+#undef NS_FN
+#undef NS
+#undef NS_CAT
+#undef NS_CAT_
@@ -2589,23 +2589,33 @@ static void neoscrypt_blkmix(uint *X, uint *Y, uint r, uint mixmode) {
  *     .....
  *     11110 = N of 2147483648;
  *   profile bits 30 to 13 are reserved */
-void neoscrypt(const uchar *password, uchar *output, uint profile) {
-    const size_t stack_align = 0x40;
-    uint N = 128, r = 2, dblmix = 1, mixmode = 0x14;
-    uint kdf, i, j;
-    uint *X, *Y, *Z, *V;
+static void neoscrypt_params(uint profile, uint *N, uint *r, uint *dblmix,
+  uint *mixmode) {
+    *N = 128;
+    *r = 2;
+    *dblmix = 1;
+    *mixmode = 0x14;
 
     if(profile & 0x1) {
-        N = 1024;        /* N = (1 << (Nfactor + 1)); */
-        r = 1;           /* r = (1 << rfactor); */
-        dblmix = 0;      /* Salsa only */
-        mixmode = 0x08;  /* 8 rounds */
+        *N = 1024;        /* N = (1 << (Nfactor + 1)); */
+        *r = 1;           /* r = (1 << rfactor); */
+        *dblmix = 0;      /* Salsa only */
+        *mixmode = 0x08;  /* 8 rounds */
     }
 
     if(profile >> 31) {
-        N = (1 << (((profile >> 8) & 0x1F) + 1));
-        r = (1 << ((profile >> 5) & 0x7));
+        *N = (1 << (((profile >> 8) & 0x1F) + 1));
+        *r = (1 << ((profile >> 5) & 0x7));
     }
+}
+
+void neoscrypt(const uchar *password, uchar *output, uint profile) {
+    const size_t stack_align = 0x40;
+    uint N, r, dblmix, mixmode;
+    uint kdf, i, j;
+    uint *X, *Y, *Z, *V;
+
+    neoscrypt_params(profile, &N, &r, &dblmix, &mixmode);
 
     // No VLAs with VC ;-(
 #ifndef _MSC_VER
@@ -3277,3 +3287,211 @@ uint cpu_vec_exts() {
     return(0);
 }
 #endif
+
+
+/* Intrinsics based kernels selected at runtime by CPU feature:
+ *   SSE2 - one hash per call in 128-bit registers;
+ *   AVX2 - two hashes per call, one per 128-bit lane, and the SSE2 kernel
+ *          re-targeted to VEX encoding for odd hashes.
+ * FastKDF only; builds with the SHA256 or BLAKE256 KDFs enabled fall back to
+ * the reference code for those profiles. */
+
+#if defined(_MSC_VER)
+#define NEOSCRYPT_TLS __declspec(thread)
+#else
+#define NEOSCRYPT_TLS __thread
+#endif
+
+#if !defined(ASM) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NEOSCRYPT_SIMD
+#endif
+
+#ifdef NEOSCRYPT_SIMD
+
+#include <immintrin.h>
+
+#ifndef FASTKDF_BUFFER_SIZE
+#define FASTKDF_BUFFER_SIZE 256U
+#endif
+
+static const uchar blake2s_sigma[10][16] = {
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 },
+    { 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 },
+    {  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 },
+    {  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 },
+    {  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 },
+    { 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 },
+    { 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 },
+    {  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 },
+    { 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0 }
+};
+
+/* Initialisation vector with the FastKDF parameter block XOR'ed in
+ * (32 byte digest, 32 byte key, fanout 1, depth 1) */
+static const uint blake2s_IV_P_XOR_KDF[8] = {
+    0x6B08C647, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+    0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+/* SSE2, one hash */
+#define NS_SUFFIX _sse2
+#define NS_TARGET "sse2"
+#define NS_LANES 1
+#define NS_VEC __m128i
+#define NS_ADD _mm_add_epi32
+#define NS_XOR _mm_xor_si128
+#define NS_SHUF _mm_shuffle_epi32
+#define NS_ROTL(v, n) _mm_or_si128(_mm_slli_epi32(v, n), _mm_srli_epi32(v, 32 - (n)))
+#define NS_ROTL16(v) _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xB1), 0xB1)
+#define NS_ROTL8(v) NS_ROTL(v, 8)
+#define NS_WORD0(v, l) ((uint) _mm_cvtsi128_si32(v))
+#define NS_GATHER(p, stride) _mm_load_si128((const __m128i *) (p))
+#define NS_SCATTER(v, p, stride) _mm_store_si128((__m128i *) (p), v)
+#include "neoscrypt-simd.h"
+#undef NS_SUFFIX
+#undef NS_TARGET
+
+/* SSE2 kernel with VEX encoding and SSSE3 byte shuffles, one hash */
+#define NS_SUFFIX _avx
+#define NS_TARGET "avx2"
+#undef NS_ROTL16
+#undef NS_ROTL8
+#define NS_ROTL16(v) _mm_shuffle_epi8(v, _mm_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2))
+#define NS_ROTL8(v) _mm_shuffle_epi8(v, _mm_set_epi8(14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3))
+#include "neoscrypt-simd.h"
+#undef NS_SUFFIX
+#undef NS_TARGET
+#undef NS_LANES
+#undef NS_VEC
+#undef NS_ADD
+#undef NS_XOR
+#undef NS_SHUF
+#undef NS_ROTL
+#undef NS_ROTL16
+#undef NS_ROTL8
+#undef NS_WORD0
+#undef NS_GATHER
+#undef NS_SCATTER
+
+/* AVX2, two hashes */
+#define NS_SUFFIX _avx2
+#define NS_TARGET "avx2"
+#define NS_LANES 2
+#define NS_VEC __m256i
+#define NS_ADD _mm256_add_epi32
+#define NS_XOR _mm256_xor_si256
+#define NS_SHUF _mm256_shuffle_epi32
+#define NS_ROTL(v, n) _mm256_or_si256(_mm256_slli_epi32(v, n), _mm256_srli_epi32(v, 32 - (n)))
+#define NS_ROTL16(v) _mm256_shuffle_epi8(v, _mm256_set_epi8( \
+    13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2, \
+    13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2))
+#define NS_ROTL8(v) _mm256_shuffle_epi8(v, _mm256_set_epi8( \
+    14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3, \
+    14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3))
+#define NS_WORD0(v, l) ((uint) _mm_cvtsi128_si32((l) ? \
+    _mm256_extracti128_si256(v, 1) : _mm256_castsi256_si128(v)))
+#define NS_GATHER(p, stride) _mm256_inserti128_si256(_mm256_castsi128_si256( \
+    _mm_load_si128((const __m128i *) (p))), _mm_load_si128((const __m128i *) ((p) + (stride))), 1)
+#define NS_SCATTER(v, p, stride) do { \
+    _mm_store_si128((__m128i *) (p), _mm256_castsi256_si128(v)); \
+    _mm_store_si128((__m128i *) ((p) + (stride)), _mm256_extracti128_si256(v, 1)); } while(0)
+#include "neoscrypt-simd.h"
+#undef NS_SUFFIX
+#undef NS_TARGET
+#undef NS_LANES
+#undef NS_VEC
+#undef NS_ADD
+#undef NS_XOR
+#undef NS_SHUF
+#undef NS_ROTL
+#undef NS_ROTL16
+#undef NS_ROTL8
+#undef NS_WORD0
+#undef NS_GATHER
+#undef NS_SCATTER
+
+/* per-thread work buffer, grown on demand and reused across calls */
+static NEOSCRYPT_TLS uchar *neoscrypt_arena = NULL;
+static NEOSCRYPT_TLS size_t neoscrypt_arena_size = 0;
+
+static uchar *neoscrypt_work(size_t size) {
+    const size_t align = 0x40;
+
+    if(size + align > neoscrypt_arena_size) {
+        free(neoscrypt_arena);
+
+        neoscrypt_arena = (uchar *) malloc(size + align);
+        neoscrypt_arena_size = neoscrypt_arena ? size + align : 0;
+
+        if(!neoscrypt_arena)
+          return(NULL);
+    }
+
+    return((uchar *) (((size_t)neoscrypt_arena + align - 1) & ~(align - 1)));
+}
+
+#endif /* NEOSCRYPT_SIMD */
+
+uint neoscrypt_kernel(void) {
+#ifdef NEOSCRYPT_SIMD
+    __builtin_cpu_init();
+
+    if(__builtin_cpu_supports("avx2"))
+      return(NEOSCRYPT_KERNEL_AVX2);
+    if(__builtin_cpu_supports("sse2"))
+      return(NEOSCRYPT_KERNEL_SSE2);
+#endif
+
+    return(NEOSCRYPT_KERNEL_SCALAR);
+}
+
+/* Hashes count 80 byte inputs stored back to back into count 32 byte
+ * outputs; kernel is one of NEOSCRYPT_KERNEL_*, AUTO picks the best one
+ * available and a kernel the CPU lacks is downgraded */
+void neoscrypt_batch(const uchar *inputs, uchar *outputs, uint count,
+  uint profile, uint kernel) {
+    uint i = 0;
+#ifdef NEOSCRYPT_SIMD
+    uint N, r, dblmix, mixmode;
+    uint best = neoscrypt_kernel();
+    uchar *work;
+
+    if(kernel == NEOSCRYPT_KERNEL_AUTO || kernel > best)
+      kernel = best;
+
+#if defined(SHA256) || defined(BLAKE256)
+    if((profile >> 1) & 0xF)
+      kernel = NEOSCRYPT_KERNEL_SCALAR;
+#endif
+
+    neoscrypt_params(profile, &N, &r, &dblmix, &mixmode);
+
+    if(kernel != NEOSCRYPT_KERNEL_SCALAR) {
+        const uint lanes = (kernel == NEOSCRYPT_KERNEL_AVX2) ? 2 : 1;
+
+        /* X, Y, Z and one V per SMix for all lanes plus the per-lane
+         * byte buffers */
+        work = neoscrypt_work((size_t)((dblmix ? 2 : 1) * N + 3) * r * 2 *
+          BLOCK_SIZE * lanes + (size_t)lanes * r * 2 * BLOCK_SIZE);
+
+        if(work) {
+            if(kernel == NEOSCRYPT_KERNEL_AVX2) {
+                for(; i + 2 <= count; i += 2)
+                  neoscrypt_avx2(&inputs[i * 80], &outputs[i * 32], N, r,
+                    dblmix, mixmode, work);
+                for(; i < count; i++)
+                  neoscrypt_avx(&inputs[i * 80], &outputs[i * 32], N, r,
+                    dblmix, mixmode, work);
+            } else {
+                for(; i < count; i++)
+                  neoscrypt_sse2(&inputs[i * 80], &outputs[i * 32], N, r,
+                    dblmix, mixmode, work);
+            }
+        }
+    }
+#endif
+
+    for(; i < count; i++)
+      neoscrypt(&inputs[i * 80], &outputs[i * 32], profile);
+}
@@ -32,6 +32,16 @@ void neoscrypt_fastkdf_4way(const unsigned char *password,
 
 unsigned int cpu_vec_exts(void);
 
+#define NEOSCRYPT_KERNEL_AUTO   0
+#define NEOSCRYPT_KERNEL_SCALAR 1
+#define NEOSCRYPT_KERNEL_SSE2   2
+#define NEOSCRYPT_KERNEL_AVX2   3
+
+unsigned int neoscrypt_kernel(void);
+
+void neoscrypt_batch(const unsigned char *inputs, unsigned char *outputs,
+  unsigned int count, unsigned int profile, unsigned int kernel);
+
 #if (__cplusplus)
 }
 #else
@@ -0,0 +1,179 @@
+/*
+ * Multi-lane SMix kernel template.
+ *
+ * This file is included once per lane width by scryptn.c with the following
+ * macros defined:
+ *
+ *   SCRYPT_LANES          number of independent hashes processed per call
+ *   SCRYPT_LANES_TARGET   GCC target string the kernel is compiled for
+ *   SCRYPT_LANES_SUFFIX   suffix appended to every generated symbol
+ *
+ * Lane state is stored word-interleaved: element k of a vector holds word k
+ * of every lane, so a single Salsa20/8 invocation on vectors advances all
+ * lanes at once. Only the data-dependent V_j lookups are done per lane.
+ */
+
+#define SCRYPT_LANES_CAT_(a, b) a##b
+#define SCRYPT_LANES_CAT(a, b) SCRYPT_LANES_CAT_(a, b)
+#define SL(name) SCRYPT_LANES_CAT(name, SCRYPT_LANES_SUFFIX)
+#define SL_FN static __attribute__((target(SCRYPT_LANES_TARGET)))
+
+typedef uint32_t SL(scrypt_vec) __attribute__((vector_size(4 * SCRYPT_LANES), aligned(4 * SCRYPT_LANES)));
+
+SL_FN void
+SL(salsa20_8)(SL(scrypt_vec) B[16])
+{
+	SL(scrypt_vec) x[16];
+	size_t i;
+
+	for (i = 0; i < 16; i++)
+		x[i] = B[i];
+
+	for (i = 0; i < 8; i += 2) {
+#define R(a,b) (((a) << (b)) | ((a) >> (32 - (b))))
+		/* Operate on columns. */
+		x[ 4] ^= R(x[ 0]+x[12], 7);  x[ 8] ^= R(x[ 4]+x[ 0], 9);
+		x[12] ^= R(x[ 8]+x[ 4],13);  x[ 0] ^= R(x[12]+x[ 8],18);
+
+		x[ 9] ^= R(x[ 5]+x[ 1], 7);  x[13] ^= R(x[ 9]+x[ 5], 9);
+		x[ 1] ^= R(x[13]+x[ 9],13);  x[ 5] ^= R(x[ 1]+x[13],18);
+
+		x[14] ^= R(x[10]+x[ 6], 7);  x[ 2] ^= R(x[14]+x[10], 9);
+		x[ 6] ^= R(x[ 2]+x[14],13);  x[10] ^= R(x[ 6]+x[ 2],18);
+
+		x[ 3] ^= R(x[15]+x[11], 7);  x[ 7] ^= R(x[ 3]+x[15], 9);
+		x[11] ^= R(x[ 7]+x[ 3],13);  x[15] ^= R(x[11]+x[ 7],18);
+
+		/* Operate on rows. */
+		x[ 1] ^= R(x[ 0]+x[ 3], 7);  x[ 2] ^= R(x[ 1]+x[ 0], 9);
+		x[ 3] ^= R(x[ 2]+x[ 1],13);  x[ 0] ^= R(x[ 3]+x[ 2],18);
+
+		x[ 6] ^= R(x[ 5]+x[ 4], 7);  x[ 7] ^= R(x[ 6]+x[ 5], 9);
+		x[ 4] ^= R(x[ 7]+x[ 6],13);  x[ 5] ^= R(x[ 4]+x[ 7],18);
+
+		x[11] ^= R(x[10]+x[ 9], 7);  x[ 8] ^= R(x[11]+x[10], 9);
+		x[ 9] ^= R(x[ 8]+x[11],13);  x[10] ^= R(x[ 9]+x[ 8],18);
+
+		x[12] ^= R(x[15]+x[14], 7);  x[13] ^= R(x[12]+x[15], 9);
+		x[14] ^= R(x[13]+x[12],13);  x[15] ^= R(x[14]+x[13],18);
+#undef R
+	}
+	for (i = 0; i < 16; i++)
+		B[i] += x[i];
+}
+
+/**
+ * blockmix_salsa8 over SCRYPT_LANES interleaved lanes. Same contract as the
+ * scalar version with every word widened to a lane vector.
+ */
+SL_FN void
+SL(blockmix_salsa8)(SL(scrypt_vec) * Bin, SL(scrypt_vec) * Bout, SL(scrypt_vec) * X, size_t r)
+{
+	size_t i, k;
+
+	/* 1: X <-- B_{2r - 1} */
+	for (k = 0; k < 16; k++)
+		X[k] = Bin[(2 * r - 1) * 16 + k];
+
+	/* 2: for i = 0 to 2r - 1 do */
+	for (i = 0; i < 2 * r; i += 2) {
+		/* 3: X <-- H(X \xor B_i) */
+		for (k = 0; k < 16; k++)
+			X[k] ^= Bin[i * 16 + k];
+		SL(salsa20_8)(X);
+
+		/* 4: Y_i <-- X */
+		for (k = 0; k < 16; k++)
+			Bout[i * 8 + k] = X[k];
+
+		/* 3: X <-- H(X \xor B_i) */
+		for (k = 0; k < 16; k++)
+			X[k] ^= Bin[i * 16 + 16 + k];
+		SL(salsa20_8)(X);
+
+		/* 4: Y_i <-- X */
+		for (k = 0; k < 16; k++)
+			Bout[i * 8 + r * 16 + k] = X[k];
+	}
+}
+
+/**
+ * V_j lookup: every lane picks its own j, so the xor is done lane by lane.
+ */
+SL_FN void
+SL(xor_lookup)(SL(scrypt_vec) * X, const SL(scrypt_vec) * V, size_t r, uint32_t N)
+{
+	const size_t words = 32 * r;
+	const size_t last = (2 * r - 1) * 16;
+	size_t k;
+	int l;
+
+	for (l = 0; l < SCRYPT_LANES; l++) {
+		const uint32_t j = X[last][l] & (N - 1);
+		const SL(scrypt_vec) * Vj = &V[j * words];
+
+		for (k = 0; k < words; k++)
+			X[k][l] ^= Vj[k][l];
+	}
+}
+
+/**
+ * smix over SCRYPT_LANES lanes. B holds the lanes back to back (128r bytes
+ * each), V must be SCRYPT_LANES * 128rN bytes and XY SCRYPT_LANES *
+ * (256r + 64) bytes, both aligned to 64 bytes.
+ */
+SL_FN void
+SL(smix)(uint8_t * B, size_t r, uint32_t N, void * Vp, void * XYp)
+{
+	SL(scrypt_vec) * V = Vp;
+	SL(scrypt_vec) * X = XYp;
+	SL(scrypt_vec) * Y = &X[32 * r];
+	SL(scrypt_vec) * Z = &X[64 * r];
+	const size_t words = 32 * r;
+	uint32_t i;
+	size_t k;
+	int l;
+
+	/* 1: X <-- B */
+	for (l = 0; l < SCRYPT_LANES; l++) {
+		for (k = 0; k < words; k++)
+			X[k][l] = le32dec(&B[l * 128 * r + 4 * k]);
+	}
+
+	/* 2: for i = 0 to N - 1 do */
+	for (i = 0; i < N; i += 2) {
+		/* 3: V_i <-- X */
+		memcpy(&V[i * words], X, words * sizeof(SL(scrypt_vec)));
+
+		/* 4: X <-- H(X) */
+		SL(blockmix_salsa8)(X, Y, Z, r);
+
+		/* 3: V_i <-- X */
+		memcpy(&V[(i + 1) * words], Y, words * sizeof(SL(scrypt_vec)));
+
+		/* 4: X <-- H(X) */
+		SL(blockmix_salsa8)(Y, X, Z, r);
+	}
+
+	/* 6: for i = 0 to N - 1 do */
+	for (i = 0; i < N; i += 2) {
+		/* 7-8: X <-- H(X \xor V_j) */
+		SL(xor_lookup)(X, V, r, N);
+		SL(blockmix_salsa8)(X, Y, Z, r);
+
+		/* 7-8: X <-- H(X \xor V_j) */
+		SL(xor_lookup)(Y, V, r, N);
+		SL(blockmix_salsa8)(Y, X, Z, r);
+	}
+
+	/* 10: B' <-- X */
+	for (l = 0; l < SCRYPT_LANES; l++) {
+		for (k = 0; k < words; k++)
+			le32enc(&B[l * 128 * r + 4 * k], X[k][l]);
+	}
+}
+
+#undef SL_FN
+#undef SL
+#undef SCRYPT_LANES_CAT
+#undef SCRYPT_LANES_CAT_
@@ -214,11 +214,99 @@ smix(uint8_t * B, size_t r, uint64_t N, uint32_t * V, uint32_t * XY)
 		le32enc(&B[4 * k], X[k]);
 }
 
+#if defined(_MSC_VER)
+#define SCRYPT_TLS __declspec(thread)
+#else
+#define SCRYPT_TLS __thread
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SCRYPT_MULTI_LANE
+#endif
+
+/* per-thread scratch arena, grown on demand and reused across calls */
+static SCRYPT_TLS char * scratch_arena = NULL;
+static SCRYPT_TLS size_t scratch_arena_size = 0;
+
+static char *
+scrypt_scratch(size_t size)
+{
+	if (size > scratch_arena_size) {
+		free(scratch_arena);
+
+		scratch_arena = (char *)malloc(size);
+		scratch_arena_size = scratch_arena ? size : 0;
+	}
+
+	return scratch_arena;
+}
+
+/**
+ * scrypt_hmac_key(ctx, passwd, passwdlen, midstate):
+ * Key an HMAC-SHA256 context with passwd. If midstate is not NULL it must
+ * hold the SHA-256 state after the first 64 bytes of passwd (see
+ * scrypt_midstate) and passwdlen must be greater than 64.
+ */
+static void
+scrypt_hmac_key(HMAC_SHA256_CTX * ctx, const uint8_t * passwd, size_t passwdlen, const uint32_t * midstate)
+{
+	unsigned char khash[32];
+
+	if (midstate == NULL || passwdlen <= 64) {
+		HMAC_SHA256_Init(ctx, passwd, passwdlen);
+		return;
+	}
+
+	/* The key is SHA256(passwd), resume it from the prefix midstate */
+	memcpy(ctx->ictx.state, midstate, 32);
+	ctx->ictx.count[0] = 0;
+	ctx->ictx.count[1] = 64 << 3;
+	SHA256_Update(&ctx->ictx, passwd + 64, passwdlen - 64);
+	SHA256_Final(khash, &ctx->ictx);
+
+	HMAC_SHA256_Init(ctx, khash, 32);
+	memset(khash, 0, 32);
+}
+
+/**
+ * scrypt_pbkdf2(keyed, salt, saltlen, buf, dkLen):
+ * PBKDF2-HMAC-SHA256 with c = 1 from an already keyed HMAC context, so the
+ * key schedule is derived once per hash and shared by both passes.
+ */
+static void
+scrypt_pbkdf2(const HMAC_SHA256_CTX * keyed, const uint8_t * salt, size_t saltlen, uint8_t * buf, size_t dkLen)
+{
+	HMAC_SHA256_CTX PShctx, hctx;
+	uint8_t ivec[4];
+	uint8_t U[32];
+	size_t i, clen;
+
+	memcpy(&PShctx, keyed, sizeof(HMAC_SHA256_CTX));
+	HMAC_SHA256_Update(&PShctx, salt, saltlen);
+
+	for (i = 0; i * 32 < dkLen; i++) {
+		be32enc(ivec, (uint32_t)(i + 1));
+
+		memcpy(&hctx, &PShctx, sizeof(HMAC_SHA256_CTX));
+		HMAC_SHA256_Update(&hctx, ivec, 4);
+		HMAC_SHA256_Final(U, &hctx);
+
+		clen = dkLen - i * 32;
+		if (clen > 32)
+			clen = 32;
+		memcpy(&buf[i * 32], U, clen);
+	}
+
+	memset(&PShctx, 0, sizeof(HMAC_SHA256_CTX));
+}
+
 /* cpu and memory intensive function to transform a 80 byte buffer into a 32 byte output
    scratchpad size needs to be at least 63 + (128 * r * p) + (256 * r + 64) + (128 * r * N) bytes
  */
-void scrypt_N_R_1_256_sp(const char* input, char* output, char* scratchpad, uint32_t N, uint32_t R, uint32_t len)
+static void
+scrypt_N_R_1_256_ms(const char* input, char* output, char* scratchpad, uint32_t N, uint32_t R, uint32_t len, const uint32_t* midstate)
 {
+	HMAC_SHA256_CTX keyed;
 	uint8_t * B;
 	uint32_t * V;
 	uint32_t * XY;
@@ -232,8 +320,10 @@ void scrypt_N_R_1_256_sp(const char* input, char* output, char* scratchpad, uint
 	XY = (uint32_t *)(B + (128 * r * p));
 	V = (uint32_t *)(B + (128 * r * p) + (256 * r + 64));
 
+	scrypt_hmac_key(&keyed, (const uint8_t*)input, len, midstate);
+
 	/* 1: (B_0 ... B_{p-1}) <-- PBKDF2(P, S, 1, p * MFLen) */
-	PBKDF2_SHA256((const uint8_t*)input, len, (const uint8_t*)input, len, 1, B, p * 128 * r);
+	scrypt_pbkdf2(&keyed, (const uint8_t*)input, len, B, p * 128 * r);
 
 	/* 2: for i = 0 to p - 1 do */
 	for (i = 0; i < p; i++) {
@@ -242,17 +332,149 @@ void scrypt_N_R_1_256_sp(const char* input, char* output, char* scratchpad, uint
 	}
 
 	/* 5: DK <-- PBKDF2(P, B, 1, dkLen) */
-	PBKDF2_SHA256((const uint8_t*)input, len, B, p * 128 * r, 1, (uint8_t*)output, 32);
+	scrypt_pbkdf2(&keyed, B, p * 128 * r, (uint8_t*)output, 32);
+
+	memset(&keyed, 0, sizeof(keyed));
+}
+
+void scrypt_N_R_1_256_sp(const char* input, char* output, char* scratchpad, uint32_t N, uint32_t R, uint32_t len)
+{
+	scrypt_N_R_1_256_ms(input, output, scratchpad, N, R, len, NULL);
 }
 
 void scrypt_N_R_1_256(const char* input, char* output, uint32_t N, uint32_t R, uint32_t len)
 {
-	//char scratchpad[131583];
-    char *scratchpad;
-    
-    // align on 4 byte boundary
-    scratchpad = (char*)malloc(128*N*R + (128*R)+(256*R)+64+64);
-	scrypt_N_R_1_256_sp(input, output, scratchpad, N, R, len);
-    free(scratchpad);
+	char *scratchpad = scrypt_scratch(128*N*R + (128*R)+(256*R)+64+64);
+
+	scrypt_N_R_1_256_ms(input, output, scratchpad, N, R, len, NULL);
+}
+
+void scrypt_midstate(const char* input, uint32_t* midstate)
+{
+	SHA256_CTX ctx;
+
+	SHA256_Init(&ctx);
+	SHA256_Transform(ctx.state, (const unsigned char*)input);
+	memcpy(midstate, ctx.state, 32);
+}
+
+#ifdef SCRYPT_MULTI_LANE
+
+#define SCRYPT_LANES 4
+#define SCRYPT_LANES_TARGET "sse2"
+#define SCRYPT_LANES_SUFFIX _x4
+#include "scryptn-lanes.h"
+#undef SCRYPT_LANES
+#undef SCRYPT_LANES_TARGET
+#undef SCRYPT_LANES_SUFFIX
+
+#define SCRYPT_LANES 8
+#define SCRYPT_LANES_TARGET "avx2"
+#define SCRYPT_LANES_SUFFIX _x8
+#include "scryptn-lanes.h"
+#undef SCRYPT_LANES
+#undef SCRYPT_LANES_TARGET
+#undef SCRYPT_LANES_SUFFIX
+
+#define SCRYPT_LANES 16
+#define SCRYPT_LANES_TARGET "avx512f"
+#define SCRYPT_LANES_SUFFIX _x16
+#include "scryptn-lanes.h"
+#undef SCRYPT_LANES
+#undef SCRYPT_LANES_TARGET
+#undef SCRYPT_LANES_SUFFIX
+
+typedef void (*scrypt_smix_lanes_fn)(uint8_t *, size_t, uint32_t, void *, void *);
+
+/*
+ * Runs one group of lanes: PBKDF2 pass 1 per lane, SMix on all lanes at
+ * once, PBKDF2 pass 2 per lane.
+ */
+static void
+scrypt_hash_lanes(scrypt_smix_lanes_fn smix_lanes, uint32_t lanes, const char* inputs, char* outputs,
+	uint32_t N, uint32_t r, uint32_t len, const uint32_t* midstate)
+{
+	HMAC_SHA256_CTX keyed[16];
+	uint8_t * B;
+	char * V;
+	char * XY;
+	uint32_t l;
+
+	B = (uint8_t *)(((uintptr_t)(scrypt_scratch((size_t)lanes * (128 * r * N + 128 * r + 256 * r + 64) + 64)) + 63) & ~(uintptr_t)(63));
+	XY = (char *)(B + lanes * 128 * r);
+	V = XY + lanes * (256 * r + 64);
+
+	for (l = 0; l < lanes; l++) {
+		const uint8_t * input = (const uint8_t *)&inputs[l * len];
+
+		scrypt_hmac_key(&keyed[l], input, len, midstate);
+		scrypt_pbkdf2(&keyed[l], input, len, &B[l * 128 * r], 128 * r);
+	}
+
+	smix_lanes(B, r, N, V, XY);
+
+	for (l = 0; l < lanes; l++) {
+		scrypt_pbkdf2(&keyed[l], &B[l * 128 * r], 128 * r, (uint8_t *)&outputs[l * 32], 32);
+		memset(&keyed[l], 0, sizeof(HMAC_SHA256_CTX));
+	}
 }
 
+#endif
+
+uint32_t scrypt_max_lanes(void)
+{
+#ifdef SCRYPT_MULTI_LANE
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx512f"))
+		return 16;
+	if (__builtin_cpu_supports("avx2"))
+		return 8;
+	if (__builtin_cpu_supports("sse2"))
+		return 4;
+#endif
+
+	return 1;
+}
+
+/**
+ * scrypt_N_R_1_256_batch(inputs, outputs, count, N, R, len, midstate, lanes):
+ * Hash count inputs of len bytes each, stored back to back, into count 32
+ * byte outputs. Inputs are processed in groups of the widest supported lane
+ * width that is not larger than lanes (0 = widest available) and the number
+ * of remaining inputs; leftovers go through the scalar path. midstate is
+ * optional and, if present, must be valid for every input.
+ */
+void scrypt_N_R_1_256_batch(const char* inputs, char* outputs, uint32_t count, uint32_t N, uint32_t R, uint32_t len,
+	const uint32_t* midstate, uint32_t lanes)
+{
+	uint32_t max_lanes = scrypt_max_lanes();
+	uint32_t i = 0;
+
+	if (lanes == 0 || lanes > max_lanes)
+		lanes = max_lanes;
+
+	/* round down to a kernel width */
+	while (lanes & (lanes - 1))
+		lanes &= lanes - 1;
+
+#ifdef SCRYPT_MULTI_LANE
+	while (count - i >= 4 && lanes >= 4) {
+		uint32_t width = lanes;
+
+		while (width > count - i)
+			width >>= 1;
+
+		scrypt_hash_lanes(width == 16 ? smix_x16 : width == 8 ? smix_x8 : smix_x4,
+			width, &inputs[i * len], &outputs[i * 32], N, R, len, midstate);
+
+		i += width;
+	}
+#endif
+
+	for (; i < count; i++) {
+		char *scratchpad = scrypt_scratch(128*N*R + (128*R)+(256*R)+64+64);
+
+		scrypt_N_R_1_256_ms(&inputs[i * len], &outputs[i * 32], scratchpad, N, R, len, midstate);
+	}
+}
@@ -7,6 +7,9 @@ extern "C" {
 
 void scrypt_N_R_1_256(const char* input, char* output, uint32_t N, uint32_t R, uint32_t len);
 void scrypt_N_R_1_256_sp(const char* input, char* output, char* scratchpad, uint32_t N, uint32_t R, uint32_t len);
+void scrypt_N_R_1_256_batch(const char* inputs, char* outputs, uint32_t count, uint32_t N, uint32_t R, uint32_t len, const uint32_t* midstate, uint32_t lanes);
+void scrypt_midstate(const char* input, uint32_t* midstate);
+uint32_t scrypt_max_lanes(void);
 //const int scrypt_scratchpad_size = 131583;
 
 #ifdef __cplusplus
@@ -0,0 +1,124 @@
+/*
+ * Multi-buffer SHA-512/256d kernel template.
+ *
+ * This file is included by sha512_256.c once per kernel with the following
+ * macros defined:
+ *
+ *   SH_SUFFIX          suffix appended to every generated symbol
+ *   SH_TARGET          GCC target string the kernel is compiled for
+ *   SH_LANES           messages hashed per call, one per 64-bit vector lane
+ *   SH_VEC             vector type
+ *   SH_ADD, SH_XOR     64-bit lane add, bitwise xor
+ *   SH_ROTR(v, n)      64-bit rotate right
+ *   SH_SHR(v, n)       64-bit shift right
+ *   SH_CH, SH_MAJ      SHA-2 choose and majority
+ *   SH_XOR3            three way xor
+ *   SH_SET1(x)         broadcast a 64-bit constant
+ *   SH_LOAD, SH_STORE  aligned load and store of SH_LANES words
+ *
+ * Lane l of every vector holds the state of message l. The second pass
+ * takes the first pass digest words straight from the state vectors, its
+ * padding is constant.
+ */
+
+#define SH_CAT_(a, b) a##b
+#define SH_CAT(a, b) SH_CAT_(a, b)
+#define SH(name) SH_CAT(name, SH_SUFFIX)
+#define SH_FN static __attribute__((target(SH_TARGET)))
+
+#define SH_F1(x) SH_XOR3(SH_ROTR(x, 28), SH_ROTR(x, 34), SH_ROTR(x, 39))
+#define SH_F2(x) SH_XOR3(SH_ROTR(x, 14), SH_ROTR(x, 18), SH_ROTR(x, 41))
+#define SH_F3(x) SH_XOR3(SH_ROTR(x,  1), SH_ROTR(x,  8), SH_SHR(x,  7))
+#define SH_F4(x) SH_XOR3(SH_ROTR(x, 19), SH_ROTR(x, 61), SH_SHR(x,  6))
+
+/* One block, w holds the 16 message words and is used as schedule ring */
+SH_FN void SH(sha512_transf)(SH_VEC *h, SH_VEC *w) {
+    SH_VEC a = h[0], b = h[1], c = h[2], d = h[3];
+    SH_VEC e = h[4], f = h[5], g = h[6], hh = h[7];
+    SH_VEC t1, t2;
+    int j;
+
+    for (j = 0; j < 80; j++) {
+        if (j >= 16) {
+            w[j & 15] = SH_ADD(SH_ADD(SH_F4(w[(j - 2) & 15]), w[(j - 7) & 15]),
+                SH_ADD(SH_F3(w[(j - 15) & 15]), w[j & 15]));
+        }
+
+        t1 = SH_ADD(SH_ADD(SH_ADD(hh, SH_F2(e)), SH_ADD(SH_CH(e, f, g),
+            SH_SET1(sha512_k[j]))), w[j & 15]);
+        t2 = SH_ADD(SH_F1(a), SH_MAJ(a, b, c));
+        hh = g;
+        g = f;
+        f = e;
+        e = SH_ADD(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = SH_ADD(t1, t2);
+    }
+
+    h[0] = SH_ADD(h[0], a); h[1] = SH_ADD(h[1], b);
+    h[2] = SH_ADD(h[2], c); h[3] = SH_ADD(h[3], d);
+    h[4] = SH_ADD(h[4], e); h[5] = SH_ADD(h[5], f);
+    h[6] = SH_ADD(h[6], g); h[7] = SH_ADD(h[7], hh);
+}
+
+/* Hashes n <= SH_LANES messages of len bytes each, stored back to back.
+ * Unused lanes repeat the first message and their digests are dropped. */
+SH_FN void SH(sha512_256d)(const unsigned char *inputs, unsigned char *outputs,
+                           unsigned int len, unsigned int n) {
+    uint64_t m[16][SH_LANES] __attribute__((aligned(64)));
+    SH_VEC h[8], w[16];
+    const unsigned int block_nb = (len + 17 + SHA512_BLOCK_SIZE - 1) / SHA512_BLOCK_SIZE;
+    unsigned int b, i, j, l;
+
+    for (i = 0; i < 8; i++)
+        h[i] = SH_SET1(sha512_256_h0[i]);
+
+    for (b = 0; b < block_nb; b++) {
+        for (l = 0; l < SH_LANES; l++) {
+            const unsigned char *msg = inputs + (l < n ? l : 0) * len;
+
+            for (j = 0; j < 16; j++)
+                m[j][l] = sha512_256_msg_word(msg, len, block_nb, (b << 7) + (j << 3));
+        }
+
+        for (j = 0; j < 16; j++)
+            w[j] = SH_LOAD(m[j]);
+
+        SH(sha512_transf)(h, w);
+    }
+
+    /* second pass over the 32 byte digest */
+    for (j = 0; j < 4; j++)
+        w[j] = h[j];
+
+    w[4] = SH_SET1(0x8000000000000000ULL);
+
+    for (j = 5; j < 15; j++)
+        w[j] = SH_SET1(0);
+
+    w[15] = SH_SET1(32 << 3);
+
+    for (i = 0; i < 8; i++)
+        h[i] = SH_SET1(sha512_256_h0[i]);
+
+    SH(sha512_transf)(h, w);
+
+    for (j = 0; j < 4; j++)
+        SH_STORE(m[j], h[j]);
+
+    for (l = 0; l < n; l++) {
+        for (j = 0; j < 4; j++)
+            UNPACK64(m[j][l], &outputs[(l << 5) + (j << 3)]);
+    }
+}
+
+#undef SH_F1
+#undef SH_F2
+#undef SH_F3
+#undef SH_F4
+#undef SH_CAT_
+#undef SH_CAT
+#undef SH
+#undef SH_FN
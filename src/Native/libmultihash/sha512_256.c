@@ -363,3 +363,165 @@ void sha512_256_final(sha512_256_ctx *ctx, unsigned char *digest)
 
 #endif /* !UNROLL_LOOPS */
 }
+
+/* SHA-512/256d, the scalar reference for the batch kernels */
+void sha512_256d(const unsigned char *message, unsigned int len,
+            unsigned char *digest)
+{
+    sha512_256(message, len, digest);
+    sha512_256(digest, 32, digest);
+}
+
+/* Multi-buffer kernels selected at runtime by CPU feature:
+ *   AVX2    - four messages per call, one per 64-bit lane;
+ *   AVX-512 - eight messages per call, using native rotates and
+ *             ternary logic for CH, MAJ and the sigma functions. */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SHA512_256_SIMD
+#endif
+
+#ifdef SHA512_256_SIMD
+
+#include <immintrin.h>
+
+/* Big endian message word at byte offset pos of the padded message */
+static inline uint64_t sha512_256_msg_word(const unsigned char *msg,
+    unsigned int len, unsigned int block_nb, unsigned int pos)
+{
+    unsigned char buf[8];
+    uint64_t result;
+    unsigned int i;
+
+    if (pos + 8 <= len) {
+        PACK64(&msg[pos], &result);
+        return result;
+    }
+
+    for (i = 0; i < 8; i++) {
+        buf[i] = pos + i < len ? msg[pos + i] :
+            pos + i == len ? 0x80 : 0;
+    }
+
+    PACK64(buf, &result);
+
+    /* message length in bits, the high 64 bits are always zero here */
+    if (pos == (block_nb << 7) - 8)
+        result |= (uint64_t) len << 3;
+
+    return result;
+}
+
+/* AVX2, four messages */
+#define SH_SUFFIX _avx2
+#define SH_TARGET "avx2"
+#define SH_LANES 4
+#define SH_VEC __m256i
+#define SH_ADD _mm256_add_epi64
+#define SH_XOR _mm256_xor_si256
+#define SH_ROTR(v, n) _mm256_or_si256(_mm256_srli_epi64(v, n), _mm256_slli_epi64(v, 64 - (n)))
+#define SH_SHR _mm256_srli_epi64
+#define SH_CH(x, y, z) _mm256_xor_si256(_mm256_and_si256(x, y), _mm256_andnot_si256(x, z))
+#define SH_MAJ(x, y, z) _mm256_or_si256(_mm256_and_si256(x, y), _mm256_and_si256(z, _mm256_or_si256(x, y)))
+#define SH_XOR3(x, y, z) _mm256_xor_si256(_mm256_xor_si256(x, y), z)
+#define SH_SET1(x) _mm256_set1_epi64x((long long) (x))
+#define SH_LOAD(p) _mm256_load_si256((const __m256i *) (p))
+#define SH_STORE(p, v) _mm256_store_si256((__m256i *) (p), v)
+#include "sha512_256-simd.h"
+#undef SH_SUFFIX
+#undef SH_TARGET
+#undef SH_LANES
+#undef SH_VEC
+#undef SH_ADD
+#undef SH_XOR
+#undef SH_ROTR
+#undef SH_SHR
+#undef SH_CH
+#undef SH_MAJ
+#undef SH_XOR3
+#undef SH_SET1
+#undef SH_LOAD
+#undef SH_STORE
+
+/* AVX-512, eight messages */
+#define SH_SUFFIX _avx512
+#define SH_TARGET "avx512f"
+#define SH_LANES 8
+#define SH_VEC __m512i
+#define SH_ADD _mm512_add_epi64
+#define SH_XOR _mm512_xor_si512
+#define SH_ROTR(v, n) _mm512_ror_epi64(v, n)
+#define SH_SHR _mm512_srli_epi64
+#define SH_CH(x, y, z) _mm512_ternarylogic_epi64(x, y, z, 0xCA)
+#define SH_MAJ(x, y, z) _mm512_ternarylogic_epi64(x, y, z, 0xE8)
+#define SH_XOR3(x, y, z) _mm512_ternarylogic_epi64(x, y, z, 0x96)
+#define SH_SET1(x) _mm512_set1_epi64((long long) (x))
+#define SH_LOAD(p) _mm512_load_si512((const void *) (p))
+#define SH_STORE(p, v) _mm512_store_si512((void *) (p), v)
+#include "sha512_256-simd.h"
+#undef SH_SUFFIX
+#undef SH_TARGET
+#undef SH_LANES
+#undef SH_VEC
+#undef SH_ADD
+#undef SH_XOR
+#undef SH_ROTR
+#undef SH_SHR
+#undef SH_CH
+#undef SH_MAJ
+#undef SH_XOR3
+#undef SH_SET1
+#undef SH_LOAD
+#undef SH_STORE
+
+#endif /* SHA512_256_SIMD */
+
+unsigned int sha512_256_kernel(void)
+{
+#ifdef SHA512_256_SIMD
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f"))
+        return SHA512_256_KERNEL_AVX512;
+    if (__builtin_cpu_supports("avx2"))
+        return SHA512_256_KERNEL_AVX2;
+#endif
+
+    return SHA512_256_KERNEL_SCALAR;
+}
+
+/* Hashes count inputs of len bytes stored back to back into count 32 byte
+ * SHA-512/256d digests; kernel is one of SHA512_256_KERNEL_*, AUTO picks
+ * the best one available and a kernel the CPU lacks is downgraded */
+void sha512_256d_batch(const unsigned char *inputs, unsigned char *outputs,
+                   unsigned int count, unsigned int len, unsigned int kernel)
+{
+    unsigned int i = 0;
+#ifdef SHA512_256_SIMD
+    unsigned int best = sha512_256_kernel();
+
+    if (kernel == SHA512_256_KERNEL_AUTO || kernel > best)
+        kernel = best;
+
+    if (kernel == SHA512_256_KERNEL_AVX512) {
+        for (; i < count; i += 8) {
+            const unsigned int n = count - i < 8 ? count - i : 8;
+
+            /* a short tail is cheaper on the narrower kernel */
+            if (n <= 4)
+                sha512_256d_avx2(&inputs[i * len], &outputs[i << 5], len, n);
+            else
+                sha512_256d_avx512(&inputs[i * len], &outputs[i << 5], len, n);
+        }
+    } else if (kernel == SHA512_256_KERNEL_AVX2) {
+        for (; i < count; i += 4) {
+            const unsigned int n = count - i < 4 ? count - i : 4;
+
+            sha512_256d_avx2(&inputs[i * len], &outputs[i << 5], len, n);
+        }
+    }
+#endif
+
+    for (; i < count; i++)
+        sha512_256d(&inputs[i * len], len, &outputs[i << 5]);
+}
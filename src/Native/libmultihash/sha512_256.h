@@ -71,6 +71,18 @@ void sha512_256_update(sha512_ctx *ctx, const unsigned char *message,
 void sha512_256_final(sha512_ctx *ctx, unsigned char *digest);
 void sha512_256(const unsigned char *message, unsigned int len,
             unsigned char *digest);
+void sha512_256d(const unsigned char *message, unsigned int len,
+            unsigned char *digest);
+
+#define SHA512_256_KERNEL_AUTO   0
+#define SHA512_256_KERNEL_SCALAR 1
+#define SHA512_256_KERNEL_AVX2   2
+#define SHA512_256_KERNEL_AVX512 3
+
+unsigned int sha512_256_kernel(void);
+
+void sha512_256d_batch(const unsigned char *inputs, unsigned char *outputs,
+                   unsigned int count, unsigned int len, unsigned int kernel);
 
 #ifdef __cplusplus
 }
@@ -8,6 +8,10 @@
 
 #ifdef _MSC_VER
 #include <malloc.h>
+#include <xmmintrin.h>
+#define VERTHASH_PREFETCH(p) _mm_prefetch((const char*)(p), _MM_HINT_T0)
+#else
+#define VERTHASH_PREFETCH(p) __builtin_prefetch((p), 0, 3)
 #endif
 
 #define HEADER_SIZE 80
@@ -18,6 +22,7 @@
 #define N_ROT 32
 #define N_INDEXES 4096
 #define BYTE_ALIGNMENT 16
+#define VERTHASH_MAX_LANES 16
 
 #define NODE_SIZE 32
 
@@ -530,6 +535,89 @@ int verthash(const unsigned char* input, const size_t input_size, unsigned char*
     return 1;
 }
 
+// Seek index i of the single lane path is p0 rotated left by i / 128
+static inline uint32_t seek_index(const uint32_t* p0, const size_t i) {
+    const uint32_t value = p0[i % (N_SUBSET/sizeof(uint32_t))];
+    const uint32_t rot = (uint32_t) (i / (N_SUBSET/sizeof(uint32_t)));
+
+    return rot == 0 ? value : (value << rot) | (value >> (32 - rot));
+}
+
+static inline const uint32_t* verthash_lookup(const uint32_t* p0, const size_t i, const uint32_t value_accumulator, const uint32_t mdiv) {
+    const uint32_t* result = (const uint32_t*)blob_bytes + (fnv1a(seek_index(p0, i), value_accumulator) % mdiv) * BYTE_ALIGNMENT/sizeof(uint32_t);
+
+    // 32 bytes at 16 byte alignment may straddle two cache lines
+    VERTHASH_PREFETCH(result);
+    VERTHASH_PREFETCH((const unsigned char*)result + HASH_OUT_SIZE - 1);
+
+    return result;
+}
+
+static void verthash_lanes(const unsigned char* inputs, const size_t input_size, const size_t lanes, unsigned char* outputs) {
+    uint32_t p1[VERTHASH_MAX_LANES][HASH_OUT_SIZE/sizeof(uint32_t)];
+    uint32_t p0[VERTHASH_MAX_LANES][N_SUBSET/sizeof(uint32_t)];
+    uint32_t value_accumulator[VERTHASH_MAX_LANES];
+    const uint32_t* next[VERTHASH_MAX_LANES];
+    const uint32_t mdiv = ((blob_size - HASH_OUT_SIZE)/BYTE_ALIGNMENT) + 1;
+
+#ifndef _MSC_VER
+    unsigned char input_header[input_size];
+#else
+    unsigned char* input_header = _alloca(input_size);
+#endif // !MSVC
+
+    for(size_t lane = 0; lane < lanes; lane++) {
+        const unsigned char* input = inputs + lane * input_size;
+
+        sha3(input, input_size, p1[lane], HASH_OUT_SIZE);
+        memcpy(input_header, input, input_size);
+
+        for(size_t i = 0; i < N_ITER; i++) {
+            input_header[0] += 1;
+            sha3(&input_header[0], input_size, (unsigned char*)p0[lane] + i*P0_SIZE, P0_SIZE);
+        }
+
+        value_accumulator[lane] = 0x811c9dc5;
+        next[lane] = verthash_lookup(p0[lane], 0, value_accumulator[lane], mdiv);
+    }
+
+    // Each lookup depends on the previous one of the same lane only. Walking the lanes in
+    // lock-step gives every prefetch the time it takes to consume all other lanes.
+    for(size_t i = 0; i < N_INDEXES; i++) {
+        for(size_t lane = 0; lane < lanes; lane++) {
+            const uint32_t* src = next[lane];
+            uint32_t acc = value_accumulator[lane];
+
+            for(size_t i2 = 0; i2 < HASH_OUT_SIZE/sizeof(uint32_t); i2++) {
+                const uint32_t value = src[i2];
+                p1[lane][i2] = fnv1a(p1[lane][i2], value);
+                acc = fnv1a(acc, value);
+            }
+
+            value_accumulator[lane] = acc;
+
+            if(i + 1 < N_INDEXES)
+                next[lane] = verthash_lookup(p0[lane], i + 1, acc, mdiv);
+        }
+    }
+
+    for(size_t lane = 0; lane < lanes; lane++)
+        memcpy(outputs + lane * HASH_OUT_SIZE, p1[lane], HASH_OUT_SIZE);
+}
+
+int verthash_batch(const unsigned char* inputs, const size_t input_size, const size_t count, unsigned char* outputs) {
+    if(!blob_initialized)
+        return 0;
+
+    for(size_t i = 0; i < count; i += VERTHASH_MAX_LANES) {
+        const size_t lanes = count - i < VERTHASH_MAX_LANES ? count - i : VERTHASH_MAX_LANES;
+
+        verthash_lanes(inputs + i * input_size, input_size, lanes, outputs + i * HASH_OUT_SIZE);
+    }
+
+    return 1;
+}
+
 int verthash_init(const char* dat_file_name, int createIfMissing) {
     if(blob_initialized == 1) return 0;
 
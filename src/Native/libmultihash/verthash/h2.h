@@ -7,6 +7,7 @@ extern "C" {
 #endif
 
 int verthash(const unsigned char* input, const size_t input_size, unsigned char* output);
+int verthash_batch(const unsigned char* inputs, const size_t input_size, const size_t count, unsigned char* outputs);
 int verthash_init(const char* dat_file_name, int createIfMissing);
 
 #ifdef __cplusplus
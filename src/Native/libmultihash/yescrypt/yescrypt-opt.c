@@ -355,8 +355,119 @@ integerify(const uint64_t * B, size_t r)
 	return ((uint64_t)hi << 32) + lo;
 }
 
+/* Intrinsics based block operation kernels selected at runtime by CPU
+ * feature:
+ *   SSE2 - one 128-bit register per Salsa20 row / pwxform lane;
+ *   AVX  - the SSE2 kernel with VEX encoding;
+ *   XOP  - the AVX kernel with native 32-bit rotates for Salsa20/8. */
+
+typedef struct {
+	void (*blkcpy)(uint64_t *, const uint64_t *, size_t);
+	void (*blkxor)(uint64_t *, const uint64_t *, size_t);
+	void (*blockmix_salsa8)(const uint64_t *, uint64_t *, uint64_t *, size_t);
+	void (*blockmix_pwxform)(const uint64_t *, uint64_t *, uint64_t *, size_t);
+} yescrypt_kernel_t;
+
+#if defined(_MSC_VER)
+#define YESCRYPT_TLS __declspec(thread)
+#else
+#define YESCRYPT_TLS __thread
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    S_P_SIZE == 8
+#define YESCRYPT_SIMD
+#endif
+
+#ifdef YESCRYPT_SIMD
+
+#include <immintrin.h>
+#include <x86intrin.h>
+
+/* SSE2 */
+#define YS_SUFFIX _sse2
+#define YS_TARGET "sse2"
+#define YS_ROTL(v, n) _mm_or_si128(_mm_slli_epi32(v, n), _mm_srli_epi32(v, 32 - (n)))
+#include "yescrypt-simd.h"
+#undef YS_SUFFIX
+#undef YS_TARGET
+
+/* AVX */
+#define YS_SUFFIX _avx
+#define YS_TARGET "avx"
+#include "yescrypt-simd.h"
+#undef YS_SUFFIX
+#undef YS_TARGET
+#undef YS_ROTL
+
+/* XOP */
+#define YS_SUFFIX _xop
+#define YS_TARGET "avx,xop"
+#define YS_ROTL(v, n) _mm_roti_epi32(v, n)
+#include "yescrypt-simd.h"
+#undef YS_SUFFIX
+#undef YS_TARGET
+#undef YS_ROTL
+
+#endif /* YESCRYPT_SIMD */
+
+/* indexed by YESCRYPT_KERNEL_* */
+static const yescrypt_kernel_t yescrypt_kernels[] = {
+	{ blkcpy, blkxor, blockmix_salsa8, blockmix_pwxform },
+	{ blkcpy, blkxor, blockmix_salsa8, blockmix_pwxform },
+#ifdef YESCRYPT_SIMD
+	{ blkcpy_sse2, blkxor_sse2, blockmix_salsa8_sse2, blockmix_pwxform_sse2 },
+	{ blkcpy_avx, blkxor_avx, blockmix_salsa8_avx, blockmix_pwxform_avx },
+	{ blkcpy_xop, blkxor_xop, blockmix_salsa8_xop, blockmix_pwxform_xop },
+#endif
+};
+
+/* kernel requested by the calling thread, see yescrypt_set_kernel() */
+static YESCRYPT_TLS unsigned int yescrypt_kernel_preference = YESCRYPT_KERNEL_AUTO;
+
+unsigned int
+yescrypt_kernel(void)
+{
+#ifdef YESCRYPT_SIMD
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx")) {
+		if (__builtin_cpu_supports("xop"))
+			return YESCRYPT_KERNEL_XOP;
+		return YESCRYPT_KERNEL_AVX;
+	}
+	if (__builtin_cpu_supports("sse2"))
+		return YESCRYPT_KERNEL_SSE2;
+#endif
+
+	return YESCRYPT_KERNEL_SCALAR;
+}
+
+void
+yescrypt_set_kernel(unsigned int kernel)
+{
+	yescrypt_kernel_preference = kernel;
+}
+
+/**
+ * select_kernel():
+ * Return the block operations of the calling thread's kernel.  AUTO picks
+ * the best one available and a kernel the CPU lacks is downgraded.
+ */
+static const yescrypt_kernel_t *
+select_kernel(void)
+{
+	unsigned int kernel = yescrypt_kernel_preference;
+	unsigned int best = yescrypt_kernel();
+
+	if (kernel == YESCRYPT_KERNEL_AUTO || kernel > best)
+		kernel = best;
+
+	return &yescrypt_kernels[kernel];
+}
+
 /**
- * smix1(B, r, N, flags, V, NROM, shared, XY, S):
+ * smix1(B, r, N, flags, V, NROM, shared, XY, S, kernel):
  * Compute first loop of B = SMix_r(B, N).  The input B must be 128r bytes in
  * length; the temporary storage V must be 128rN bytes in length; the temporary
  * storage XY must be 256r + 64 bytes in length.  The value N must be even and
@@ -365,10 +476,10 @@ integerify(const uint64_t * B, size_t r)
 static void
 smix1(uint64_t * B, size_t r, uint64_t N, yescrypt_flags_t flags,
     uint64_t * V, uint64_t NROM, const yescrypt_shared_t * shared,
-    uint64_t * XY, uint64_t * S)
+    uint64_t * XY, uint64_t * S, const yescrypt_kernel_t * kernel)
 {
 	void (*blockmix)(const uint64_t *, uint64_t *, uint64_t *, size_t) =
-	    (S ? blockmix_pwxform : blockmix_salsa8);
+	    (S ? kernel->blockmix_pwxform : kernel->blockmix_salsa8);
 	const uint64_t * VROM = shared->shared1.aligned;
 	uint32_t VROM_mask = shared->mask1;
 	size_t s = 16 * r;
@@ -392,7 +503,7 @@ smix1(uint64_t * B, size_t r, uint64_t N, yescrypt_flags_t flags,
 	/* 4: X <-- H(X) */
 	/* 3: V_i <-- X */
 	blockmix(X, Y, Z, r);
-	blkcpy(&V[s], Y, s);
+	kernel->blkcpy(&V[s], Y, s);
 
 	X = XY;
 
@@ -402,7 +513,7 @@ smix1(uint64_t * B, size_t r, uint64_t N, yescrypt_flags_t flags,
 			j = integerify(Y, r) & (NROM - 1);
 
 			/* X <-- H(X \xor VROM_j) */
-			blkxor(Y, &VROM[j * s], s);
+			kernel->blkxor(Y, &VROM[j * s], s);
 		}
 
 		blockmix(Y, X, Z, r);
@@ -410,7 +521,7 @@ smix1(uint64_t * B, size_t r, uint64_t N, yescrypt_flags_t flags,
 		/* 2: for i = 0 to N - 1 do */
 		for (n = 1, i = 2; i < N; i += 2) {
 			/* 3: V_i <-- X */
-			blkcpy(&V[i * s], X, s);
+			kernel->blkcpy(&V[i * s], X, s);
 
 			if ((i & (i - 1)) == 0)
 				n <<= 1;
@@ -420,13 +531,13 @@ smix1(uint64_t * B, size_t r, uint64_t N, yescrypt_flags_t flags,
 			j += i - n;
 
 			/* X <-- X \xor V_j */
-			blkxor(X, &V[j * s], s);
+			kernel->blkxor(X, &V[j * s], s);
 
 			/* 4: X <-- H(X) */
 			blockmix(X, Y, Z, r);
 
 			/* 3: V_i <-- X */
-			blkcpy(&V[(i + 1) * s], Y, s);
+			kernel->blkcpy(&V[(i + 1) * s], Y, s);
 
 			j = integerify(Y, r);
 			if (((i + 1) & VROM_mask) == 1) {
@@ -434,14 +545,14 @@ smix1(uint64_t * B, size_t r, uint64_t N, yescrypt_flags_t flags,
 				j &= NROM - 1;
 
 				/* X <-- H(X \xor VROM_j) */
-				blkxor(Y, &VROM[j * s], s);
+				kernel->blkxor(Y, &VROM[j * s], s);
 			} else {
 				/* j <-- Wrap(Integerify(X), i) */
 				j &= n - 1;
 				j += i + 1 - n;
 
 				/* X <-- H(X \xor V_j) */
-				blkxor(Y, &V[j * s], s);
+				kernel->blkxor(Y, &V[j * s], s);
 			}
 
 			blockmix(Y, X, Z, r);
@@ -455,7 +566,7 @@ smix1(uint64_t * B, size_t r, uint64_t N, yescrypt_flags_t flags,
 		/* 2: for i = 0 to N - 1 do */
 		for (n = 1, i = 2; i < N; i += 2) {
 			/* 3: V_i <-- X */
-			blkcpy(&V[i * s], X, s);
+			kernel->blkcpy(&V[i * s], X, s);
 
 			if (rw) {
 				if ((i & (i - 1)) == 0)
@@ -466,14 +577,14 @@ smix1(uint64_t * B, size_t r, uint64_t N, yescrypt_flags_t flags,
 				j += i - n;
 
 				/* X <-- X \xor V_j */
-				blkxor(X, &V[j * s], s);
+				kernel->blkxor(X, &V[j * s], s);
 			}
 
 			/* 4: X <-- H(X) */
 			blockmix(X, Y, Z, r);
 
 			/* 3: V_i <-- X */
-			blkcpy(&V[(i + 1) * s], Y, s);
+			kernel->blkcpy(&V[(i + 1) * s], Y, s);
 
 			if (rw) {
 				/* j <-- Wrap(Integerify(X), i) */
@@ -481,7 +592,7 @@ smix1(uint64_t * B, size_t r, uint64_t N, yescrypt_flags_t flags,
 				j += (i + 1) - n;
 
 				/* X <-- X \xor V_j */
-				blkxor(Y, &V[j * s], s);
+				kernel->blkxor(Y, &V[j * s], s);
 			}
 
 			/* 4: X <-- H(X) */
@@ -501,7 +612,7 @@ smix1(uint64_t * B, size_t r, uint64_t N, yescrypt_flags_t flags,
 }
 
 /**
- * smix2(B, r, N, Nloop, flags, V, NROM, shared, XY, S):
+ * smix2(B, r, N, Nloop, flags, V, NROM, shared, XY, S, kernel):
  * Compute second loop of B = SMix_r(B, N).  The input B must be 128r bytes in
  * length; the temporary storage V must be 128rN bytes in length; the temporary
  * storage XY must be 256r + 64 bytes in length.  The value N must be a
@@ -511,10 +622,10 @@ static void
 smix2(uint64_t * B, size_t r, uint64_t N, uint64_t Nloop,
     yescrypt_flags_t flags,
     uint64_t * V, uint64_t NROM, const yescrypt_shared_t * shared,
-    uint64_t * XY, uint64_t * S)
+    uint64_t * XY, uint64_t * S, const yescrypt_kernel_t * kernel)
 {
 	void (*blockmix)(const uint64_t *, uint64_t *, uint64_t *, size_t) =
-	    (S ? blockmix_pwxform : blockmix_salsa8);
+	    (S ? kernel->blockmix_pwxform : kernel->blockmix_salsa8);
 	const uint64_t * VROM = shared->shared1.aligned;
 	uint32_t VROM_mask = shared->mask1 | 1;
 	size_t s = 16 * r;
@@ -545,10 +656,10 @@ smix2(uint64_t * B, size_t r, uint64_t N, uint64_t Nloop,
 			j = integerify(X, r) & (N - 1);
 
 			/* 8: X <-- H(X \xor V_j) */
-			blkxor(X, &V[j * s], s);
+			kernel->blkxor(X, &V[j * s], s);
 			/* V_j <-- Xprev \xor V_j */
 			if (rw)
-				blkcpy(&V[j * s], X, s);
+				kernel->blkcpy(&V[j * s], X, s);
 			blockmix(X, Y, Z, r);
 
 			j = integerify(Y, r);
@@ -557,16 +668,16 @@ smix2(uint64_t * B, size_t r, uint64_t N, uint64_t Nloop,
 				j &= NROM - 1;
 
 				/* X <-- H(X \xor VROM_j) */
-				blkxor(Y, &VROM[j * s], s);
+				kernel->blkxor(Y, &VROM[j * s], s);
 			} else {
 				/* 7: j <-- Integerify(X) mod N */
 				j &= N - 1;
 
 				/* 8: X <-- H(X \xor V_j) */
-				blkxor(Y, &V[j * s], s);
+				kernel->blkxor(Y, &V[j * s], s);
 				/* V_j <-- Xprev \xor V_j */
 				if (rw)
-					blkcpy(&V[j * s], Y, s);
+					kernel->blkcpy(&V[j * s], Y, s);
 			}
 
 			blockmix(Y, X, Z, r);
@@ -579,20 +690,20 @@ smix2(uint64_t * B, size_t r, uint64_t N, uint64_t Nloop,
 			j = integerify(X, r) & (N - 1);
 
 			/* 8: X <-- H(X \xor V_j) */
-			blkxor(X, &V[j * s], s);
+			kernel->blkxor(X, &V[j * s], s);
 			/* V_j <-- Xprev \xor V_j */
 			if (rw)
-				blkcpy(&V[j * s], X, s);
+				kernel->blkcpy(&V[j * s], X, s);
 			blockmix(X, Y, Z, r);
 
 			/* 7: j <-- Integerify(X) mod N */
 			j = integerify(Y, r) & (N - 1);
 
 			/* 8: X <-- H(X \xor V_j) */
-			blkxor(Y, &V[j * s], s);
+			kernel->blkxor(Y, &V[j * s], s);
 			/* V_j <-- Xprev \xor V_j */
 			if (rw)
-				blkcpy(&V[j * s], Y, s);
+				kernel->blkcpy(&V[j * s], Y, s);
 			blockmix(Y, X, Z, r);
 		} while (--i);
 	}
@@ -622,18 +733,18 @@ p2floor(uint64_t x)
 }
 
 /**
- * smix(B, r, N, p, t, flags, V, NROM, shared, XY, S):
+ * smix(B, r, N, p, t, flags, V, NROM, shared, XY, S, kernel):
  * Compute B = SMix_r(B, N).  The input B must be 128rp bytes in length; the
  * temporary storage V must be 128rN bytes in length; the temporary storage
  * XY must be 256r+64 or (256r+64)*p bytes in length (the larger size is
  * required with OpenMP-enabled builds).  The value N must be a power of 2
- * greater than 1.
+ * greater than 1.  kernel provides the block operations, see select_kernel().
  */
 static void
 smix(uint64_t * B, size_t r, uint64_t N, uint32_t p, uint32_t t,
     yescrypt_flags_t flags,
     uint64_t * V, uint64_t NROM, const yescrypt_shared_t * shared,
-    uint64_t * XY, uint64_t * S)
+    uint64_t * XY, uint64_t * S, const yescrypt_kernel_t * kernel)
 {
 	size_t s = 16 * r;
 	uint64_t Nchunk = N / p, Nloop_all, Nloop_rw;
@@ -665,7 +776,7 @@ smix(uint64_t * B, size_t r, uint64_t N, uint32_t p, uint32_t t,
 	Nloop_rw &= ~(uint64_t)1; /* round down to even */
 
 #ifdef _OPENMP
-#pragma omp parallel if (p > 1) default(none) private(i) shared(B, r, N, p, flags, V, NROM, shared, XY, S, s, Nchunk, Nloop_all, Nloop_rw)
+#pragma omp parallel if (p > 1) default(none) private(i) shared(B, r, N, p, flags, V, NROM, shared, XY, S, kernel, s, Nchunk, Nloop_all, Nloop_rw)
 	{
 #pragma omp for
 #endif
@@ -683,11 +794,11 @@ smix(uint64_t * B, size_t r, uint64_t N, uint32_t p, uint32_t t,
 		if (Sp)
 			smix1(Bp, 1, S_SIZE_ALL / 16,
 			    flags & ~YESCRYPT_PWXFORM,
-			    Sp, NROM, shared, XYp, NULL);
+			    Sp, NROM, shared, XYp, NULL, kernel);
 		if (!(flags & __YESCRYPT_INIT_SHARED_2))
-			smix1(Bp, r, Np, flags, Vp, NROM, shared, XYp, Sp);
+			smix1(Bp, r, Np, flags, Vp, NROM, shared, XYp, Sp, kernel);
 		smix2(Bp, r, p2floor(Np), Nloop_rw, flags, Vp,
-		    NROM, shared, XYp, Sp);
+		    NROM, shared, XYp, Sp, kernel);
 	}
 
 	if (Nloop_all > Nloop_rw) {
@@ -703,7 +814,7 @@ smix(uint64_t * B, size_t r, uint64_t N, uint32_t p, uint32_t t,
 #endif
 			uint64_t * Sp = S ? &S[i * S_SIZE_ALL] : S;
 			smix2(Bp, r, N, Nloop_all - Nloop_rw,
-			    flags & ~YESCRYPT_RW, V, NROM, shared, XYp, Sp);
+			    flags & ~YESCRYPT_RW, V, NROM, shared, XYp, Sp, kernel);
 		}
 	}
 #ifdef _OPENMP
@@ -739,6 +850,7 @@ yescrypt_kdf(const yescrypt_shared_t * shared, yescrypt_local_t * local,
 	size_t B_size, V_size, XY_size, need;
 	uint64_t * B, * V, * XY, * S;
 	uint64_t sha256[4];
+	const yescrypt_kernel_t * kernel = select_kernel();
 
 	/*
 	 * YESCRYPT_PARALLEL_SMIX is a no-op at p = 1 for its intended purpose,
@@ -904,13 +1016,13 @@ yescrypt_kdf(const yescrypt_shared_t * shared, yescrypt_local_t * local,
 		blkcpy(sha256, B, sizeof(sha256) / sizeof(sha256[0]));
 
 	if (p == 1 || (flags & YESCRYPT_PARALLEL_SMIX)) {
-		smix(B, r, N, p, t, flags, V, NROM, shared, XY, S);
+		smix(B, r, N, p, t, flags, V, NROM, shared, XY, S, kernel);
 	} else {
 		uint32_t i;
 
 		/* 2: for i = 0 to p - 1 do */
 #ifdef _OPENMP
-#pragma omp parallel for default(none) private(i) shared(B, r, N, p, t, flags, V, NROM, shared, XY, S)
+#pragma omp parallel for default(none) private(i) shared(B, r, N, p, t, flags, V, NROM, shared, XY, S, kernel)
 #endif
 		for (i = 0; i < p; i++) {
 			/* 3: B_i <-- MF(B_i, N) */
@@ -919,10 +1031,10 @@ yescrypt_kdf(const yescrypt_shared_t * shared, yescrypt_local_t * local,
 			    &V[(size_t)16 * r * i * N],
 			    NROM, shared,
 			    &XY[((size_t)32 * r + 8) * i],
-			    S ? &S[S_SIZE_ALL * i] : S);
+			    S ? &S[S_SIZE_ALL * i] : S, kernel);
 #else
 			smix(&B[(size_t)16 * r * i], r, N, 1, t, flags, V,
-			    NROM, shared, XY, S);
+			    NROM, shared, XY, S, kernel);
 #endif
 		}
 	}
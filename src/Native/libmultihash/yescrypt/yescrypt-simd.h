@@ -0,0 +1,177 @@
+/*
+ * Intrinsics based yescrypt block operation kernel template.
+ *
+ * This file is included by yescrypt-opt.c once per kernel with the
+ * following macros defined:
+ *
+ *   YS_SUFFIX          suffix appended to every generated symbol
+ *   YS_TARGET          GCC target string the kernel is compiled for
+ *   YS_ROTL(v, n)      32-bit rotate left
+ *
+ * Blocks are kept in the SIMD shuffled layout produced by
+ * salsa20_simd_shuffle(), which is the diagonal layout of Colin Percival's
+ * SSE2 scrypt, so every 64 byte block is four rows of a Salsa20 state and
+ * every S_P_SIZE block is four pwxform lanes of two 64-bit words each.
+ */
+
+#define YS_CAT_(a, b) a##b
+#define YS_CAT(a, b) YS_CAT_(a, b)
+#define YS(name) YS_CAT(name, YS_SUFFIX)
+#define YS_FN static __attribute__((target(YS_TARGET)))
+
+#define YS_ARX(out, in1, in2, s) \
+	out = _mm_xor_si128(out, YS_ROTL(_mm_add_epi32(in1, in2), s));
+
+/* X <-- X + Salsa20/8(X) */
+#define YS_SALSA20_8(X0, X1, X2, X3) { \
+	__m128i Y0 = X0, Y1 = X1, Y2 = X2, Y3 = X3; \
+	int n; \
+	for (n = 0; n < 8; n += 2) { \
+		YS_ARX(Y1, Y0, Y3, 7) \
+		YS_ARX(Y2, Y1, Y0, 9) \
+		YS_ARX(Y3, Y2, Y1, 13) \
+		YS_ARX(Y0, Y3, Y2, 18) \
+		Y1 = _mm_shuffle_epi32(Y1, 0x93); \
+		Y2 = _mm_shuffle_epi32(Y2, 0x4E); \
+		Y3 = _mm_shuffle_epi32(Y3, 0x39); \
+		YS_ARX(Y3, Y0, Y1, 7) \
+		YS_ARX(Y2, Y3, Y0, 9) \
+		YS_ARX(Y1, Y2, Y3, 13) \
+		YS_ARX(Y0, Y1, Y2, 18) \
+		Y1 = _mm_shuffle_epi32(Y1, 0x39); \
+		Y2 = _mm_shuffle_epi32(Y2, 0x4E); \
+		Y3 = _mm_shuffle_epi32(Y3, 0x93); \
+	} \
+	X0 = _mm_add_epi32(X0, Y0); \
+	X1 = _mm_add_epi32(X1, Y1); \
+	X2 = _mm_add_epi32(X2, Y2); \
+	X3 = _mm_add_epi32(X3, Y3); \
+}
+
+/* X <-- (hi(X) * lo(X) + S0[p0]) xor S1[p1], both 64-bit words at once */
+#define YS_PWXFORM_LANE(X) { \
+	uint32_t xl = (uint32_t)_mm_cvtsi128_si32(X) & S_MASK; \
+	uint32_t xh = (uint32_t)_mm_cvtsi128_si32(_mm_srli_epi64(X, 32)) & S_MASK; \
+	X = _mm_mul_epu32(_mm_srli_epi64(X, 32), X); \
+	X = _mm_add_epi64(X, _mm_loadu_si128((const __m128i *)(S0 + xl))); \
+	X = _mm_xor_si128(X, _mm_loadu_si128((const __m128i *)(S1 + xh))); \
+}
+
+#define YS_LOAD(X, p) \
+	X##0 = _mm_loadu_si128(&(p)[0]); X##1 = _mm_loadu_si128(&(p)[1]); \
+	X##2 = _mm_loadu_si128(&(p)[2]); X##3 = _mm_loadu_si128(&(p)[3]);
+#define YS_XOR(X, p) \
+	X##0 = _mm_xor_si128(X##0, _mm_loadu_si128(&(p)[0])); \
+	X##1 = _mm_xor_si128(X##1, _mm_loadu_si128(&(p)[1])); \
+	X##2 = _mm_xor_si128(X##2, _mm_loadu_si128(&(p)[2])); \
+	X##3 = _mm_xor_si128(X##3, _mm_loadu_si128(&(p)[3]));
+#define YS_STORE(p, X) \
+	_mm_storeu_si128(&(p)[0], X##0); _mm_storeu_si128(&(p)[1], X##1); \
+	_mm_storeu_si128(&(p)[2], X##2); _mm_storeu_si128(&(p)[3], X##3);
+
+/* count is a multiple of 8 in all callers */
+YS_FN void YS(blkcpy)(uint64_t * dest, const uint64_t * src, size_t count)
+{
+	__m128i * d = (__m128i *)dest;
+	const __m128i * s = (const __m128i *)src;
+	size_t i;
+
+	for (i = 0; i < count / 2; i += 4) {
+		__m128i X0, X1, X2, X3;
+		YS_LOAD(X, &s[i])
+		YS_STORE(&d[i], X)
+	}
+}
+
+YS_FN void YS(blkxor)(uint64_t * dest, const uint64_t * src, size_t count)
+{
+	__m128i * d = (__m128i *)dest;
+	const __m128i * s = (const __m128i *)src;
+	size_t i;
+
+	for (i = 0; i < count / 2; i += 4) {
+		__m128i X0, X1, X2, X3;
+		YS_LOAD(X, &d[i])
+		YS_XOR(X, &s[i])
+		YS_STORE(&d[i], X)
+	}
+}
+
+/**
+ * blockmix_salsa8(Bin, Bout, X, r):
+ * Compute Bout = BlockMix_{salsa20/8, r}(Bin).  The input Bin must be 128r
+ * bytes in length; the output Bout must also be the same size.  X is unused,
+ * the state stays in registers.
+ */
+YS_FN void YS(blockmix_salsa8)(const uint64_t * Bin, uint64_t * Bout,
+    uint64_t * X, size_t r)
+{
+	const __m128i * in = (const __m128i *)Bin;
+	__m128i * out = (__m128i *)Bout;
+	__m128i X0, X1, X2, X3;
+	size_t i;
+
+	(void)X;
+
+	YS_LOAD(X, &in[(2 * r - 1) * 4])
+
+	for (i = 0; i < 2 * r; i += 2) {
+		YS_XOR(X, &in[i * 4])
+		YS_SALSA20_8(X0, X1, X2, X3)
+		YS_STORE(&out[i * 2], X)
+
+		YS_XOR(X, &in[i * 4 + 4])
+		YS_SALSA20_8(X0, X1, X2, X3)
+		YS_STORE(&out[i * 2 + r * 4], X)
+	}
+}
+
+/**
+ * blockmix_pwxform(Bin, Bout, S, r):
+ * Compute Bout = BlockMix_pwxform{salsa20/8, S, r}(Bin).  The input Bin must
+ * be 128r bytes in length; the output Bout must also be the same size.  With
+ * S_P_SIZE * 8 == 64 every pwxform block is also a Salsa20 block and only the
+ * last one goes through Salsa20/8.
+ */
+YS_FN void YS(blockmix_pwxform)(const uint64_t * Bin, uint64_t * Bout,
+    uint64_t * S, size_t r)
+{
+	const __m128i * in = (const __m128i *)Bin;
+	__m128i * out = (__m128i *)Bout;
+	const uint8_t * S0 = (const uint8_t *)S;
+	const uint8_t * S1 = (const uint8_t *)(S + S_SIZE1 * S_SIMD);
+	size_t r1 = 2 * r, i;
+	__m128i X0, X1, X2, X3;
+
+	YS_LOAD(X, &in[(r1 - 1) * 4])
+
+	for (i = 0; i < r1; i++) {
+		int k;
+
+		YS_XOR(X, &in[i * 4])
+
+		/* the four lanes are independent, interleave them */
+		for (k = 0; k < S_ROUNDS; k++) {
+			YS_PWXFORM_LANE(X0)
+			YS_PWXFORM_LANE(X1)
+			YS_PWXFORM_LANE(X2)
+			YS_PWXFORM_LANE(X3)
+		}
+
+		if (i == r1 - 1)
+			YS_SALSA20_8(X0, X1, X2, X3)
+
+		YS_STORE(&out[i * 4], X)
+	}
+}
+
+#undef YS_STORE
+#undef YS_XOR
+#undef YS_LOAD
+#undef YS_PWXFORM_LANE
+#undef YS_SALSA20_8
+#undef YS_ARX
+#undef YS_FN
+#undef YS
+#undef YS_CAT
+#undef YS_CAT_
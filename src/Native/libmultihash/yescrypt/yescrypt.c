@@ -323,27 +323,29 @@ uint8_t* yescrypt_gensalt(uint32_t N_log2, uint32_t r, uint32_t p, yescrypt_flag
 	    buf, sizeof(buf));
 }
 
+#if defined(_MSC_VER)
+#define YESCRYPT_TLS __declspec(thread)
+#else
+#define YESCRYPT_TLS __thread
+#endif
+
 static int yescrypt_bsty(const uint8_t * passwd, size_t passwdlen,
     const uint8_t * salt, size_t saltlen, uint64_t N, uint32_t r, uint32_t p,
     uint8_t * buf, size_t buflen)
 {
+	/* per-thread region, grown on demand and reused across calls */
+	static YESCRYPT_TLS yescrypt_local_t local;
 	yescrypt_shared_t shared;
-	yescrypt_local_t local;
 	int retval;
 
 	if (yescrypt_init_shared(&shared, NULL, 0,
 		    0, 0, 0, YESCRYPT_SHARED_DEFAULTS, 0, NULL, 0))
 			return -1;
-	if (yescrypt_init_local(&local)) {
-			yescrypt_free_shared(&shared);
-			return -1;
-	}
 
 	retval = yescrypt_kdf(&shared, &local,
 	    passwd, passwdlen, salt, saltlen, N, r, p, 0, YESCRYPT_FLAGS,
 	    buf, buflen);
 
-	yescrypt_free_local(&local);
 	yescrypt_free_shared(&shared);
 
 	return retval;
@@ -43,6 +43,26 @@ void yescryptR8_hash(const char* input, char* output, uint32_t len);
 void yescryptR16_hash(const char* input, char* output, uint32_t len);	
 void yescryptR32_hash(const char* input, char* output, uint32_t len);
 
+#define YESCRYPT_KERNEL_AUTO   0
+#define YESCRYPT_KERNEL_SCALAR 1
+#define YESCRYPT_KERNEL_SSE2   2
+#define YESCRYPT_KERNEL_AVX    3
+#define YESCRYPT_KERNEL_XOP    4
+
+/**
+ * yescrypt_kernel():
+ * Return the best YESCRYPT_KERNEL_* available on this CPU.
+ */
+extern unsigned int yescrypt_kernel(void);
+
+/**
+ * yescrypt_set_kernel(kernel):
+ * Select the YESCRYPT_KERNEL_* used by subsequent yescrypt_kdf() calls on the
+ * calling thread.  AUTO (the default) picks the best kernel available and a
+ * kernel the CPU lacks is downgraded.
+ */
+extern void yescrypt_set_kernel(unsigned int kernel);
+
 /**
  * crypto_scrypt(passwd, passwdlen, salt, saltlen, N, r, p, buf, buflen):
  * Compute scrypt(passwd[0 .. passwdlen - 1], salt[0 .. saltlen - 1], N, r,
@@ -729,14 +729,21 @@ static void blockmix_salsa(uint32_t *B, uint32_t rounds)
 #define Swidth_to_Sbytes1(Swidth) ((1 << Swidth) * PWXsimple * 8)
 #define Swidth_to_Smask(Swidth) (((1 << Swidth) - 1) * PWXsimple * 8)
 
-typedef struct {
+typedef struct pwxform_ctx pwxform_ctx_t;
+
+struct pwxform_ctx {
 	yespower_version_t version;
 	uint32_t salsa20_rounds;
 	uint32_t PWXrounds, Swidth, Sbytes, Smask;
 	uint32_t *S;
 	uint32_t (*S0)[2], (*S1)[2], (*S2)[2];
 	size_t w;
-} pwxform_ctx_t;
+	/* implementations of the kernel selected for this hash */
+	void (*blkcpy)(uint32_t *dst, const uint32_t *src, size_t count);
+	void (*blkxor)(uint32_t *dst, const uint32_t *src, size_t count);
+	void (*blockmix_salsa)(uint32_t *B, uint32_t rounds);
+	void (*blockmix_pwxform)(uint32_t *B, pwxform_ctx_t *ctx, size_t r);
+};
 
 /**
  * pwxform(B):
@@ -858,6 +865,126 @@ static void blockmix_pwxform(uint32_t *B, pwxform_ctx_t *ctx, size_t r)
 #endif
 }
 
+/* Intrinsics based smix kernels selected at runtime by CPU feature:
+ *   SSE2 - one 128-bit register per Salsa20 row / pwxform lane;
+ *   AVX  - the SSE2 kernel with VEX encoding;
+ *   XOP  - the AVX kernel with native 32-bit rotates for Salsa20. */
+
+#if defined(_MSC_VER)
+#define YESPOWER_TLS __declspec(thread)
+#else
+#define YESPOWER_TLS __thread
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define YESPOWER_SIMD
+#endif
+
+#ifdef YESPOWER_SIMD
+
+#include <immintrin.h>
+#include <x86intrin.h>
+
+#if PWXbytes != 64
+#error "yespower-simd.h assumes 64 byte pwxform blocks"
+#endif
+
+/* SSE2 */
+#define YP_SUFFIX _sse2
+#define YP_TARGET "sse2"
+#define YP_ROTL(v, n) _mm_or_si128(_mm_slli_epi32(v, n), _mm_srli_epi32(v, 32 - (n)))
+#include "yespower-simd.h"
+#undef YP_SUFFIX
+#undef YP_TARGET
+
+/* AVX */
+#define YP_SUFFIX _avx
+#define YP_TARGET "avx"
+#include "yespower-simd.h"
+#undef YP_SUFFIX
+#undef YP_TARGET
+#undef YP_ROTL
+
+/* XOP */
+#define YP_SUFFIX _xop
+#define YP_TARGET "avx,xop"
+#define YP_ROTL(v, n) _mm_roti_epi32(v, n)
+#include "yespower-simd.h"
+#undef YP_SUFFIX
+#undef YP_TARGET
+#undef YP_ROTL
+
+#endif /* YESPOWER_SIMD */
+
+/* kernel requested by the calling thread, see yespower_set_kernel() */
+static YESPOWER_TLS unsigned int yespower_kernel_preference = YESPOWER_KERNEL_AUTO;
+
+unsigned int yespower_kernel(void)
+{
+#ifdef YESPOWER_SIMD
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx")) {
+		if (__builtin_cpu_supports("xop"))
+			return YESPOWER_KERNEL_XOP;
+		return YESPOWER_KERNEL_AVX;
+	}
+	if (__builtin_cpu_supports("sse2"))
+		return YESPOWER_KERNEL_SSE2;
+#endif
+
+	return YESPOWER_KERNEL_SCALAR;
+}
+
+void yespower_set_kernel(unsigned int kernel)
+{
+	yespower_kernel_preference = kernel;
+}
+
+/**
+ * select_kernel(ctx):
+ * Point ctx at the block operations of the calling thread's kernel.
+ * AUTO picks the best one available and a kernel the CPU lacks is
+ * downgraded.
+ */
+static void select_kernel(pwxform_ctx_t *ctx)
+{
+	unsigned int kernel = yespower_kernel_preference;
+	unsigned int best = yespower_kernel();
+
+	if (kernel == YESPOWER_KERNEL_AUTO || kernel > best)
+		kernel = best;
+
+	switch (kernel) {
+#ifdef YESPOWER_SIMD
+	case YESPOWER_KERNEL_XOP:
+		ctx->blkcpy = blkcpy_xop;
+		ctx->blkxor = blkxor_xop;
+		ctx->blockmix_salsa = blockmix_salsa_xop;
+		ctx->blockmix_pwxform = blockmix_pwxform_xop;
+		break;
+	case YESPOWER_KERNEL_AVX:
+		ctx->blkcpy = blkcpy_avx;
+		ctx->blkxor = blkxor_avx;
+		ctx->blockmix_salsa = blockmix_salsa_avx;
+		ctx->blockmix_pwxform = blockmix_pwxform_avx;
+		break;
+	case YESPOWER_KERNEL_SSE2:
+		ctx->blkcpy = blkcpy_sse2;
+		ctx->blkxor = blkxor_sse2;
+		ctx->blockmix_salsa = blockmix_salsa_sse2;
+		ctx->blockmix_pwxform = blockmix_pwxform_sse2;
+		break;
+#endif
+	default:
+		ctx->blkcpy = blkcpy;
+		ctx->blkxor = blkxor;
+		ctx->blockmix_salsa = blockmix_salsa;
+		ctx->blockmix_pwxform = blockmix_pwxform;
+		break;
+	}
+}
+
 /**
  * integerify(B, r):
  * Return the result of parsing B_{2r-1} as a little-endian integer.
@@ -915,28 +1042,28 @@ static void smix1(uint32_t *B, size_t r, uint32_t N,
 	if (ctx->version != YESPOWER_0_5) {
 		for (k = 1; k < r; k++) {
 			blkcpy(&X[k * 32], &X[(k - 1) * 32], 32);
-			blockmix_pwxform(&X[k * 32], ctx, 1);
+			ctx->blockmix_pwxform(&X[k * 32], ctx, 1);
 		}
 	}
 
 	/* 2: for i = 0 to N - 1 do */
 	for (i = 0; i < N; i++) {
 		/* 3: V_i <-- X */
-		blkcpy(&V[i * s], X, s);
+		ctx->blkcpy(&V[i * s], X, s);
 
 		if (i > 1) {
 			/* j <-- Wrap(Integerify(X), i) */
 			j = wrap(integerify(X, r), i);
 
 			/* X <-- X xor V_j */
-			blkxor(X, &V[j * s], s);
+			ctx->blkxor(X, &V[j * s], s);
 		}
 
 		/* 4: X <-- H(X) */
 		if (V != ctx->S)
-			blockmix_pwxform(X, ctx, r);
+			ctx->blockmix_pwxform(X, ctx, r);
 		else
-			blockmix_salsa(X, ctx->salsa20_rounds);
+			ctx->blockmix_salsa(X, ctx->salsa20_rounds);
 	}
 
 	/* B' <-- X */
@@ -970,13 +1097,13 @@ static void smix2(uint32_t *B, size_t r, uint32_t N, uint32_t Nloop,
 		j = integerify(X, r) & (N - 1);
 
 		/* 8.1: X <-- X xor V_j */
-		blkxor(X, &V[j * s], s);
+		ctx->blkxor(X, &V[j * s], s);
 		/* V_j <-- X */
 		if (Nloop != 2)
-			blkcpy(&V[j * s], X, s);
+			ctx->blkcpy(&V[j * s], X, s);
 
 		/* 8.2: X <-- H(X) */
-		blockmix_pwxform(X, ctx, r);
+		ctx->blockmix_pwxform(X, ctx, r);
 	}
 
 	/* 10: B' <-- X */
@@ -1041,15 +1168,6 @@ int yespower(yespower_local_t *local,
 		return -1;
 	}
 
-	/* Allocate memory */
-	B_size = (size_t)128 * r;
-	V_size = B_size * N;
-	if ((V = malloc(V_size)) == NULL)
-		return -1;
-	if ((B = malloc(B_size)) == NULL)
-		goto free_V;
-	if ((X = malloc(B_size)) == NULL)
-		goto free_B;
 	ctx.version = version;
 	if (version == YESPOWER_0_5) {
 		ctx.salsa20_rounds = 8;
@@ -1062,14 +1180,44 @@ int yespower(yespower_local_t *local,
 		ctx.Swidth = Swidth_1_0;
 		ctx.Sbytes = 3 * Swidth_to_Sbytes1(ctx.Swidth);
 	}
-	if ((S = malloc(ctx.Sbytes)) == NULL)
-		goto free_X;
+
+	/* Allocate memory */
+	B_size = (size_t)128 * r;
+	V_size = B_size * N;
+	if (local) {
+		/* V, B, X and S carved from the caller's region, reused across calls */
+		size_t need = V_size + 2 * B_size + ctx.Sbytes;
+		if (local->aligned_size < need) {
+			yespower_free_local(local);
+			if ((local->base = malloc(need + 63)) == NULL)
+				return -1;
+			local->aligned = (uint8_t *)local->base + 63;
+			local->aligned = (uint8_t *)local->aligned -
+			    ((uintptr_t)local->aligned & 63);
+			local->base_size = need + 63;
+			local->aligned_size = need;
+		}
+		V = (uint32_t *)local->aligned;
+		B = (uint32_t *)((uint8_t *)V + V_size);
+		X = (uint32_t *)((uint8_t *)B + B_size);
+		S = (uint32_t *)((uint8_t *)X + B_size);
+	} else {
+		if ((V = malloc(V_size)) == NULL)
+			return -1;
+		if ((B = malloc(B_size)) == NULL)
+			goto free_V;
+		if ((X = malloc(B_size)) == NULL)
+			goto free_B;
+		if ((S = malloc(ctx.Sbytes)) == NULL)
+			goto free_X;
+	}
 	ctx.S = S;
 	ctx.S0 = (uint32_t (*)[2])S;
 	ctx.S1 = ctx.S0 + (1 << ctx.Swidth) * PWXsimple;
 	ctx.S2 = ctx.S1 + (1 << ctx.Swidth) * PWXsimple;
 	ctx.Smask = Swidth_to_Smask(ctx.Swidth);
 	ctx.w = 0;
+	select_kernel(&ctx);
 
 	SHA256_Buf(src, srclen, (uint8_t *)sha256);
 
@@ -1109,6 +1257,9 @@ int yespower(yespower_local_t *local,
 	/* Success! */
 	retval = 0;
 
+	if (local)
+		return retval;
+
 	/* Free memory */
 	free(S);
 free_X:
@@ -1124,13 +1275,14 @@ free_V:
 int yespower_tls(const uint8_t *src, size_t srclen,
     const yespower_params_t *params, yespower_binary_t *dst)
 {
-/* The reference implementation doesn't use thread-local storage */
-	return yespower(NULL, src, srclen, params, dst);
+/* Per-thread region, grown on demand and reused across calls */
+	static YESPOWER_TLS yespower_local_t local;
+
+	return yespower(&local, src, srclen, params, dst);
 }
 
 int yespower_init_local(yespower_local_t *local)
 {
-/* The reference implementation doesn't use the local structure */
 	local->base = local->aligned = NULL;
 	local->base_size = local->aligned_size = 0;
 	return 0;
@@ -1138,9 +1290,8 @@ int yespower_init_local(yespower_local_t *local)
 
 int yespower_free_local(yespower_local_t *local)
 {
-/* The reference implementation frees its memory in yespower() */
-	(void)local; /* unused */
-	return 0;
+	free(local->base);
+	return yespower_init_local(local);
 }
 
 void yespower_hash(const char* input, char* output, uint32_t len)
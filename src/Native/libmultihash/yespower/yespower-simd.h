@@ -0,0 +1,195 @@
+/*
+ * Intrinsics based yespower block operation kernel template.
+ *
+ * This file is included by yespower-combined.c once per kernel with the
+ * following macros defined:
+ *
+ *   YP_SUFFIX          suffix appended to every generated symbol
+ *   YP_TARGET          GCC target string the kernel is compiled for
+ *   YP_ROTL(v, n)      32-bit rotate left
+ *
+ * Blocks are kept in the diagonal layout introduced by Colin Percival's SSE2
+ * scrypt, which smix1() and smix2() apply on input, so every 64 byte block is
+ * four rows of a Salsa20 state and every PWXbytes block is four pwxform lanes
+ * of two 64-bit words each.
+ */
+
+#define YP_CAT_(a, b) a##b
+#define YP_CAT(a, b) YP_CAT_(a, b)
+#define YP(name) YP_CAT(name, YP_SUFFIX)
+#define YP_FN static __attribute__((target(YP_TARGET)))
+
+#define YP_ARX(out, in1, in2, s) \
+	out = _mm_xor_si128(out, YP_ROTL(_mm_add_epi32(in1, in2), s));
+
+/* X <-- X + Salsa20/rounds(X) */
+#define YP_SALSA20(X0, X1, X2, X3, rounds) { \
+	__m128i Y0 = X0, Y1 = X1, Y2 = X2, Y3 = X3; \
+	uint32_t n; \
+	for (n = 0; n < rounds; n += 2) { \
+		YP_ARX(Y1, Y0, Y3, 7) \
+		YP_ARX(Y2, Y1, Y0, 9) \
+		YP_ARX(Y3, Y2, Y1, 13) \
+		YP_ARX(Y0, Y3, Y2, 18) \
+		Y1 = _mm_shuffle_epi32(Y1, 0x93); \
+		Y2 = _mm_shuffle_epi32(Y2, 0x4E); \
+		Y3 = _mm_shuffle_epi32(Y3, 0x39); \
+		YP_ARX(Y3, Y0, Y1, 7) \
+		YP_ARX(Y2, Y3, Y0, 9) \
+		YP_ARX(Y1, Y2, Y3, 13) \
+		YP_ARX(Y0, Y1, Y2, 18) \
+		Y1 = _mm_shuffle_epi32(Y1, 0x39); \
+		Y2 = _mm_shuffle_epi32(Y2, 0x4E); \
+		Y3 = _mm_shuffle_epi32(Y3, 0x93); \
+	} \
+	X0 = _mm_add_epi32(X0, Y0); \
+	X1 = _mm_add_epi32(X1, Y1); \
+	X2 = _mm_add_epi32(X2, Y2); \
+	X3 = _mm_add_epi32(X3, Y3); \
+}
+
+/* X <-- (hi(X) * lo(X) + S0[p0]) xor S1[p1], both 64-bit words at once */
+#define YP_PWXFORM_LANE(X) { \
+	uint32_t xl = (uint32_t)_mm_cvtsi128_si32(X) & Smask; \
+	uint32_t xh = (uint32_t)_mm_cvtsi128_si32(_mm_srli_epi64(X, 32)) & Smask; \
+	X = _mm_mul_epu32(_mm_srli_epi64(X, 32), X); \
+	X = _mm_add_epi64(X, _mm_loadu_si128((const __m128i *)(S0 + xl))); \
+	X = _mm_xor_si128(X, _mm_loadu_si128((const __m128i *)(S1 + xh))); \
+}
+
+/* count is a multiple of 16 in all callers */
+YP_FN void YP(blkcpy)(uint32_t *dst, const uint32_t *src, size_t count)
+{
+	__m128i *d = (__m128i *)dst;
+	const __m128i *s = (const __m128i *)src;
+	size_t i;
+
+	for (i = 0; i < count / 4; i += 4) {
+		_mm_storeu_si128(&d[i + 0], _mm_loadu_si128(&s[i + 0]));
+		_mm_storeu_si128(&d[i + 1], _mm_loadu_si128(&s[i + 1]));
+		_mm_storeu_si128(&d[i + 2], _mm_loadu_si128(&s[i + 2]));
+		_mm_storeu_si128(&d[i + 3], _mm_loadu_si128(&s[i + 3]));
+	}
+}
+
+YP_FN void YP(blkxor)(uint32_t *dst, const uint32_t *src, size_t count)
+{
+	__m128i *d = (__m128i *)dst;
+	const __m128i *s = (const __m128i *)src;
+	size_t i, k;
+
+	for (i = 0; i < count / 4; i += 4)
+		for (k = 0; k < 4; k++)
+			_mm_storeu_si128(&d[i + k], _mm_xor_si128(
+			    _mm_loadu_si128(&d[i + k]), _mm_loadu_si128(&s[i + k])));
+}
+
+/**
+ * blockmix_salsa(B):
+ * Compute B = BlockMix_{salsa20, 1}(B).  The input B must be 128 bytes in
+ * length.
+ */
+YP_FN void YP(blockmix_salsa)(uint32_t *B, uint32_t rounds)
+{
+	__m128i *Bv = (__m128i *)B;
+	__m128i X0 = _mm_loadu_si128(&Bv[4]), X1 = _mm_loadu_si128(&Bv[5]);
+	__m128i X2 = _mm_loadu_si128(&Bv[6]), X3 = _mm_loadu_si128(&Bv[7]);
+	size_t i;
+
+	for (i = 0; i < 2; i++) {
+		X0 = _mm_xor_si128(X0, _mm_loadu_si128(&Bv[i * 4 + 0]));
+		X1 = _mm_xor_si128(X1, _mm_loadu_si128(&Bv[i * 4 + 1]));
+		X2 = _mm_xor_si128(X2, _mm_loadu_si128(&Bv[i * 4 + 2]));
+		X3 = _mm_xor_si128(X3, _mm_loadu_si128(&Bv[i * 4 + 3]));
+		YP_SALSA20(X0, X1, X2, X3, rounds)
+		_mm_storeu_si128(&Bv[i * 4 + 0], X0);
+		_mm_storeu_si128(&Bv[i * 4 + 1], X1);
+		_mm_storeu_si128(&Bv[i * 4 + 2], X2);
+		_mm_storeu_si128(&Bv[i * 4 + 3], X3);
+	}
+}
+
+/**
+ * blockmix_pwxform(B, ctx, r):
+ * Compute B = BlockMix_pwxform{salsa20, ctx, r}(B).  The input B must be
+ * 128r bytes in length.  With PWXbytes == 64 every pwxform block is also a
+ * Salsa20 block and only the last one goes through Salsa20.
+ */
+YP_FN void YP(blockmix_pwxform)(uint32_t *B, pwxform_ctx_t *ctx, size_t r)
+{
+	__m128i *Bv = (__m128i *)B;
+	uint8_t *S0 = (uint8_t *)ctx->S0, *S1 = (uint8_t *)ctx->S1;
+	uint8_t *S2 = (uint8_t *)ctx->S2;
+	const uint32_t Smask = ctx->Smask;
+	const uint32_t PWXrounds = ctx->PWXrounds;
+	const int writes = ctx->version != YESPOWER_0_5;
+	size_t r1 = 2 * r, i;
+	__m128i X0, X1, X2, X3;
+
+	X0 = _mm_loadu_si128(&Bv[(r1 - 1) * 4 + 0]);
+	X1 = _mm_loadu_si128(&Bv[(r1 - 1) * 4 + 1]);
+	X2 = _mm_loadu_si128(&Bv[(r1 - 1) * 4 + 2]);
+	X3 = _mm_loadu_si128(&Bv[(r1 - 1) * 4 + 3]);
+
+	for (i = 0; i < r1; i++) {
+		size_t w = ctx->w * sizeof(*ctx->S0);
+		uint32_t k;
+
+		if (r1 > 1) {
+			X0 = _mm_xor_si128(X0, _mm_loadu_si128(&Bv[i * 4 + 0]));
+			X1 = _mm_xor_si128(X1, _mm_loadu_si128(&Bv[i * 4 + 1]));
+			X2 = _mm_xor_si128(X2, _mm_loadu_si128(&Bv[i * 4 + 2]));
+			X3 = _mm_xor_si128(X3, _mm_loadu_si128(&Bv[i * 4 + 3]));
+		}
+
+		/* pwxform(X), writing the S-boxes in the reference order */
+		for (k = 0; k < PWXrounds; k++) {
+			YP_PWXFORM_LANE(X0)
+			if (writes)
+				_mm_storeu_si128((__m128i *)(S0 + w), X0);
+			YP_PWXFORM_LANE(X1)
+			if (writes) {
+				_mm_storeu_si128((__m128i *)(S1 + w), X1);
+				w += PWXsimple * 8;
+			}
+			YP_PWXFORM_LANE(X2)
+			if (writes && k == 0)
+				_mm_storeu_si128((__m128i *)(S0 + w), X2);
+			YP_PWXFORM_LANE(X3)
+			if (writes && k == 0) {
+				_mm_storeu_si128((__m128i *)(S1 + w), X3);
+				w += PWXsimple * 8;
+			}
+		}
+
+		if (writes) {
+			/* (S0, S1, S2) <-- (S2, S0, S1), w <-- w mod 2^Swidth */
+			uint8_t *t = S2;
+			S2 = S1;
+			S1 = S0;
+			S0 = t;
+			ctx->w = (w / sizeof(*ctx->S0)) &
+			    ((1 << ctx->Swidth) * PWXsimple - 1);
+		}
+
+		if (i == r1 - 1)
+			YP_SALSA20(X0, X1, X2, X3, ctx->salsa20_rounds)
+
+		_mm_storeu_si128(&Bv[i * 4 + 0], X0);
+		_mm_storeu_si128(&Bv[i * 4 + 1], X1);
+		_mm_storeu_si128(&Bv[i * 4 + 2], X2);
+		_mm_storeu_si128(&Bv[i * 4 + 3], X3);
+	}
+
+	ctx->S0 = (uint32_t (*)[2])S0;
+	ctx->S1 = (uint32_t (*)[2])S1;
+	ctx->S2 = (uint32_t (*)[2])S2;
+}
+
+#undef YP_PWXFORM_LANE
+#undef YP_SALSA20
+#undef YP_ARX
+#undef YP_FN
+#undef YP
+#undef YP_CAT
+#undef YP_CAT_
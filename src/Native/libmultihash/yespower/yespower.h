@@ -130,6 +130,26 @@ extern int yespower_tls(const uint8_t *src, size_t srclen,
 extern int yespower_b2b_tls(const uint8_t *src, size_t srclen,
     const yespower_params_t *params, yespower_binary_t *dst);
 
+#define YESPOWER_KERNEL_AUTO   0
+#define YESPOWER_KERNEL_SCALAR 1
+#define YESPOWER_KERNEL_SSE2   2
+#define YESPOWER_KERNEL_AVX    3
+#define YESPOWER_KERNEL_XOP    4
+
+/**
+ * yespower_kernel():
+ * Return the best YESPOWER_KERNEL_* available on this CPU.
+ */
+extern unsigned int yespower_kernel(void);
+
+/**
+ * yespower_set_kernel(kernel):
+ * Select the YESPOWER_KERNEL_* used by subsequent yespower() calls on the
+ * calling thread.  AUTO (the default) picks the best kernel available and a
+ * kernel the CPU lacks is downgraded.
+ */
+extern void yespower_set_kernel(unsigned int kernel);
+
 void yespower_hash(const char* input, char* output, uint32_t len);
 void yespowerIC_hash(const char* input, char* output, uint32_t len);
 void yespowerIOTS_hash(const char* input, char* output, uint32_t len);